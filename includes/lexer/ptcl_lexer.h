@@ -4,13 +4,20 @@
 #include <stdlib.h>
 #include <ptcl_token.h>
 #include <ptcl_lexer_configuration.h>
+#include <ptcl_trace.h>
 
 #define PTCL_DEFAULT_POOL_SIZE 16
+#define PTCL_LEXER_DEFAULT_TOKENS_CAPACITY 256
 
 typedef struct ptcl_lexer ptcl_lexer;
 
 ptcl_lexer* ptcl_lexer_create(char* executor, char* source, ptcl_lexer_configuration *configuration);
 
+// Starts new source, buffers of previous one are kept
+void ptcl_lexer_set_source(ptcl_lexer *lexer, char *executor, char *source);
+
+void ptcl_lexer_set_trace(ptcl_lexer* lexer, ptcl_trace *trace);
+
 char ptcl_lexer_current(ptcl_lexer* lexer);
 
 void ptcl_lexer_skip(ptcl_lexer* lexer);
@@ -33,6 +40,9 @@ bool ptcl_lexer_add_pool_string(ptcl_lexer *lexer, char *string);
 
 ptcl_tokens_list ptcl_lexer_tokenize(ptcl_lexer* lexer);
 
+// Destroys tokens of list made by this lexer, its array is reused by next tokenizing
+void ptcl_lexer_recycle(ptcl_lexer *lexer, ptcl_tokens_list tokens_list);
+
 void ptcl_lexer_destroy(ptcl_lexer* lexer);
 
 #endif //PTCL_LEXER_H
@@ -1,6 +1,7 @@
 #ifndef PTCL_LEXER_CONFIGURATION_H
 #define PTCL_LEXER_CONFIGURATION_H
 
+#include <stdint.h>
 #include <string.h>
 #include <ptcl_token.h>
 
@@ -70,6 +71,7 @@ static ptcl_lexer_configuration ptcl_lexer_configuration_default()
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_and_type, "and");
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_or_type, "or");
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_const_type, "const");
+    PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_import_type, "import");
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_hashtag_type, "#");
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_left_par_type, "(");
     PTCL_LEXER_CONFIGURATION_ADD_TOKEN(ptcl_token_right_par_type, ")");
@@ -97,6 +99,32 @@ static ptcl_lexer_configuration ptcl_lexer_configuration_default()
     return configuration;
 }
 
+// Same for same keywords, so code, which is compiled with other keywords, isn't reused
+static uint64_t ptcl_lexer_configuration_hash(ptcl_lexer_configuration *configuration)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < configuration->count; i++)
+    {
+        const uint32_t type = configuration->tokens[i].type;
+        const unsigned char *bytes = (const unsigned char *)&type;
+        for (size_t j = 0; j < sizeof(type); j++)
+        {
+            hash = (hash ^ bytes[j]) * 0x100000001b3ULL;
+        }
+
+        for (char *value = configuration->tokens[i].value; value != NULL; value++)
+        {
+            hash = (hash ^ (unsigned char)*value) * 0x100000001b3ULL;
+            if (*value == '\0')
+            {
+                break;
+            }
+        }
+    }
+
+    return hash;
+}
+
 static bool ptcl_lexer_configuration_try_get_token(ptcl_lexer_configuration *configuration, char *name, ptcl_token_type *type)
 {
     for (size_t i = 0; i < configuration->count; i++)
@@ -0,0 +1,45 @@
+#ifndef PTCL_MODULE_H
+#define PTCL_MODULE_H
+
+#include <ptcl_lexer.h>
+
+#define PTCL_MODULE_EXTENSION ".ptcl"
+#define PTCL_MODULE_INTERFACE_EXTENSION ".ptcli"
+#define PTCL_MODULE_DEFAULT_CAPACITY 8
+
+// Loaded modules. Interface of module is its tokens in binary form, which is written next to it on first import
+// and mapped by next ones, so importing file doesn't read and tokenize module again
+typedef struct ptcl_modules ptcl_modules;
+
+typedef struct ptcl_modules_failure
+{
+    // Value of import token, NULL if there was no memory
+    char *path;
+    ptcl_location location;
+} ptcl_modules_failure;
+
+ptcl_modules *ptcl_modules_create(ptcl_lexer_configuration *configuration);
+
+bool ptcl_modules_has_imports(ptcl_token *tokens, size_t count);
+
+// Copies input to buffer, where top-level imports are replaced by tokens of modules. Each module is inserted once.
+// Runtime functions and methods of modules are inserted as prototypes, their bodies are emitted only by module itself.
+// Top-level runtime variables are inserted as prototypes too, so importer declares them as extern.
+// Tokens of modules are valid until modules are destroyed or changed module is imported by next expanding
+bool ptcl_modules_expand(ptcl_modules *modules, ptcl_tokens_list *input, ptcl_token **buffer, size_t *capacity, size_t *count, ptcl_modules_failure *failure);
+
+// Count of leading tokens of input, which are only imports
+size_t ptcl_modules_leading_imports(ptcl_token *tokens, size_t count);
+
+// Expands tokens, which follow input of last expanding. Modules inserted by it aren't inserted again,
+// and imported modules are added to its ones
+bool ptcl_modules_expand_next(ptcl_modules *modules, ptcl_tokens_list *input, ptcl_token **buffer, size_t *capacity, size_t *count, ptcl_modules_failure *failure);
+
+// Modules inserted by last expanding, including ones imported by other modules. Paths live as long as modules
+size_t ptcl_modules_imported_count(ptcl_modules *modules);
+
+char *ptcl_modules_imported_path(ptcl_modules *modules, size_t index);
+
+void ptcl_modules_destroy(ptcl_modules *modules);
+
+#endif // PTCL_MODULE_H
@@ -0,0 +1,45 @@
+#ifndef PTCL_INCREMENTAL_H
+#define PTCL_INCREMENTAL_H
+
+#include <stdint.h>
+#include <ptcl_lexer.h>
+
+#define PTCL_INCREMENTAL_EXTENSION ".ptclc"
+// Must be increased when parser or transpiler give other code for same tokens, so older caches are dropped
+#define PTCL_INCREMENTAL_VERSION 1
+#define PTCL_INCREMENTAL_DEFAULT_CAPACITY 64
+
+// Transpiled bodies of ordinary top-level functions by their fingerprints, which are kept in file between compilations.
+// Fingerprint of body is hash of tokens of its function and hashes of top-level declarations, which it names.
+// Declarations, which can change parsing of anything after them, like syntaxes, are mixed into every next fingerprint,
+// so change of body recompiles only it, change of declaration only bodies, which depend on it
+typedef struct ptcl_incremental ptcl_incremental;
+
+// Cache of input is kept next to it with own extension. Missing, broken or outdated cache is started again
+ptcl_incremental *ptcl_incremental_create(char *input);
+
+// Forgets declarations of previous parse. Seed is mixed into all fingerprints, for example hash of prelude
+void ptcl_incremental_begin(ptcl_incremental *incremental, uint64_t seed);
+
+// Adds top-level declaration, NULL name means declaration, which every next body depends on
+void ptcl_incremental_declare(ptcl_incremental *incremental, char *name, ptcl_token *tokens, size_t count);
+
+uint64_t ptcl_incremental_fingerprint(ptcl_incremental *incremental, ptcl_token *tokens, size_t count);
+
+// Hash of types and values of tokens without their locations
+uint64_t ptcl_incremental_hash_tokens(ptcl_token *tokens, size_t count);
+
+bool ptcl_incremental_contains(ptcl_incremental *incremental, uint64_t fingerprint);
+
+// Returns code of body and marks it as used, so it is saved again. NULL if there is no such body
+char *ptcl_incremental_find(ptcl_incremental *incremental, uint64_t fingerprint, bool *with_stdlib);
+
+// Code is copied. Returns false if there is no memory, then body is just compiled again next time
+bool ptcl_incremental_store(ptcl_incremental *incremental, uint64_t fingerprint, char *code, size_t length, bool with_stdlib);
+
+// Writes used and stored bodies, unused ones are dropped. File isn't written if nothing has changed
+bool ptcl_incremental_save(ptcl_incremental *incremental);
+
+void ptcl_incremental_destroy(ptcl_incremental *incremental);
+
+#endif // PTCL_INCREMENTAL_H
@@ -1,6 +1,7 @@
 #ifndef PTCL_NODE_H
 #define PTCL_NODE_H
 
+#include <stdint.h>
 #include <ptcl_token.h>
 
 typedef struct ptcl_statement ptcl_statement;
@@ -38,6 +39,7 @@ typedef enum ptcl_expression_type
     ptcl_expression_array_type,
     ptcl_expression_variable_type,
     ptcl_expression_character_type,
+    ptcl_expression_string_type,
     ptcl_expression_double_type,
     ptcl_expression_float_type,
     ptcl_expression_integer_type,
@@ -267,34 +269,41 @@ typedef struct ptcl_argument
     bool is_variadic;
 } ptcl_argument;
 
-static ptcl_name ptcl_name_self = {
+// Built-in names and types are shared by all parsers of process, so they are read-only and copied before changing
+static ptcl_name const ptcl_name_self = {
     .value = "self",
     .location = {0},
     .is_anonymous = false,
     .is_free = false};
 
-static ptcl_name ptcl_name_empty = {
+static ptcl_name const ptcl_name_empty = {
     .value = "",
     .location = {0},
     .is_anonymous = false,
     .is_free = false};
 
-static ptcl_type ptcl_type_any = {
+static ptcl_type const ptcl_type_any = {
     .type = ptcl_value_any_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_any_pointer = {
+static ptcl_type const ptcl_type_const_any = {
+    .type = ptcl_value_any_type,
+    .is_primitive = true,
+    .is_static = false,
+    .is_const = true};
+
+static ptcl_type const ptcl_type_any_pointer = {
     .type = ptcl_value_pointer_type,
     .pointer = {.is_any = true, .is_null = false, .target = NULL},
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_any_type = {
+static ptcl_type const ptcl_type_any_type = {
     .type = ptcl_value_object_type_type,
-    .object_type = {.target = &ptcl_type_any},
+    .object_type = {.target = (ptcl_type *)&ptcl_type_any},
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
@@ -305,37 +314,37 @@ static ptcl_type const ptcl_type_word = {
     .is_static = true,
     .is_const = false};
 
-static ptcl_type ptcl_type_character = {
+static ptcl_type const ptcl_type_character = {
     .type = ptcl_value_character_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_double = {
+static ptcl_type const ptcl_type_double = {
     .type = ptcl_value_double_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_float = {
+static ptcl_type const ptcl_type_float = {
     .type = ptcl_value_float_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_integer = {
+static ptcl_type const ptcl_type_integer = {
     .type = ptcl_value_integer_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_void = {
+static ptcl_type const ptcl_type_void = {
     .type = ptcl_value_void_type,
     .is_primitive = true,
     .is_static = false,
     .is_const = false};
 
-static ptcl_type ptcl_type_null = {
+static ptcl_type const ptcl_type_null = {
     .type = ptcl_value_pointer_type,
     .is_primitive = true,
     .is_static = true,
@@ -356,6 +365,13 @@ typedef struct ptcl_expression_array
     size_t count;
 } ptcl_expression_array;
 
+// String literal, characters are stored in one buffer with terminator
+typedef struct ptcl_expression_string
+{
+    char *value;
+    size_t length;
+} ptcl_expression_string;
+
 typedef struct ptcl_expression_binary
 {
     ptcl_binary_operator_type type;
@@ -461,25 +477,33 @@ typedef struct ptcl_statement_func_decl
     ptcl_func_body *func_body;
     size_t index;
     ptcl_type return_type;
+    // Fingerprint of body for incremental compilation, zero if body isn't ordinary one
+    uint64_t fingerprint;
     bool is_variadic;
     bool is_self_const;
     bool with_self;
     bool is_constructor;
+    // Body isn't parsed, transpiler takes its code from incremental cache by fingerprint
+    bool is_cached;
 } ptcl_statement_func_decl;
 
+// Keep common header small, large payloads must be stored out of line
 typedef struct ptcl_expression
 {
     ptcl_expression_type type;
-    ptcl_type return_type;
-    ptcl_location location;
     bool is_original;
     bool with_type;
+    // Made from element of each, which body is instantiated for next elements by replacing its value
+    bool is_slot;
+    ptcl_location location;
+    ptcl_type return_type;
 
     union
     {
         ptcl_expression_lated_func_body lated_body;
-        ptcl_statement_func_call func_call;
-        ptcl_expression_array array;
+        ptcl_statement_func_call *func_call;
+        ptcl_expression_array *array;
+        ptcl_expression_string string;
         ptcl_name word;
         char character;
         long long_n;
@@ -490,16 +514,22 @@ typedef struct ptcl_expression
         ptcl_expression_binary binary;
         ptcl_expression_unary unary;
         ptcl_expression_array_element array_element;
+        // Dot isn't larger than variable, so out of line it would only cost allocation
         ptcl_expression_dot dot;
-        ptcl_expression_ctor ctor;
+        ptcl_expression_ctor *ctor;
         ptcl_expression_if if_expr;
         ptcl_expression_object_type object_type;
-        ptcl_expression_cast cast;
+        ptcl_expression_cast *cast;
         ptcl_statement *internal_statement;
         ptcl_token internal_token;
     };
 } ptcl_expression;
 
+#define PTCL_EXPRESSION_MAX_SIZE 112
+
+_Static_assert(sizeof(void *) != 8 || sizeof(ptcl_expression) <= PTCL_EXPRESSION_MAX_SIZE,
+               "ptcl_expression grew, large payloads must be stored out of line");
+
 typedef struct ptcl_statement_typedata_decl
 {
     ptcl_statement_modifiers modifiers;
@@ -557,6 +587,8 @@ typedef struct ptcl_statement
     ptcl_func_body *root;
     ptcl_attributes attributes;
     bool is_original;
+    // Lated state index + 1 of syntax or inlined static function which produced statement, 0 for written code
+    uint32_t origin;
 
     union
     {
@@ -589,6 +621,7 @@ static ptcl_expression *ptcl_expression_create(ptcl_expression_type type, ptcl_t
         expression->location = location;
         expression->is_original = true;
         expression->with_type = true;
+        expression->is_slot = false;
     }
 
     return expression;
@@ -601,6 +634,7 @@ static ptcl_statement *ptcl_statement_create(ptcl_statement_type type, ptcl_func
     {
         statement->type = type;
         statement->is_original = true;
+        statement->origin = 0;
         statement->attributes = attributes;
         statement->root = root;
         statement->location = location;
@@ -722,31 +756,36 @@ static ptcl_type ptcl_type_create_typedata(ptcl_type_typedata *typedata, bool is
     return base;
 }
 
-static ptcl_type ptcl_type_create_array(ptcl_type *type, bool is_const, size_t count)
+// Targets are shared and never changed through holder, built-in ones are in read-only memory
+static ptcl_type *ptcl_type_share(const ptcl_type *type)
+{
+    return (ptcl_type *)type;
+}
+
+static ptcl_type ptcl_type_create_array(const ptcl_type *type, bool is_const, size_t count)
 {
     ptcl_type base = ptcl_type_create_base(ptcl_value_array_type, true, is_const, true);
     base.array = (ptcl_type_array){
-        .target = type,
+        .target = ptcl_type_share(type),
         .count = count};
     return base;
 }
 
-static ptcl_type ptcl_type_create_object_type(ptcl_type *type, bool is_const)
+static ptcl_type ptcl_type_create_object_type(const ptcl_type *type, bool is_const)
 {
     ptcl_type base = ptcl_type_create_base(ptcl_value_object_type_type, true, is_const, false);
-    base.object_type.target = type;
+    base.object_type.target = ptcl_type_share(type);
     return base;
 }
 
-static ptcl_type ptcl_type_create_pointer(ptcl_type *type, bool is_const)
+static ptcl_type ptcl_type_create_pointer(const ptcl_type *type, bool is_const)
 {
     ptcl_type base = ptcl_type_create_base(ptcl_value_pointer_type, true, is_const, type->is_static);
     base.pointer = (ptcl_type_pointer){
-        .target = type,
+        .target = ptcl_type_share(type),
         .is_any = false,
         .is_null = false,
         .is_const = is_const};
-    base.pointer.target->is_static = false;
     return base;
 }
 
@@ -881,17 +920,32 @@ static ptcl_expression_array ptcl_expression_array_create_member(ptcl_type type,
         .count = count};
 }
 
-static ptcl_expression *ptcl_expression_array_create(ptcl_type type, ptcl_expression **expressions, size_t count, ptcl_location location)
+// Array is stored out of line like call, node doesn't own its elements if it isn't created
+static ptcl_expression *ptcl_expression_array_node_create(ptcl_expression_array array, ptcl_type return_type, ptcl_location location)
 {
-    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_array_type, type, location);
-    if (expression != NULL)
+    ptcl_expression_array *target = malloc(sizeof(ptcl_expression_array));
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_array_type, return_type, location);
+    if (expression == NULL)
     {
-        expression->array = ptcl_expression_array_create_member(type, expressions, count);
+        free(target);
+        return NULL;
     }
 
+    *target = array;
+    expression->array = target;
     return expression;
 }
 
+static ptcl_expression *ptcl_expression_array_create(ptcl_type type, ptcl_expression **expressions, size_t count, ptcl_location location)
+{
+    return ptcl_expression_array_node_create(ptcl_expression_array_create_member(type, expressions, count), type, location);
+}
+
 static ptcl_expression_array ptcl_expression_array_create_empty(ptcl_type type)
 {
     return (ptcl_expression_array){
@@ -914,32 +968,69 @@ static ptcl_expression *ptcl_expression_create_character(char character, ptcl_lo
 
 static ptcl_expression *ptcl_expression_create_characters(ptcl_expression **expressions, size_t count, ptcl_location location)
 {
-    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_array_type, (ptcl_type){0}, location);
+    ptcl_type array_type = ptcl_type_create_array(&ptcl_type_character, false, (int)count);
+    return ptcl_expression_array_node_create(ptcl_expression_array_create_member(ptcl_type_character, expressions, count), array_type, location);
+}
+
+static ptcl_expression *ptcl_expression_create_string(char *value, size_t length, ptcl_location location)
+{
+    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_string_type, (ptcl_type){0}, location);
     if (expression != NULL)
     {
-        ptcl_type array_type = ptcl_type_create_array(&ptcl_type_character, false, (int)count);
-        expression->return_type = array_type;
-        expression->array = (ptcl_expression_array){
-            .type = ptcl_type_character,
-            .expressions = expressions,
-            .count = count};
+        expression->return_type = ptcl_type_create_array(&ptcl_type_character, false, (int)(length + 1));
+        expression->return_type.is_static = true;
+        expression->string = (ptcl_expression_string){
+            .value = value,
+            .length = length};
     }
 
     return expression;
 }
 
-static ptcl_expression *ptcl_expression_create_array(ptcl_type type, ptcl_expression **expressions, ptcl_location location)
+// Creates array of character nodes from string, used only where elements are needed one by one
+static ptcl_expression *ptcl_expression_string_to_array(ptcl_expression *string)
 {
-    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_array_type, type, location);
-    if (expression != NULL)
+    const size_t count = string->string.length + 1;
+    ptcl_expression **expressions = malloc(count * sizeof(ptcl_expression *));
+    if (expressions == NULL)
     {
-        expression->array = (ptcl_expression_array){
-            .type = *type.array.target,
-            .expressions = expressions,
-            .count = type.array.count};
+        return NULL;
     }
 
-    return expression;
+    for (size_t i = 0; i < count; i++)
+    {
+        expressions[i] = ptcl_expression_create_character(string->string.value[i], string->location);
+        if (expressions[i] == NULL)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                free(expressions[j]);
+            }
+
+            free(expressions);
+            return NULL;
+        }
+    }
+
+    ptcl_expression *array = ptcl_expression_create_characters(expressions, count, string->location);
+    if (array == NULL)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            free(expressions[i]);
+        }
+
+        free(expressions);
+        return NULL;
+    }
+
+    array->return_type.is_static = string->return_type.is_static;
+    return array;
+}
+
+static ptcl_expression *ptcl_expression_create_array(ptcl_type type, ptcl_expression **expressions, ptcl_location location)
+{
+    return ptcl_expression_array_node_create(ptcl_expression_array_create_member(*type.array.target, expressions, type.array.count), type, location);
 }
 
 static ptcl_expression *ptcl_expression_create_variable(ptcl_name name, ptcl_type type, size_t variable_id, ptcl_func_body *root, ptcl_location location)
@@ -1054,27 +1145,27 @@ static bool ptcl_type_get_member(
     return false;
 }
 
-static ptcl_type ptcl_type_create_func_from_decl(ptcl_statement_func_decl func_decl, ptcl_type *return_type, bool is_static_by_declaration)
+static ptcl_type ptcl_type_create_func_from_decl(ptcl_statement_func_decl func_decl, const ptcl_type *return_type, bool is_static_by_declaration)
 {
     return (ptcl_type){
         .type = ptcl_value_function_pointer_type,
         .is_primitive = true,
         .is_static = false,
-        .function_pointer.return_type = return_type,
+        .function_pointer.return_type = ptcl_type_share(return_type),
         .function_pointer.arguments = func_decl.arguments,
         .function_pointer.count = func_decl.count,
         .function_pointer.is_static_by_declaration = is_static_by_declaration,
         .function_pointer.is_variadic = func_decl.is_variadic};
 }
 
-static ptcl_type ptcl_type_create_func(ptcl_type *return_type, ptcl_argument *arguments, size_t count, bool is_static_by_declaration,
+static ptcl_type ptcl_type_create_func(const ptcl_type *return_type, ptcl_argument *arguments, size_t count, bool is_static_by_declaration,
                                        bool is_variadic)
 {
     return (ptcl_type){
         .type = ptcl_value_function_pointer_type,
         .is_primitive = true,
         .is_static = false,
-        .function_pointer.return_type = return_type,
+        .function_pointer.return_type = ptcl_type_share(return_type),
         .function_pointer.arguments = arguments,
         .function_pointer.count = count,
         .function_pointer.is_static_by_declaration = is_static_by_declaration,
@@ -1210,17 +1301,46 @@ static ptcl_expression *ptcl_expression_binary_create(ptcl_binary_operator_type
     return expression;
 }
 
+static ptcl_expression *ptcl_expression_func_call_create(ptcl_statement_func_call func_call, ptcl_type return_type, ptcl_location location)
+{
+    ptcl_statement_func_call *target = malloc(sizeof(ptcl_statement_func_call));
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_func_call_type, return_type, location);
+    if (expression == NULL)
+    {
+        free(target);
+        return NULL;
+    }
+
+    *target = func_call;
+    expression->func_call = target;
+    return expression;
+}
+
 static ptcl_expression *ptcl_expression_cast_create(ptcl_expression *value, ptcl_type type, bool is_free, ptcl_location location)
 {
+    ptcl_expression_cast *cast = malloc(sizeof(ptcl_expression_cast));
+    if (cast == NULL)
+    {
+        return NULL;
+    }
+
     ptcl_expression *expression = ptcl_expression_create(ptcl_expression_cast_type, type, location);
-    if (expression != NULL)
+    if (expression == NULL)
     {
-        expression->cast = (ptcl_expression_cast){
-            .type = type,
-            .value = value,
-            .is_free = is_free};
+        free(cast);
+        return NULL;
     }
 
+    *cast = (ptcl_expression_cast){
+        .type = type,
+        .value = value,
+        .is_free = is_free};
+    expression->cast = cast;
     return expression;
 }
 
@@ -1377,6 +1497,27 @@ static ptcl_expression_ctor ptcl_expression_ctor_create(ptcl_name name, ptcl_exp
         .count = count};
 }
 
+// Ctor is stored out of line like call, node doesn't own its values if it isn't created
+static ptcl_expression *ptcl_expression_ctor_node_create(ptcl_expression_ctor ctor, ptcl_type return_type, ptcl_location location)
+{
+    ptcl_expression_ctor *target = malloc(sizeof(ptcl_expression_ctor));
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_ctor_type, return_type, location);
+    if (expression == NULL)
+    {
+        free(target);
+        return NULL;
+    }
+
+    *target = ctor;
+    expression->ctor = target;
+    return expression;
+}
+
 static ptcl_expression *ptcl_expression_word_create(ptcl_name content, ptcl_location location)
 {
     ptcl_expression *expression = ptcl_expression_create(ptcl_expression_word_type, ptcl_type_word, location);
@@ -1473,6 +1614,23 @@ static char *ptcl_string_from_array(ptcl_expression_array expression)
     return characters;
 }
 
+static char *ptcl_string_from_expression(ptcl_expression *expression)
+{
+    if (expression->type != ptcl_expression_string_type)
+    {
+        return ptcl_string_from_array(*expression->array);
+    }
+
+    char *characters = malloc(sizeof(char) * (expression->string.length + 1));
+    if (characters == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(characters, expression->string.value, expression->string.length + 1);
+    return characters;
+}
+
 static bool ptcl_type_equals(ptcl_type left, ptcl_type right)
 {
     if (left.type != right.type)
@@ -1483,16 +1641,16 @@ static bool ptcl_type_equals(ptcl_type left, ptcl_type right)
     switch (left.type)
     {
     case ptcl_value_pointer_type:
-        if (left.pointer.is_any || right.pointer.is_any)
+        if (left.pointer.is_any || right.pointer.is_any || left.pointer.target == right.pointer.target)
         {
             return true;
         }
 
         return ptcl_type_equals(*left.pointer.target, *right.pointer.target);
     case ptcl_value_array_type:
-        return ptcl_type_equals(*left.array.target, *right.array.target);
+        return left.array.target == right.array.target || ptcl_type_equals(*left.array.target, *right.array.target);
     case ptcl_value_object_type_type:
-        return ptcl_type_equals(*left.object_type.target, *right.object_type.target);
+        return left.object_type.target == right.object_type.target || ptcl_type_equals(*left.object_type.target, *right.object_type.target);
     case ptcl_value_function_pointer_type:
         return ptcl_type_function_equals(left.function_pointer, right.function_pointer);
     default:
@@ -1590,16 +1748,17 @@ static bool ptcl_type_is_castable(ptcl_type expected, ptcl_type target)
     switch (expected.type)
     {
     case ptcl_value_pointer_type:
-        if (expected.pointer.is_any || target.pointer.is_null)
+        // Castability is reflexive, so shared (interned) targets need no walk
+        if (expected.pointer.is_any || target.pointer.is_null || expected.pointer.target == target.pointer.target)
         {
             return true;
         }
 
         return ptcl_type_is_castable(*expected.pointer.target, *target.pointer.target);
     case ptcl_value_array_type:
-        return ptcl_type_is_castable(*expected.array.target, *target.array.target);
+        return expected.array.target == target.array.target || ptcl_type_is_castable(*expected.array.target, *target.array.target);
     case ptcl_value_object_type_type:
-        return ptcl_type_is_castable(*expected.object_type.target, *target.object_type.target);
+        return expected.object_type.target == target.object_type.target || ptcl_type_is_castable(*expected.object_type.target, *target.object_type.target);
     case ptcl_value_typedata_type:
         return ptcl_name_compare(expected.typedata->identifier, target.typedata->identifier);
     case ptcl_value_word_type:
@@ -1728,6 +1887,7 @@ static ptcl_expression *ptcl_expression_unary_static_evaluate(ptcl_binary_operat
         return unary;
     }
 
+    value->is_slot = false;
     switch (type)
     {
     case ptcl_binary_operator_minus_type:
@@ -1793,7 +1953,8 @@ static ptcl_type ptcl_type_copy(ptcl_type type, bool *is_out_of_memory)
     switch (type.type)
     {
     case ptcl_value_object_type_type:
-        if (type.object_type.target != NULL)
+        // Primitive targets are shared: built-ins and interned types outlive any copy
+        if (type.object_type.target != NULL && !type.object_type.target->is_primitive)
         {
             copy.object_type.target = malloc(sizeof(ptcl_type));
             *is_out_of_memory = copy.object_type.target == NULL;
@@ -1812,7 +1973,8 @@ static ptcl_type ptcl_type_copy(ptcl_type type, bool *is_out_of_memory)
 
         break;
     case ptcl_value_pointer_type:
-        if (type.pointer.target != NULL)
+        // Primitive targets are shared: built-ins and interned types outlive any copy
+        if (type.pointer.target != NULL && !type.pointer.target->is_primitive)
         {
             copy.pointer.target = malloc(sizeof(ptcl_type));
             *is_out_of_memory = copy.pointer.target == NULL;
@@ -1890,7 +2052,8 @@ static ptcl_type ptcl_type_copy(ptcl_type type, bool *is_out_of_memory)
         break;
     }
     case ptcl_value_array_type:
-        if (type.array.target != NULL)
+        // Primitive targets are shared: built-ins and interned types outlive any copy
+        if (type.array.target != NULL && !type.array.target->is_primitive)
         {
             copy.array.target = malloc(sizeof(ptcl_type));
             *is_out_of_memory = copy.array.target == NULL;
@@ -1986,6 +2149,62 @@ static ptcl_expression *ptcl_expression_copy(ptcl_expression *target, ptcl_locat
             return NULL;
         }
 
+        // Large payloads are stored out of line, so copy gets own one like inline payloads and doesn't refer to one of target,
+        // which can be changed or released before copy. Their parts are still shared
+        bool is_copied = true;
+        switch (target->type)
+        {
+        case ptcl_expression_func_call_type:
+            expression->func_call = malloc(sizeof(ptcl_statement_func_call));
+            is_copied = expression->func_call != NULL;
+            if (is_copied)
+            {
+                *expression->func_call = *target->func_call;
+            }
+
+            break;
+        case ptcl_expression_ctor_type:
+            expression->ctor = malloc(sizeof(ptcl_expression_ctor));
+            is_copied = expression->ctor != NULL;
+            if (is_copied)
+            {
+                *expression->ctor = *target->ctor;
+            }
+
+            break;
+        case ptcl_expression_array_type:
+            expression->array = malloc(sizeof(ptcl_expression_array));
+            is_copied = expression->array != NULL;
+            if (is_copied)
+            {
+                *expression->array = *target->array;
+            }
+
+            break;
+        case ptcl_expression_cast_type:
+            expression->cast = malloc(sizeof(ptcl_expression_cast));
+            is_copied = expression->cast != NULL;
+            if (is_copied)
+            {
+                *expression->cast = *target->cast;
+            }
+
+            break;
+        default:
+            break;
+        }
+
+        if (!is_copied)
+        {
+            if (expression->with_type)
+            {
+                ptcl_type_destroy(expression->return_type);
+            }
+
+            free(expression);
+            return NULL;
+        }
+
         expression->location = location;
     }
 
@@ -2026,13 +2245,13 @@ static bool ptcl_type_is_primitive(ptcl_value_type type)
 
 static ptcl_expression *ptcl_expression_static_cast(ptcl_expression *expression)
 {
-    if (expression->type != ptcl_expression_cast_type || !expression->cast.value->return_type.is_static)
+    if (expression->type != ptcl_expression_cast_type || !expression->cast->value->return_type.is_static)
     {
         return expression;
     }
 
-    ptcl_type type = expression->cast.type;
-    ptcl_expression *value = expression->cast.value;
+    ptcl_type type = expression->cast->type;
+    ptcl_expression *value = expression->cast->value;
     if (value->return_type.type == ptcl_value_function_pointer_type || !ptcl_type_is_primitive(expression->return_type.type) || !ptcl_type_is_primitive(type.type))
     {
         return expression;
@@ -2166,18 +2385,66 @@ static bool ptcl_expression_binary_static_type_equals(ptcl_expression *left, ptc
     return ptcl_type_is_castable(*right->return_type.object_type.target, left->return_type);
 }
 
+static bool ptcl_expression_try_get_character(ptcl_expression *array, size_t index, char *character)
+{
+    if (array->type == ptcl_expression_string_type)
+    {
+        *character = array->string.value[index];
+        return true;
+    }
+
+    ptcl_expression *element = array->array->expressions[index];
+    if (element->type != ptcl_expression_character_type)
+    {
+        return false;
+    }
+
+    *character = element->character;
+    return true;
+}
+
 static bool ptcl_expression_binary_static_equals(ptcl_expression *left, ptcl_expression *right)
 {
-    if (left->type == ptcl_expression_array_type)
+    if (left->type == ptcl_expression_string_type || right->type == ptcl_expression_string_type)
+    {
+        const bool is_left_array = left->type == ptcl_expression_string_type || left->type == ptcl_expression_array_type;
+        const bool is_right_array = right->type == ptcl_expression_string_type || right->type == ptcl_expression_array_type;
+        if (!is_left_array || !is_right_array)
+        {
+            return false;
+        }
+
+        const size_t count = left->type == ptcl_expression_string_type ? left->string.length + 1 : left->array->count;
+        const size_t right_count = right->type == ptcl_expression_string_type ? right->string.length + 1 : right->array->count;
+        if (count != right_count)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            char left_character;
+            char right_character;
+            if (!ptcl_expression_try_get_character(left, i, &left_character) ||
+                !ptcl_expression_try_get_character(right, i, &right_character) ||
+                left_character != right_character)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    else if (left->type == ptcl_expression_array_type)
     {
-        if (left->array.count != right->array.count)
+        if (left->array->count != right->array->count)
         {
             return false;
         }
 
-        for (size_t i = 0; i < left->array.count; i++)
+        for (size_t i = 0; i < left->array->count; i++)
         {
-            if (ptcl_expression_binary_static_equals(left->array.expressions[i], right->array.expressions[i]))
+            if (ptcl_expression_binary_static_equals(left->array->expressions[i], right->array->expressions[i]))
             {
                 continue;
             }
@@ -2215,6 +2482,8 @@ static inline ptcl_expression *ptcl_expression_binary_static_evaluate(ptcl_binar
     int condition = -1;
     ptcl_expression *result = left;
     result->location = location;
+    // Folded value isn't element of each anymore
+    result->is_slot = false;
     switch (type)
     {
     case ptcl_binary_operator_type_equals_type:
@@ -3042,6 +3311,25 @@ static void ptcl_expression_inside_destroy(ptcl_expression *expression)
             ptcl_type_destroy(expression->return_type);
         }
 
+        // Copy owns only its payload stored out of line, not parts of it
+        switch (expression->type)
+        {
+        case ptcl_expression_func_call_type:
+            free(expression->func_call);
+            break;
+        case ptcl_expression_array_type:
+            free(expression->array);
+            break;
+        case ptcl_expression_cast_type:
+            free(expression->cast);
+            break;
+        case ptcl_expression_ctor_type:
+            free(expression->ctor);
+            break;
+        default:
+            break;
+        }
+
         return;
     }
 
@@ -3055,22 +3343,28 @@ static void ptcl_expression_inside_destroy(ptcl_expression *expression)
     case ptcl_expression_lated_func_body_type:
         break;
     case ptcl_expression_func_call_type:
-        ptcl_statement_func_call_destroy(expression->func_call);
+        ptcl_statement_func_call_destroy(*expression->func_call);
+        free(expression->func_call);
         break;
     case ptcl_expression_array_type:
-        ptcl_expression_array_destroy(expression->array);
+        ptcl_expression_array_destroy(*expression->array);
+        free(expression->array);
+        break;
+    case ptcl_expression_string_type:
+        free(expression->string.value);
         break;
     case ptcl_expression_binary_type:
         ptcl_expression_destroy(expression->binary.left);
         ptcl_expression_destroy(expression->binary.right);
         break;
     case ptcl_expression_cast_type:
-        ptcl_expression_destroy(expression->cast.value);
-        if (expression->cast.is_free)
+        ptcl_expression_destroy(expression->cast->value);
+        if (expression->cast->is_free)
         {
-            ptcl_type_destroy(expression->cast.type);
+            ptcl_type_destroy(expression->cast->type);
         }
 
+        free(expression->cast);
         break;
     case ptcl_expression_unary_type:
         ptcl_expression_destroy(expression->unary.child);
@@ -3088,7 +3382,8 @@ static void ptcl_expression_inside_destroy(ptcl_expression *expression)
         ptcl_expression_destroy(expression->dot.left);
         break;
     case ptcl_expression_ctor_type:
-        ptcl_expression_ctor_destroy(expression->ctor);
+        ptcl_expression_ctor_destroy(*expression->ctor);
+        free(expression->ctor);
         break;
     case ptcl_expression_if_type:
         ptcl_expression_if_destroy(expression->if_expr);
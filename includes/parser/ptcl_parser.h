@@ -4,6 +4,10 @@
 #include <ptcl_node.h>
 #include <ptcl_parser_error.h>
 #include <ptcl_lexer_configuration.h>
+#include <ptcl_arena.h>
+#include <ptcl_type_interner.h>
+#include <ptcl_trace.h>
+#include <ptcl_incremental.h>
 
 #define PTCL_PARSER_MAX_DEPTH 256
 #define PTCL_PARSER_MAX_MODIFIERS_RECURSION 16
@@ -20,7 +24,7 @@ static ptcl_name const ptcl_statement_t_name = {
     .is_free = false,
     .is_anonymous = false};
 
-static ptcl_type_comp_type ptcl_statement_comp_type = {
+static ptcl_type_comp_type const ptcl_statement_comp_type = {
     .identifier = {
         .value = PTCL_PARSER_STATEMENT_TYPE_NAME,
         .location = {0},
@@ -38,13 +42,25 @@ static ptcl_name const ptcl_expression_t_name = {
     .is_free = false,
     .is_anonymous = false};
 
+static ptcl_type_comp_type const ptcl_expression_comp_type = {
+    .identifier = {
+        .value = PTCL_PARSER_EXPRESSION_TYPE_NAME,
+        .location = {0},
+        .is_free = false,
+        .is_anonymous = false},
+    .types = NULL,
+    .count = 0,
+    .functions = NULL,
+    .is_optional = false,
+    .is_any = false};
+
 static ptcl_name const ptcl_token_t_name = {
     .value = PTCL_PARSER_TOKEN_TYPE_NAME,
     .location = {0},
     .is_free = false,
     .is_anonymous = false};
 
-static ptcl_type_comp_type ptcl_token_comp_type = {
+static ptcl_type_comp_type const ptcl_token_comp_type = {
     .identifier = {
         .value = PTCL_PARSER_TOKEN_TYPE_NAME,
         .location = {0},
@@ -62,19 +78,17 @@ static ptcl_name const ptcl_insert_name = {
     .is_free = false,
     .is_anonymous = false};
 
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-#pragma GCC diagnostic ignored "-Wdiscarded-qualifiers"
-static ptcl_type ptcl_statement_t_type = {
+static ptcl_type const ptcl_statement_t_type = {
     .type = ptcl_value_type_type,
     .is_primitive = true,
     .is_static = true,
-    .comp_type = &ptcl_statement_comp_type};
+    .comp_type = (ptcl_type_comp_type *)&ptcl_statement_comp_type};
 
-static ptcl_type ptcl_token_t_type = {
+static ptcl_type const ptcl_token_t_type = {
     .type = ptcl_value_type_type,
     .is_primitive = true,
     .is_static = true,
-    .comp_type = &ptcl_token_comp_type};
+    .comp_type = (ptcl_type_comp_type *)&ptcl_token_comp_type};
 
 typedef enum ptcl_parser_flags
 {
@@ -94,6 +108,9 @@ typedef struct ptcl_parser_tokens_state
 {
     size_t position;
     ptcl_token *tokens;
+    // Distance from opening bracket to its pair, zero for other tokens.
+    // NULL for tokens which are built while parsing
+    size_t *partners;
     size_t count;
     bool is_free;
 } ptcl_parser_tokens_state;
@@ -104,6 +121,23 @@ typedef struct ptcl_parser_insert_state
     size_t syntax_depth;
 } ptcl_parser_insert_state;
 
+// Watermarks of everything speculative parsing can append to
+typedef struct ptcl_parser_checkpoint
+{
+    ptcl_parser_tokens_state tokens;
+    size_t syntax_depth;
+    size_t insert_states_count;
+    ptcl_arena_checkpoint arena;
+    size_t errors_count;
+    size_t syntaxes_count;
+    size_t typedatas_count;
+    size_t comp_types_count;
+    size_t functions_count;
+    size_t variables_count;
+    size_t lated_states_count;
+    size_t this_pairs_count;
+} ptcl_parser_checkpoint;
+
 typedef struct ptcl_parser_this_s_pair
 {
     ptcl_func_body *body;
@@ -201,6 +235,16 @@ typedef struct ptcl_parser_syntax
     bool is_out_of_scope;
 } ptcl_parser_syntax;
 
+// Syntaxes which are still matching the nodes of one usage, so each step compares only new nodes
+typedef struct ptcl_parser_syntax_candidates
+{
+    size_t *indices;
+    size_t count;
+    size_t matched;
+    size_t syntaxes_count;
+    bool is_built;
+} ptcl_parser_syntax_candidates;
+
 typedef struct ptcl_parser_syntax_pair
 {
     ptcl_func_body *body;
@@ -236,6 +280,61 @@ typedef enum ptcl_parser_instance_type
     ptcl_parser_instance_syntax_type
 } ptcl_parser_instance_type;
 
+// Increments counter only when stats are requested, so disabled stats cost one branch
+#define PTCL_STATS_ADD(stats, counter, value) \
+    do                                        \
+    {                                         \
+        if ((stats) != NULL)                  \
+        {                                     \
+            (stats)->counter += (value);      \
+        }                                     \
+    } while (false)
+
+typedef struct ptcl_parser_stats
+{
+    size_t tokens_count;
+    size_t lookups_count;
+    size_t lookups_scanned;
+    size_t syntax_match_attempts;
+    size_t syntax_backtracks;
+    size_t syntax_expansions;
+    size_t lated_body_reparses;
+    size_t cast_checks;
+    size_t interpreter_calls;
+    size_t interpreter_statements;
+    size_t statements_count;
+    size_t expressions_count;
+    size_t nodes_bytes;
+    size_t interned_types_count;
+    size_t arena_bytes;
+    size_t incremental_bodies_count;
+    size_t cached_bodies_count;
+} ptcl_parser_stats;
+
+typedef enum ptcl_parser_profile_type
+{
+    ptcl_parser_profile_none_type,
+    ptcl_parser_profile_syntax_type,
+    ptcl_parser_profile_inline_type
+} ptcl_parser_profile_type;
+
+typedef struct ptcl_parser_profile_entry
+{
+    ptcl_parser_profile_type type;
+    char *name;
+    size_t expansions_count;
+    size_t tokens_count;
+    size_t nodes_count;
+    size_t output_bytes;
+} ptcl_parser_profile_entry;
+
+// Expansion costs of syntaxes and inlined static functions, indexed by lated state of their body
+typedef struct ptcl_parser_profile
+{
+    ptcl_parser_profile_entry *entries;
+    size_t count;
+} ptcl_parser_profile;
+
 typedef struct ptcl_parser_result
 {
     ptcl_lexer_configuration *configuration;
@@ -256,9 +355,24 @@ typedef struct ptcl_parser_result
     size_t lated_states_count;
     ptcl_parser_this_s_pair *this_pairs;
     size_t this_pairs_count;
+    ptcl_arena *arena;
+    ptcl_type_interner *types;
+    ptcl_parser_stats *stats;
+    // First statements and instances belong to prelude, NULL if it wasn't used
+    struct ptcl_parser_result *prelude;
     bool is_critical;
 } ptcl_parser_result;
 
+// Prelude, which parser keeps between parses. Its top-level instances belong to root, until they are moved to parsed file
+typedef struct ptcl_parser_prelude
+{
+    ptcl_parser_result result;
+    ptcl_func_body *root;
+    // Seed of incremental cache of files
+    uint64_t hash;
+    unsigned int hidden_built_in_types;
+} ptcl_parser_prelude;
+
 typedef struct ptcl_parser_statement_info
 {
     ptcl_statement_type type;
@@ -594,8 +708,67 @@ static void ptcl_parser_comp_type_destroy(ptcl_parser_comp_type comp_type)
 
 ptcl_parser *ptcl_parser_create(ptcl_tokens_list *input, ptcl_lexer_configuration *configuration);
 
+// Top-level imports are replaced by tokens of modules, which are loaded by parser and live as long as it.
+// Imports, which input starts with, are parsed as prelude on top of prelude and kept, while next files start with
+// the same modules, so their declarations aren't parsed again. Result must be destroyed before next parse
 ptcl_parser_result ptcl_parser_parse(ptcl_parser *parser);
 
+// Parses input as prelude, which is kept by parser and placed before each next parsed file, so it is parsed once.
+// Returns result with errors if it fails, otherwise empty one. Tokens of input must live as long as prelude,
+// results of parses must be destroyed before it is replaced or parser is destroyed
+ptcl_parser_result ptcl_parser_parse_prelude(ptcl_parser *parser);
+
+// False if parser has no prelude. Prelude is owned by parser
+bool ptcl_parser_get_prelude(ptcl_parser *parser, ptcl_parser_prelude *prelude);
+
+// Replaces prelude by one, which isn't parsed, like loaded from snapshot. Its nodes and instances are only read
+// and must live until prelude is replaced or parser is destroyed. Results of parses must be destroyed before it
+bool ptcl_parser_set_prelude(ptcl_parser *parser, ptcl_parser_prelude prelude);
+
+// Prelude of leading imports is mapped from image next to file instead of parsing, if it has the same modules.
+// With saving, parsed one is written there, so next runs map it
+void ptcl_parser_set_imports_saved(ptcl_parser *parser, bool is_saved);
+
+// Modules, which last parse has imported. Paths live as long as parser
+size_t ptcl_parser_imported_count(ptcl_parser *parser);
+
+char *ptcl_parser_imported_path(ptcl_parser *parser, size_t index);
+
+// Next parse reads these tokens
+void ptcl_parser_set_input(ptcl_parser *parser, ptcl_tokens_list *input);
+
+// Destroys nodes and instances of result, which parser has made last. Its arrays and arena are kept for next parse,
+// interner too if keep_types is set, so it doesn't allocate them again
+void ptcl_parser_recycle(ptcl_parser *parser, ptcl_parser_result result, bool keep_types);
+
+// Cache is owned by caller. Plain bodies of top-level functions, which it contains, aren't parsed by next parse
+// and are marked as cached, so transpiler takes their code from it. NULL disables it
+void ptcl_parser_set_incremental(ptcl_parser *parser, ptcl_incremental *incremental);
+
+// Stats are owned by caller and filled by next parse, NULL disables them
+void ptcl_parser_set_stats(ptcl_parser *parser, ptcl_parser_stats *stats);
+
+ptcl_parser_stats *ptcl_parser_get_stats(ptcl_parser *parser);
+
+// Profile is owned by caller and refilled by next parse, NULL disables it
+void ptcl_parser_set_profile(ptcl_parser *parser, ptcl_parser_profile *profile);
+
+ptcl_parser_profile *ptcl_parser_get_profile(ptcl_parser *parser);
+
+// Returns NULL if index has no entry
+ptcl_parser_profile_entry *ptcl_parser_profile_at(ptcl_parser_profile *profile, size_t index);
+
+void ptcl_parser_profile_destroy(ptcl_parser_profile *profile);
+
+// Tracer is owned by caller, NULL disables it
+void ptcl_parser_set_trace(ptcl_parser *parser, ptcl_trace *trace);
+
+ptcl_trace *ptcl_parser_get_trace(ptcl_parser *parser);
+
+// Bodies of ordinary top-level functions which can't change compile time state are parsed
+// on this count of threads after the file. 1 parses serially, 0 uses all processors
+void ptcl_parser_set_jobs(ptcl_parser *parser, size_t jobs);
+
 bool ptcl_parser_parse_get_statement(ptcl_parser *parser, ptcl_parser_statement_info *info);
 
 ptcl_statement *ptcl_parser_parse_statement(ptcl_parser *parser);
@@ -645,21 +818,15 @@ void ptcl_parser_extra_body(ptcl_parser *parser, bool is_syntax);
 
 ptcl_type ptcl_parser_type(ptcl_parser *parser, bool with_word, bool with_any, bool with_static);
 
-ptcl_expression *ptcl_parser_cast(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
-
-ptcl_expression *ptcl_parser_binary(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
-
-ptcl_expression *ptcl_parser_additive(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
-
-ptcl_expression *ptcl_parser_multiplicative(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
+ptcl_expression *ptcl_parser_cast(ptcl_parser *parser, const ptcl_type *except, ptcl_parser_expression_flags flags);
 
-ptcl_expression *ptcl_parser_unary(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
+ptcl_expression *ptcl_parser_unary(ptcl_parser *parser, const ptcl_type *except, ptcl_parser_expression_flags flags);
 
-ptcl_expression *ptcl_parser_dot(ptcl_parser *parser, ptcl_type *except, ptcl_expression *left, ptcl_parser_expression_flags flags);
+ptcl_expression *ptcl_parser_dot(ptcl_parser *parser, const ptcl_type *except, ptcl_expression *left, ptcl_parser_expression_flags flags);
 
-ptcl_expression *ptcl_parser_array_element(ptcl_parser *parser, ptcl_type *except, ptcl_expression *left, ptcl_parser_expression_flags flags);
+ptcl_expression *ptcl_parser_array_element(ptcl_parser *parser, const ptcl_type *except, ptcl_expression *left, ptcl_parser_expression_flags flags);
 
-ptcl_expression *ptcl_parser_value(ptcl_parser *parser, ptcl_type *except, ptcl_parser_expression_flags flags);
+ptcl_expression *ptcl_parser_value(ptcl_parser *parser, const ptcl_type *except, ptcl_parser_expression_flags flags);
 
 ptcl_name ptcl_parser_name_word(ptcl_parser *parser);
 
@@ -769,6 +936,11 @@ bool ptcl_parser_try_get_variable(ptcl_parser *parser, ptcl_name name, ptcl_pars
 
 size_t ptcl_parser_add_lated_body(ptcl_parser *parser, size_t start, size_t tokens_count, bool is_free, ptcl_location location);
 
+ptcl_parser_checkpoint ptcl_parser_get_checkpoint(ptcl_parser *parser);
+
+// Releases errors and instances, which were added after checkpoint, and truncates their tables to it
+void ptcl_parser_rollback(ptcl_parser *parser, ptcl_parser_checkpoint checkpoint);
+
 bool ptcl_parser_is_syntax_defined(ptcl_parser *parser, ptcl_name name);
 
 bool ptcl_parser_is_comp_type_defined(ptcl_parser *parser, ptcl_name name, bool is_static);
@@ -783,7 +955,9 @@ bool ptcl_parser_is_defined(ptcl_parser *parser, ptcl_name name);
 
 bool ptcl_parser_check_arguments(ptcl_parser *parser, ptcl_parser_function *function, ptcl_expression **arguments, size_t count);
 
-bool ptcl_parser_syntax_try_find(ptcl_parser *parser, ptcl_parser_syntax_node *nodes, size_t count, ptcl_parser_syntax **syntax, bool *can_continue, char **end_token);
+// Candidates can be NULL, otherwise nodes before candidates->matched must be the same as in previous call
+bool ptcl_parser_syntax_try_find(ptcl_parser *parser, ptcl_parser_syntax_node *nodes, size_t count, ptcl_parser_syntax **syntax, bool *can_continue, char **end_token,
+                                 ptcl_parser_syntax_candidates *candidates);
 
 bool ptcl_parser_try_get_typedata_member(ptcl_parser *parser, ptcl_name name, char *member_name, ptcl_argument **member, size_t *index);
 
@@ -833,6 +1007,8 @@ void ptcl_parser_throw_unknown_variable_or_type(ptcl_parser *parser, char *name,
 
 void ptcl_parser_throw_unknown_type(ptcl_parser *parser, char *value, ptcl_location location);
 
+void ptcl_parser_throw_unknown_module(ptcl_parser *parser, char *path, ptcl_location location);
+
 void ptcl_parser_throw_redefination(ptcl_parser *parser, char *name, ptcl_location location);
 
 void ptcl_parser_throw_user(ptcl_parser *parser, char *message, ptcl_location location);
@@ -1,6 +1,8 @@
 #ifndef PTCL_PARSER_ERROR_H
 #define PTCL_PARSER_ERROR_H
 
+#include <ptcl_string.h>
+
 typedef enum ptcl_parser_error_type
 {
     ptcl_parser_error_out_of_memory_type,
@@ -24,33 +26,104 @@ typedef enum ptcl_parser_error_type
     ptcl_parser_error_unknown_variable_type,
     ptcl_parser_error_unknown_syntax_type,
     ptcl_parser_error_unknown_variable_or_type_type,
+    ptcl_parser_error_unknown_module_type,
     ptcl_parser_error_user_type
 } ptcl_parser_error_type;
 
+#define PTCL_PARSER_ERROR_MAX_OPERANDS 3
+
+// Error is stored as kind with operands, message is built only when it's requested
 typedef struct ptcl_parser_error
 {
     ptcl_parser_error_type type;
     bool is_critical;
+    char *operands[PTCL_PARSER_ERROR_MAX_OPERANDS];
     char *message;
-    bool is_free_message;
     ptcl_location location;
 } ptcl_parser_error;
 
-static ptcl_parser_error ptcl_parser_error_create(
-    ptcl_parser_error_type type, bool is_critical, char *message, bool is_free_message, ptcl_location location)
+static ptcl_parser_error ptcl_parser_error_create(ptcl_parser_error_type type, bool is_critical, ptcl_location location)
 {
     return (ptcl_parser_error){
         .type = type,
         .is_critical = is_critical,
-        .message = message,
-        .is_free_message = is_free_message,
+        .operands = {NULL},
+        .message = NULL,
         .location = location};
 }
 
-static void ptcl_parser_error_destroy(ptcl_parser_error error) {
-    if (error.is_free_message) {
-        free(error.message);
+static char *ptcl_parser_error_format(ptcl_parser_error *error)
+{
+    char **operands = error->operands;
+    switch (error->type)
+    {
+    case ptcl_parser_error_out_of_memory_type:
+        return ptcl_string_duplicate("Out of memory");
+    case ptcl_parser_error_not_allowed_token_type:
+        return ptcl_string("Token '", operands[0], "' not allowed", NULL);
+    case ptcl_parser_error_except_token_type:
+        return ptcl_string("Except token '", operands[0], "'", NULL);
+    case ptcl_parser_error_except_type_specifier_type:
+        return ptcl_string_duplicate("Expect type specifier");
+    case ptcl_parser_error_incorrect_type_type:
+        return ptcl_string("Except '", operands[0], "' type, but received '", operands[1], "'", NULL);
+    case ptcl_parser_error_variable_redefinition_type:
+        return ptcl_string("Redefination variable with '", operands[0], "'", NULL);
+    case ptcl_parser_error_redefinition_type:
+        return ptcl_string("Redefination '", operands[0], "'", NULL);
+    case ptcl_parser_error_none_type_type:
+        return ptcl_string_duplicate("Type must be specified to use 'none'");
+    case ptcl_parser_error_must_be_variable_type:
+        return ptcl_string_duplicate("Must be variable");
+    case ptcl_parser_error_must_be_static_type:
+        return ptcl_string_duplicate("Must be static");
+    case ptcl_parser_error_wrong_arguments_type:
+        return ptcl_string("Wrong arguments '", operands[0], "(", operands[1], ")', expected (", operands[2], ")", NULL);
+    case ptcl_parser_error_max_depth_type:
+        return ptcl_string_duplicate("Max syntaxes depth");
+    case ptcl_parser_error_unknown_member_type:
+        return ptcl_string("Unknown member with '", operands[0], "' name", NULL);
+    case ptcl_parser_error_unknown_statement_type:
+        return ptcl_string_duplicate("Unknown statement");
+    case ptcl_parser_error_unknown_expression_type:
+        return ptcl_string_duplicate("Unknown expression");
+    case ptcl_parser_error_unknown_function_type:
+        return ptcl_string("Unknown function '", operands[0], "'", NULL);
+    case ptcl_parser_error_unknown_variable_type:
+        return ptcl_string("Unknown variable with '", operands[0], "' name", NULL);
+    case ptcl_parser_error_unknown_syntax_type:
+        return ptcl_string("Unknown syntax: '", operands[0], "'", NULL);
+    case ptcl_parser_error_unknown_variable_or_type_type:
+        return ptcl_string("Unknown variable with '", operands[0], "' name or expected type", NULL);
+    case ptcl_parser_error_unknown_type_type:
+        return ptcl_string("Unknown type '", operands[0], "'", NULL);
+    case ptcl_parser_error_unknown_module_type:
+        return ptcl_string("Unknown module '", operands[0], "'", NULL);
+    case ptcl_parser_error_user_type:
+    default:
+        return ptcl_string_duplicate(operands[0]);
+    }
+}
+
+// Returns NULL only if there is no memory for message
+static char *ptcl_parser_error_get_message(ptcl_parser_error *error)
+{
+    if (error->message == NULL)
+    {
+        error->message = ptcl_parser_error_format(error);
     }
+
+    return error->message;
+}
+
+static void ptcl_parser_error_destroy(ptcl_parser_error error)
+{
+    for (size_t i = 0; i < PTCL_PARSER_ERROR_MAX_OPERANDS; i++)
+    {
+        free(error.operands[i]);
+    }
+
+    free(error.message);
 }
 
-#endif // PTCL_PARSER_ERROR_H
\ No newline at end of file
+#endif // PTCL_PARSER_ERROR_H
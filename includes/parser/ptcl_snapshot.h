@@ -0,0 +1,45 @@
+#ifndef PTCL_SNAPSHOT_H
+#define PTCL_SNAPSHOT_H
+
+#include <ptcl_parser.h>
+
+#define PTCL_SNAPSHOT_EXTENSION ".ptcls"
+#define PTCL_SNAPSHOT_PRELUDE_EXTENSION ".ptclp"
+// Prelude of leading imports of file, it is kept next to file
+#define PTCL_SNAPSHOT_IMPORTS_EXTENSION ".ptclm"
+// Must be increased when meaning of nodes changes, sizes and fields of nodes are checked by themselves
+#define PTCL_SNAPSHOT_VERSION 3
+#define PTCL_SNAPSHOT_ALIGNMENT 16
+
+// Parsed program, which is given to transpiler again without lexing and parsing. File is image of nodes, where
+// pointers are offsets in image and are listed after it. Loading maps file and adds its address to listed pointers,
+// so nodes are used in place. Strings are stored once by content, types and nodes, shared by pointers, once by address.
+// Image is made for nodes of this build, so snapshots of other builds are refused
+typedef struct ptcl_snapshot ptcl_snapshot;
+
+// Saves body and variables, which are read by transpiler. Returns false if result has errors,
+// if bodies of it are taken from incremental cache or if file can't be written
+bool ptcl_snapshot_save(ptcl_parser_result *result, char *path);
+
+// Saves prelude with its instances and tokens of its lated bodies, so parser can take it instead of parsing it.
+// Key is checked by loading, it must change with everything, prelude is parsed by. Returns false if prelude has errors,
+// bound functions, or if file can't be written
+bool ptcl_snapshot_save_prelude(ptcl_parser_prelude *prelude, uint64_t key, char *path);
+
+// NULL if file is missing, broken or made by other build. Checksum, pointers, their targets and tags of nodes
+// are checked before image is used
+ptcl_snapshot *ptcl_snapshot_load(char *path);
+
+// Same as loading of program, image of prelude is also refused by other key
+ptcl_snapshot *ptcl_snapshot_load_prelude(char *path, uint64_t key);
+
+// Nodes of result are owned by snapshot, result must not be destroyed or recycled.
+// Scopes and declarations, which were released after parsing, are replaced by one empty body
+ptcl_parser_result ptcl_snapshot_get_result(ptcl_snapshot *snapshot);
+
+// Prelude for parser, which is owned by snapshot. Snapshot must live until parser releases prelude
+ptcl_parser_prelude ptcl_snapshot_get_prelude(ptcl_snapshot *snapshot);
+
+void ptcl_snapshot_destroy(ptcl_snapshot *snapshot);
+
+#endif // PTCL_SNAPSHOT_H
@@ -0,0 +1,32 @@
+#ifndef PTCL_TYPE_INTERNER_H
+#define PTCL_TYPE_INTERNER_H
+
+#include <ptcl_node.h>
+
+#define PTCL_TYPE_INTERNER_DEFAULT_CAPACITY 64
+
+// Canonical nodes for targets of pointer, array and object types, so targets are shared instead of copied.
+// Holders still keep ptcl_type by value and compare types structurally, address of target is only a fast path
+typedef struct ptcl_type_interner ptcl_type_interner;
+
+ptcl_type_interner *ptcl_type_interner_create();
+
+// Interner of one thread: shared one and its shared ones are only read, new nodes are placed in local until adopting
+ptcl_type_interner *ptcl_type_interner_create_local(ptcl_type_interner *shared);
+
+// Returns canonical node for type. Takes ownership of type and its owned targets in any case.
+// Canonical nodes are marked as primitive, so holders never free them, and must not be changed
+ptcl_type *ptcl_type_interner_intern(ptcl_type_interner *interner, ptcl_type type);
+
+size_t ptcl_type_interner_count(ptcl_type_interner *interner);
+
+// Moves nodes of local interner into this one and releases local. Nodes stay at their addresses,
+// but one that equals already known node is only kept alive and not found by next interning
+bool ptcl_type_interner_adopt(ptcl_type_interner *interner, ptcl_type_interner *local);
+
+// Forgets all nodes, but keeps table and arena capacity for next program
+void ptcl_type_interner_clear(ptcl_type_interner *interner);
+
+void ptcl_type_interner_destroy(ptcl_type_interner *interner);
+
+#endif // PTCL_TYPE_INTERNER_H
@@ -0,0 +1,87 @@
+#ifndef PTCL_BATCH_H
+#define PTCL_BATCH_H
+
+#include <stdio.h>
+#include <ptcl_transpiler.h>
+#include <ptcl_string_buffer.h>
+#include <ptcl_output_cache.h>
+
+typedef struct ptcl_batch_file
+{
+    char *input;
+    // NULL keeps transpiled code in memory, so caller can print outputs in order
+    char *output;
+    ptcl_parser_stats *parser_stats;
+    ptcl_transpiler_stats *transpiler_stats;
+    ptcl_parser_profile *profile;
+    // Filled by compilation
+    char *transpiled;
+    char *diagnostics;
+    size_t source_bytes;
+    size_t output_bytes;
+    size_t worker;
+    uint64_t duration;
+    bool is_compiled;
+    // Output and diagnostics are taken from output cache
+    bool is_cached;
+} ptcl_batch_file;
+
+// Configuration is only read, so it is shared by all workers
+typedef struct ptcl_batch
+{
+    ptcl_lexer_configuration *configuration;
+    ptcl_batch_file *files;
+    size_t count;
+    size_t jobs;
+    // Threads for function bodies of each file, useful when there are less files than processors
+    size_t parser_jobs;
+    // Parsed once by each worker and placed before every file, NULL if there is none.
+    // Its image is mapped instead, if it is next to prelude and was saved with same configuration and source
+    char *prelude;
+    // Bodies of functions are cached next to each input, so unchanged ones aren't compiled again
+    bool is_incremental;
+    // Parsed programs are saved next to inputs, so they can be transpiled again without parsing. Prelude is saved too,
+    // and leading imports of each input, which are parsed as its prelude
+    bool with_snapshot;
+    // Directory of output cache, which can be shared by batches, NULL if there is none
+    char *cache;
+    size_t cache_limit;
+    bool with_trace;
+    // Filled by compilation, one trace buffer for each worker
+    ptcl_trace **traces;
+    size_t traces_count;
+    uint64_t duration;
+} ptcl_batch;
+
+static ptcl_batch_file ptcl_batch_file_create(char *input, char *output)
+{
+    return (ptcl_batch_file){
+        .input = input,
+        .output = output};
+}
+
+static ptcl_batch ptcl_batch_create(ptcl_lexer_configuration *configuration, ptcl_batch_file *files, size_t count, size_t jobs)
+{
+    return (ptcl_batch){
+        .configuration = configuration,
+        .files = files,
+        .count = count,
+        .jobs = jobs,
+        .parser_jobs = 1,
+        .cache_limit = PTCL_OUTPUT_CACHE_DEFAULT_LIMIT};
+}
+
+// Compiles files on jobs threads, 0 uses all processors. Inputs with snapshot extension are only transpiled.
+// Returns false if any file isn't compiled
+bool ptcl_batch_compile(ptcl_batch *batch);
+
+// Appends errors of result with lines of source they point to. Errors of imported modules have only positions
+void ptcl_batch_add_errors(ptcl_string_buffer *buffer, char *input, char *source, ptcl_parser_result *result);
+
+// Writes time and throughput of every file and of whole batch
+void ptcl_batch_write_summary(ptcl_batch *batch, FILE *output);
+
+// Releases transpiled code and diagnostics of files and traces of workers
+void ptcl_batch_destroy(ptcl_batch *batch);
+
+#endif // PTCL_BATCH_H
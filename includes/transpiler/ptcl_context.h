@@ -0,0 +1,44 @@
+#ifndef PTCL_CONTEXT_H
+#define PTCL_CONTEXT_H
+
+#include <ptcl_lexer.h>
+#include <ptcl_transpiler.h>
+
+// Lexer, parser and transpiler of one thread, which are reused for many programs.
+// Reset gives their buffers, arrays and arenas back instead of releasing, so steady compilation barely allocates
+typedef struct ptcl_context ptcl_context;
+
+ptcl_context *ptcl_context_create(ptcl_lexer_configuration *configuration);
+
+// Interner is kept by reset only if it is set, otherwise one huge program doesn't hold memory of its types. Set by default
+void ptcl_context_set_keep_types(ptcl_context *context, bool keep_types);
+
+// Stats, profile and trace are set on parts directly, they are kept by reset
+ptcl_lexer *ptcl_context_get_lexer(ptcl_context *context);
+
+ptcl_parser *ptcl_context_get_parser(ptcl_context *context);
+
+ptcl_transpiler *ptcl_context_get_transpiler(ptcl_context *context);
+
+// Resets context if it has program and parses source. Result is owned by context, source must live until reset
+ptcl_parser_result *ptcl_context_parse(ptcl_context *context, char *executor, char *source);
+
+// Parses source once, next programs start with its declarations. Result has errors if it fails, then there is no prelude.
+// Source must live until prelude is replaced or context is destroyed
+ptcl_parser_result *ptcl_context_parse_prelude(ptcl_context *context, char *executor, char *source);
+
+// Maps prelude from image instead of parsing it, next programs start with its declarations. False if image is missing,
+// broken or saved with other key, then previous prelude is kept
+bool ptcl_context_load_prelude(ptcl_context *context, char *path, uint64_t key);
+
+// Saves parsed or loaded prelude as image. False if there is no prelude or if it can't be saved
+bool ptcl_context_save_prelude(ptcl_context *context, char *path, uint64_t key);
+
+// Transpiles parsed program, code is owned by caller
+char *ptcl_context_transpile(ptcl_context *context);
+
+void ptcl_context_reset(ptcl_context *context);
+
+void ptcl_context_destroy(ptcl_context *context);
+
+#endif // PTCL_CONTEXT_H
@@ -0,0 +1,50 @@
+#ifndef PTCL_OUTPUT_CACHE_H
+#define PTCL_OUTPUT_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PTCL_OUTPUT_CACHE_EXTENSION ".ptclo"
+// Must be increased when compiler gives other code or diagnostics for same input, so older entries aren't used
+#define PTCL_OUTPUT_CACHE_VERSION 1
+#define PTCL_OUTPUT_CACHE_DEFAULT_LIMIT (256 * 1024 * 1024)
+
+// Transpiled code and diagnostics of inputs in directory, one file for each key. Key is hash of source, directory
+// of input, from which imports are resolved, and options of compilation. Entry keeps hashes of imported modules and
+// is used only while they are same. Entries are written atomically and only read after, so processes and threads
+// can share directory without locks. Cache itself is only read after creation, so it is shared by workers
+typedef struct ptcl_output_cache ptcl_output_cache;
+
+typedef struct ptcl_output_cache_key
+{
+    uint64_t first;
+    uint64_t second;
+} ptcl_output_cache_key;
+
+typedef struct ptcl_output_cache_entry
+{
+    bool is_compiled;
+    // Owned by caller, NULL if there is none
+    char *transpiled;
+    char *diagnostics;
+} ptcl_output_cache_entry;
+
+// Options are hash of everything else, which changes output, like keywords and prelude.
+// Directory is made if it is missing. Limit is size of all entries in bytes, NULL if directory can't be made
+ptcl_output_cache *ptcl_output_cache_create(char *directory, size_t limit, uint64_t options);
+
+ptcl_output_cache_key ptcl_output_cache_get_key(ptcl_output_cache *cache, char *input, char *source, size_t size);
+
+// Returns true if entry exists and its modules are unchanged, then it becomes the most recently used
+bool ptcl_output_cache_find(ptcl_output_cache *cache, ptcl_output_cache_key key, ptcl_output_cache_entry *entry);
+
+// Modules are paths of imported files, they are hashed now, so entry is used only while they are same
+bool ptcl_output_cache_store(ptcl_output_cache *cache, ptcl_output_cache_key key, ptcl_output_cache_entry entry, char **modules, size_t count);
+
+// Removes least recently used entries, while their size is over limit
+void ptcl_output_cache_trim(ptcl_output_cache *cache);
+
+void ptcl_output_cache_destroy(ptcl_output_cache *cache);
+
+#endif // PTCL_OUTPUT_CACHE_H
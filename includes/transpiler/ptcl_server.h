@@ -0,0 +1,47 @@
+#ifndef PTCL_SERVER_H
+#define PTCL_SERVER_H
+
+#include <stdint.h>
+#include <ptcl_lexer_configuration.h>
+
+#define PTCL_SERVER_DEFAULT_PATH "ptcl.sock"
+#define PTCL_SERVER_LATENCIES_CAPACITY 4096
+// Larger requests are refused, so one client can't take all memory
+#define PTCL_SERVER_MAX_REQUEST (64 * 1024 * 1024)
+// Milliseconds, which client may be silent while sending request or not reading answer, then connection is closed
+#define PTCL_SERVER_TIMEOUT 10000
+
+// Compiles requests of local clients over Unix socket. Each worker keeps its context with built-ins, prelude,
+// imported modules and interned types between requests, so small compile costs no startup.
+// Client sends request and shuts down writing, server answers and closes connection:
+//   compile <name>\n<source>  - compiles source, name is used for imports and diagnostics
+//   file <path>\n             - compiles file
+//   stats\n                   - latencies of requests as JSON
+//   stop\n                    - stops server after current requests
+// Answer starts with "ok\n" and C code or JSON, or with "error\n" and diagnostics
+typedef struct ptcl_server ptcl_server;
+
+// Nanoseconds over last PTCL_SERVER_LATENCIES_CAPACITY requests, from accepting connection until answer is sent
+typedef struct ptcl_server_latencies
+{
+    size_t requests_count;
+    size_t failures_count;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t max;
+} ptcl_server_latencies;
+
+// Socket is bound and listened here, so clients can connect once it returns. Stale socket file is replaced, other files at path aren't removed.
+// Prelude can be NULL, it is read once and parsed by every worker. Jobs 0 uses all processors. NULL if socket can't be made
+ptcl_server *ptcl_server_create(ptcl_lexer_configuration *configuration, char *path, char *prelude, size_t jobs);
+
+// Serves requests on worker threads until stop request. Returns false if no worker could be started
+bool ptcl_server_run(ptcl_server *server);
+
+ptcl_server_latencies ptcl_server_get_latencies(ptcl_server *server);
+
+// Closes socket and removes its file
+void ptcl_server_destroy(ptcl_server *server);
+
+#endif // PTCL_SERVER_H
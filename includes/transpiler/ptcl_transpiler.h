@@ -1,14 +1,25 @@
 #ifndef PTCL_TRANSPILER_H
 #define PTCL_TRANSPILER_H
 
+#include <limits.h>
 #include <ptcl_parser.h>
 
 #define PTCL_TRANSPILER_SIZE_T_MAX_DIGITS (sizeof(size_t) * CHAR_BIT * 302 / 1000 + 1)
 #define PTCL_TRANSPILER_ANONYMOUS_PREFIX "__ptcl_t_anonymous_"
 #define PTCL_TRANSPILER_TEMP_PREFIX "__ptcl_t_temp_"
+#define PTCL_TRANSPILER_DEFAULT_CAPACITY 16
 
 typedef struct ptcl_transpiler ptcl_transpiler;
 
+typedef struct ptcl_transpiler_stats
+{
+    size_t statements_count;
+    size_t expressions_count;
+    size_t temp_variables_count;
+    size_t anonymous_count;
+    size_t output_bytes;
+} ptcl_transpiler_stats;
+
 typedef struct ptcl_transpiler_variable
 {
     ptcl_name name;
@@ -100,8 +111,23 @@ static ptcl_transpiler_function ptcl_transpiler_function_create(ptcl_name name,
 
 ptcl_transpiler *ptcl_transpiler_create(ptcl_parser_result result);
 
+// Starts transpiling of other result, capacity of arrays and output buffer is kept
+void ptcl_transpiler_reset(ptcl_transpiler *transpiler, ptcl_parser_result result);
+
 char *ptcl_transpiler_transpile(ptcl_transpiler *transpiler);
 
+// Stats are owned by caller and filled by next transpile, NULL disables them
+void ptcl_transpiler_set_stats(ptcl_transpiler *transpiler, ptcl_transpiler_stats *stats);
+
+// Adds emitted bytes to profile entries of syntaxes and inlined functions, NULL disables it
+void ptcl_transpiler_set_profile(ptcl_transpiler *transpiler, ptcl_parser_profile *profile);
+
+// Tracer is owned by caller, NULL disables it
+void ptcl_transpiler_set_trace(ptcl_transpiler *transpiler, ptcl_trace *trace);
+
+// Code of cached bodies is taken from it, code of other fingerprinted bodies is stored to it. NULL disables it
+void ptcl_transpiler_set_incremental(ptcl_transpiler *transpiler, ptcl_incremental *incremental);
+
 bool ptcl_transpiler_append_word_s(ptcl_transpiler *transpiler, char *word);
 
 bool ptcl_transpiler_append_word(ptcl_transpiler *transpiler, char *word);
@@ -0,0 +1,47 @@
+#ifndef PTCL_ARENA_H
+#define PTCL_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PTCL_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct ptcl_arena ptcl_arena;
+
+typedef struct ptcl_arena_stats
+{
+    size_t chunks_count;
+    size_t allocations_count;
+    size_t used;
+    size_t reserved;
+} ptcl_arena_stats;
+
+typedef struct ptcl_arena_checkpoint
+{
+    void *chunk;
+    size_t chunk_used;
+    size_t generation;
+    ptcl_arena_stats stats;
+} ptcl_arena_checkpoint;
+
+ptcl_arena *ptcl_arena_create(size_t chunk_size);
+
+void *ptcl_arena_allocate(ptcl_arena *arena, size_t size);
+
+ptcl_arena_checkpoint ptcl_arena_get_checkpoint(ptcl_arena *arena);
+
+// Releases own allocations made after checkpoint, chunks adopted after it are kept.
+// Their chunks are kept for next allocations. Checkpoint taken before clear does nothing
+void ptcl_arena_rollback(ptcl_arena *arena, ptcl_arena_checkpoint checkpoint);
+
+ptcl_arena_stats ptcl_arena_get_stats(ptcl_arena *arena);
+
+// Takes chunks of other arena, so its allocations live as long as this one. Other arena is released
+void ptcl_arena_adopt(ptcl_arena *arena, ptcl_arena *other);
+
+// Releases all allocations, but keeps chunks for next ones
+void ptcl_arena_clear(ptcl_arena *arena);
+
+void ptcl_arena_destroy(ptcl_arena *arena);
+
+#endif // PTCL_ARENA_H
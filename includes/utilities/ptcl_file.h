@@ -0,0 +1,40 @@
+#ifndef PTCL_FILE_H
+#define PTCL_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reads whole file and ends it with zero, NULL if it can't be read. Size can be NULL
+char *ptcl_file_read(char *path, size_t *size);
+
+// Data is written to temporary file, which is renamed over target only after it's complete,
+// so concurrent readers see either old or new file
+bool ptcl_file_write_atomic(char *path, void *data, size_t size);
+
+// Maps whole file privately, so it can be changed in memory without changing file. Where mapping isn't supported,
+// file is just read. NULL if it can't be mapped or it is empty
+char *ptcl_file_map(char *path, size_t *size);
+
+void ptcl_file_unmap(char *data, size_t size);
+
+typedef struct ptcl_file_info
+{
+    char *path;
+    uint64_t size;
+    // Last modification in seconds
+    int64_t time;
+} ptcl_file_info;
+
+// Files of directory, whose names end with extension. NULL if directory can't be read or it has no such files
+ptcl_file_info *ptcl_file_list(char *directory, char *extension, size_t *count);
+
+void ptcl_file_list_destroy(ptcl_file_info *files, size_t count);
+
+// Sets time of last modification to now
+bool ptcl_file_touch(char *path);
+
+// Returns true if directory exists after it
+bool ptcl_file_make_directory(char *path);
+
+#endif // PTCL_FILE_H
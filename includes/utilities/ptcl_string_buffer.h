@@ -2,6 +2,9 @@
 #define PTCL_STRING_BUFFER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+
+#define PTCL_STRING_BUFFER_DEFAULT_CAPACITY 64
 
 typedef struct ptcl_string_buffer ptcl_string_buffer;
 
@@ -21,6 +24,9 @@ char *ptcl_string_buffer_copy_and_clear(ptcl_string_buffer *string_buffer);
 
 size_t ptcl_string_buffer_length(ptcl_string_buffer *string_buffer);
 
+// Content without copying, it is valid until buffer is changed
+char *ptcl_string_buffer_get_data(ptcl_string_buffer *string_buffer);
+
 bool ptcl_string_buffer_is_empty(ptcl_string_buffer *string_buffer);
 
 void ptcl_string_buffer_reset_position(ptcl_string_buffer *string_buffer);
@@ -29,6 +35,7 @@ size_t ptcl_string_buffer_get_position(ptcl_string_buffer *string_buffer);
 
 void ptcl_string_buffer_set_position(ptcl_string_buffer *string_buffer, size_t position);
 
+// Empties buffer, capacity is kept
 void ptcl_string_buffer_clear(ptcl_string_buffer *string_buffer);
 
 void ptcl_string_buffer_destroy(ptcl_string_buffer *string_buffer);
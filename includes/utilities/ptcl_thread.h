@@ -0,0 +1,29 @@
+#ifndef PTCL_THREAD_H
+#define PTCL_THREAD_H
+
+#include <stddef.h>
+
+typedef struct ptcl_thread ptcl_thread;
+
+typedef void (*ptcl_thread_routine)(void *argument);
+
+// Returns NULL if thread can't be started, so caller can run routine by itself
+ptcl_thread *ptcl_thread_create(ptcl_thread_routine routine, void *argument);
+
+// Waits for routine to return and releases thread
+void ptcl_thread_join(ptcl_thread *thread);
+
+// Count of logical processors, at least one
+size_t ptcl_thread_hardware_count();
+
+typedef struct ptcl_mutex ptcl_mutex;
+
+ptcl_mutex *ptcl_mutex_create();
+
+void ptcl_mutex_lock(ptcl_mutex *mutex);
+
+void ptcl_mutex_unlock(ptcl_mutex *mutex);
+
+void ptcl_mutex_destroy(ptcl_mutex *mutex);
+
+#endif // PTCL_THREAD_H
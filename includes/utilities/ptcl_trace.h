@@ -0,0 +1,41 @@
+#ifndef PTCL_TRACE_H
+#define PTCL_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PTCL_TRACE_DEFAULT_CAPACITY 256
+
+// Takes start timestamp only when tracing is requested, so disabled tracer costs one branch
+#define PTCL_TRACE_START(trace) ((trace) != NULL ? ptcl_trace_timestamp() : 0)
+
+#define PTCL_TRACE_ADD(trace, category, name, suffix, start)                \
+    do                                                                      \
+    {                                                                       \
+        if ((trace) != NULL)                                                \
+        {                                                                   \
+            ptcl_trace_add((trace), (category), (name), (suffix), (start)); \
+        }                                                                   \
+    } while (0)
+
+// Event buffer of one thread. It is never shared, so recording needs no locks
+typedef struct ptcl_trace ptcl_trace;
+
+ptcl_trace *ptcl_trace_create(size_t thread_id);
+
+// Monotonic time in nanoseconds
+uint64_t ptcl_trace_timestamp();
+
+// Records complete event from start until now. Name and suffix are copied, suffix may be NULL
+bool ptcl_trace_add(ptcl_trace *trace, const char *category, const char *name, const char *suffix, uint64_t start);
+
+size_t ptcl_trace_count(ptcl_trace *trace);
+
+// Writes events of all buffers in chrome://tracing (Perfetto) JSON format
+bool ptcl_trace_write(ptcl_trace **traces, size_t count, FILE *output);
+
+void ptcl_trace_destroy(ptcl_trace *trace);
+
+#endif // PTCL_TRACE_H
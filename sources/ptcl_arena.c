@@ -0,0 +1,220 @@
+#include <stdlib.h>
+#include <ptcl_arena.h>
+
+#define PTCL_ARENA_ALIGNMENT (sizeof(void *) * 2)
+
+typedef struct ptcl_arena_chunk
+{
+    struct ptcl_arena_chunk *previous;
+    size_t capacity;
+    size_t used;
+} ptcl_arena_chunk;
+
+typedef struct ptcl_arena
+{
+    ptcl_arena_chunk *current;
+    // Chunks released by clear, they are taken before allocating new ones
+    ptcl_arena_chunk *spare;
+    // Chunks of adopted arenas, they aren't allocated from and aren't released by rollback
+    ptcl_arena_chunk *adopted;
+    size_t chunk_size;
+    // Incremented by clear, checkpoints taken before it are stale
+    size_t generation;
+    // Own allocations, checkpoints keep and restore only them
+    ptcl_arena_stats stats;
+    ptcl_arena_stats adopted_stats;
+} ptcl_arena;
+
+static inline size_t ptcl_arena_align(size_t size)
+{
+    return (size + PTCL_ARENA_ALIGNMENT - 1) & ~(PTCL_ARENA_ALIGNMENT - 1);
+}
+
+static inline char *ptcl_arena_chunk_data(ptcl_arena_chunk *chunk)
+{
+    return (char *)chunk + ptcl_arena_align(sizeof(ptcl_arena_chunk));
+}
+
+static ptcl_arena_chunk *ptcl_arena_take_spare(ptcl_arena *arena, size_t size)
+{
+    for (ptcl_arena_chunk **link = &arena->spare; *link != NULL; link = &(*link)->previous)
+    {
+        ptcl_arena_chunk *chunk = *link;
+        if (chunk->capacity < size)
+        {
+            continue;
+        }
+
+        *link = chunk->previous;
+        return chunk;
+    }
+
+    return NULL;
+}
+
+static ptcl_arena_chunk *ptcl_arena_add_chunk(ptcl_arena *arena, size_t size)
+{
+    size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+    ptcl_arena_chunk *chunk = ptcl_arena_take_spare(arena, capacity);
+    if (chunk != NULL)
+    {
+        capacity = chunk->capacity;
+    }
+    else
+    {
+        chunk = malloc(ptcl_arena_align(sizeof(ptcl_arena_chunk)) + capacity);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    chunk->previous = arena->current;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    arena->current = chunk;
+    arena->stats.chunks_count++;
+    arena->stats.reserved += capacity;
+    return chunk;
+}
+
+ptcl_arena *ptcl_arena_create(size_t chunk_size)
+{
+    ptcl_arena *arena = malloc(sizeof(ptcl_arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->current = NULL;
+    arena->spare = NULL;
+    arena->adopted = NULL;
+    arena->chunk_size = chunk_size == 0 ? PTCL_ARENA_DEFAULT_CHUNK_SIZE : chunk_size;
+    arena->generation = 0;
+    arena->stats = (ptcl_arena_stats){0};
+    arena->adopted_stats = (ptcl_arena_stats){0};
+    return arena;
+}
+
+void *ptcl_arena_allocate(ptcl_arena *arena, size_t size)
+{
+    size = ptcl_arena_align(size == 0 ? 1 : size);
+    ptcl_arena_chunk *chunk = arena->current;
+    if (chunk == NULL || chunk->capacity - chunk->used < size)
+    {
+        chunk = ptcl_arena_add_chunk(arena, size);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    void *result = ptcl_arena_chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+    arena->stats.allocations_count++;
+    arena->stats.used += size;
+    return result;
+}
+
+ptcl_arena_checkpoint ptcl_arena_get_checkpoint(ptcl_arena *arena)
+{
+    return (ptcl_arena_checkpoint){
+        .chunk = arena->current,
+        .chunk_used = arena->current == NULL ? 0 : arena->current->used,
+        .generation = arena->generation,
+        .stats = arena->stats};
+}
+
+void ptcl_arena_rollback(ptcl_arena *arena, ptcl_arena_checkpoint checkpoint)
+{
+    // Clear has already released everything of stale checkpoint, its chunk may even be reused
+    if (checkpoint.generation != arena->generation)
+    {
+        return;
+    }
+
+    // Chunks are linked from newest to oldest, so everything above checkpoint chunk was added after it
+    while (arena->current != checkpoint.chunk && arena->current != NULL)
+    {
+        ptcl_arena_chunk *chunk = arena->current;
+        arena->current = chunk->previous;
+        chunk->previous = arena->spare;
+        arena->spare = chunk;
+    }
+
+    if (arena->current != NULL)
+    {
+        arena->current->used = checkpoint.chunk_used;
+    }
+
+    arena->stats = checkpoint.stats;
+}
+
+ptcl_arena_stats ptcl_arena_get_stats(ptcl_arena *arena)
+{
+    return (ptcl_arena_stats){
+        .chunks_count = arena->stats.chunks_count + arena->adopted_stats.chunks_count,
+        .allocations_count = arena->stats.allocations_count + arena->adopted_stats.allocations_count,
+        .used = arena->stats.used + arena->adopted_stats.used,
+        .reserved = arena->stats.reserved + arena->adopted_stats.reserved};
+}
+
+static void ptcl_arena_push_chunks(ptcl_arena_chunk **list, ptcl_arena_chunk *chunks)
+{
+    while (chunks != NULL)
+    {
+        ptcl_arena_chunk *previous = chunks->previous;
+        chunks->previous = *list;
+        *list = chunks;
+        chunks = previous;
+    }
+}
+
+void ptcl_arena_adopt(ptcl_arena *arena, ptcl_arena *other)
+{
+    if (other == NULL)
+    {
+        return;
+    }
+
+    // Adopted chunks are kept apart, so allocations continue in current chunk and rollback can't release them
+    const ptcl_arena_stats stats = ptcl_arena_get_stats(other);
+    arena->adopted_stats.chunks_count += stats.chunks_count;
+    arena->adopted_stats.allocations_count += stats.allocations_count;
+    arena->adopted_stats.used += stats.used;
+    arena->adopted_stats.reserved += stats.reserved;
+    ptcl_arena_push_chunks(&arena->adopted, other->current);
+    ptcl_arena_push_chunks(&arena->adopted, other->adopted);
+    ptcl_arena_push_chunks(&arena->spare, other->spare);
+    free(other);
+}
+
+void ptcl_arena_clear(ptcl_arena *arena)
+{
+    ptcl_arena_push_chunks(&arena->spare, arena->current);
+    ptcl_arena_push_chunks(&arena->spare, arena->adopted);
+    arena->current = NULL;
+    arena->adopted = NULL;
+    arena->generation++;
+    arena->stats = (ptcl_arena_stats){0};
+    arena->adopted_stats = (ptcl_arena_stats){0};
+}
+
+void ptcl_arena_destroy(ptcl_arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    ptcl_arena_clear(arena);
+    ptcl_arena_chunk *chunk = arena->spare;
+    while (chunk != NULL)
+    {
+        ptcl_arena_chunk *previous = chunk->previous;
+        free(chunk);
+        chunk = previous;
+    }
+
+    free(arena);
+}
@@ -0,0 +1,730 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_batch.h>
+#include <ptcl_context.h>
+#include <ptcl_module.h>
+#include <ptcl_snapshot.h>
+#include <ptcl_thread.h>
+#include <ptcl_string_buffer.h>
+
+typedef struct ptcl_batch_worker
+{
+    ptcl_batch *batch;
+    size_t id;
+    size_t *order;
+    size_t *assigned;
+    // Reused by all files of worker
+    ptcl_context *context;
+    char *source;
+    size_t capacity;
+    // Source of prelude is read once and shared by workers
+    char *prelude;
+    // Errors of prelude, they are given to every file of worker
+    char *prelude_diagnostics;
+    // Imported by prelude, outputs depend on them like on modules of file. Paths are owned by parser
+    char **prelude_modules;
+    size_t prelude_modules_count;
+    // Options of batch, image of prelude is refused if they have changed
+    uint64_t prelude_key;
+    // Shared by workers, NULL if there is none
+    ptcl_output_cache *cache;
+    ptcl_string_buffer *diagnostics;
+    bool is_compiled;
+} ptcl_batch_worker;
+
+static bool ptcl_batch_append_format(ptcl_string_buffer *buffer, const char *format, size_t first, size_t second)
+{
+    char line[64];
+    const int length = snprintf(line, sizeof(line), format, first, second);
+    return length >= 0 && ptcl_string_buffer_append_str(buffer, line, (size_t)length);
+}
+
+static void ptcl_batch_fail(ptcl_batch_worker *worker, ptcl_batch_file *file, char *message)
+{
+    ptcl_string_buffer_append_str(worker->diagnostics, message, strlen(message));
+    ptcl_string_buffer_append(worker->diagnostics, '\n');
+    file->diagnostics = ptcl_string_buffer_copy_and_clear(worker->diagnostics);
+}
+
+// Returns message if file isn't read
+static char *ptcl_batch_load(char *path, char **source, size_t *capacity, size_t *size)
+{
+    FILE *target = fopen(path, "rb");
+    if (target == NULL)
+    {
+        return "Failed to open file";
+    }
+
+    fseek(target, 0, SEEK_END);
+    const long length = ftell(target);
+    if (length < 0)
+    {
+        fclose(target);
+        return "Failed to get file size";
+    }
+
+    if ((size_t)length + 1 > *capacity)
+    {
+        char *buffer = realloc(*source, (size_t)length + 1);
+        if (buffer == NULL)
+        {
+            fclose(target);
+            return "Memory allocation failed";
+        }
+
+        *source = buffer;
+        *capacity = (size_t)length + 1;
+    }
+
+    fseek(target, 0, SEEK_SET);
+    const size_t bytes_read = fread(*source, 1, (size_t)length, target);
+    (*source)[bytes_read] = '\0';
+    *size = bytes_read;
+    fclose(target);
+    return NULL;
+}
+
+static bool ptcl_batch_read(ptcl_batch_worker *worker, ptcl_batch_file *file)
+{
+    char *message = ptcl_batch_load(file->input, &worker->source, &worker->capacity, &file->source_bytes);
+    if (message != NULL)
+    {
+        ptcl_batch_fail(worker, file, message);
+        return false;
+    }
+
+    return true;
+}
+
+void ptcl_batch_add_errors(ptcl_string_buffer *buffer, char *input, char *source, ptcl_parser_result *result)
+{
+    for (size_t i = 0; i < result->errors_count; i++)
+    {
+        const size_t error_position = result->errors[i].location.position;
+        char *executor = result->errors[i].location.executor;
+        if (executor != NULL && executor != input && strcmp(executor, input) != 0)
+        {
+            // Source of imported module isn't read, so only its position is shown
+            ptcl_string_buffer_append_str(buffer, "Error in ", 9);
+            ptcl_string_buffer_append_str(buffer, executor, strlen(executor));
+            ptcl_batch_append_format(buffer, " at position %zu:\n", error_position, 0);
+            goto message;
+        }
+
+        size_t line_start = 0;
+        size_t line_end = 0;
+        size_t line_number = 1;
+        for (size_t j = 0; j < error_position; j++)
+        {
+            if (source[j] == '\n')
+            {
+                line_number++;
+                line_start = j + 1;
+            }
+        }
+
+        line_end = error_position;
+        while (source[line_end] != '\0' && source[line_end] != '\n')
+        {
+            line_end++;
+        }
+
+        ptcl_batch_append_format(buffer, "Error at line %zu, position %zu:\n  ", line_number, error_position - line_start);
+        ptcl_string_buffer_append_str(buffer, source + line_start, line_end - line_start);
+        ptcl_string_buffer_append_str(buffer, "\n  ", 3);
+        for (size_t j = line_start; j < error_position; j++)
+        {
+            ptcl_string_buffer_append(buffer, ' ');
+        }
+
+        ptcl_string_buffer_append_str(buffer, "^\n", 2);
+    message:
+        ptcl_string_buffer_append_str(buffer, "Message: ", 9);
+        char *message = ptcl_parser_error_get_message(&result->errors[i]);
+        message = message != NULL ? message : "Out of memory";
+        ptcl_string_buffer_append_str(buffer, message, strlen(message));
+        ptcl_string_buffer_append_str(buffer, "\n\n", 2);
+    }
+}
+
+static bool ptcl_batch_write(ptcl_batch_file *file, char *transpiled)
+{
+    FILE *output = fopen(file->output, "wb");
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    fputs(transpiled, output);
+    const bool is_written = ferror(output) == 0;
+    return fclose(output) == 0 && is_written;
+}
+
+// Takes transpiled code, which is kept by file or written to its output
+static void ptcl_batch_output(ptcl_batch_worker *worker, ptcl_batch_file *file, char *transpiled)
+{
+    file->output_bytes = strlen(transpiled);
+    if (file->output == NULL)
+    {
+        file->transpiled = transpiled;
+        file->is_compiled = true;
+    }
+    else
+    {
+        file->is_compiled = ptcl_batch_write(file, transpiled);
+        free(transpiled);
+        if (!file->is_compiled)
+        {
+            ptcl_batch_fail(worker, file, "Failed to write output");
+        }
+    }
+}
+
+static bool ptcl_batch_reuse(ptcl_batch_worker *worker, ptcl_batch_file *file, ptcl_output_cache_key key)
+{
+    ptcl_output_cache_entry entry;
+    if (!ptcl_output_cache_find(worker->cache, key, &entry))
+    {
+        return false;
+    }
+
+    file->is_cached = true;
+    file->diagnostics = entry.diagnostics;
+    if (entry.is_compiled && entry.transpiled != NULL)
+    {
+        ptcl_batch_output(worker, file, entry.transpiled);
+    }
+    else
+    {
+        free(entry.transpiled);
+    }
+
+    return true;
+}
+
+// Only results of source are stored, failures of memory or output are not
+static void ptcl_batch_store(ptcl_batch_worker *worker, ptcl_output_cache_key key, ptcl_output_cache_entry entry)
+{
+    ptcl_parser *parser = ptcl_context_get_parser(worker->context);
+    const size_t imported_count = ptcl_parser_imported_count(parser);
+    const size_t count = worker->prelude_modules_count + imported_count;
+    char **modules = malloc((count == 0 ? 1 : count) * sizeof(char *));
+    if (modules == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < worker->prelude_modules_count; i++)
+    {
+        modules[i] = worker->prelude_modules[i];
+    }
+
+    for (size_t i = 0; i < imported_count; i++)
+    {
+        modules[worker->prelude_modules_count + i] = ptcl_parser_imported_path(parser, i);
+    }
+
+    ptcl_output_cache_store(worker->cache, key, entry, modules, count);
+    free(modules);
+}
+
+static bool ptcl_batch_is_snapshot(char *input)
+{
+    const size_t length = strlen(input);
+    const size_t extension = strlen(PTCL_SNAPSHOT_EXTENSION);
+    return length > extension && strcmp(input + length - extension, PTCL_SNAPSHOT_EXTENSION) == 0;
+}
+
+// script.ptcl -> script.ptcls
+static char *ptcl_batch_snapshot_path(char *input, char *snapshot_extension)
+{
+    const size_t length = strlen(input);
+    const size_t extension = strlen(PTCL_MODULE_EXTENSION);
+    return length > extension && strcmp(input + length - extension, PTCL_MODULE_EXTENSION) == 0
+               ? ptcl_string(input, snapshot_extension + extension, NULL)
+               : ptcl_string(input, snapshot_extension, NULL);
+}
+
+static bool ptcl_batch_save_snapshot(char *input, ptcl_parser_result *result)
+{
+    char *path = ptcl_batch_snapshot_path(input, PTCL_SNAPSHOT_EXTENSION);
+    const bool is_saved = path != NULL && ptcl_snapshot_save(result, path);
+    free(path);
+    return is_saved;
+}
+
+// Snapshot already has prelude and imported modules of its program, so it is only transpiled
+static void ptcl_batch_compile_snapshot(ptcl_batch_worker *worker, ptcl_batch_file *file, ptcl_trace *trace)
+{
+    ptcl_snapshot *snapshot = ptcl_snapshot_load(file->input);
+    if (snapshot == NULL)
+    {
+        ptcl_batch_fail(worker, file, "Failed to load snapshot");
+        return;
+    }
+
+    ptcl_transpiler *transpiler = ptcl_context_get_transpiler(worker->context);
+    ptcl_transpiler_set_stats(transpiler, file->transpiler_stats);
+    // Costs of expansions are known only while parsing
+    ptcl_transpiler_set_profile(transpiler, NULL);
+    ptcl_transpiler_set_trace(transpiler, trace);
+    ptcl_transpiler_reset(transpiler, ptcl_snapshot_get_result(snapshot));
+    char *transpiled = ptcl_transpiler_transpile(transpiler);
+    ptcl_transpiler_reset(transpiler, (ptcl_parser_result){0});
+    ptcl_snapshot_destroy(snapshot);
+    if (transpiled == NULL)
+    {
+        ptcl_batch_fail(worker, file, "Memory allocation failed");
+        return;
+    }
+
+    ptcl_batch_output(worker, file, transpiled);
+}
+
+static void ptcl_batch_compile_file(ptcl_batch_worker *worker, ptcl_batch_file *file)
+{
+    ptcl_batch *batch = worker->batch;
+    ptcl_trace *trace = batch->traces_count > worker->id ? batch->traces[worker->id] : NULL;
+    const uint64_t start = ptcl_trace_timestamp();
+    file->worker = worker->id;
+    if (ptcl_batch_is_snapshot(file->input))
+    {
+        ptcl_batch_compile_snapshot(worker, file, trace);
+        file->duration = ptcl_trace_timestamp() - start;
+        return;
+    }
+
+    if (worker->prelude_diagnostics != NULL)
+    {
+        char *diagnostics = worker->prelude_diagnostics;
+        ptcl_string_buffer_append_str(worker->diagnostics, diagnostics, strlen(diagnostics));
+        file->diagnostics = ptcl_string_buffer_copy_and_clear(worker->diagnostics);
+        file->duration = ptcl_trace_timestamp() - start;
+        return;
+    }
+
+    if (!ptcl_batch_read(worker, file))
+    {
+        file->duration = ptcl_trace_timestamp() - start;
+        return;
+    }
+
+    ptcl_output_cache_key key = {0};
+    if (worker->cache != NULL)
+    {
+        key = ptcl_output_cache_get_key(worker->cache, file->input, worker->source, file->source_bytes);
+        // Snapshot is made only by parsing
+        if (!batch->with_snapshot && ptcl_batch_reuse(worker, file, key))
+        {
+            file->duration = ptcl_trace_timestamp() - start;
+            return;
+        }
+    }
+
+    ptcl_context *context = worker->context;
+    ptcl_parser *parser = ptcl_context_get_parser(context);
+    ptcl_transpiler *transpiler = ptcl_context_get_transpiler(context);
+    ptcl_lexer_set_trace(ptcl_context_get_lexer(context), trace);
+    ptcl_parser_set_stats(parser, file->parser_stats);
+    ptcl_parser_set_profile(parser, file->profile);
+    ptcl_parser_set_trace(parser, trace);
+    ptcl_parser_set_jobs(parser, batch->parser_jobs);
+    ptcl_parser_set_imports_saved(parser, batch->with_snapshot);
+    ptcl_transpiler_set_stats(transpiler, file->transpiler_stats);
+    ptcl_transpiler_set_profile(transpiler, file->profile);
+    ptcl_transpiler_set_trace(transpiler, trace);
+    // Cache can't be made without memory, then file is just compiled completely.
+    // Snapshot needs every body parsed, so it doesn't use cached ones
+    ptcl_incremental *incremental = batch->is_incremental && !batch->with_snapshot ? ptcl_incremental_create(file->input) : NULL;
+    ptcl_parser_set_incremental(parser, incremental);
+    ptcl_transpiler_set_incremental(transpiler, incremental);
+
+    ptcl_parser_result *result = ptcl_context_parse(context, file->input, worker->source);
+    if (result->errors_count != 0)
+    {
+        ptcl_batch_add_errors(worker->diagnostics, file->input, worker->source, result);
+        file->diagnostics = ptcl_string_buffer_copy_and_clear(worker->diagnostics);
+        if (worker->cache != NULL && file->diagnostics != NULL)
+        {
+            ptcl_batch_store(worker, key, (ptcl_output_cache_entry){.diagnostics = file->diagnostics});
+        }
+
+        goto cleanup;
+    }
+
+    if (batch->with_snapshot && !ptcl_batch_save_snapshot(file->input, result))
+    {
+        ptcl_batch_fail(worker, file, "Failed to write snapshot");
+        goto cleanup;
+    }
+
+    char *transpiled = ptcl_context_transpile(context);
+    if (transpiled == NULL)
+    {
+        ptcl_batch_fail(worker, file, "Memory allocation failed");
+        goto cleanup;
+    }
+
+    if (worker->cache != NULL)
+    {
+        ptcl_batch_store(worker, key, (ptcl_output_cache_entry){.is_compiled = true, .transpiled = transpiled});
+    }
+
+    ptcl_batch_output(worker, file, transpiled);
+
+    if (incremental != NULL)
+    {
+        ptcl_incremental_save(incremental);
+    }
+
+cleanup:
+    ptcl_context_reset(context);
+    ptcl_parser_set_incremental(parser, NULL);
+    ptcl_transpiler_set_incremental(transpiler, NULL);
+    ptcl_incremental_destroy(incremental);
+    file->duration = ptcl_trace_timestamp() - start;
+}
+
+// Prelude is parsed by thread of worker, so its instances are made by the same parser that uses them
+static void ptcl_batch_parse_prelude(ptcl_batch_worker *worker)
+{
+    ptcl_batch *batch = worker->batch;
+    if (batch->prelude == NULL)
+    {
+        return;
+    }
+
+    if (worker->prelude == NULL)
+    {
+        ptcl_string_buffer_append_str(worker->diagnostics, "Failed to read prelude\n", 23);
+        worker->prelude_diagnostics = ptcl_string_buffer_copy_and_clear(worker->diagnostics);
+        return;
+    }
+
+    // Image of prelude is mapped instead of parsing, key has configuration and source of prelude
+    char *image = ptcl_batch_snapshot_path(batch->prelude, PTCL_SNAPSHOT_PRELUDE_EXTENSION);
+    if (image != NULL && ptcl_context_load_prelude(worker->context, image, worker->prelude_key))
+    {
+        free(image);
+        return;
+    }
+
+    ptcl_parser_result *result = ptcl_context_parse_prelude(worker->context, batch->prelude, worker->prelude);
+    if (result->errors_count != 0)
+    {
+        ptcl_string_buffer_append_str(worker->diagnostics, "Failed to parse prelude\n", 24);
+        ptcl_batch_add_errors(worker->diagnostics, batch->prelude, worker->prelude, result);
+        worker->prelude_diagnostics = ptcl_string_buffer_copy_and_clear(worker->diagnostics);
+    }
+
+    ptcl_parser *parser = ptcl_context_get_parser(worker->context);
+    const size_t count = ptcl_parser_imported_count(parser);
+    worker->prelude_modules = count > 0 ? malloc(count * sizeof(char *)) : NULL;
+    if (worker->prelude_modules == NULL && count > 0)
+    {
+        // Outputs can't be checked against modules of prelude
+        worker->cache = NULL;
+    }
+
+    for (size_t i = 0; worker->prelude_modules != NULL && i < count; i++)
+    {
+        worker->prelude_modules[worker->prelude_modules_count++] = ptcl_parser_imported_path(parser, i);
+    }
+
+    ptcl_context_reset(worker->context);
+    // Modules of prelude aren't saved, so prelude with imports is always parsed. Image only spares parsing
+    // of next runs, so prelude, which can't be saved, is still used
+    if (batch->with_snapshot && worker->id == 0 && worker->prelude_diagnostics == NULL && count == 0 && image != NULL)
+    {
+        ptcl_context_save_prelude(worker->context, image, worker->prelude_key);
+    }
+
+    free(image);
+}
+
+static void ptcl_batch_worker_run(void *argument)
+{
+    ptcl_batch_worker *worker = argument;
+    ptcl_batch *batch = worker->batch;
+    ptcl_batch_parse_prelude(worker);
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        const size_t index = worker->order[i];
+        if (worker->assigned[index] != worker->id)
+        {
+            continue;
+        }
+
+        ptcl_batch_file *file = &batch->files[index];
+        ptcl_batch_compile_file(worker, file);
+        worker->is_compiled &= file->is_compiled;
+    }
+}
+
+static long ptcl_batch_file_size(char *path)
+{
+    FILE *target = fopen(path, "rb");
+    if (target == NULL)
+    {
+        return 0;
+    }
+
+    fseek(target, 0, SEEK_END);
+    const long size = ftell(target);
+    fclose(target);
+    return size;
+}
+
+// Largest files are given first to the least loaded worker, so workers finish at about the same time without locks
+static void ptcl_batch_schedule(ptcl_batch *batch, size_t jobs, size_t *order, size_t *assigned, size_t *loads)
+{
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        const long size = ptcl_batch_file_size(batch->files[i].input);
+        batch->files[i].source_bytes = size > 0 ? (size_t)size : 0;
+        order[i] = i;
+    }
+
+    // Insertion sort keeps equal files in input order
+    for (size_t i = 1; i < batch->count; i++)
+    {
+        const size_t index = order[i];
+        size_t j = i;
+        while (j > 0 && batch->files[order[j - 1]].source_bytes < batch->files[index].source_bytes)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+
+        order[j] = index;
+    }
+
+    for (size_t i = 0; i < jobs; i++)
+    {
+        loads[i] = 0;
+    }
+
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        size_t target = 0;
+        for (size_t j = 1; j < jobs; j++)
+        {
+            if (loads[j] < loads[target])
+            {
+                target = j;
+            }
+        }
+
+        assigned[order[i]] = target;
+        // Empty files still cost their setup
+        loads[target] += batch->files[order[i]].source_bytes + 1;
+    }
+}
+
+// Everything besides source, which changes output. Prelude, which can't be read, fails every file, so it isn't stored
+static uint64_t ptcl_batch_options(ptcl_batch *batch, char *prelude, size_t size)
+{
+    uint64_t hash = ptcl_lexer_configuration_hash(batch->configuration);
+    const unsigned char with_prelude = batch->prelude != NULL;
+    hash = (hash ^ with_prelude) * 0x100000001b3ULL;
+    for (size_t i = 0; prelude != NULL && i < size; i++)
+    {
+        hash = (hash ^ (unsigned char)prelude[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+bool ptcl_batch_compile(ptcl_batch *batch)
+{
+    const uint64_t start = ptcl_trace_timestamp();
+    if (batch->count == 0)
+    {
+        batch->duration = 0;
+        return true;
+    }
+
+    size_t jobs = batch->jobs == 0 ? ptcl_thread_hardware_count() : batch->jobs;
+    jobs = jobs < batch->count ? jobs : batch->count;
+    batch->parser_jobs = batch->parser_jobs == 0 ? 1 : batch->parser_jobs;
+
+    size_t *order = malloc(batch->count * 2 * sizeof(size_t) + jobs * sizeof(size_t));
+    ptcl_batch_worker *workers = malloc(jobs * sizeof(ptcl_batch_worker));
+    ptcl_thread **threads = malloc(jobs * sizeof(ptcl_thread *));
+    bool is_compiled = order != NULL && workers != NULL && threads != NULL;
+    if (!is_compiled)
+    {
+        goto cleanup;
+    }
+
+    if (batch->with_trace)
+    {
+        batch->traces = calloc(jobs, sizeof(ptcl_trace *));
+        for (size_t i = 0; batch->traces != NULL && i < jobs; i++)
+        {
+            batch->traces[i] = ptcl_trace_create(i + 1);
+            batch->traces_count += batch->traces[i] != NULL;
+        }
+    }
+
+    char *prelude = NULL;
+    size_t prelude_capacity = 0;
+    size_t prelude_size = 0;
+    if (batch->prelude != NULL && ptcl_batch_load(batch->prelude, &prelude, &prelude_capacity, &prelude_size) != NULL)
+    {
+        free(prelude);
+        prelude = NULL;
+    }
+
+    // Unusable cache directory only disables cache
+    const uint64_t options = ptcl_batch_options(batch, prelude, prelude_size);
+    ptcl_output_cache *cache = batch->cache != NULL ? ptcl_output_cache_create(batch->cache, batch->cache_limit, options) : NULL;
+    size_t *assigned = order + batch->count;
+    ptcl_batch_schedule(batch, jobs, order, assigned, assigned + batch->count);
+    for (size_t i = 0; i < jobs; i++)
+    {
+        workers[i] = (ptcl_batch_worker){
+            .batch = batch,
+            .id = i,
+            .order = order,
+            .assigned = assigned,
+            .context = ptcl_context_create(batch->configuration),
+            .source = NULL,
+            .capacity = 0,
+            .prelude = prelude,
+            .prelude_diagnostics = NULL,
+            .prelude_modules = NULL,
+            .prelude_modules_count = 0,
+            .prelude_key = options,
+            .cache = cache,
+            .diagnostics = ptcl_string_buffer_create(),
+            .is_compiled = true};
+        if (workers[i].context == NULL || workers[i].diagnostics == NULL)
+        {
+            ptcl_context_destroy(workers[i].context);
+            if (workers[i].diagnostics != NULL)
+            {
+                ptcl_string_buffer_destroy(workers[i].diagnostics);
+            }
+
+            jobs = i;
+            break;
+        }
+    }
+
+    if (jobs == 0)
+    {
+        free(prelude);
+        ptcl_output_cache_destroy(cache);
+        is_compiled = false;
+        goto cleanup;
+    }
+
+    // Files of workers which weren't created are given to the first one
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        if (assigned[i] >= jobs)
+        {
+            assigned[i] = 0;
+        }
+    }
+
+    for (size_t i = 1; i < jobs; i++)
+    {
+        threads[i] = ptcl_thread_create(ptcl_batch_worker_run, &workers[i]);
+    }
+
+    ptcl_batch_worker_run(&workers[0]);
+    for (size_t i = 1; i < jobs; i++)
+    {
+        if (threads[i] == NULL)
+        {
+            ptcl_batch_worker_run(&workers[i]);
+            continue;
+        }
+
+        ptcl_thread_join(threads[i]);
+    }
+
+    for (size_t i = 0; i < jobs; i++)
+    {
+        is_compiled &= workers[i].is_compiled;
+        free(workers[i].source);
+        free(workers[i].prelude_diagnostics);
+        free(workers[i].prelude_modules);
+        ptcl_context_destroy(workers[i].context);
+        ptcl_string_buffer_destroy(workers[i].diagnostics);
+    }
+
+    // Contexts keep tokens of prelude, not its source
+    free(prelude);
+    if (cache != NULL)
+    {
+        ptcl_output_cache_trim(cache);
+        ptcl_output_cache_destroy(cache);
+    }
+
+cleanup:
+    free(order);
+    free(workers);
+    free(threads);
+    batch->duration = ptcl_trace_timestamp() - start;
+    return is_compiled;
+}
+
+static double ptcl_batch_throughput(size_t bytes, uint64_t duration)
+{
+    return duration == 0 ? 0 : (double)bytes * 1000.0 / (double)duration;
+}
+
+void ptcl_batch_write_summary(ptcl_batch *batch, FILE *output)
+{
+    size_t source_bytes = 0;
+    size_t failed_count = 0;
+    uint64_t busy = 0;
+    fprintf(output, "%-32s %8s %12s %12s %12s %8s\n", "file", "worker", "bytes", "time_ms", "MB/s", "status");
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        ptcl_batch_file *file = &batch->files[i];
+        source_bytes += file->source_bytes;
+        failed_count += !file->is_compiled;
+        busy += file->duration;
+        fprintf(output, "%-32s %8zu %12zu %12.3f %12.2f %8s\n",
+                file->input,
+                file->worker,
+                file->source_bytes,
+                (double)file->duration / 1000000.0,
+                ptcl_batch_throughput(file->source_bytes, file->duration),
+                file->is_compiled ? (file->is_cached ? "cached" : "ok") : "failed");
+    }
+
+    const double seconds = (double)batch->duration / 1000000000.0;
+    fprintf(output, "%zu files, %zu failed, %zu bytes in %.3f ms (%.3f ms busy), %.2f MB/s, %.2f files/s\n",
+            batch->count,
+            failed_count,
+            source_bytes,
+            (double)batch->duration / 1000000.0,
+            (double)busy / 1000000.0,
+            ptcl_batch_throughput(source_bytes, batch->duration),
+            seconds == 0 ? 0 : (double)batch->count / seconds);
+}
+
+void ptcl_batch_destroy(ptcl_batch *batch)
+{
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        free(batch->files[i].transpiled);
+        free(batch->files[i].diagnostics);
+        batch->files[i].transpiled = NULL;
+        batch->files[i].diagnostics = NULL;
+    }
+
+    for (size_t i = 0; i < batch->traces_count; i++)
+    {
+        ptcl_trace_destroy(batch->traces[i]);
+    }
+
+    free(batch->traces);
+    batch->traces = NULL;
+    batch->traces_count = 0;
+}
@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <ptcl_context.h>
+#include <ptcl_snapshot.h>
+
+typedef struct ptcl_context
+{
+    ptcl_lexer *lexer;
+    ptcl_parser *parser;
+    ptcl_transpiler *transpiler;
+    ptcl_tokens_list tokens_list;
+    // Tokens of prelude are kept, because its syntaxes are expanded from them
+    ptcl_tokens_list prelude_tokens;
+    // Image, which prelude is mapped from instead of tokens. Parser reads it, so it is released after parser
+    ptcl_snapshot *prelude_snapshot;
+    ptcl_parser_result result;
+    bool has_result;
+    bool keep_types;
+} ptcl_context;
+
+ptcl_context *ptcl_context_create(ptcl_lexer_configuration *configuration)
+{
+    ptcl_context *context = malloc(sizeof(ptcl_context));
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    context->tokens_list = (ptcl_tokens_list){0};
+    context->prelude_tokens = (ptcl_tokens_list){0};
+    context->prelude_snapshot = NULL;
+    context->result = (ptcl_parser_result){0};
+    context->has_result = false;
+    context->keep_types = true;
+    context->lexer = ptcl_lexer_create("", "", configuration);
+    context->parser = ptcl_parser_create(&context->tokens_list, configuration);
+    context->transpiler = ptcl_transpiler_create(context->result);
+    if (context->lexer == NULL || context->parser == NULL || context->transpiler == NULL)
+    {
+        ptcl_context_destroy(context);
+        return NULL;
+    }
+
+    return context;
+}
+
+void ptcl_context_set_keep_types(ptcl_context *context, bool keep_types)
+{
+    context->keep_types = keep_types;
+}
+
+ptcl_lexer *ptcl_context_get_lexer(ptcl_context *context)
+{
+    return context->lexer;
+}
+
+ptcl_parser *ptcl_context_get_parser(ptcl_context *context)
+{
+    return context->parser;
+}
+
+ptcl_transpiler *ptcl_context_get_transpiler(ptcl_context *context)
+{
+    return context->transpiler;
+}
+
+ptcl_parser_result *ptcl_context_parse(ptcl_context *context, char *executor, char *source)
+{
+    ptcl_context_reset(context);
+    ptcl_lexer_set_source(context->lexer, executor, source);
+    context->tokens_list = ptcl_lexer_tokenize(context->lexer);
+    context->result = ptcl_parser_parse(context->parser);
+    context->has_result = true;
+    return &context->result;
+}
+
+ptcl_parser_result *ptcl_context_parse_prelude(ptcl_context *context, char *executor, char *source)
+{
+    ptcl_context_reset(context);
+    ptcl_lexer_set_source(context->lexer, executor, source);
+    context->tokens_list = ptcl_lexer_tokenize(context->lexer);
+    context->result = ptcl_parser_parse_prelude(context->parser);
+    context->has_result = true;
+
+    // Previous prelude is already released by parser
+    ptcl_lexer_recycle(context->lexer, context->prelude_tokens);
+    ptcl_snapshot_destroy(context->prelude_snapshot);
+    context->prelude_tokens = (ptcl_tokens_list){0};
+    context->prelude_snapshot = NULL;
+    if (context->result.errors_count == 0)
+    {
+        context->prelude_tokens = context->tokens_list;
+        context->tokens_list = (ptcl_tokens_list){0};
+    }
+
+    return &context->result;
+}
+
+bool ptcl_context_load_prelude(ptcl_context *context, char *path, uint64_t key)
+{
+    ptcl_snapshot *snapshot = ptcl_snapshot_load_prelude(path, key);
+    if (snapshot == NULL)
+    {
+        return false;
+    }
+
+    ptcl_context_reset(context);
+    const bool is_set = ptcl_parser_set_prelude(context->parser, ptcl_snapshot_get_prelude(snapshot));
+
+    // Previous prelude is already released by parser
+    ptcl_lexer_recycle(context->lexer, context->prelude_tokens);
+    ptcl_snapshot_destroy(context->prelude_snapshot);
+    context->prelude_tokens = (ptcl_tokens_list){0};
+    context->prelude_snapshot = is_set ? snapshot : NULL;
+    if (!is_set)
+    {
+        ptcl_snapshot_destroy(snapshot);
+    }
+
+    return is_set;
+}
+
+bool ptcl_context_save_prelude(ptcl_context *context, char *path, uint64_t key)
+{
+    ptcl_parser_prelude prelude;
+    return ptcl_parser_get_prelude(context->parser, &prelude) && ptcl_snapshot_save_prelude(&prelude, key, path);
+}
+
+char *ptcl_context_transpile(ptcl_context *context)
+{
+    ptcl_transpiler_reset(context->transpiler, context->result);
+    return ptcl_transpiler_transpile(context->transpiler);
+}
+
+void ptcl_context_reset(ptcl_context *context)
+{
+    if (!context->has_result)
+    {
+        return;
+    }
+
+    // Nodes can refer to values of tokens, so tokens are released after them
+    ptcl_parser_recycle(context->parser, context->result, context->keep_types);
+    ptcl_lexer_recycle(context->lexer, context->tokens_list);
+    context->result = (ptcl_parser_result){0};
+    context->tokens_list = (ptcl_tokens_list){0};
+    context->has_result = false;
+}
+
+void ptcl_context_destroy(ptcl_context *context)
+{
+    if (context == NULL)
+    {
+        return;
+    }
+
+    ptcl_context_reset(context);
+    if (context->transpiler != NULL)
+    {
+        ptcl_transpiler_destroy(context->transpiler);
+    }
+
+    if (context->parser != NULL)
+    {
+        ptcl_parser_destroy(context->parser);
+    }
+
+    ptcl_snapshot_destroy(context->prelude_snapshot);
+
+    if (context->lexer != NULL)
+    {
+        ptcl_lexer_recycle(context->lexer, context->prelude_tokens);
+        ptcl_lexer_destroy(context->lexer);
+    }
+
+    free(context);
+}
@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ptcl_file.h>
+#include <ptcl_string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <utime.h>
+#endif
+
+char *ptcl_file_read(char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = length >= 0 ? malloc((size_t)length + 1) : NULL;
+    if (data != NULL)
+    {
+        const size_t bytes_read = fread(data, 1, (size_t)length, file);
+        data[bytes_read] = '\0';
+        if (size != NULL)
+        {
+            *size = bytes_read;
+        }
+    }
+
+    fclose(file);
+    return data;
+}
+
+bool ptcl_file_write_atomic(char *path, void *data, size_t size)
+{
+    char suffix[64];
+#ifdef _WIN32
+    snprintf(suffix, sizeof(suffix), ".%lu.%p.tmp", (unsigned long)GetCurrentProcessId(), data);
+#else
+    snprintf(suffix, sizeof(suffix), ".%ld.%p.tmp", (long)getpid(), data);
+#endif
+    char *temporary = ptcl_string(path, suffix, NULL);
+    if (temporary == NULL)
+    {
+        return false;
+    }
+
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL)
+    {
+        free(temporary);
+        return false;
+    }
+
+    bool is_written = fwrite(data, 1, size, file) == size;
+    is_written = fclose(file) == 0 && is_written;
+#ifdef _WIN32
+    is_written = is_written && MoveFileExA(temporary, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    is_written = is_written && rename(temporary, path) == 0;
+#endif
+    if (!is_written)
+    {
+        remove(temporary);
+    }
+
+    free(temporary);
+    return is_written;
+}
+
+char *ptcl_file_map(char *path, size_t *size)
+{
+#ifdef _WIN32
+    char *data = ptcl_file_read(path, size);
+    if (data != NULL && *size == 0)
+    {
+        free(data);
+        return NULL;
+    }
+
+    return data;
+#else
+    const int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0)
+    {
+        return NULL;
+    }
+
+    struct stat info;
+    char *data = NULL;
+    if (fstat(descriptor, &info) == 0 && info.st_size > 0)
+    {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+        data = data != MAP_FAILED ? data : NULL;
+        *size = (size_t)info.st_size;
+    }
+
+    // Mapping is kept after descriptor is closed
+    close(descriptor);
+    return data;
+#endif
+}
+
+void ptcl_file_unmap(char *data, size_t size)
+{
+    if (data == NULL)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+static bool ptcl_file_has_extension(const char *name, const char *extension)
+{
+    const size_t length = strlen(name);
+    const size_t extension_length = strlen(extension);
+    return length > extension_length && strcmp(name + length - extension_length, extension) == 0;
+}
+
+static bool ptcl_file_add_info(ptcl_file_info **files, size_t *count, size_t *capacity, char *directory, const char *name)
+{
+    if (*count >= *capacity)
+    {
+        const size_t new_capacity = *capacity == 0 ? 16 : *capacity * 2;
+        ptcl_file_info *buffer = realloc(*files, new_capacity * sizeof(ptcl_file_info));
+        if (buffer == NULL)
+        {
+            return false;
+        }
+
+        *files = buffer;
+        *capacity = new_capacity;
+    }
+
+    char *path = ptcl_string(directory, "/", name, NULL);
+    struct stat info;
+    if (path == NULL || stat(path, &info) != 0)
+    {
+        // File can be removed by other process while directory is read
+        free(path);
+        return path != NULL;
+    }
+
+    (*files)[(*count)++] = (ptcl_file_info){
+        .path = path,
+        .size = (uint64_t)info.st_size,
+        .time = (int64_t)info.st_mtime};
+    return true;
+}
+
+ptcl_file_info *ptcl_file_list(char *directory, char *extension, size_t *count)
+{
+    ptcl_file_info *files = NULL;
+    size_t capacity = 0;
+    bool is_listed = true;
+    *count = 0;
+#ifdef _WIN32
+    char *pattern = ptcl_string(directory, "/*", extension, NULL);
+    if (pattern == NULL)
+    {
+        return NULL;
+    }
+
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA(pattern, &data);
+    free(pattern);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+
+    do
+    {
+        if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && ptcl_file_has_extension(data.cFileName, extension))
+        {
+            is_listed = ptcl_file_add_info(&files, count, &capacity, directory, data.cFileName);
+        }
+    } while (is_listed && FindNextFileA(handle, &data));
+
+    FindClose(handle);
+#else
+    DIR *target = opendir(directory);
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    struct dirent *entry;
+    while (is_listed && (entry = readdir(target)) != NULL)
+    {
+        if (ptcl_file_has_extension(entry->d_name, extension))
+        {
+            is_listed = ptcl_file_add_info(&files, count, &capacity, directory, entry->d_name);
+        }
+    }
+
+    closedir(target);
+#endif
+    if (!is_listed)
+    {
+        ptcl_file_list_destroy(files, *count);
+        *count = 0;
+        return NULL;
+    }
+
+    return files;
+}
+
+void ptcl_file_list_destroy(ptcl_file_info *files, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        free(files[i].path);
+    }
+
+    free(files);
+}
+
+bool ptcl_file_touch(char *path)
+{
+#ifdef _WIN32
+    return _utime(path, NULL) == 0;
+#else
+    return utime(path, NULL) == 0;
+#endif
+}
+
+bool ptcl_file_make_directory(char *path)
+{
+#ifdef _WIN32
+    _mkdir(path);
+#else
+    mkdir(path, 0777);
+#endif
+    struct stat info;
+    return stat(path, &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
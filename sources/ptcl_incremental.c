@@ -0,0 +1,496 @@
+#include <string.h>
+#include <ptcl_incremental.h>
+#include <ptcl_module.h>
+#include <ptcl_file.h>
+#include <ptcl_string.h>
+
+#define PTCL_INCREMENTAL_MAGIC 0x43435450u
+
+// Cache is header, then records of bodies, then their codes, each ends with zero
+typedef struct ptcl_incremental_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+    uint64_t code_size;
+} ptcl_incremental_header;
+
+typedef struct ptcl_incremental_record
+{
+    uint64_t fingerprint;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t with_stdlib;
+    uint32_t reserved;
+} ptcl_incremental_record;
+
+typedef struct ptcl_incremental_body
+{
+    uint64_t fingerprint;
+    // Points to loaded cache, or is owned if body is stored by this compilation
+    char *code;
+    size_t length;
+    bool with_stdlib;
+    bool is_owned;
+    bool is_used;
+} ptcl_incremental_body;
+
+typedef struct ptcl_incremental_declaration
+{
+    char *name;
+    uint64_t hash;
+} ptcl_incremental_declaration;
+
+typedef struct ptcl_incremental
+{
+    char *path;
+    char *image;
+    ptcl_incremental_body *bodies;
+    size_t count;
+    size_t capacity;
+    // Index of body plus one by fingerprint
+    size_t *slots;
+    size_t slots_capacity;
+    // Names are values of tokens, so they live as long as parsed input
+    ptcl_incremental_declaration *declarations;
+    size_t declarations_count;
+    size_t declarations_capacity;
+    uint64_t common;
+    bool is_changed;
+} ptcl_incremental;
+
+static uint64_t ptcl_incremental_hash(uint64_t hash, const void *value, size_t length)
+{
+    const unsigned char *bytes = value;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static uint64_t ptcl_incremental_hash_token(uint64_t hash, ptcl_token token)
+{
+    const uint32_t type = token.type;
+    char *value = token.value != NULL ? token.value : "";
+    hash = ptcl_incremental_hash(hash, &type, sizeof(type));
+    return ptcl_incremental_hash(hash, value, strlen(value) + 1);
+}
+
+uint64_t ptcl_incremental_hash_tokens(ptcl_token *tokens, size_t count)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        hash = ptcl_incremental_hash_token(hash, tokens[i]);
+    }
+
+    return hash;
+}
+
+static bool ptcl_incremental_index(ptcl_incremental *incremental, size_t capacity)
+{
+    size_t *slots = calloc(capacity, sizeof(size_t));
+    if (slots == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < incremental->count; i++)
+    {
+        size_t index = incremental->bodies[i].fingerprint & (capacity - 1);
+        while (slots[index] != 0)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        slots[index] = i + 1;
+    }
+
+    free(incremental->slots);
+    incremental->slots = slots;
+    incremental->slots_capacity = capacity;
+    return true;
+}
+
+static ptcl_incremental_body *ptcl_incremental_get(ptcl_incremental *incremental, uint64_t fingerprint)
+{
+    size_t index = fingerprint & (incremental->slots_capacity - 1);
+    while (incremental->slots[index] != 0)
+    {
+        ptcl_incremental_body *body = &incremental->bodies[incremental->slots[index] - 1];
+        if (body->fingerprint == fingerprint)
+        {
+            return body;
+        }
+
+        index = (index + 1) & (incremental->slots_capacity - 1);
+    }
+
+    return NULL;
+}
+
+static bool ptcl_incremental_add(ptcl_incremental *incremental, ptcl_incremental_body body)
+{
+    if (incremental->count >= incremental->capacity)
+    {
+        const size_t capacity = incremental->capacity == 0 ? PTCL_INCREMENTAL_DEFAULT_CAPACITY : incremental->capacity * 2;
+        ptcl_incremental_body *buffer = realloc(incremental->bodies, capacity * sizeof(ptcl_incremental_body));
+        if (buffer == NULL)
+        {
+            return false;
+        }
+
+        incremental->bodies = buffer;
+        incremental->capacity = capacity;
+    }
+
+    if ((incremental->count + 1) * 4 > incremental->slots_capacity * 3 &&
+        !ptcl_incremental_index(incremental, incremental->slots_capacity * 2))
+    {
+        return false;
+    }
+
+    size_t index = body.fingerprint & (incremental->slots_capacity - 1);
+    while (incremental->slots[index] != 0)
+    {
+        index = (index + 1) & (incremental->slots_capacity - 1);
+    }
+
+    incremental->bodies[incremental->count++] = body;
+    incremental->slots[index] = incremental->count;
+    return true;
+}
+
+// Image is checked completely, broken cache is just ignored
+static void ptcl_incremental_load(ptcl_incremental *incremental)
+{
+    size_t size;
+    char *image = ptcl_file_read(incremental->path, &size);
+    if (image == NULL)
+    {
+        return;
+    }
+
+    ptcl_incremental_header header;
+    if (size < sizeof(header))
+    {
+        free(image);
+        return;
+    }
+
+    memcpy(&header, image, sizeof(header));
+    const size_t available = size - sizeof(header);
+    if (header.magic != PTCL_INCREMENTAL_MAGIC || header.version != PTCL_INCREMENTAL_VERSION ||
+        header.count > available / sizeof(ptcl_incremental_record) ||
+        header.code_size != available - header.count * sizeof(ptcl_incremental_record))
+    {
+        free(image);
+        return;
+    }
+
+    incremental->image = image;
+    char *codes = image + sizeof(header) + header.count * sizeof(ptcl_incremental_record);
+    for (size_t i = 0; i < header.count; i++)
+    {
+        ptcl_incremental_record record;
+        memcpy(&record, image + sizeof(header) + i * sizeof(record), sizeof(record));
+        if ((uint64_t)record.offset + record.length >= header.code_size || codes[record.offset + record.length] != '\0' ||
+            ptcl_incremental_get(incremental, record.fingerprint) != NULL)
+        {
+            continue;
+        }
+
+        const ptcl_incremental_body body = {
+            .fingerprint = record.fingerprint,
+            .code = codes + record.offset,
+            .length = record.length,
+            .with_stdlib = record.with_stdlib != 0};
+        if (!ptcl_incremental_add(incremental, body))
+        {
+            return;
+        }
+    }
+}
+
+ptcl_incremental *ptcl_incremental_create(char *input)
+{
+    ptcl_incremental *incremental = malloc(sizeof(ptcl_incremental));
+    if (incremental == NULL)
+    {
+        return NULL;
+    }
+
+    *incremental = (ptcl_incremental){0};
+    const size_t length = strlen(input);
+    const size_t extension = strlen(PTCL_MODULE_EXTENSION);
+    // script.ptcl -> script.ptclc
+    incremental->path = length > extension && strcmp(input + length - extension, PTCL_MODULE_EXTENSION) == 0
+                            ? ptcl_string(input, PTCL_INCREMENTAL_EXTENSION + extension, NULL)
+                            : ptcl_string(input, PTCL_INCREMENTAL_EXTENSION, NULL);
+    if (incremental->path == NULL || !ptcl_incremental_index(incremental, PTCL_INCREMENTAL_DEFAULT_CAPACITY))
+    {
+        ptcl_incremental_destroy(incremental);
+        return NULL;
+    }
+
+    ptcl_incremental_load(incremental);
+    return incremental;
+}
+
+void ptcl_incremental_begin(ptcl_incremental *incremental, uint64_t seed)
+{
+    incremental->declarations_count = 0;
+    for (size_t i = 0; i < incremental->declarations_capacity; i++)
+    {
+        incremental->declarations[i] = (ptcl_incremental_declaration){0};
+    }
+
+    incremental->common = ptcl_incremental_hash(0xcbf29ce484222325ULL, &seed, sizeof(seed));
+}
+
+static ptcl_incremental_declaration *ptcl_incremental_find_declaration(ptcl_incremental *incremental, char *name)
+{
+    if (incremental->declarations_capacity == 0)
+    {
+        return NULL;
+    }
+
+    size_t index = ptcl_incremental_hash(0xcbf29ce484222325ULL, name, strlen(name)) & (incremental->declarations_capacity - 1);
+    while (incremental->declarations[index].name != NULL)
+    {
+        if (strcmp(incremental->declarations[index].name, name) == 0)
+        {
+            return &incremental->declarations[index];
+        }
+
+        index = (index + 1) & (incremental->declarations_capacity - 1);
+    }
+
+    // Empty slot, where name is added
+    return &incremental->declarations[index];
+}
+
+static bool ptcl_incremental_grow_declarations(ptcl_incremental *incremental)
+{
+    ptcl_incremental_declaration *previous = incremental->declarations;
+    const size_t previous_capacity = incremental->declarations_capacity;
+    const size_t capacity = previous_capacity == 0 ? PTCL_INCREMENTAL_DEFAULT_CAPACITY : previous_capacity * 2;
+    incremental->declarations = calloc(capacity, sizeof(ptcl_incremental_declaration));
+    if (incremental->declarations == NULL)
+    {
+        incremental->declarations = previous;
+        return false;
+    }
+
+    incremental->declarations_capacity = capacity;
+    for (size_t i = 0; i < previous_capacity; i++)
+    {
+        if (previous[i].name != NULL)
+        {
+            *ptcl_incremental_find_declaration(incremental, previous[i].name) = previous[i];
+        }
+    }
+
+    free(previous);
+    return true;
+}
+
+// Words are hashed with declarations they name, so dependent bodies change with them
+static uint64_t ptcl_incremental_hash_dependent(ptcl_incremental *incremental, ptcl_token *tokens, size_t count)
+{
+    uint64_t hash = incremental->common;
+    for (size_t i = 0; i < count; i++)
+    {
+        hash = ptcl_incremental_hash_token(hash, tokens[i]);
+        if (tokens[i].type != ptcl_token_word_type || tokens[i].value == NULL)
+        {
+            continue;
+        }
+
+        ptcl_incremental_declaration *declaration = ptcl_incremental_find_declaration(incremental, tokens[i].value);
+        if (declaration != NULL && declaration->name != NULL)
+        {
+            hash = ptcl_incremental_hash(hash, &declaration->hash, sizeof(declaration->hash));
+        }
+    }
+
+    return hash;
+}
+
+void ptcl_incremental_declare(ptcl_incremental *incremental, char *name, ptcl_token *tokens, size_t count)
+{
+    const uint64_t hash = ptcl_incremental_hash_dependent(incremental, tokens, count);
+    if (name == NULL)
+    {
+        incremental->common = hash;
+        return;
+    }
+
+    if ((incremental->declarations_count + 1) * 4 > incremental->declarations_capacity * 3 &&
+        !ptcl_incremental_grow_declarations(incremental))
+    {
+        // Without table declaration can only change everything after it
+        incremental->common = ptcl_incremental_hash(incremental->common, &hash, sizeof(hash));
+        return;
+    }
+
+    ptcl_incremental_declaration *declaration = ptcl_incremental_find_declaration(incremental, name);
+    if (declaration->name == NULL)
+    {
+        *declaration = (ptcl_incremental_declaration){.name = name, .hash = hash};
+        incremental->declarations_count++;
+        return;
+    }
+
+    // Prototype and definition, or declarations of same name in different scopes
+    declaration->hash = ptcl_incremental_hash(declaration->hash, &hash, sizeof(hash));
+}
+
+uint64_t ptcl_incremental_fingerprint(ptcl_incremental *incremental, ptcl_token *tokens, size_t count)
+{
+    const uint64_t fingerprint = ptcl_incremental_hash_dependent(incremental, tokens, count);
+    // Zero means that body has no fingerprint
+    return fingerprint != 0 ? fingerprint : 1;
+}
+
+bool ptcl_incremental_contains(ptcl_incremental *incremental, uint64_t fingerprint)
+{
+    return ptcl_incremental_get(incremental, fingerprint) != NULL;
+}
+
+char *ptcl_incremental_find(ptcl_incremental *incremental, uint64_t fingerprint, bool *with_stdlib)
+{
+    ptcl_incremental_body *body = ptcl_incremental_get(incremental, fingerprint);
+    if (body == NULL)
+    {
+        return NULL;
+    }
+
+    body->is_used = true;
+    *with_stdlib = body->with_stdlib;
+    return body->code;
+}
+
+bool ptcl_incremental_store(ptcl_incremental *incremental, uint64_t fingerprint, char *code, size_t length, bool with_stdlib)
+{
+    ptcl_incremental_body *existing = ptcl_incremental_get(incremental, fingerprint);
+    if (existing != NULL)
+    {
+        existing->is_used = true;
+        return true;
+    }
+
+    char *copy = malloc(length + 1);
+    if (copy == NULL)
+    {
+        return false;
+    }
+
+    memcpy(copy, code, length);
+    copy[length] = '\0';
+    const ptcl_incremental_body body = {
+        .fingerprint = fingerprint,
+        .code = copy,
+        .length = length,
+        .with_stdlib = with_stdlib,
+        .is_owned = true,
+        .is_used = true};
+    if (!ptcl_incremental_add(incremental, body))
+    {
+        free(copy);
+        return false;
+    }
+
+    incremental->is_changed = true;
+    return true;
+}
+
+bool ptcl_incremental_save(ptcl_incremental *incremental)
+{
+    size_t count = 0;
+    size_t code_size = 0;
+    for (size_t i = 0; i < incremental->count; i++)
+    {
+        ptcl_incremental_body *body = &incremental->bodies[i];
+        if (body->is_used)
+        {
+            count++;
+            code_size += body->length + 1;
+        }
+    }
+
+    if (!incremental->is_changed && count == incremental->count)
+    {
+        return true;
+    }
+
+    if (code_size > UINT32_MAX)
+    {
+        return false;
+    }
+
+    const size_t size = sizeof(ptcl_incremental_header) + count * sizeof(ptcl_incremental_record) + code_size;
+    char *image = malloc(size);
+    if (image == NULL)
+    {
+        return false;
+    }
+
+    const ptcl_incremental_header header = {
+        .magic = PTCL_INCREMENTAL_MAGIC,
+        .version = PTCL_INCREMENTAL_VERSION,
+        .count = count,
+        .code_size = code_size};
+    memcpy(image, &header, sizeof(header));
+
+    ptcl_incremental_record *records = (ptcl_incremental_record *)(image + sizeof(header));
+    char *codes = (char *)(records + count);
+    size_t offset = 0;
+    size_t index = 0;
+    for (size_t i = 0; i < incremental->count; i++)
+    {
+        ptcl_incremental_body *body = &incremental->bodies[i];
+        if (!body->is_used)
+        {
+            continue;
+        }
+
+        records[index++] = (ptcl_incremental_record){
+            .fingerprint = body->fingerprint,
+            .offset = (uint32_t)offset,
+            .length = (uint32_t)body->length,
+            .with_stdlib = body->with_stdlib};
+        memcpy(codes + offset, body->code, body->length + 1);
+        offset += body->length + 1;
+    }
+
+    const bool is_written = ptcl_file_write_atomic(incremental->path, image, size);
+    free(image);
+    incremental->is_changed = !is_written;
+    return is_written;
+}
+
+void ptcl_incremental_destroy(ptcl_incremental *incremental)
+{
+    if (incremental == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < incremental->count; i++)
+    {
+        if (incremental->bodies[i].is_owned)
+        {
+            free(incremental->bodies[i].code);
+        }
+    }
+
+    free(incremental->bodies);
+    free(incremental->slots);
+    free(incremental->declarations);
+    free(incremental->image);
+    free(incremental->path);
+    free(incremental);
+}
@@ -72,6 +72,7 @@ ptcl_expression *ptcl_interpreter_evaluate_func_body(ptcl_interpreter *interpret
 
 ptcl_expression *ptcl_interpreter_evaluate_statement(ptcl_interpreter *interpreter, ptcl_statement *statement, ptcl_location location)
 {
+    PTCL_STATS_ADD(ptcl_parser_get_stats(interpreter->parser), interpreter_statements, 1);
     switch (statement->type)
     {
     case ptcl_statement_func_body_type:
@@ -182,7 +183,7 @@ ptcl_expression *ptcl_interpreter_evaluate_expression(ptcl_interpreter *interpre
     case ptcl_expression_func_call_type:
     {
         bool placeholder = false;
-        result = ptcl_interpreter_evaluate_function_call(interpreter, expression->func_call, true, NULL, &placeholder, location);
+        result = ptcl_interpreter_evaluate_function_call(interpreter, *expression->func_call, true, NULL, &placeholder, location);
         if (result == NULL)
         {
             return NULL;
@@ -192,7 +193,7 @@ ptcl_expression *ptcl_interpreter_evaluate_expression(ptcl_interpreter *interpre
     }
     case ptcl_expression_array_type:
     {
-        ptcl_expression *array_expression = ptcl_expression_array_create(expression->return_type, expression->array.expressions, expression->array.count, location);
+        ptcl_expression *array_expression = ptcl_expression_array_create(expression->return_type, expression->array->expressions, expression->array->count, location);
         if (array_expression == NULL)
         {
             ptcl_parser_throw_out_of_memory(interpreter->parser, location);
@@ -203,6 +204,20 @@ ptcl_expression *ptcl_interpreter_evaluate_expression(ptcl_interpreter *interpre
         array_expression->with_type = false;
         return array_expression;
     }
+    case ptcl_expression_string_type:
+    {
+        ptcl_expression *string_expression = ptcl_expression_create(ptcl_expression_string_type, expression->return_type, location);
+        if (string_expression == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(interpreter->parser, location);
+            return NULL;
+        }
+
+        string_expression->string = expression->string;
+        string_expression->is_original = false;
+        string_expression->with_type = false;
+        return string_expression;
+    }
     case ptcl_expression_if_type:
     {
         ptcl_expression *condition = ptcl_interpreter_evaluate_expression(interpreter, expression->if_expr.condition, location);
@@ -243,17 +258,17 @@ ptcl_expression *ptcl_interpreter_evaluate_expression(ptcl_interpreter *interpre
             }
 
             bool placeholder = false;
-            return ptcl_interpreter_evaluate_function_call(interpreter, expression->dot.right->func_call, true, self, &placeholder, location);
+            return ptcl_interpreter_evaluate_function_call(interpreter, *expression->dot.right->func_call, true, self, &placeholder, location);
         }
 
         break;
     case ptcl_expression_array_element_type:
     case ptcl_expression_cast_type:
     {
-        ptcl_expression *cast_value = ptcl_interpreter_evaluate_expression(interpreter, expression->cast.value, location);
+        ptcl_expression *cast_value = ptcl_interpreter_evaluate_expression(interpreter, expression->cast->value, location);
         if (cast_value != NULL)
         {
-            cast_value->return_type = expression->cast.type;
+            cast_value->return_type = expression->cast->type;
             cast_value->with_type = false;
         }
 
@@ -358,11 +373,11 @@ ptcl_expression *ptcl_interpreter_evaluate_expression(ptcl_interpreter *interpre
     return result;
 }
 
-ptcl_expression *ptcl_interpreter_evaluate_function_call(ptcl_interpreter *interpreter, ptcl_statement_func_call func_call, bool evaluate_arguments, ptcl_expression *self, bool *is_self_used, ptcl_location location)
+static ptcl_expression *ptcl_interpreter_evaluate_function_call_untraced(ptcl_interpreter *interpreter, ptcl_statement_func_call func_call, bool evaluate_arguments, ptcl_expression *self, bool *is_self_used, ptcl_location location)
 {
     if (func_call.identifier.is_name && strcmp(func_call.identifier.name.value, PTCL_PARSER_ERROR_FUNC_NAME) == 0)
     {
-        ptcl_parser_throw_user(interpreter->parser, ptcl_string_from_array(func_call.arguments[0]->array), location);
+        ptcl_parser_throw_user(interpreter->parser, ptcl_string_from_expression(func_call.arguments[0]), location);
         return NULL;
     }
 
@@ -530,6 +545,21 @@ ptcl_expression *ptcl_interpreter_evaluate_function_call(ptcl_interpreter *inter
     return result;
 }
 
+ptcl_expression *ptcl_interpreter_evaluate_function_call(ptcl_interpreter *interpreter, ptcl_statement_func_call func_call, bool evaluate_arguments, ptcl_expression *self, bool *is_self_used, ptcl_location location)
+{
+    PTCL_STATS_ADD(ptcl_parser_get_stats(interpreter->parser), interpreter_calls, 1);
+    ptcl_trace *trace = ptcl_parser_get_trace(interpreter->parser);
+    if (trace == NULL)
+    {
+        return ptcl_interpreter_evaluate_function_call_untraced(interpreter, func_call, evaluate_arguments, self, is_self_used, location);
+    }
+
+    const uint64_t trace_start = ptcl_trace_timestamp();
+    ptcl_expression *result = ptcl_interpreter_evaluate_function_call_untraced(interpreter, func_call, evaluate_arguments, self, is_self_used, location);
+    ptcl_trace_add(trace, "interpreter", "call", func_call.func_decl != NULL ? func_call.func_decl->name.value : NULL, trace_start);
+    return result;
+}
+
 ptcl_expression *ptcl_interpreter_get_member_from_dot(ptcl_interpreter *interpreter, ptcl_expression *expression, ptcl_location location)
 {
     if (!expression->dot.is_name)
@@ -559,7 +589,7 @@ ptcl_expression *ptcl_interpreter_get_member_from_dot(ptcl_interpreter *interpre
         return NULL;
     }
 
-    ptcl_expression *value = left->ctor.values[index];
+    ptcl_expression *value = left->ctor->values[index];
     ptcl_expression_destroy(left);
     return value;
 }
@@ -10,13 +10,18 @@ typedef struct ptcl_lexer
     size_t length;
     char *executor;
     ptcl_token *tokens;
+    size_t count;
     size_t capacity;
+    // Array of recycled tokens list, next tokenizing starts from it
+    ptcl_token *spare;
+    size_t spare_capacity;
     ptcl_string_buffer *buffer;
     ptcl_lexer_configuration *configuration;
     char **strings;
     size_t strings_count;
     size_t strings_capacity;
     size_t position;
+    ptcl_trace *trace;
 } ptcl_lexer;
 
 static ptcl_location ptcl_lexer_create_location(ptcl_lexer *lexer)
@@ -49,14 +54,35 @@ ptcl_lexer *ptcl_lexer_create(char *executor, char *source, ptcl_lexer_configura
     }
 
     lexer->strings_count = 0;
+    lexer->tokens = NULL;
+    lexer->count = 0;
+    lexer->capacity = 0;
+    lexer->spare = NULL;
+    lexer->spare_capacity = 0;
     lexer->source = source;
     lexer->length = strlen(source);
     lexer->executor = executor;
     lexer->configuration = configuration;
     lexer->position = 0;
+    lexer->trace = NULL;
     return lexer;
 }
 
+void ptcl_lexer_set_source(ptcl_lexer *lexer, char *executor, char *source)
+{
+    lexer->source = source;
+    lexer->length = strlen(source);
+    lexer->executor = executor;
+    lexer->position = 0;
+    lexer->strings_count = 0;
+    ptcl_string_buffer_clear(lexer->buffer);
+}
+
+void ptcl_lexer_set_trace(ptcl_lexer *lexer, ptcl_trace *trace)
+{
+    lexer->trace = trace;
+}
+
 char ptcl_lexer_current(ptcl_lexer *lexer)
 {
     return lexer->source[lexer->position];
@@ -98,14 +124,20 @@ void ptcl_lexer_add_buffer(ptcl_lexer *lexer, bool check_token)
 
 bool ptcl_lexer_add_token(ptcl_lexer *lexer, ptcl_token token)
 {
-    ptcl_token *buffer = realloc(lexer->tokens, (lexer->capacity + 1) * sizeof(ptcl_token));
-    if (buffer == NULL)
+    if (lexer->count == lexer->capacity)
     {
-        return false;
+        const size_t capacity = lexer->capacity == 0 ? PTCL_LEXER_DEFAULT_TOKENS_CAPACITY : lexer->capacity * 2;
+        ptcl_token *buffer = realloc(lexer->tokens, capacity * sizeof(ptcl_token));
+        if (buffer == NULL)
+        {
+            return false;
+        }
+
+        lexer->tokens = buffer;
+        lexer->capacity = capacity;
     }
 
-    lexer->tokens = buffer;
-    lexer->tokens[lexer->capacity++] = token;
+    lexer->tokens[lexer->count++] = token;
     return true;
 }
 
@@ -181,8 +213,12 @@ char *ptcl_lexer_try_get_or_add_string(ptcl_lexer *lexer, char *string)
 
 ptcl_tokens_list ptcl_lexer_tokenize(ptcl_lexer *lexer)
 {
-    lexer->tokens = NULL;
-    lexer->capacity = 0;
+    const uint64_t trace_start = PTCL_TRACE_START(lexer->trace);
+    lexer->tokens = lexer->spare;
+    lexer->count = 0;
+    lexer->capacity = lexer->spare_capacity;
+    lexer->spare = NULL;
+    lexer->spare_capacity = 0;
 
     while (ptcl_lexer_not_ended(lexer))
     {
@@ -308,10 +344,10 @@ ptcl_tokens_list ptcl_lexer_tokenize(ptcl_lexer *lexer)
             free(value);
         }
 
-        if (operator_type == ptcl_token_dot_type && lexer->capacity > 2)
+        if (operator_type == ptcl_token_dot_type && lexer->count > 2)
         {
-            ptcl_token *first = &lexer->tokens[lexer->capacity - 2];
-            ptcl_token second = lexer->tokens[lexer->capacity - 1];
+            ptcl_token *first = &lexer->tokens[lexer->count - 2];
+            ptcl_token second = lexer->tokens[lexer->count - 1];
             if (first->type == ptcl_token_dot_type && second.type == ptcl_token_dot_type)
             {
                 if (first->is_free_value)
@@ -330,7 +366,7 @@ ptcl_tokens_list ptcl_lexer_tokenize(ptcl_lexer *lexer)
                     .is_free_value = false,
                     .location = first->location};
 
-                lexer->capacity--;
+                lexer->count--;
                 continue;
             }
         }
@@ -339,15 +375,38 @@ ptcl_tokens_list ptcl_lexer_tokenize(ptcl_lexer *lexer)
     }
 
     ptcl_lexer_add_token_by_str(lexer, ptcl_string_buffer_copy_and_clear(lexer->buffer), false);
+    PTCL_TRACE_ADD(lexer->trace, "lexer", "tokenize", lexer->executor, trace_start);
     return (ptcl_tokens_list){
         .source = lexer->source,
         .executor = lexer->executor,
         .tokens = lexer->tokens,
-        .count = lexer->capacity};
+        .count = lexer->count};
+}
+
+void ptcl_lexer_recycle(ptcl_lexer *lexer, ptcl_tokens_list tokens_list)
+{
+    for (size_t i = 0; i < tokens_list.count; i++)
+    {
+        ptcl_token_destroy(tokens_list.tokens[i]);
+    }
+
+    if (tokens_list.tokens != lexer->tokens)
+    {
+        free(tokens_list.tokens);
+        return;
+    }
+
+    free(lexer->spare);
+    lexer->spare = lexer->tokens;
+    lexer->spare_capacity = lexer->capacity;
+    lexer->tokens = NULL;
+    lexer->count = 0;
+    lexer->capacity = 0;
 }
 
 void ptcl_lexer_destroy(ptcl_lexer *lexer)
 {
+    free(lexer->spare);
     ptcl_string_buffer_destroy(lexer->buffer);
     free(lexer->strings);
     free(lexer);
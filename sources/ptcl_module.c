@@ -0,0 +1,895 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ptcl_module.h>
+#include <ptcl_file.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#define PTCL_MODULE_MAGIC 0x49435450u
+#define PTCL_MODULE_VERSION 2
+
+// Interface is header, then records of tokens, then their values without duplicates
+typedef struct ptcl_module_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t configuration_hash;
+    uint64_t source_size;
+    // Nanoseconds of last modification
+    int64_t source_time;
+    uint64_t tokens_count;
+    uint64_t strings_size;
+} ptcl_module_header;
+
+typedef struct ptcl_module_record
+{
+    uint32_t type;
+    uint32_t value;
+    uint32_t position;
+} ptcl_module_record;
+
+typedef struct ptcl_module
+{
+    char *path;
+    // Mapped interface, or image in memory if interface can't be mapped
+    void *data;
+    size_t size;
+    bool is_mapped;
+    ptcl_token *tokens;
+    size_t count;
+    uint64_t source_size;
+    int64_t source_time;
+    size_t stamp;
+} ptcl_module;
+
+typedef struct ptcl_modules
+{
+    ptcl_lexer_configuration *configuration;
+    uint64_t configuration_hash;
+    ptcl_module **items;
+    size_t count;
+    size_t capacity;
+    // Modules inserted by current expanding have it, so cycles and repeated imports are skipped
+    size_t stamp;
+    ptcl_module **imported;
+    size_t imported_count;
+    size_t imported_capacity;
+} ptcl_modules;
+
+static uint64_t ptcl_modules_hash(uint64_t hash, const char *value, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (unsigned char)value[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+ptcl_modules *ptcl_modules_create(ptcl_lexer_configuration *configuration)
+{
+    ptcl_modules *modules = malloc(sizeof(ptcl_modules));
+    if (modules == NULL)
+    {
+        return NULL;
+    }
+
+    modules->items = malloc(PTCL_MODULE_DEFAULT_CAPACITY * sizeof(ptcl_module *));
+    if (modules->items == NULL)
+    {
+        free(modules);
+        return NULL;
+    }
+
+    modules->configuration = configuration;
+    modules->configuration_hash = ptcl_lexer_configuration_hash(configuration);
+    modules->count = 0;
+    modules->capacity = PTCL_MODULE_DEFAULT_CAPACITY;
+    modules->stamp = 0;
+    modules->imported = NULL;
+    modules->imported_count = 0;
+    modules->imported_capacity = 0;
+    return modules;
+}
+
+static bool ptcl_modules_is_absolute(char *path)
+{
+#ifdef _WIN32
+    if (path[0] != '\0' && path[1] == ':')
+    {
+        return true;
+    }
+#endif
+
+    return path[0] == '/' || path[0] == '\\';
+}
+
+// Module is searched next to importer, then from working directory
+static char *ptcl_modules_resolve(char *importer, char *path, struct stat *info, bool *is_out_of_memory)
+{
+    size_t directory = 0;
+    for (size_t i = 0; importer != NULL && importer[i] != '\0'; i++)
+    {
+        if (importer[i] == '/' || importer[i] == '\\')
+        {
+            directory = i + 1;
+        }
+    }
+
+    if (directory > 0 && !ptcl_modules_is_absolute(path))
+    {
+        const size_t length = strlen(path);
+        char *near = malloc(directory + length + 1);
+        if (near == NULL)
+        {
+            *is_out_of_memory = true;
+            return NULL;
+        }
+
+        memcpy(near, importer, directory);
+        memcpy(near + directory, path, length + 1);
+        if (stat(near, info) == 0)
+        {
+            return near;
+        }
+
+        free(near);
+    }
+
+    if (stat(path, info) != 0)
+    {
+        return NULL;
+    }
+
+    char *result = ptcl_string_duplicate(path);
+    *is_out_of_memory = result == NULL;
+    return result;
+}
+
+// Seconds aren't enough, module saved twice in one second with same size would be taken as unchanged
+static int64_t ptcl_modules_time(char *path, struct stat *info)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+    {
+        // Intervals of 100 nanoseconds
+        return (int64_t)(((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+    }
+
+    return (int64_t)info->st_mtime * 1000000000;
+#elif defined(__APPLE__)
+    (void)path;
+    return (int64_t)info->st_mtimespec.tv_sec * 1000000000 + info->st_mtimespec.tv_nsec;
+#else
+    (void)path;
+    return (int64_t)info->st_mtim.tv_sec * 1000000000 + info->st_mtim.tv_nsec;
+#endif
+}
+
+static char *ptcl_modules_interface_path(char *path)
+{
+    const size_t length = strlen(path);
+    const size_t extension = strlen(PTCL_MODULE_EXTENSION);
+    if (length > extension && strcmp(path + length - extension, PTCL_MODULE_EXTENSION) == 0)
+    {
+        // module.ptcl -> module.ptcli
+        return ptcl_string(path, PTCL_MODULE_INTERFACE_EXTENSION + extension, NULL);
+    }
+
+    return ptcl_string(path, PTCL_MODULE_INTERFACE_EXTENSION, NULL);
+}
+
+// Values are mapped for copy on write, so parser can't change interface on disk
+static bool ptcl_module_map(ptcl_module *module, char *interface)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(interface, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    void *data = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    }
+
+    if (mapping != NULL)
+    {
+        data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    module->size = (size_t)size.QuadPart;
+#else
+    const int file = open(interface, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    }
+
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    module->size = (size_t)info.st_size;
+#endif
+
+    module->data = data;
+    module->is_mapped = true;
+    return true;
+}
+
+static void ptcl_module_unload(ptcl_module *module)
+{
+    free(module->tokens);
+    module->tokens = NULL;
+    module->count = 0;
+    if (module->data == NULL)
+    {
+        return;
+    }
+
+    if (module->is_mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(module->data);
+#else
+        munmap(module->data, module->size);
+#endif
+    }
+    else
+    {
+        free(module->data);
+    }
+
+    module->data = NULL;
+    module->size = 0;
+}
+
+// Image is checked completely, broken or outdated interface is just built again
+static bool ptcl_module_read(ptcl_modules *modules, ptcl_module *module)
+{
+    ptcl_module_header header;
+    if (module->size < sizeof(header))
+    {
+        return false;
+    }
+
+    memcpy(&header, module->data, sizeof(header));
+    const size_t available = module->size - sizeof(header);
+    if (header.magic != PTCL_MODULE_MAGIC || header.version != PTCL_MODULE_VERSION ||
+        header.configuration_hash != modules->configuration_hash ||
+        header.source_size != module->source_size || header.source_time != module->source_time ||
+        header.tokens_count > available / sizeof(ptcl_module_record) ||
+        header.strings_size != available - header.tokens_count * sizeof(ptcl_module_record))
+    {
+        return false;
+    }
+
+    ptcl_module_record *records = (ptcl_module_record *)((char *)module->data + sizeof(header));
+    char *strings = (char *)(records + header.tokens_count);
+    if (header.tokens_count == 0)
+    {
+        module->count = 0;
+        return true;
+    }
+
+    if (header.strings_size == 0 || strings[header.strings_size - 1] != '\0')
+    {
+        return false;
+    }
+
+    ptcl_token *tokens = malloc(header.tokens_count * sizeof(ptcl_token));
+    if (tokens == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < header.tokens_count; i++)
+    {
+        ptcl_module_record record = records[i];
+        if (record.value >= header.strings_size || record.type > ptcl_token_import_type)
+        {
+            free(tokens);
+            return false;
+        }
+
+        tokens[i] = ptcl_token_create(
+            (ptcl_token_type)record.type, strings + record.value, ptcl_location_create(module->path, record.position), false);
+    }
+
+    module->tokens = tokens;
+    module->count = header.tokens_count;
+    return true;
+}
+
+// Equal values share one string, so slots keep index of first token with value
+static void *ptcl_module_serialize(ptcl_modules *modules, ptcl_module *module, ptcl_tokens_list tokens, size_t *size)
+{
+    size_t capacity = 16;
+    while (capacity < tokens.count * 2)
+    {
+        capacity *= 2;
+    }
+
+    size_t *slots = calloc(capacity, sizeof(size_t));
+    size_t *offsets = malloc((tokens.count + 1) * sizeof(size_t));
+    if (slots == NULL || offsets == NULL)
+    {
+        free(slots);
+        free(offsets);
+        return NULL;
+    }
+
+    size_t strings_size = 0;
+    for (size_t i = 0; i < tokens.count; i++)
+    {
+        char *value = tokens.tokens[i].value != NULL ? tokens.tokens[i].value : "";
+        const size_t length = strlen(value);
+        size_t index = ptcl_modules_hash(0xcbf29ce484222325ULL, value, length) & (capacity - 1);
+        while (slots[index] != 0 && strcmp(tokens.tokens[slots[index] - 1].value, value) != 0)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        if (slots[index] != 0)
+        {
+            offsets[i] = offsets[slots[index] - 1];
+            continue;
+        }
+
+        slots[index] = i + 1;
+        offsets[i] = strings_size;
+        strings_size += length + 1;
+    }
+
+    char *image = NULL;
+    if (strings_size <= UINT32_MAX && (tokens.count == 0 || tokens.tokens[tokens.count - 1].location.position <= UINT32_MAX))
+    {
+        *size = sizeof(ptcl_module_header) + tokens.count * sizeof(ptcl_module_record) + strings_size;
+        image = malloc(*size);
+    }
+
+    if (image == NULL)
+    {
+        free(slots);
+        free(offsets);
+        return NULL;
+    }
+
+    const ptcl_module_header header = {
+        .magic = PTCL_MODULE_MAGIC,
+        .version = PTCL_MODULE_VERSION,
+        .configuration_hash = modules->configuration_hash,
+        .source_size = module->source_size,
+        .source_time = module->source_time,
+        .tokens_count = tokens.count,
+        .strings_size = strings_size};
+    memcpy(image, &header, sizeof(header));
+
+    ptcl_module_record *records = (ptcl_module_record *)(image + sizeof(header));
+    char *strings = (char *)(records + tokens.count);
+    for (size_t i = 0; i < tokens.count; i++)
+    {
+        records[i] = (ptcl_module_record){
+            .type = tokens.tokens[i].type,
+            .value = (uint32_t)offsets[i],
+            .position = (uint32_t)tokens.tokens[i].location.position};
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        if (slots[i] != 0)
+        {
+            char *value = tokens.tokens[slots[i] - 1].value;
+            value = value != NULL ? value : "";
+            memcpy(strings + offsets[slots[i] - 1], value, strlen(value) + 1);
+        }
+    }
+
+    free(slots);
+    free(offsets);
+    return image;
+}
+
+static bool ptcl_module_build(ptcl_modules *modules, ptcl_module *module, char *interface)
+{
+    char *source = ptcl_file_read(module->path, NULL);
+    if (source == NULL)
+    {
+        return false;
+    }
+
+    ptcl_lexer *lexer = ptcl_lexer_create(module->path, source, modules->configuration);
+    if (lexer == NULL)
+    {
+        free(source);
+        return false;
+    }
+
+    ptcl_tokens_list tokens = ptcl_lexer_tokenize(lexer);
+    size_t size;
+    void *image = ptcl_module_serialize(modules, module, tokens, &size);
+    ptcl_tokens_list_destroy(tokens);
+    ptcl_lexer_destroy(lexer);
+    free(source);
+    if (image == NULL)
+    {
+        return false;
+    }
+
+    module->data = image;
+    module->size = size;
+    module->is_mapped = false;
+    if (!ptcl_module_read(modules, module))
+    {
+        ptcl_module_unload(module);
+        return false;
+    }
+
+    // Interface is renamed over old one, so concurrent importers map either old or new one.
+    // Failed write only costs tokenizing by next importers
+    ptcl_file_write_atomic(interface, image, size);
+    return true;
+}
+
+static bool ptcl_module_load(ptcl_modules *modules, ptcl_module *module)
+{
+    char *interface = ptcl_modules_interface_path(module->path);
+    if (interface == NULL)
+    {
+        return false;
+    }
+
+    if (ptcl_module_map(module, interface))
+    {
+        if (ptcl_module_read(modules, module))
+        {
+            free(interface);
+            return true;
+        }
+
+        ptcl_module_unload(module);
+    }
+
+    const bool is_built = ptcl_module_build(modules, module, interface);
+    free(interface);
+    return is_built;
+}
+
+static ptcl_module *ptcl_modules_add(ptcl_modules *modules, char *path)
+{
+    if (modules->count == modules->capacity)
+    {
+        ptcl_module **buffer = realloc(modules->items, modules->capacity * 2 * sizeof(ptcl_module *));
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+
+        modules->items = buffer;
+        modules->capacity *= 2;
+    }
+
+    ptcl_module *module = calloc(1, sizeof(ptcl_module));
+    if (module == NULL)
+    {
+        return NULL;
+    }
+
+    module->path = path;
+    module->stamp = modules->stamp - 1;
+    modules->items[modules->count++] = module;
+    return module;
+}
+
+static ptcl_module *ptcl_modules_get(ptcl_modules *modules, char *importer, ptcl_token name, ptcl_modules_failure *failure)
+{
+    struct stat info;
+    bool is_out_of_memory = false;
+    char *path = ptcl_modules_resolve(importer, name.value, &info, &is_out_of_memory);
+    failure->path = is_out_of_memory ? NULL : name.value;
+    if (path == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_module *module = NULL;
+    for (size_t i = 0; i < modules->count; i++)
+    {
+        if (strcmp(modules->items[i]->path, path) == 0)
+        {
+            module = modules->items[i];
+            break;
+        }
+    }
+
+    const int64_t time = ptcl_modules_time(path, &info);
+    if (module != NULL)
+    {
+        free(path);
+        // Module inserted by this expanding isn't reloaded, its tokens are already copied
+        if (module->stamp == modules->stamp ||
+            (module->data != NULL && module->source_size == (uint64_t)info.st_size && module->source_time == time))
+        {
+            return module;
+        }
+
+        ptcl_module_unload(module);
+    }
+    else
+    {
+        module = ptcl_modules_add(modules, path);
+        if (module == NULL)
+        {
+            free(path);
+            failure->path = NULL;
+            return NULL;
+        }
+    }
+
+    module->source_size = (uint64_t)info.st_size;
+    module->source_time = time;
+    return ptcl_module_load(modules, module) ? module : NULL;
+}
+
+static bool ptcl_modules_push(ptcl_token **buffer, size_t *capacity, size_t *count, ptcl_token token)
+{
+    if (*count == *capacity)
+    {
+        const size_t new_capacity = *capacity == 0 ? PTCL_LEXER_DEFAULT_TOKENS_CAPACITY : *capacity * 2;
+        ptcl_token *tokens = realloc(*buffer, new_capacity * sizeof(ptcl_token));
+        if (tokens == NULL)
+        {
+            return false;
+        }
+
+        *buffer = tokens;
+        *capacity = new_capacity;
+    }
+
+    (*buffer)[(*count)++] = token;
+    return true;
+}
+
+static inline bool ptcl_modules_is_import(ptcl_token *tokens, size_t count, size_t index)
+{
+    return tokens[index].type == ptcl_token_import_type && index + 1 < count && tokens[index + 1].type == ptcl_token_string_type;
+}
+
+// Quoted curly brackets of syntax declarations, like [{], don't open blocks
+static inline bool ptcl_modules_is_quoted(ptcl_token *tokens, size_t count, size_t index)
+{
+    return index > 0 && index + 1 < count &&
+           tokens[index - 1].type == ptcl_token_left_square_type &&
+           tokens[index + 1].type == ptcl_token_right_square_type;
+}
+
+static inline bool ptcl_modules_is_modifier(ptcl_token_type type)
+{
+    return type == ptcl_token_prototype_type || type == ptcl_token_static_type || type == ptcl_token_const_type ||
+           type == ptcl_token_global_type || type == ptcl_token_auto_type || type == ptcl_token_caret_type;
+}
+
+// Index of closing curly bracket of block, which is opened at index, or count if block isn't closed
+static size_t ptcl_modules_block_end(ptcl_token *tokens, size_t count, size_t index)
+{
+    size_t depth = 0;
+    for (size_t i = index; i < count; i++)
+    {
+        if (ptcl_modules_is_quoted(tokens, count, i))
+        {
+            continue;
+        }
+
+        if (tokens[i].type == ptcl_token_left_curly_type)
+        {
+            depth++;
+        }
+        else if (tokens[i].type == ptcl_token_right_curly_type && --depth == 0)
+        {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+// Index of body of function, which is declared at index, or count if declaration is inserted as is.
+// Prototypes have no body and compile-time functions are run by importer, so only runtime definitions are found
+static size_t ptcl_modules_function_body(ptcl_token *tokens, size_t count, size_t index)
+{
+    for (size_t i = index; i > 0 && ptcl_modules_is_modifier(tokens[i - 1].type); i--)
+    {
+        if (tokens[i - 1].type == ptcl_token_prototype_type || tokens[i - 1].type == ptcl_token_static_type)
+        {
+            return count;
+        }
+    }
+
+    size_t depth = 0;
+    size_t colon = count;
+    for (size_t i = index + 1; i < count; i++)
+    {
+        switch (tokens[i].type)
+        {
+        case ptcl_token_left_par_type:
+            depth++;
+            break;
+        case ptcl_token_right_par_type:
+            depth = depth > 0 ? depth - 1 : 0;
+            break;
+        case ptcl_token_colon_type:
+            colon = depth == 0 ? i : colon;
+            break;
+        case ptcl_token_left_curly_type:
+            if (depth != 0)
+            {
+                return count;
+            }
+
+            return colon + 1 < i && tokens[colon + 1].type != ptcl_token_static_type ? i : count;
+        case ptcl_token_right_curly_type:
+        case ptcl_token_function_type:
+            return count;
+        default:
+            break;
+        }
+    }
+
+    return count;
+}
+
+// Whether top-level runtime variable is defined at index: name: type = value.
+// Static variables aren't emitted, and names of types and parameters are followed by colon too
+static bool ptcl_modules_is_variable(ptcl_token *tokens, size_t count, size_t index)
+{
+    if (tokens[index].type != ptcl_token_word_type || index + 2 >= count || tokens[index + 1].type != ptcl_token_colon_type ||
+        tokens[index + 2].type == ptcl_token_colon_type || tokens[index + 2].type == ptcl_token_static_type)
+    {
+        return false;
+    }
+
+    if (index > 0 && (tokens[index - 1].type == ptcl_token_type_type || tokens[index - 1].type == ptcl_token_typedata_type ||
+                      tokens[index - 1].type == ptcl_token_dot_type || tokens[index - 1].type == ptcl_token_tilde_type ||
+                      tokens[index - 1].type == ptcl_token_exclamation_mark_type))
+    {
+        return false;
+    }
+
+    for (size_t i = index; i > 0 && ptcl_modules_is_modifier(tokens[i - 1].type); i--)
+    {
+        if (tokens[i - 1].type == ptcl_token_prototype_type || tokens[i - 1].type == ptcl_token_static_type)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool ptcl_modules_insert(
+    ptcl_modules *modules, ptcl_token *tokens, size_t count, char *executor, bool is_module,
+    ptcl_token **buffer, size_t *capacity, size_t *result_count, ptcl_modules_failure *failure)
+{
+    size_t depth = 0;
+    // Parameters of functions and syntaxes are inside brackets
+    size_t brackets_depth = 0;
+    // Methods of types, which are declared by module, are exported like its functions
+    bool is_type_pending = false;
+    bool in_type = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        ptcl_token token = tokens[i];
+        if ((token.type == ptcl_token_left_par_type || token.type == ptcl_token_left_square_type) &&
+            !ptcl_modules_is_quoted(tokens, count, i))
+        {
+            brackets_depth++;
+        }
+        else if ((token.type == ptcl_token_right_par_type || token.type == ptcl_token_right_square_type) &&
+                 !ptcl_modules_is_quoted(tokens, count, i))
+        {
+            brackets_depth = brackets_depth > 0 ? brackets_depth - 1 : 0;
+        }
+        else if ((token.type == ptcl_token_left_curly_type || token.type == ptcl_token_right_curly_type) &&
+                 !ptcl_modules_is_quoted(tokens, count, i))
+        {
+            if (token.type == ptcl_token_left_curly_type)
+            {
+                in_type = depth == 0 ? is_type_pending : in_type;
+                is_type_pending = false;
+                depth++;
+            }
+            else
+            {
+                depth = depth > 0 ? depth - 1 : 0;
+                in_type = depth == 0 ? false : in_type;
+            }
+        }
+        else if (depth == 0 && token.type == ptcl_token_type_type)
+        {
+            // type name: base { ... }
+            is_type_pending = i + 2 < count && tokens[i + 1].type == ptcl_token_word_type && tokens[i + 2].type == ptcl_token_colon_type;
+        }
+        else if (is_module && token.type == ptcl_token_function_type && (depth == 0 || (depth == 1 && in_type)))
+        {
+            // Definition is emitted by compilation of module itself, importer gets only its prototype,
+            // so several importers can be linked together
+            const size_t body = ptcl_modules_function_body(tokens, count, i);
+            const size_t body_end = body != count ? ptcl_modules_block_end(tokens, count, body) : count;
+            if (body_end != count)
+            {
+                bool is_pushed = ptcl_modules_push(buffer, capacity, result_count,
+                                                   ptcl_token_create(ptcl_token_prototype_type, "prototype", token.location, false));
+                for (size_t j = i; j < body && is_pushed; j++)
+                {
+                    is_pushed = ptcl_modules_push(buffer, capacity, result_count, tokens[j]);
+                }
+
+                if (!is_pushed)
+                {
+                    failure->path = NULL;
+                    failure->location = token.location;
+                    return false;
+                }
+
+                i = body_end;
+                continue;
+            }
+        }
+        else if (is_module && depth == 0 && brackets_depth == 0 && ptcl_modules_is_variable(tokens, count, i))
+        {
+            // Like functions, variable is defined once by module and importers declare it as extern
+            if (!ptcl_modules_push(buffer, capacity, result_count,
+                                   ptcl_token_create(ptcl_token_prototype_type, "prototype", token.location, false)))
+            {
+                failure->path = NULL;
+                failure->location = token.location;
+                return false;
+            }
+        }
+        else if (depth == 0 && ptcl_modules_is_import(tokens, count, i))
+        {
+            failure->location = token.location;
+            ptcl_module *module = ptcl_modules_get(modules, executor, tokens[i + 1], failure);
+            if (module == NULL)
+            {
+                return false;
+            }
+
+            i++;
+            if (module->stamp == modules->stamp)
+            {
+                continue;
+            }
+
+            module->stamp = modules->stamp;
+            if (modules->imported_count >= modules->imported_capacity)
+            {
+                const size_t imported_capacity = modules->imported_capacity == 0 ? PTCL_MODULE_DEFAULT_CAPACITY : modules->imported_capacity * 2;
+                ptcl_module **imported = realloc(modules->imported, imported_capacity * sizeof(ptcl_module *));
+                if (imported == NULL)
+                {
+                    failure->path = NULL;
+                    return false;
+                }
+
+                modules->imported = imported;
+                modules->imported_capacity = imported_capacity;
+            }
+
+            modules->imported[modules->imported_count++] = module;
+            if (!ptcl_modules_insert(modules, module->tokens, module->count, module->path, true, buffer, capacity, result_count, failure))
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (!ptcl_modules_push(buffer, capacity, result_count, token))
+        {
+            failure->path = NULL;
+            failure->location = token.location;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ptcl_modules_has_imports(ptcl_token *tokens, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (tokens[i].type == ptcl_token_import_type)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t ptcl_modules_leading_imports(ptcl_token *tokens, size_t count)
+{
+    size_t index = 0;
+    while (index < count && ptcl_modules_is_import(tokens, count, index))
+    {
+        index += 2;
+    }
+
+    return index;
+}
+
+bool ptcl_modules_expand(ptcl_modules *modules, ptcl_tokens_list *input, ptcl_token **buffer, size_t *capacity, size_t *count, ptcl_modules_failure *failure)
+{
+    modules->stamp++;
+    modules->imported_count = 0;
+    *count = 0;
+    return ptcl_modules_insert(modules, input->tokens, input->count, input->executor, false, buffer, capacity, count, failure);
+}
+
+bool ptcl_modules_expand_next(ptcl_modules *modules, ptcl_tokens_list *input, ptcl_token **buffer, size_t *capacity, size_t *count, ptcl_modules_failure *failure)
+{
+    *count = 0;
+    return ptcl_modules_insert(modules, input->tokens, input->count, input->executor, false, buffer, capacity, count, failure);
+}
+
+size_t ptcl_modules_imported_count(ptcl_modules *modules)
+{
+    return modules->imported_count;
+}
+
+char *ptcl_modules_imported_path(ptcl_modules *modules, size_t index)
+{
+    return modules->imported[index]->path;
+}
+
+void ptcl_modules_destroy(ptcl_modules *modules)
+{
+    if (modules == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < modules->count; i++)
+    {
+        ptcl_module_unload(modules->items[i]);
+        free(modules->items[i]->path);
+        free(modules->items[i]);
+    }
+
+    free(modules->items);
+    free(modules->imported);
+    free(modules);
+}
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_output_cache.h>
+#include <ptcl_file.h>
+#include <ptcl_string.h>
+
+#define PTCL_OUTPUT_CACHE_MAGIC 0x4f435450u
+
+// Entry is header, then records of modules with their paths, then transpiled code and diagnostics
+typedef struct ptcl_output_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t first;
+    uint64_t second;
+    uint32_t is_compiled;
+    uint32_t modules_count;
+    // Length plus one, zero if there is no such text
+    uint64_t transpiled_size;
+    uint64_t diagnostics_size;
+} ptcl_output_cache_header;
+
+typedef struct ptcl_output_cache_module
+{
+    uint64_t first;
+    uint64_t second;
+    uint32_t path_length;
+    uint32_t reserved;
+} ptcl_output_cache_module;
+
+typedef struct ptcl_output_cache
+{
+    char *directory;
+    size_t limit;
+    uint64_t options;
+} ptcl_output_cache;
+
+// First half is FNV-1a, second one adds each byte and mixes it with other multiplier and shift, so inputs, which
+// collide in one of them, still have different keys unless both collide
+static void ptcl_output_cache_hash(ptcl_output_cache_key *key, const void *value, size_t length)
+{
+    const unsigned char *bytes = value;
+    for (size_t i = 0; i < length; i++)
+    {
+        key->first = (key->first ^ bytes[i]) * 0x100000001b3ULL;
+        key->second = (key->second + bytes[i] + 1) * 0x9e3779b97f4a7c15ULL;
+        key->second ^= key->second >> 29;
+    }
+}
+
+static ptcl_output_cache_key ptcl_output_cache_key_create()
+{
+    return (ptcl_output_cache_key){.first = 0xcbf29ce484222325ULL, .second = 0x84222325cbf29ce4ULL};
+}
+
+ptcl_output_cache *ptcl_output_cache_create(char *directory, size_t limit, uint64_t options)
+{
+    if (!ptcl_file_make_directory(directory))
+    {
+        return NULL;
+    }
+
+    ptcl_output_cache *cache = malloc(sizeof(ptcl_output_cache));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->directory = directory;
+    cache->limit = limit;
+    cache->options = options;
+    return cache;
+}
+
+ptcl_output_cache_key ptcl_output_cache_get_key(ptcl_output_cache *cache, char *input, char *source, size_t size)
+{
+    ptcl_output_cache_key key = ptcl_output_cache_key_create();
+    const uint32_t version = PTCL_OUTPUT_CACHE_VERSION;
+    ptcl_output_cache_hash(&key, &version, sizeof(version));
+    ptcl_output_cache_hash(&key, &cache->options, sizeof(cache->options));
+
+    // Same source in other directory can import other modules
+    const char *separator = strrchr(input, '/');
+    const char *backslash = strrchr(input, '\\');
+    separator = backslash != NULL && (separator == NULL || backslash > separator) ? backslash : separator;
+    const size_t directory_length = separator != NULL ? (size_t)(separator - input) : 0;
+    ptcl_output_cache_hash(&key, &directory_length, sizeof(directory_length));
+    ptcl_output_cache_hash(&key, input, directory_length);
+    ptcl_output_cache_hash(&key, source, size);
+    return key;
+}
+
+static char *ptcl_output_cache_path(ptcl_output_cache *cache, ptcl_output_cache_key key)
+{
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx%016llx", (unsigned long long)key.first, (unsigned long long)key.second);
+    return ptcl_string(cache->directory, "/", name, PTCL_OUTPUT_CACHE_EXTENSION, NULL);
+}
+
+// Hash of missing module is zero, so entry is never used without it
+static ptcl_output_cache_key ptcl_output_cache_hash_module(char *path)
+{
+    size_t size;
+    char *source = ptcl_file_read(path, &size);
+    if (source == NULL)
+    {
+        return (ptcl_output_cache_key){0};
+    }
+
+    ptcl_output_cache_key key = ptcl_output_cache_key_create();
+    ptcl_output_cache_hash(&key, source, size);
+    free(source);
+    return key;
+}
+
+static char *ptcl_output_cache_copy(char *value, uint64_t size)
+{
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    char *copy = malloc(size);
+    if (copy != NULL)
+    {
+        memcpy(copy, value, size - 1);
+        copy[size - 1] = '\0';
+    }
+
+    return copy;
+}
+
+// Every size is checked, so broken or foreign file is just a miss
+bool ptcl_output_cache_find(ptcl_output_cache *cache, ptcl_output_cache_key key, ptcl_output_cache_entry *entry)
+{
+    char *path = ptcl_output_cache_path(cache, key);
+    if (path == NULL)
+    {
+        return false;
+    }
+
+    size_t size;
+    char *image = ptcl_file_read(path, &size);
+    ptcl_output_cache_header header;
+    if (image == NULL || size < sizeof(header))
+    {
+        goto miss;
+    }
+
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != PTCL_OUTPUT_CACHE_MAGIC || header.version != PTCL_OUTPUT_CACHE_VERSION ||
+        header.first != key.first || header.second != key.second)
+    {
+        goto miss;
+    }
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.modules_count; i++)
+    {
+        ptcl_output_cache_module module;
+        if (size - offset < sizeof(module))
+        {
+            goto miss;
+        }
+
+        memcpy(&module, image + offset, sizeof(module));
+        offset += sizeof(module);
+        if (size - offset < module.path_length)
+        {
+            goto miss;
+        }
+
+        // Path is ended by next record, so it is copied
+        char *module_path = ptcl_output_cache_copy(image + offset, (uint64_t)module.path_length + 1);
+        offset += module.path_length;
+        if (module_path == NULL)
+        {
+            goto miss;
+        }
+
+        const ptcl_output_cache_key current = ptcl_output_cache_hash_module(module_path);
+        free(module_path);
+        if (current.first != module.first || current.second != module.second)
+        {
+            goto miss;
+        }
+    }
+
+    const uint64_t transpiled_length = header.transpiled_size > 0 ? header.transpiled_size - 1 : 0;
+    const uint64_t diagnostics_length = header.diagnostics_size > 0 ? header.diagnostics_size - 1 : 0;
+    if (transpiled_length > size - offset || diagnostics_length != size - offset - transpiled_length)
+    {
+        goto miss;
+    }
+
+    entry->is_compiled = header.is_compiled != 0;
+    entry->transpiled = ptcl_output_cache_copy(image + offset, header.transpiled_size);
+    entry->diagnostics = ptcl_output_cache_copy(image + offset + transpiled_length, header.diagnostics_size);
+    if ((header.transpiled_size != 0 && entry->transpiled == NULL) || (header.diagnostics_size != 0 && entry->diagnostics == NULL))
+    {
+        free(entry->transpiled);
+        free(entry->diagnostics);
+        goto miss;
+    }
+
+    // Time of file is time of last use
+    ptcl_file_touch(path);
+    free(image);
+    free(path);
+    return true;
+
+miss:
+    free(image);
+    free(path);
+    return false;
+}
+
+bool ptcl_output_cache_store(ptcl_output_cache *cache, ptcl_output_cache_key key, ptcl_output_cache_entry entry, char **modules, size_t count)
+{
+    const size_t transpiled_length = entry.transpiled != NULL ? strlen(entry.transpiled) : 0;
+    const size_t diagnostics_length = entry.diagnostics != NULL ? strlen(entry.diagnostics) : 0;
+    size_t size = sizeof(ptcl_output_cache_header) + transpiled_length + diagnostics_length;
+    for (size_t i = 0; i < count; i++)
+    {
+        size += sizeof(ptcl_output_cache_module) + strlen(modules[i]);
+    }
+
+    char *path = ptcl_output_cache_path(cache, key);
+    char *image = malloc(size);
+    if (path == NULL || image == NULL)
+    {
+        free(path);
+        free(image);
+        return false;
+    }
+
+    const ptcl_output_cache_header header = {
+        .magic = PTCL_OUTPUT_CACHE_MAGIC,
+        .version = PTCL_OUTPUT_CACHE_VERSION,
+        .first = key.first,
+        .second = key.second,
+        .is_compiled = entry.is_compiled,
+        .modules_count = (uint32_t)count,
+        .transpiled_size = entry.transpiled != NULL ? transpiled_length + 1 : 0,
+        .diagnostics_size = entry.diagnostics != NULL ? diagnostics_length + 1 : 0};
+    memcpy(image, &header, sizeof(header));
+    size_t offset = sizeof(header);
+    for (size_t i = 0; i < count; i++)
+    {
+        const ptcl_output_cache_key hash = ptcl_output_cache_hash_module(modules[i]);
+        const ptcl_output_cache_module module = {
+            .first = hash.first,
+            .second = hash.second,
+            .path_length = (uint32_t)strlen(modules[i])};
+        memcpy(image + offset, &module, sizeof(module));
+        offset += sizeof(module);
+        memcpy(image + offset, modules[i], module.path_length);
+        offset += module.path_length;
+    }
+
+    if (transpiled_length > 0)
+    {
+        memcpy(image + offset, entry.transpiled, transpiled_length);
+    }
+
+    if (diagnostics_length > 0)
+    {
+        memcpy(image + offset + transpiled_length, entry.diagnostics, diagnostics_length);
+    }
+
+    const bool is_written = ptcl_file_write_atomic(path, image, size);
+    free(image);
+    free(path);
+    return is_written;
+}
+
+static int ptcl_output_cache_compare_files(const void *left, const void *right)
+{
+    const int64_t first = ((const ptcl_file_info *)left)->time;
+    const int64_t second = ((const ptcl_file_info *)right)->time;
+    return first < second ? -1 : first > second;
+}
+
+void ptcl_output_cache_trim(ptcl_output_cache *cache)
+{
+    size_t count;
+    ptcl_file_info *files = ptcl_file_list(cache->directory, PTCL_OUTPUT_CACHE_EXTENSION, &count);
+    if (files == NULL)
+    {
+        return;
+    }
+
+    uint64_t size = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size += files[i].size;
+    }
+
+    qsort(files, count, sizeof(ptcl_file_info), ptcl_output_cache_compare_files);
+    for (size_t i = 0; i < count && size > cache->limit; i++)
+    {
+        // Other process can remove it first
+        remove(files[i].path);
+        size -= files[i].size;
+    }
+
+    ptcl_file_list_destroy(files, count);
+}
+
+void ptcl_output_cache_destroy(ptcl_output_cache *cache)
+{
+    free(cache);
+}
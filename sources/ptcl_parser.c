@@ -1,6 +1,8 @@
 #include <ptcl_parser.h>
-#include <ptcl_parser_builder.h>
 #include <ptcl_interpreter.h>
+#include <ptcl_thread.h>
+#include <ptcl_module.h>
+#include <ptcl_snapshot.h>
 
 #define PTCL_PARSER_DESTROY_ARGUMENTS(arguments, count) \
     for (size_t i = 0; i < count; i++)                  \
@@ -9,83 +11,6 @@
     }                                                   \
     free(arguments);
 
-#define SETUP_STATIC_ANY()              \
-    ptcl_type any_copy = ptcl_type_any; \
-    any_copy.is_static = true;          \
-    any_copy.is_const = true;
-
-#define CREATE_TOKEN_TYPE()                                                                            \
-    ptcl_comp_type_builder token_builder = ptcl_comp_type_builder_create(PTCL_PARSER_TOKEN_TYPE_NAME); \
-    ptcl_type_comp_type *token_comp_type = malloc(sizeof(ptcl_type_comp_type));                        \
-    if (token_comp_type == NULL)                                                                       \
-        goto out_of_memory;                                                                            \
-    *token_comp_type = ptcl_comp_type_builder_build_type(&token_builder);                              \
-    ptcl_type token_type = ptcl_type_create_comp_type_t(token_comp_type, true);                        \
-    ptcl_parser_add_instance_comp_type(parser, ptcl_comp_type_builder_build(&token_builder, token_type.comp_type))
-
-#define CREATE_STATEMENT_TYPE()                                                                                \
-    ptcl_comp_type_builder statement_builder = ptcl_comp_type_builder_create(PTCL_PARSER_STATEMENT_TYPE_NAME); \
-    ptcl_type_comp_type *statement_comp_type = malloc(sizeof(ptcl_type_comp_type));                            \
-    if (statement_comp_type == NULL)                                                                           \
-        goto out_of_memory;                                                                                    \
-    *statement_comp_type = ptcl_comp_type_builder_build_type(&statement_builder);                              \
-    ptcl_type statement_type = ptcl_type_create_comp_type_t(statement_comp_type, true);                        \
-    ptcl_parser_add_instance_comp_type(parser, ptcl_comp_type_builder_build(&statement_builder, statement_type.comp_type))
-
-#define CREATE_EXPRESSION_TYPE()                                                                                 \
-    ptcl_comp_type_builder expression_builder = ptcl_comp_type_builder_create(PTCL_PARSER_EXPRESSION_TYPE_NAME); \
-    ptcl_type_comp_type *expression_comp_type = malloc(sizeof(ptcl_type_comp_type));                             \
-    if (expression_comp_type == NULL)                                                                            \
-        goto out_of_memory;                                                                                      \
-    *expression_comp_type = ptcl_comp_type_builder_build_type(&expression_builder);                              \
-    ptcl_type expression_type = ptcl_type_create_comp_type_t(expression_comp_type, true);                        \
-    ptcl_parser_add_instance_comp_type(parser, ptcl_comp_type_builder_build(&expression_builder, expression_type.comp_type))
-
-#define CREATE_GET_STATEMENTS_FUNC()                                                                              \
-    ptcl_func_built_in_builder get_statements_builder = ptcl_func_built_in_builder_create("ptcl_get_statements"); \
-    ptcl_type type_copy = statement_type;                                                                         \
-    ptcl_type array_statements = ptcl_type_create_array(&type_copy, true, -1);                                    \
-    array_statements.array.target->is_static = false;                                                             \
-    array_statements.array.target->is_const = true;                                                               \
-    array_statements.is_const = true;                                                                             \
-    ptcl_func_built_in_builder_bind(&get_statements_builder, ptcl_get_statements_realization);                    \
-    ptcl_func_built_in_builder_add_argument(&get_statements_builder, any_copy);                                   \
-    ptcl_func_built_in_builder_return(&get_statements_builder, array_statements);                                 \
-    ptcl_parser_add_instance_function(parser, ptcl_func_built_in_builder_build(&get_statements_builder))
-
-#define CREATE_ERROR_FUNC()                                                                                    \
-    ptcl_func_built_in_builder error_builder = ptcl_func_built_in_builder_create(PTCL_PARSER_ERROR_FUNC_NAME); \
-    ptcl_type character_copy = ptcl_type_character;                                                            \
-    ptcl_type string_type = ptcl_type_create_array(&character_copy, true, -1);                                 \
-    string_type.is_static = true;                                                                              \
-    ptcl_func_built_in_builder_bind(&error_builder, ptcl_error_realization);                                   \
-    ptcl_func_built_in_builder_add_argument(&error_builder, string_type);                                      \
-    ptcl_func_built_in_builder_return(&error_builder, ptcl_type_void);                                         \
-    ptcl_parser_add_instance_function(parser, ptcl_func_built_in_builder_build(&error_builder))
-
-#define CREATE_DEFINED_FUNC()                                                                       \
-    ptcl_func_built_in_builder defined_builder = ptcl_func_built_in_builder_create("ptcl_defined"); \
-    ptcl_func_built_in_builder_bind(&defined_builder, ptcl_defined_realization);                    \
-    ptcl_func_built_in_builder_add_argument(&defined_builder, any_copy);                            \
-    ptcl_func_built_in_builder_return(&defined_builder, ptcl_type_integer);                         \
-    ptcl_parser_add_instance_function(parser, ptcl_func_built_in_builder_build(&defined_builder))
-
-#define CREATE_INSERT_FUNC()                                                                      \
-    ptcl_func_built_in_builder insert_builder = ptcl_func_built_in_builder_create("ptcl_insert"); \
-    ptcl_func_built_in_builder_bind(&insert_builder, ptcl_insert_realization);                    \
-    ptcl_func_built_in_builder_add_argument(&insert_builder, any_copy);                           \
-    ptcl_func_built_in_builder_return(&insert_builder, ptcl_type_integer);                        \
-    ptcl_parser_add_instance_function(parser, ptcl_func_built_in_builder_build(&insert_builder))
-
-#define CLEANUP_BUILDERS()                                       \
-    ptcl_func_built_in_builder_destroy(&get_statements_builder); \
-    ptcl_func_built_in_builder_destroy(&defined_builder);        \
-    ptcl_func_built_in_builder_destroy(&insert_builder);         \
-    ptcl_func_built_in_builder_destroy(&error_builder);          \
-    ptcl_comp_type_builder_destroy(&token_builder);              \
-    ptcl_comp_type_builder_destroy(&statement_builder);          \
-    ptcl_comp_type_builder_destroy(&expression_builder)
-
 // TODO: need to make one function for vars declaring and args
 
 typedef struct
@@ -141,8 +66,63 @@ typedef struct
 {
     ptcl_parser_this_s_pair *items;
     size_t count;
+    size_t capacity;
 } ptcl_this_pairs_array;
 
+// Body of ordinary top-level function, which is parsed by worker after declarations before it are known
+typedef struct
+{
+    ptcl_func_body *body;
+    ptcl_argument *arguments;
+    size_t arguments_count;
+    const ptcl_type *return_type;
+    ptcl_parser_tokens_state tokens;
+    ptcl_parser_flags states;
+    size_t syntaxes_count;
+    size_t typedatas_count;
+    size_t comp_types_count;
+    size_t functions_count;
+    size_t variables_count;
+    ptcl_parser_variable *declared;
+    size_t declared_count;
+    ptcl_parser_error *errors;
+    size_t errors_count;
+    bool is_critical;
+} ptcl_parser_deferred_body;
+
+typedef struct
+{
+    ptcl_parser_deferred_body *items;
+    size_t count;
+    size_t capacity;
+} ptcl_deferred_bodies_array;
+
+// Nodes made from element of each while body is parsed for first one, so next elements replace their values
+typedef struct
+{
+    // Index of element variable, -1 if nodes aren't recorded
+    size_t variable;
+    ptcl_expression **items;
+    size_t count;
+    size_t capacity;
+    bool is_out_of_memory;
+} ptcl_parser_each_slots;
+
+// First tokens of syntaxes, so token, which can't start any of them, isn't checked against each syntax.
+// Hidden syntaxes are kept until it's built again, it is only filter before exact check
+typedef struct
+{
+    // Open addressing table of first words, capacity is power of two
+    char **words;
+    size_t capacity;
+    // Token types of first nodes, which aren't word tokens
+    bool types[ptcl_token_import_type + 1];
+    // Some syntax starts with variable or value, so any token can start it
+    bool is_any;
+    size_t syntaxes_count;
+    bool is_built;
+} ptcl_parser_syntax_starts;
+
 typedef struct
 {
     ptcl_parser_tokens_state tokens;
@@ -155,13 +135,31 @@ typedef struct
 {
     ptcl_func_body *root;
     ptcl_func_body *main_root;
+    // Input, or its copy with imported modules
+    ptcl_token *main_tokens;
     ptcl_func_body *inserted_body;
-    ptcl_type *return_type;
+    const ptcl_type *return_type;
     ptcl_expression *return_value;
     ptcl_parser_insert_state insert_states[PTCL_PARSER_DECL_INSERT_DEPTH];
     size_t insert_states_count;
+    // Tokens of top-level statements, which are declared for incremental compilation
+    size_t statement_start;
+    size_t declared_count;
+    bool is_declaring;
+    // Position of plain body of current top-level function
+    size_t body_start;
 } ptcl_parser_temp;
 
+typedef struct ptcl_parser_base
+{
+    ptcl_parser_result *prelude;
+    ptcl_func_body *root;
+    ptcl_token *imported;
+    unsigned int hidden_built_in_types;
+    uint64_t hash;
+    bool is_set;
+} ptcl_parser_base;
+
 typedef struct ptcl_parser
 {
     ptcl_interpreter *interpreter;
@@ -179,8 +177,73 @@ typedef struct ptcl_parser
     ptcl_variable_array variables;
     ptcl_lated_states_array lated_states;
     ptcl_this_pairs_array this_pairs;
+    ptcl_arena *arena;
+    ptcl_type_interner *types;
+    ptcl_parser_stats *stats;
+    ptcl_parser_profile *profile;
+    ptcl_trace *trace;
+    size_t jobs;
+    ptcl_deferred_bodies_array deferred_bodies;
+    ptcl_parser_each_slots each_slots;
+    ptcl_parser_syntax_starts syntax_starts;
+    // Built-in types removed by undefine, one bit for each
+    unsigned int hidden_built_in_types;
+    // Arrays, arena and interner of previous result were given back, so next parse reuses them
+    bool is_recycled;
+    // Created by first import, tokens of modules are kept for next parses
+    ptcl_modules *modules;
+    bool is_expanded;
+    ptcl_token *imported;
+    size_t imported_capacity;
+    // Instances and statements of prelude, each parse starts with them
+    ptcl_parser_result *prelude;
+    ptcl_func_body *prelude_root;
+    ptcl_token *prelude_imported;
+    unsigned int prelude_hidden_built_in_types;
+    uint64_t prelude_hash;
+    // Prelude is set from outside, parser owns only its interner
+    bool is_prelude_set;
+    // Top-level instances of prelude are kept in scope after its file
+    bool is_prelude;
+    // Leading imports of files are parsed once as prelude on top of prelude and replace it,
+    // while files start with the same imports. Fields of prelude below are kept here meanwhile
+    ptcl_parser_base base;
+    bool is_imports;
+    // Prelude of imports is parsed, it starts with statements of prelude below
+    bool is_imports_parsed;
+    bool is_imports_saved;
+    // Count of leading tokens of input, which are parsed in prelude of imports
+    size_t imports_count;
+    // Image, which prelude of imports is mapped from
+    ptcl_snapshot *imports_snapshot;
+    ptcl_incremental *incremental;
 } ptcl_parser;
 
+// Top-level instances of parsed prelude have this root between parses and root of parsed file during them
+static ptcl_func_body ptcl_parser_prelude_root;
+
+static ptcl_token *ptcl_parser_cross_boundary(ptcl_parser *parser);
+
+static void ptcl_parser_rollback_failed(ptcl_parser *parser, ptcl_parser_checkpoint checkpoint);
+
+static void ptcl_parser_join_bodies(ptcl_parser *parser);
+
+static void ptcl_parser_use_imports(ptcl_parser *parser);
+
+static bool ptcl_parser_worker_extend(void **items, size_t *count, size_t *capacity, void *source, size_t target, size_t size);
+
+// Position is inside of current tokens almost always, so inserted states and syntaxes are left only by crossing the end
+static inline ptcl_token *ptcl_parser_cursor(ptcl_parser *parser)
+{
+    ptcl_parser_tokens_state *tokens = &parser->state.tokens;
+    if (tokens->position < tokens->count)
+    {
+        return &tokens->tokens[tokens->position];
+    }
+
+    return ptcl_parser_cross_boundary(parser);
+}
+
 static ptcl_expression_ctor ptcl_parser_ctor_args(ptcl_parser *parser, ptcl_name name, ptcl_parser_typedata typedata_parser)
 {
     if (ptcl_parser_not(parser, ptcl_token_left_par_type))
@@ -273,21 +336,18 @@ static ptcl_expression_ctor ptcl_parser_ctor_args(ptcl_parser *parser, ptcl_name
 
 static ptcl_expression *ptcl_parser_try_ctor(ptcl_parser *parser, ptcl_name name, ptcl_parser_typedata *typedata, ptcl_location location)
 {
-    ptcl_expression *result = ptcl_expression_create(
-        ptcl_expression_ctor_type,
-        ptcl_type_create_typedata(typedata->typedata, false),
-        location);
     ptcl_name_destroy(name);
-    if (result == NULL)
+    ptcl_expression_ctor ctor = ptcl_parser_ctor_args(parser, typedata->typedata->identifier, *typedata);
+    if (ptcl_parser_critical(parser))
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
         return NULL;
     }
 
-    result->ctor = ptcl_parser_ctor_args(parser, typedata->typedata->identifier, *typedata);
-    if (ptcl_parser_critical(parser))
+    ptcl_expression *result = ptcl_expression_ctor_node_create(ctor, ptcl_type_create_typedata(typedata->typedata, false), location);
+    if (result == NULL)
     {
-        free(result);
+        ptcl_expression_ctor_destroy(ctor);
+        ptcl_parser_throw_out_of_memory(parser, location);
         return NULL;
     }
 
@@ -312,16 +372,13 @@ static ptcl_expression *ptcl_parser_try_func(ptcl_parser *parser, ptcl_name name
     }
     else
     {
-        result = ptcl_expression_create(
-            ptcl_expression_func_call_type, func_call.return_type, location);
+        result = ptcl_expression_func_call_create(func_call, func_call.return_type, location);
         if (result == NULL)
         {
             ptcl_parser_throw_out_of_memory(parser, location);
             ptcl_statement_func_call_destroy(func_call);
             return NULL;
         }
-
-        result->func_call = func_call;
     }
 
     return result;
@@ -394,7 +451,7 @@ static ptcl_expression *ptcl_parser_var_call_expr(ptcl_parser *parser, ptcl_name
         return NULL;
     }
 
-    ptcl_expression *result = ptcl_expression_create(ptcl_expression_func_call_type, func_decl.return_type, location);
+    ptcl_expression *result = ptcl_expression_func_call_create(func_call, func_decl.return_type, location);
     if (result == NULL)
     {
         ptcl_parser_throw_out_of_memory(parser, location);
@@ -404,7 +461,6 @@ static ptcl_expression *ptcl_parser_var_call_expr(ptcl_parser *parser, ptcl_name
     }
 
     result->with_type = false;
-    result->func_call = func_call;
     return result;
 }
 
@@ -434,6 +490,28 @@ static ptcl_expression *ptcl_parser_variable_from_transformed(ptcl_parser *parse
     return result;
 }
 
+static void ptcl_parser_each_record(ptcl_parser *parser, ptcl_expression *slot)
+{
+    ptcl_parser_each_slots *slots = &parser->each_slots;
+    if (slots->count >= slots->capacity)
+    {
+        const size_t capacity = slots->capacity == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : slots->capacity * 2;
+        ptcl_expression **buffer = realloc(slots->items, capacity * sizeof(ptcl_expression *));
+        if (buffer == NULL)
+        {
+            // Body is parsed for each element then
+            slots->is_out_of_memory = true;
+            return;
+        }
+
+        slots->items = buffer;
+        slots->capacity = capacity;
+    }
+
+    slot->is_slot = true;
+    slots->items[slots->count++] = slot;
+}
+
 static ptcl_expression *ptcl_parser_var_expr(ptcl_parser *parser, ptcl_name name, ptcl_parser_variable *variable, bool is_change_value, ptcl_location location)
 {
     ptcl_expression *result = NULL;
@@ -468,6 +546,10 @@ static ptcl_expression *ptcl_parser_var_expr(ptcl_parser *parser, ptcl_name name
         }
 
         result->return_type.is_static = variable->built_in->return_type.is_static || !variable->is_built_in;
+        if ((size_t)(variable - parser->variables.items) == parser->each_slots.variable)
+        {
+            ptcl_parser_each_record(parser, result);
+        }
     }
     else
     {
@@ -617,7 +699,7 @@ static void ptcl_statement_func_call_by_ident(ptcl_statement *statement, ptcl_id
     if (expression->type == ptcl_expression_dot_type)
     {
         statement->func_call = ptcl_statement_func_call_create(
-            expression->dot.right->func_call.func_decl,
+            expression->dot.right->func_call->func_decl,
             identifier,
             NULL,
             0);
@@ -625,7 +707,7 @@ static void ptcl_statement_func_call_by_ident(ptcl_statement *statement, ptcl_id
     else if (expression->type == ptcl_expression_func_call_type)
     {
         statement->func_call = ptcl_statement_func_call_create(
-            expression->func_call.func_decl,
+            expression->func_call->func_decl,
             identifier,
             NULL,
             0);
@@ -713,15 +795,15 @@ static bool ptcl_parser_func_call_stat(ptcl_parser *parser, ptcl_statement **res
 
 static ptcl_token *ptcl_parser_tokens_from_array(ptcl_expression *expression)
 {
-    ptcl_token *expression_tokens = malloc(expression->array.count * sizeof(ptcl_token));
-    if (expression_tokens == NULL && expression->array.count > 0)
+    ptcl_token *expression_tokens = malloc(expression->array->count * sizeof(ptcl_token));
+    if (expression_tokens == NULL && expression->array->count > 0)
     {
         return NULL;
     }
 
-    for (size_t i = 0; i < expression->array.count; i++)
+    for (size_t i = 0; i < expression->array->count; i++)
     {
-        expression_tokens[i] = expression->array.expressions[i]->internal_token;
+        expression_tokens[i] = expression->array->expressions[i]->internal_token;
     }
 
     return expression_tokens;
@@ -769,7 +851,8 @@ static bool ptcl_parser_try_parse_insert(ptcl_parser *parser, ptcl_parser_tokens
     }
 
     state->tokens = expression_tokens;
-    state->count = expression->array.count;
+    state->partners = NULL;
+    state->count = expression->array->count;
     state->position = 0;
     state->is_free = true;
     expression->is_original = false;
@@ -1084,17 +1167,17 @@ static ptcl_type ptcl_parser_pointers(ptcl_parser *parser, ptcl_type type)
 
     if (ptcl_parser_match(parser, ptcl_token_asterisk_type))
     {
-        ptcl_type *target = malloc(sizeof(ptcl_type));
+        const bool is_static = type.is_static;
+        type.is_static = false;
+        ptcl_type *target = ptcl_type_interner_intern(parser->types, type);
         if (target == NULL)
         {
             ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_type_destroy(type);
             return type;
         }
 
-        *target = type;
-        target->is_primitive = false;
         type = ptcl_type_create_pointer(target, false);
+        type.is_static = is_static;
         return ptcl_parser_pointers(parser, type);
     }
     else if (ptcl_parser_match(parser, ptcl_token_left_square_type))
@@ -1114,30 +1197,64 @@ static ptcl_type ptcl_parser_pointers(ptcl_parser *parser, ptcl_type type)
             return type;
         }
 
-        ptcl_type *target = malloc(sizeof(ptcl_type));
+        type.is_static = false;
+        ptcl_type *target = ptcl_type_interner_intern(parser->types, type);
         if (target == NULL)
         {
             ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_type_destroy(type);
             return type;
         }
 
-        *target = type;
-        target->is_static = false;
-        target->is_primitive = false;
         type = ptcl_type_create_array(target, false, -1);
         type.is_static = true;
         return ptcl_parser_pointers(parser, type);
     }
     else if (ptcl_parser_match(parser, ptcl_token_const_type))
     {
-        if (type.type == ptcl_value_pointer_type)
-        {
-            type.pointer.target->is_const = true;
-        }
-        else if (type.type == ptcl_value_array_type)
+        if (type.type == ptcl_value_pointer_type || type.type == ptcl_value_array_type)
         {
-            type.array.target->is_const = true;
+            // Interned targets are shared, so constant one is interned separately
+            ptcl_type *target = ptcl_type_get_target(type);
+            if (target->type == ptcl_value_function_pointer_type && !target->is_primitive)
+            {
+                target->is_const = true;
+                return type;
+            }
+
+            // Equal function pointers share canonical node, so its members are copied for constant one
+            ptcl_type constant = *target;
+            if (target->type == ptcl_value_function_pointer_type)
+            {
+                bool is_out_of_memory;
+                constant = ptcl_type_copy(*target, &is_out_of_memory);
+                if (is_out_of_memory)
+                {
+                    ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+                    return type;
+                }
+            }
+
+            constant.is_const = true;
+            ptcl_type *interned = ptcl_type_interner_intern(parser->types, constant);
+            if (!target->is_primitive)
+            {
+                free(target);
+            }
+
+            if (interned == NULL)
+            {
+                ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+                return type;
+            }
+
+            if (type.type == ptcl_value_pointer_type)
+            {
+                type.pointer.target = interned;
+            }
+            else
+            {
+                type.array.target = interned;
+            }
         }
         else
         {
@@ -1150,8 +1267,99 @@ static ptcl_type ptcl_parser_pointers(ptcl_parser *parser, ptcl_type type)
     return type;
 }
 
+static const ptcl_token_type ptcl_parser_brackets[][2] = {
+    {ptcl_token_left_curly_type, ptcl_token_right_curly_type},
+    {ptcl_token_left_par_type, ptcl_token_right_par_type},
+    {ptcl_token_left_square_type, ptcl_token_right_square_type}};
+
+// Bracket as syntax pattern element, like '[{]', is a single token and has no pair
+static bool ptcl_parser_is_quoted_bracket(ptcl_token *tokens, size_t count, size_t index)
+{
+    return index > 0 && index + 1 < count &&
+           tokens[index - 1].type == ptcl_token_left_square_type &&
+           tokens[index + 1].type == ptcl_token_right_square_type;
+}
+
+// Pairs brackets of input in one pass per kind and reports each unbalanced one at its own location
+static bool ptcl_parser_pair_brackets(ptcl_parser *parser)
+{
+    ptcl_token *tokens = ptcl_parser_tokens(parser);
+    const size_t count = ptcl_parser_count(parser);
+    if (count == 0)
+    {
+        return true;
+    }
+
+    size_t *partners = ptcl_arena_allocate(parser->arena, count * sizeof(size_t));
+    size_t *opened = malloc(count * sizeof(size_t));
+    if (partners == NULL || opened == NULL)
+    {
+        free(opened);
+        ptcl_parser_throw_out_of_memory(parser, tokens[0].location);
+        return false;
+    }
+
+    memset(partners, 0, count * sizeof(size_t));
+    bool is_balanced = true;
+    for (size_t kind = 0; kind < sizeof(ptcl_parser_brackets) / sizeof(ptcl_parser_brackets[0]); kind++)
+    {
+        const ptcl_token_type left = ptcl_parser_brackets[kind][0];
+        const ptcl_token_type right = ptcl_parser_brackets[kind][1];
+        size_t depth = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if ((tokens[i].type != left && tokens[i].type != right) ||
+                (left != ptcl_token_left_square_type && ptcl_parser_is_quoted_bracket(tokens, count, i)))
+            {
+                continue;
+            }
+
+            if (tokens[i].type == left)
+            {
+                opened[depth++] = i;
+            }
+            else if (depth > 0)
+            {
+                const size_t pair = opened[--depth];
+                partners[pair] = i - pair;
+            }
+            else
+            {
+                is_balanced = false;
+                ptcl_parser_throw_not_allowed_token(parser, tokens[i].value, tokens[i].location);
+            }
+        }
+
+        for (size_t i = 0; i < depth; i++)
+        {
+            is_balanced = false;
+            ptcl_parser_throw_except_token(
+                parser, ptcl_lexer_configuration_get_value(parser->configuration, right), tokens[opened[i]].location);
+        }
+    }
+
+    free(opened);
+    parser->state.tokens.partners = partners;
+    return is_balanced;
+}
+
 static void ptcl_parser_skip_block_or_expression(ptcl_parser *parser)
 {
+    // Opening bracket is already skipped, so its pair is found in one jump when it's known
+    ptcl_parser_tokens_state *state = &parser->state.tokens;
+    if (state->partners != NULL && state->position > 0 && state->position <= state->count)
+    {
+        const size_t opening = state->position - 1;
+        const size_t closing = opening + state->partners[opening];
+        if (closing != opening && closing < state->count &&
+            state->tokens[opening].type == ptcl_token_left_curly_type &&
+            state->tokens[closing].type == ptcl_token_right_curly_type)
+        {
+            state->position = closing + 1;
+            return;
+        }
+    }
+
     ptcl_location location = ptcl_parser_current(parser).location;
     size_t depth = 1;
     while (depth > 0 && !ptcl_parser_ended(parser))
@@ -1175,13 +1383,36 @@ static void ptcl_parser_skip_block_or_expression(ptcl_parser *parser)
     }
 }
 
-static void ptcl_parser_set_arrays_length(ptcl_type *type, ptcl_type *target)
+// Nested arrays are interned and shared, so array with other length is interned as new node
+static ptcl_type ptcl_parser_set_arrays_length(ptcl_parser *parser, ptcl_type type, const ptcl_type *target)
 {
-    if (type->type == ptcl_value_array_type)
+    if (type.type != ptcl_value_array_type || target->type != ptcl_value_array_type)
+    {
+        return type;
+    }
+
+    type.array.count = target->array.count;
+    ptcl_type *nested = type.array.target;
+    if (nested == NULL || nested->type != ptcl_value_array_type || target->array.target == NULL)
+    {
+        return type;
+    }
+
+    const ptcl_type counted = ptcl_parser_set_arrays_length(parser, *nested, target->array.target);
+    if (counted.array.count == nested->array.count && counted.array.target == nested->array.target)
+    {
+        return type;
+    }
+
+    ptcl_type *interned = ptcl_type_interner_intern(parser->types, counted);
+    if (interned == NULL)
     {
-        type->array.count = target->array.count;
-        ptcl_parser_set_arrays_length(type->array.target, target->array.target);
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        return type;
     }
+
+    type.array.target = interned;
+    return type;
 }
 
 static ptcl_statement *ptcl_create_statement_from_expression(ptcl_func_body *root, ptcl_expression *expression, ptcl_location location)
@@ -1241,7 +1472,7 @@ static ptcl_expression *ptcl_error_realization(ptcl_parser *parser, ptcl_express
     }
 
     ptcl_expression *content = arguments[0];
-    char *message = ptcl_string_from_array(arguments[0]->array);
+    char *message = ptcl_string_from_expression(arguments[0]);
     PTCL_PARSER_DESTROY_ARGUMENTS(arguments, count);
     if (message == NULL)
     {
@@ -1260,7 +1491,7 @@ static ptcl_expression *ptcl_defined_realization(ptcl_parser *parser, ptcl_expre
     ptcl_name name;
     if (ptcl_type_is_string(name_argument->return_type))
     {
-        name = ptcl_name_create(ptcl_string_from_array(name_argument->array), true, location);
+        name = ptcl_name_create(ptcl_string_from_expression(name_argument), true, location);
         if (name.value == NULL)
         {
             PTCL_PARSER_DESTROY_ARGUMENTS(arguments, count);
@@ -1296,8 +1527,9 @@ static ptcl_expression *ptcl_get_statements_realization(ptcl_parser *parser, ptc
     case ptcl_value_function_pointer_type:
     {
         ptcl_parser_temp *temp = &parser->temp;
+        PTCL_STATS_ADD(parser->stats, lated_body_reparses, 1);
         ptcl_parser_tokens_state lated_body = parser->lated_states.items[argument->lated_body.index];
-        const ptcl_parser_tokens_state last_tokens_state = parser->state.tokens;
+        const ptcl_parser_checkpoint checkpoint = ptcl_parser_get_checkpoint(parser);
         ptcl_parser_set_tokens_state(parser, lated_body);
         ptcl_parser_set_position(parser, 0);
 
@@ -1308,11 +1540,12 @@ static ptcl_expression *ptcl_get_statements_realization(ptcl_parser *parser, ptc
         temp->inserted_body = &body;
 
         ptcl_parser_func_body_by_pointer(parser, temp->inserted_body, true, false, ptcl_parser_ignore_error(parser));
-        ptcl_parser_set_tokens_state(parser, last_tokens_state);
+        ptcl_parser_set_tokens_state(parser, checkpoint.tokens);
         temp->inserted_body = last_state;
 
         if (ptcl_parser_critical(parser))
         {
+            ptcl_parser_rollback_failed(parser, checkpoint);
             PTCL_PARSER_DESTROY_ARGUMENTS(arguments, count);
             return NULL;
         }
@@ -1325,7 +1558,7 @@ static ptcl_expression *ptcl_get_statements_realization(ptcl_parser *parser, ptc
             return NULL;
         }
 
-        ptcl_expression *array = ptcl_expression_create(ptcl_expression_array_type, array_type, location);
+        ptcl_expression *array = ptcl_expression_array_node_create(ptcl_expression_array_create_empty(ptcl_statement_t_type), array_type, location);
         if (array == NULL)
         {
             free(statements);
@@ -1355,7 +1588,7 @@ static ptcl_expression *ptcl_get_statements_realization(ptcl_parser *parser, ptc
         }
 
         PTCL_PARSER_DESTROY_ARGUMENTS(arguments, count);
-        array->array = ptcl_expression_array_create_member(ptcl_statement_t_type, statements, body.count);
+        *array->array = ptcl_expression_array_create_member(ptcl_statement_t_type, statements, body.count);
         ptcl_func_body_destroy(body);
         return array;
     }
@@ -1446,7 +1679,7 @@ static bool ptcl_check_array_statements(ptcl_parser *parser, ptcl_expression_arr
 
 static ptcl_expression *ptcl_insert_statements_array(ptcl_parser *parser, ptcl_expression *argument, ptcl_location location)
 {
-    ptcl_expression_array array = argument->array;
+    ptcl_expression_array array = *argument->array;
     if (!ptcl_check_array_statements(parser, array))
     {
         ptcl_expression_destroy(argument);
@@ -1496,6 +1729,7 @@ static ptcl_expression *ptcl_insert_statements_array(ptcl_parser *parser, ptcl_e
         body->count++;
     }
 
+    free(argument->array);
     free(argument);
     free(array.expressions);
     return NULL;
@@ -1517,7 +1751,7 @@ static ptcl_expression *ptcl_insert_tokens_array(ptcl_parser *parser, ptcl_expre
         const ptcl_parser_tokens_state last_state = parser->state.tokens;
         ptcl_parser_set_position(parser, 0);
         ptcl_parser_set_tokens(parser, expression_tokens);
-        ptcl_parser_set_count(parser, argument->array.count);
+        ptcl_parser_set_count(parser, argument->array->count);
 
         ptcl_expression *value = ptcl_parser_cast(parser, NULL, false);
 
@@ -1601,6 +1835,85 @@ static ptcl_expression *ptcl_insert_realization(ptcl_parser *parser, ptcl_expres
     return NULL;
 }
 
+static ptcl_type const ptcl_parser_static_any = {
+    .type = ptcl_value_any_type,
+    .is_primitive = true,
+    .is_static = true,
+    .is_const = true};
+
+static ptcl_type const ptcl_parser_statement_element = {
+    .type = ptcl_value_type_type,
+    .is_primitive = true,
+    .is_static = false,
+    .is_const = true,
+    .comp_type = (ptcl_type_comp_type *)&ptcl_statement_comp_type};
+
+static ptcl_argument const ptcl_parser_any_arguments[] = {
+    {.type = ptcl_parser_static_any, .name = {.value = "", .is_free = false}}};
+
+static ptcl_argument const ptcl_parser_string_arguments[] = {
+    {.type = {
+         .type = ptcl_value_array_type,
+         .is_primitive = true,
+         .is_static = true,
+         .is_const = true,
+         .array = {.target = (ptcl_type *)&ptcl_type_character, .count = -1}},
+     .name = {.value = "", .is_free = false}}};
+
+// Built-ins are the outermost scope of every parser. They are built once at compile time and never change,
+// so parse starts without allocating them
+static ptcl_parser_comp_type const ptcl_parser_built_in_types[] = {
+    {.identifier = {.value = PTCL_PARSER_TOKEN_TYPE_NAME, .is_free = false}, .comp_type = (ptcl_type_comp_type *)&ptcl_token_comp_type},
+    {.identifier = {.value = PTCL_PARSER_STATEMENT_TYPE_NAME, .is_free = false}, .comp_type = (ptcl_type_comp_type *)&ptcl_statement_comp_type},
+    {.identifier = {.value = PTCL_PARSER_EXPRESSION_TYPE_NAME, .is_free = false}, .comp_type = (ptcl_type_comp_type *)&ptcl_expression_comp_type}};
+
+static ptcl_parser_function const ptcl_parser_built_in_functions[] = {
+    {.name = {.value = "ptcl_get_statements", .is_free = false},
+     .is_built_in = true,
+     .bind = ptcl_get_statements_realization,
+     .func = {
+         .name = {.value = "ptcl_get_statements", .is_free = false},
+         .arguments = (ptcl_argument *)ptcl_parser_any_arguments,
+         .count = 1,
+         .return_type = {
+             .type = ptcl_value_array_type,
+             .is_primitive = true,
+             .is_static = true,
+             .is_const = true,
+             .array = {.target = (ptcl_type *)&ptcl_parser_statement_element, .count = -1}}}},
+    {.name = {.value = "ptcl_defined", .is_free = false},
+     .is_built_in = true,
+     .bind = ptcl_defined_realization,
+     .func = {
+         .name = {.value = "ptcl_defined", .is_free = false},
+         .arguments = (ptcl_argument *)ptcl_parser_any_arguments,
+         .count = 1,
+         .return_type = ptcl_type_integer}},
+    {.name = {.value = PTCL_PARSER_ERROR_FUNC_NAME, .is_free = false},
+     .is_built_in = true,
+     .bind = ptcl_error_realization,
+     .func = {
+         .name = {.value = PTCL_PARSER_ERROR_FUNC_NAME, .is_free = false},
+         .arguments = (ptcl_argument *)ptcl_parser_string_arguments,
+         .count = 1,
+         .return_type = ptcl_type_void}},
+    {.name = {.value = "ptcl_insert", .is_free = false},
+     .is_built_in = true,
+     .bind = ptcl_insert_realization,
+     .func = {
+         .name = {.value = "ptcl_insert", .is_free = false},
+         .arguments = (ptcl_argument *)ptcl_parser_any_arguments,
+         .count = 1,
+         .return_type = ptcl_type_integer}}};
+
+#define PTCL_PARSER_BUILT_IN_TYPES_COUNT (sizeof(ptcl_parser_built_in_types) / sizeof(ptcl_parser_comp_type))
+#define PTCL_PARSER_BUILT_IN_FUNCTIONS_COUNT (sizeof(ptcl_parser_built_in_functions) / sizeof(ptcl_parser_function))
+
+static bool ptcl_parser_is_built_in_type(ptcl_parser_comp_type *comp_type)
+{
+    return comp_type >= ptcl_parser_built_in_types && comp_type < ptcl_parser_built_in_types + PTCL_PARSER_BUILT_IN_TYPES_COUNT;
+}
+
 ptcl_parser *ptcl_parser_create(ptcl_tokens_list *input, ptcl_lexer_configuration *configuration)
 {
     ptcl_parser *parser = malloc(sizeof(ptcl_parser));
@@ -1611,535 +1924,1241 @@ ptcl_parser *ptcl_parser_create(ptcl_tokens_list *input, ptcl_lexer_configuratio
 
     parser->configuration = configuration;
     parser->input = input;
+    parser->stats = NULL;
+    parser->profile = NULL;
+    parser->trace = NULL;
+    parser->jobs = 1;
+    parser->interpreter = NULL;
+    parser->is_recycled = false;
+    parser->modules = NULL;
+    parser->is_expanded = false;
+    parser->imported = NULL;
+    parser->imported_capacity = 0;
+    parser->prelude = NULL;
+    parser->prelude_root = NULL;
+    parser->prelude_imported = NULL;
+    parser->prelude_hidden_built_in_types = 0;
+    parser->prelude_hash = 0;
+    parser->is_prelude_set = false;
+    parser->is_prelude = false;
+    parser->base = (ptcl_parser_base){0};
+    parser->is_imports = false;
+    parser->is_imports_parsed = false;
+    parser->is_imports_saved = false;
+    parser->imports_count = 0;
+    parser->imports_snapshot = NULL;
+    parser->incremental = NULL;
+    parser->each_slots = (ptcl_parser_each_slots){.variable = (size_t)-1};
+    parser->syntax_starts = (ptcl_parser_syntax_starts){0};
     return parser;
 }
 
-static void ptcl_parser_reset(ptcl_parser *parser)
+void ptcl_parser_set_input(ptcl_parser *parser, ptcl_tokens_list *input)
 {
-    parser->state = (ptcl_parser_status){0};
-    parser->temp = (ptcl_parser_temp){0};
-    parser->errors = (ptcl_error_array){0};
-    parser->syntaxes = (ptcl_syntax_array){0};
-    parser->typedatas = (ptcl_typedata_array){0};
-    parser->comp_types = (ptcl_comptype_array){0};
-    parser->functions = (ptcl_function_array){0};
-    parser->variables = (ptcl_variable_array){0};
-    parser->lated_states = (ptcl_lated_states_array){0};
-    parser->this_pairs = (ptcl_this_pairs_array){0};
+    parser->input = input;
+}
 
-    parser->syntaxes.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->comp_types.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->typedatas.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->functions.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->variables.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->lated_states.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
-    parser->interpreter = ptcl_interpreter_create(parser);
-    if (parser->interpreter == NULL)
-    {
-        goto cleanup;
-    }
+void ptcl_parser_set_incremental(ptcl_parser *parser, ptcl_incremental *incremental)
+{
+    parser->incremental = incremental;
+}
 
-    parser->syntaxes.items = malloc(parser->syntaxes.capacity * sizeof(ptcl_parser_syntax));
-    if (parser->syntaxes.items == NULL)
+void ptcl_parser_set_stats(ptcl_parser *parser, ptcl_parser_stats *stats)
+{
+    parser->stats = stats;
+}
+
+ptcl_parser_stats *ptcl_parser_get_stats(ptcl_parser *parser)
+{
+    return parser->stats;
+}
+
+void ptcl_parser_set_profile(ptcl_parser *parser, ptcl_parser_profile *profile)
+{
+    parser->profile = profile;
+}
+
+ptcl_parser_profile *ptcl_parser_get_profile(ptcl_parser *parser)
+{
+    return parser->profile;
+}
+
+ptcl_parser_profile_entry *ptcl_parser_profile_at(ptcl_parser_profile *profile, size_t index)
+{
+    if (index >= profile->count || profile->entries[index].type == ptcl_parser_profile_none_type)
     {
-        goto cleanup;
+        return NULL;
     }
 
-    parser->comp_types.items = malloc(parser->comp_types.capacity * sizeof(ptcl_parser_comp_type));
-    if (parser->comp_types.items == NULL)
+    return &profile->entries[index];
+}
+
+void ptcl_parser_profile_destroy(ptcl_parser_profile *profile)
+{
+    for (size_t i = 0; i < profile->count; i++)
     {
-        goto cleanup;
+        free(profile->entries[i].name);
     }
 
-    parser->typedatas.items = malloc(parser->typedatas.capacity * sizeof(ptcl_parser_typedata));
-    if (parser->typedatas.items == NULL)
-        goto cleanup;
+    free(profile->entries);
+    profile->entries = NULL;
+    profile->count = 0;
+}
 
-    parser->functions.items = malloc(parser->functions.capacity * sizeof(ptcl_parser_function));
-    if (parser->functions.items == NULL)
+void ptcl_parser_set_trace(ptcl_parser *parser, ptcl_trace *trace)
+{
+    parser->trace = trace;
+}
+
+void ptcl_parser_set_jobs(ptcl_parser *parser, size_t jobs)
+{
+    parser->jobs = jobs == 0 ? ptcl_thread_hardware_count() : jobs;
+}
+
+ptcl_trace *ptcl_parser_get_trace(ptcl_parser *parser)
+{
+    return parser->trace;
+}
+
+static void ptcl_parser_trace_declaration(ptcl_parser *parser, ptcl_statement *statement, uint64_t start)
+{
+    if (statement == NULL)
     {
-        goto cleanup;
+        ptcl_trace_add(parser->trace, "parser", "declaration", NULL, start);
+        return;
     }
 
-    parser->variables.items = malloc(parser->variables.capacity * sizeof(ptcl_parser_variable));
-    if (parser->variables.items == NULL)
+    switch (statement->type)
     {
-        goto cleanup;
+    case ptcl_statement_func_decl_type:
+        ptcl_trace_add(parser->trace, "parser", "function", statement->func_decl.name.value, start);
+        break;
+    case ptcl_statement_typedata_decl_type:
+        ptcl_trace_add(parser->trace, "parser", "typedata", statement->typedata_decl.name.value, start);
+        break;
+    case ptcl_statement_type_decl_type:
+        ptcl_trace_add(parser->trace, "parser", "type", statement->type_decl.name.value, start);
+        break;
+    default:
+        ptcl_trace_add(parser->trace, "parser", "statement", NULL, start);
+        break;
     }
+}
 
-    parser->lated_states.items = malloc(parser->lated_states.capacity * sizeof(ptcl_parser_tokens_state));
-    if (parser->lated_states.items == NULL)
+static void ptcl_parser_stats_add_expression(ptcl_parser_stats *stats, ptcl_expression *expression);
+
+static void ptcl_parser_stats_add_body(ptcl_parser_stats *stats, ptcl_func_body body);
+
+static void ptcl_parser_stats_add_func_call(ptcl_parser_stats *stats, ptcl_statement_func_call func_call)
+{
+    if (!func_call.identifier.is_name)
     {
-        goto cleanup;
+        ptcl_parser_stats_add_expression(stats, func_call.identifier.value);
     }
 
-    ptcl_parser_enable_state(parser, ptcl_parser_add_errors_flag);
-    ptcl_parser_enable_state(parser, ptcl_parser_in_syntax_flag);
-    return;
-cleanup:
-    ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-    if (parser->interpreter != NULL)
+    for (size_t i = 0; i < func_call.count; i++)
     {
-        ptcl_interpreter_destroy(parser->interpreter);
+        ptcl_parser_stats_add_expression(stats, func_call.arguments[i]);
     }
 
-    free(parser->syntaxes.items);
-    free(parser->comp_types.items);
-    free(parser->typedatas.items);
-    free(parser->functions.items);
-    free(parser->variables.items);
-    free(parser->lated_states.items);
+    if (func_call.built_in != NULL)
+    {
+        ptcl_parser_stats_add_expression(stats, func_call.built_in);
+    }
 }
 
-ptcl_parser_result ptcl_parser_parse(ptcl_parser *parser)
+static void ptcl_parser_stats_add_statement(ptcl_parser_stats *stats, ptcl_statement *statement)
 {
-    ptcl_parser_reset(parser);
-    if (ptcl_parser_critical(parser))
+    stats->statements_count++;
+    stats->nodes_bytes += sizeof(ptcl_statement);
+    if (!statement->is_original)
     {
-        goto out_of_memory;
+        return;
     }
 
-    SETUP_STATIC_ANY();
-    CREATE_TOKEN_TYPE();
-    CREATE_STATEMENT_TYPE();
-    CREATE_EXPRESSION_TYPE();
-    CREATE_GET_STATEMENTS_FUNC();
-    CREATE_DEFINED_FUNC();
-    CREATE_ERROR_FUNC();
-    CREATE_INSERT_FUNC();
+    switch (statement->type)
+    {
+    case ptcl_statement_func_call_type:
+        ptcl_parser_stats_add_func_call(stats, statement->func_call);
+        break;
+    case ptcl_statement_func_decl_type:
+        if (statement->func_decl.func_body != NULL && !ptcl_statement_modifiers_flags_prototype(statement->func_decl.modifiers))
+        {
+            ptcl_parser_stats_add_body(stats, *statement->func_decl.func_body);
+        }
 
-    ptcl_parser_set_tokens(parser, parser->input->tokens);
-    ptcl_parser_set_count(parser, parser->input->count);
-    ptcl_parser_result result = {
-        .configuration = parser->configuration,
-        .body = ptcl_parser_func_body(
-            parser, false, true, ptcl_parser_ignore_error(parser)),
-        .errors = parser->errors.items,
-        .errors_count = parser->errors.count,
-        .syntaxes = parser->syntaxes.items,
-        .syntaxes_count = parser->syntaxes.count,
-        .comp_types = parser->comp_types.items,
-        .comp_types_count = parser->comp_types.count,
-        .typedatas = parser->typedatas.items,
-        .typedatas_count = parser->typedatas.count,
-        .functions = parser->functions.items,
-        .functions_count = parser->functions.count,
-        .variables = parser->variables.items,
-        .variables_count = parser->variables.count,
-        .lated_states = parser->lated_states.items,
-        .lated_states_count = parser->lated_states.count,
-        .this_pairs = parser->this_pairs.items,
-        .this_pairs_count = parser->this_pairs.count,
-        .is_critical = ptcl_parser_critical(parser)};
-
-    goto success;
-
-out_of_memory:
-    ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-    result = (ptcl_parser_result){
-        .body = ptcl_func_body_create(NULL, 0, NULL),
-        .errors_count = 1,
-        .errors = parser->errors.items,
-        .syntaxes = parser->syntaxes.items,
-        .syntaxes_count = parser->syntaxes.count,
-        .comp_types = parser->comp_types.items,
-        .comp_types_count = parser->comp_types.count,
-        .typedatas = parser->typedatas.items,
-        .typedatas_count = parser->typedatas.count,
-        .functions = parser->functions.items,
-        .functions_count = parser->functions.count,
-        .variables = parser->variables.items,
-        .variables_count = parser->variables.count,
-        .lated_states = NULL,
-        .lated_states_count = 0,
-        .is_critical = ptcl_parser_critical(parser)};
-
-success:
-    CLEANUP_BUILDERS();
-    return result;
-}
-
-bool ptcl_parser_parse_get_statement(ptcl_parser *parser, ptcl_parser_statement_info *info)
-{
-    for (size_t i = 0; i < PTCL_PARSER_MAX_MODIFIERS_RECURSION; i++)
-    {
-        bool is_modifier = true;
-        ptcl_token current = ptcl_parser_current(parser);
-        ptcl_statement_modifiers *modifiers = &info->modifiers;
-        switch (current.type)
+        break;
+    case ptcl_statement_type_decl_type:
+        if (statement->type_decl.body != NULL)
         {
-        case ptcl_token_prototype_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_prototype_flag);
-            break;
-        case ptcl_token_const_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_const_flag);
-            break;
-        case ptcl_token_global_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_global_flag);
-            break;
-        case ptcl_token_static_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_static_flag);
-            break;
-        case ptcl_token_auto_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_auto_flag);
-            break;
-        case ptcl_token_caret_type:
-            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_injection_flag);
-            break;
-        default:
-            is_modifier = false;
-            break;
+            ptcl_parser_stats_add_body(stats, *statement->type_decl.body);
         }
 
-        if (!is_modifier)
+        break;
+    case ptcl_statement_return_type:
+        ptcl_parser_stats_add_expression(stats, statement->ret.value);
+        break;
+    case ptcl_statement_assign_type:
+        ptcl_parser_stats_add_expression(stats, statement->assign.value);
+        if (!statement->assign.identifier.is_name)
         {
-            break;
+            ptcl_parser_stats_add_expression(stats, statement->assign.identifier.value);
         }
 
-        ptcl_parser_skip(parser);
-    }
-
-    ptcl_token current = ptcl_parser_current(parser);
-    ptcl_statement_type *type = &info->type;
-    switch (current.type)
-    {
-    case ptcl_token_tilde_type:
-    case ptcl_token_word_word_type:
-    case ptcl_token_exclamation_mark_type:
-    case ptcl_token_word_type:
-    {
-        ptcl_token current = ptcl_parser_current(parser);
-        info->name = ptcl_parser_name(parser, false);
-        if (ptcl_parser_critical(parser))
+        break;
+    case ptcl_statement_if_type:
+        ptcl_parser_stats_add_expression(stats, statement->if_stat.condition);
+        ptcl_parser_stats_add_body(stats, statement->if_stat.body);
+        if (statement->if_stat.with_else)
         {
-            return false;
+            ptcl_parser_stats_add_body(stats, statement->if_stat.else_body);
         }
 
-        ptcl_token next = ptcl_parser_current(parser);
-        switch (next.type)
-        {
-        case ptcl_token_colon_type:
-        case ptcl_token_equals_type:
-            *type = ptcl_statement_assign_type;
-            break;
-        case ptcl_token_dot_type:
-        {
-            ptcl_expression *left = ptcl_parser_func_call_or_var(parser, info->name, current, ptcl_parser_expression_ignore_excepted_flag, false);
-            if (left == NULL)
-            {
-                break;
-            }
-
-            info->expression = ptcl_parser_dot(parser, NULL, left, ptcl_parser_expression_flags_default(false));
-            if (ptcl_parser_critical(parser))
-            {
-                break;
-            }
+        break;
+    case ptcl_statement_func_body_type:
+        ptcl_parser_stats_add_body(stats, statement->body.body);
+        break;
+    default:
+        break;
+    }
+}
 
-            switch (ptcl_parser_current(parser).type)
-            {
-            case ptcl_token_equals_type:
-                *type = ptcl_statement_assign_type;
-                break;
-            default:
-                // Can be already evaluated function with static void return type
-                if (info->expression == NULL)
-                {
-                    *type = ptcl_statement_none_type;
-                }
+static void ptcl_parser_stats_add_body(ptcl_parser_stats *stats, ptcl_func_body body)
+{
+    for (size_t i = 0; i < body.count; i++)
+    {
+        ptcl_parser_stats_add_statement(stats, body.statements[i]);
+    }
+}
 
-                *type = ptcl_statement_func_call_type;
-                break;
-            }
+static void ptcl_parser_stats_add_expression(ptcl_parser_stats *stats, ptcl_expression *expression)
+{
+    if (expression == NULL)
+    {
+        return;
+    }
 
-            break;
-        }
-        default:
-            *type = ptcl_statement_func_call_type;
-            break;
-        }
+    stats->expressions_count++;
+    stats->nodes_bytes += sizeof(ptcl_expression);
+    if (!expression->is_original)
+    {
+        return;
+    }
 
+    switch (expression->type)
+    {
+    case ptcl_expression_func_call_type:
+        stats->nodes_bytes += sizeof(ptcl_statement_func_call);
+        ptcl_parser_stats_add_func_call(stats, *expression->func_call);
         break;
-    }
-    case ptcl_token_at_type:
-        if (ptcl_parser_peek(parser, 1).type == ptcl_token_left_curly_type)
+    case ptcl_expression_array_type:
+        stats->nodes_bytes += sizeof(ptcl_expression_array);
+        for (size_t i = 0; i < expression->array->count; i++)
         {
-            *type = ptcl_statement_func_body_type;
-            break;
+            ptcl_parser_stats_add_expression(stats, expression->array->expressions[i]);
         }
 
         break;
-    case ptcl_token_auto_type:
-    case ptcl_token_optional_type:
-        *type = ptcl_statement_type_decl_type;
-        break;
-    case ptcl_token_return_type:
-        *type = ptcl_statement_return_type;
+    case ptcl_expression_string_type:
+        stats->nodes_bytes += expression->string.length + 1;
         break;
-    case ptcl_token_if_type:
-        *type = ptcl_statement_if_type;
+    case ptcl_expression_binary_type:
+        ptcl_parser_stats_add_expression(stats, expression->binary.left);
+        ptcl_parser_stats_add_expression(stats, expression->binary.right);
         break;
-    case ptcl_token_each_type:
-        *type = ptcl_statement_each_type;
+    case ptcl_expression_cast_type:
+        stats->nodes_bytes += sizeof(ptcl_expression_cast);
+        ptcl_parser_stats_add_expression(stats, expression->cast->value);
         break;
-    case ptcl_token_syntax_type:
-        *type = ptcl_statement_syntax_type;
+    case ptcl_expression_unary_type:
+        ptcl_parser_stats_add_expression(stats, expression->unary.child);
         break;
-    case ptcl_token_unsyntax_type:
-        *type = ptcl_statement_unsyntax_type;
+    case ptcl_expression_dot_type:
+        ptcl_parser_stats_add_expression(stats, expression->dot.left);
+        if (!expression->dot.is_name)
+        {
+            ptcl_parser_stats_add_expression(stats, expression->dot.right);
+        }
+
         break;
-    case ptcl_token_undefine_type:
-        *type = ptcl_statement_undefine_type;
+    case ptcl_expression_ctor_type:
+        stats->nodes_bytes += sizeof(ptcl_expression_ctor);
+        for (size_t i = 0; i < expression->ctor->count; i++)
+        {
+            ptcl_parser_stats_add_expression(stats, expression->ctor->values[i]);
+        }
+
         break;
-    case ptcl_token_type_type:
-        *type = ptcl_statement_type_decl_type;
+    case ptcl_expression_if_type:
+        ptcl_parser_stats_add_expression(stats, expression->if_expr.condition);
+        ptcl_parser_stats_add_expression(stats, expression->if_expr.body);
+        ptcl_parser_stats_add_expression(stats, expression->if_expr.else_body);
         break;
-    case ptcl_token_typedata_type:
-        *type = ptcl_statement_typedata_decl_type;
+    case ptcl_expression_array_element_type:
+        ptcl_parser_stats_add_expression(stats, expression->array_element.value);
+        ptcl_parser_stats_add_expression(stats, expression->array_element.index);
         break;
-    case ptcl_token_function_type:
-        *type = ptcl_statement_func_decl_type;
+    case ptcl_expression_in_statement_type:
+        ptcl_parser_stats_add_statement(stats, expression->internal_statement);
         break;
     default:
-        return false;
+        break;
     }
-
-    return true;
 }
 
-static ptcl_statement *ptcl_parser_syntax_stat(ptcl_parser *parser)
+// Syntaxes have no names, so they are presented by their pattern
+static char *ptcl_parser_profile_syntax_name(ptcl_parser_syntax *syntax)
 {
-    size_t depth = parser->state.syntax_depth;
-    ptcl_attributes attributes = ptcl_parser_parse_attributes(parser);
-    if (ptcl_parser_critical(parser))
+    char *name = ptcl_string_duplicate("");
+    for (size_t i = 0; i < syntax->count && name != NULL; i++)
     {
-        return NULL;
+        ptcl_parser_syntax_node node = syntax->nodes[i];
+        const char *separator = i != syntax->count - 1 ? " " : "";
+        if (node.type == ptcl_parser_syntax_node_word_type)
+        {
+            name = ptcl_string_append(name, node.word.name.value, separator, NULL);
+        }
+        else if (node.type == ptcl_parser_syntax_node_variable_type)
+        {
+            name = ptcl_string_append(name, "[", node.variable.name, "]", separator, NULL);
+        }
+        else
+        {
+            name = ptcl_string_append(name, "[]", separator, NULL);
+        }
     }
 
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_statement *statement = NULL;
-    if (!ptcl_parser_in_type(parser))
+    return name;
+}
+
+static ptcl_parser_profile_entry *ptcl_parser_profile_add(
+    ptcl_parser *parser, size_t index, ptcl_parser_profile_type type, ptcl_parser_syntax *syntax, char *name)
+{
+    ptcl_parser_profile *profile = parser->profile;
+    if (index >= profile->count)
     {
-        statement = ptcl_statement_create(ptcl_statement_func_body_type, ptcl_parser_root(parser), attributes, location);
-        if (statement == NULL)
+        size_t count = profile->count == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : profile->count;
+        while (count <= index)
         {
-            ptcl_attributes_destroy(attributes);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            return NULL;
+            count *= 2;
         }
-    }
 
-    ptcl_func_body body = ptcl_func_body_create(
-        NULL, 0,
-        parser->temp.inserted_body == NULL                           ? parser->temp.main_root
-        : parser->temp.inserted_body->root == parser->temp.main_root ? parser->temp.inserted_body
-                                                                     : parser->temp.main_root);
-    ptcl_parser_func_body_by_pointer(parser, &body, false, false, ptcl_parser_ignore_error(parser));
-    if (parser->state.syntax_depth == depth)
-    {
-        ptcl_parser_leave_from_syntax(parser);
-    }
+        ptcl_parser_profile_entry *buffer = realloc(profile->entries, count * sizeof(ptcl_parser_profile_entry));
+        if (buffer == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            return NULL;
+        }
 
-    if (ptcl_parser_critical(parser))
-    {
-        free(statement);
-        ptcl_attributes_destroy(attributes);
-        return NULL;
+        memset(buffer + profile->count, 0, (count - profile->count) * sizeof(ptcl_parser_profile_entry));
+        profile->entries = buffer;
+        profile->count = count;
     }
 
-    if (ptcl_parser_in_type(parser))
+    ptcl_parser_profile_entry *entry = &profile->entries[index];
+    if (entry->type == ptcl_parser_profile_none_type)
     {
-        ptcl_func_body *previous = ptcl_parser_root(parser);
-        parser->temp.root = body.root;
-
-        ptcl_func_body *root_body = ptcl_parser_root(parser);
-        size_t new_count = root_body->count + body.count;
-        ptcl_statement **new_statements = realloc(root_body->statements,
-                                                  sizeof(ptcl_statement *) * new_count);
-        if (new_statements == NULL && new_count > 0)
+        entry->name = syntax != NULL ? ptcl_parser_profile_syntax_name(syntax) : ptcl_string_duplicate(name);
+        if (entry->name == NULL)
         {
-            ptcl_func_body_destroy(body);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            parser->temp.root = previous;
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
             return NULL;
         }
 
-        for (size_t i = 0; i < body.count; i++)
+        entry->type = type;
+    }
+
+    return entry;
+}
+
+static size_t ptcl_parser_profile_count_nodes(ptcl_func_body body)
+{
+    ptcl_parser_stats counter = {0};
+    ptcl_parser_stats_add_body(&counter, body);
+    return counter.statements_count + counter.expressions_count;
+}
+
+// Checks cost about hundred cycles and are a fraction of percent of parsing, so they are counted, not memoized
+static inline bool ptcl_parser_is_castable(ptcl_parser *parser, ptcl_type expected, ptcl_type target)
+{
+    PTCL_STATS_ADD(parser->stats, cast_checks, 1);
+    return ptcl_type_is_castable(expected, target);
+}
+
+static inline void ptcl_parser_count_lookup(ptcl_parser *parser, size_t scanned)
+{
+    PTCL_STATS_ADD(parser->stats, lookups_count, 1);
+    PTCL_STATS_ADD(parser->stats, lookups_scanned, scanned);
+}
+
+// Registry is shared by all parsers, so types removed by undefine are only hidden for this one
+static bool ptcl_parser_try_get_built_in_type(ptcl_parser *parser, ptcl_name name, size_t scanned, ptcl_parser_comp_type **instance)
+{
+    for (size_t i = 0; i < PTCL_PARSER_BUILT_IN_TYPES_COUNT; i++)
+    {
+        if ((parser->hidden_built_in_types & (1u << i)) != 0 || !ptcl_name_compare(ptcl_parser_built_in_types[i].identifier, name))
         {
-            new_statements[i + root_body->count] = body.statements[i];
+            continue;
         }
 
-        free(body.statements);
-        root_body->statements = new_statements;
-        root_body->count = new_count;
-        parser->temp.root = previous;
-    }
-    else
-    {
-        statement->body = ptcl_statement_func_body_create_by_body(body);
+        ptcl_parser_count_lookup(parser, scanned + i + 1);
+        *instance = (ptcl_parser_comp_type *)&ptcl_parser_built_in_types[i];
+        return true;
     }
 
-    return statement;
+    ptcl_parser_count_lookup(parser, scanned + PTCL_PARSER_BUILT_IN_TYPES_COUNT);
+    return false;
 }
 
-ptcl_statement *ptcl_parser_parse_statement(ptcl_parser *parser)
+// Types of prelude are only read, so they are shared by interner of each parse
+static ptcl_type_interner *ptcl_parser_create_types(ptcl_parser *parser)
 {
-    if (ptcl_parser_parse_try_syntax_usage_here(parser, true))
+    return parser->prelude != NULL ? ptcl_type_interner_create_local(parser->prelude->types) : ptcl_type_interner_create();
+}
+
+static void ptcl_parser_reset(ptcl_parser *parser)
+{
+    parser->state = (ptcl_parser_status){0};
+    parser->temp = (ptcl_parser_temp){0};
+    parser->syntax_starts.is_built = false;
+    parser->deferred_bodies = (ptcl_deferred_bodies_array){0};
+    parser->hidden_built_in_types = 0;
+    if (parser->is_recycled)
+    {
+        parser->is_recycled = false;
+        parser->errors.count = 0;
+        parser->syntaxes.count = 0;
+        parser->typedatas.count = 0;
+        parser->comp_types.count = 0;
+        parser->functions.count = 0;
+        parser->variables.count = 0;
+        parser->lated_states.count = 0;
+        parser->this_pairs.count = 0;
+        if (parser->types == NULL)
+        {
+            parser->types = ptcl_parser_create_types(parser);
+            if (parser->types == NULL)
+            {
+                goto cleanup;
+            }
+        }
+
+        ptcl_parser_enable_state(parser, ptcl_parser_add_errors_flag);
+        ptcl_parser_enable_state(parser, ptcl_parser_in_syntax_flag);
+        return;
+    }
+
+    parser->errors = (ptcl_error_array){0};
+    parser->syntaxes = (ptcl_syntax_array){0};
+    parser->typedatas = (ptcl_typedata_array){0};
+    parser->comp_types = (ptcl_comptype_array){0};
+    parser->functions = (ptcl_function_array){0};
+    parser->variables = (ptcl_variable_array){0};
+    parser->lated_states = (ptcl_lated_states_array){0};
+    parser->this_pairs = (ptcl_this_pairs_array){0};
+    parser->arena = NULL;
+    parser->types = NULL;
+
+    parser->syntaxes.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    parser->comp_types.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    parser->typedatas.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    parser->functions.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    parser->variables.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    parser->lated_states.capacity = PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY;
+    // Interpreter keeps nothing between evaluations, so it lives as long as parser
+    if (parser->interpreter == NULL)
     {
-        return ptcl_parser_syntax_stat(parser);
+        parser->interpreter = ptcl_interpreter_create(parser);
+        if (parser->interpreter == NULL)
+        {
+            goto cleanup;
+        }
     }
 
-    if (ptcl_parser_critical(parser))
+    parser->syntaxes.items = malloc(parser->syntaxes.capacity * sizeof(ptcl_parser_syntax));
+    if (parser->syntaxes.items == NULL)
     {
-        return NULL;
+        goto cleanup;
     }
 
-    ptcl_attributes attributes = ptcl_parser_parse_attributes(parser);
-    if (ptcl_parser_critical(parser))
+    parser->comp_types.items = malloc(parser->comp_types.capacity * sizeof(ptcl_parser_comp_type));
+    if (parser->comp_types.items == NULL)
     {
-        return NULL;
+        goto cleanup;
     }
 
-    ptcl_statement *statement = NULL;
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_parser_statement_info info = ptcl_parser_statement_info_default(parser);
-    if (!ptcl_parser_parse_get_statement(parser, &info))
+    parser->typedatas.items = malloc(parser->typedatas.capacity * sizeof(ptcl_parser_typedata));
+    if (parser->typedatas.items == NULL)
+        goto cleanup;
+
+    parser->functions.items = malloc(parser->functions.capacity * sizeof(ptcl_parser_function));
+    if (parser->functions.items == NULL)
     {
-        ptcl_attributes_destroy(attributes);
-        ptcl_parser_throw_unknown_statement(parser, location);
-        return NULL;
+        goto cleanup;
     }
 
-    ptcl_statement_type type = info.type;
-    // Already parsed in get_statement or just non sense things
-    if (type == ptcl_statement_none_type)
+    parser->variables.items = malloc(parser->variables.capacity * sizeof(ptcl_parser_variable));
+    if (parser->variables.items == NULL)
     {
-        ptcl_attributes_destroy(attributes);
-        return NULL;
+        goto cleanup;
     }
 
-    const bool with_own_statement = ptcl_statement_with_own_statement(type);
-    const ptcl_statement_modifiers modifiers = info.modifiers;
-    ptcl_expression *expression = info.expression;
-    ptcl_name name = info.name;
+    parser->lated_states.items = malloc(parser->lated_states.capacity * sizeof(ptcl_parser_tokens_state));
+    if (parser->lated_states.items == NULL)
+    {
+        goto cleanup;
+    }
 
-    // "If" will parse new statement anyway
-    if (with_own_statement && type != ptcl_statement_if_type)
+    parser->arena = ptcl_arena_create(PTCL_ARENA_DEFAULT_CHUNK_SIZE);
+    if (parser->arena == NULL)
     {
-        statement = ptcl_statement_create(type, ptcl_parser_root(parser), attributes, location);
-        if (statement == NULL)
-        {
-            ptcl_attributes_destroy(attributes);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            return NULL;
-        }
+        goto cleanup;
     }
 
-    switch (type)
+    parser->types = ptcl_parser_create_types(parser);
+    if (parser->types == NULL)
     {
-    case ptcl_statement_func_call_type:
+        goto cleanup;
+    }
+
+    ptcl_parser_enable_state(parser, ptcl_parser_add_errors_flag);
+    ptcl_parser_enable_state(parser, ptcl_parser_in_syntax_flag);
+    return;
+cleanup:
+    ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+    free(parser->syntaxes.items);
+    free(parser->comp_types.items);
+    free(parser->typedatas.items);
+    free(parser->functions.items);
+    free(parser->variables.items);
+    free(parser->lated_states.items);
+    free(parser->this_pairs.items);
+    parser->syntaxes = (ptcl_syntax_array){0};
+    parser->comp_types = (ptcl_comptype_array){0};
+    parser->typedatas = (ptcl_typedata_array){0};
+    parser->functions = (ptcl_function_array){0};
+    parser->variables = (ptcl_variable_array){0};
+    parser->lated_states = (ptcl_lated_states_array){0};
+    parser->this_pairs = (ptcl_this_pairs_array){0};
+    ptcl_arena_destroy(parser->arena);
+    parser->arena = NULL;
+    ptcl_type_interner_destroy(parser->types);
+    parser->types = NULL;
+}
+
+static bool ptcl_parser_create_modules(ptcl_parser *parser)
+{
+    if (parser->modules == NULL)
     {
-        bool is_null = false;
-        if (!ptcl_parser_func_call_stat(parser, &statement, expression, name, modifiers, &is_null))
+        parser->modules = ptcl_modules_create(parser->configuration);
+    }
+
+    return parser->modules != NULL;
+}
+
+// Modules are inserted before brackets are paired, so they are parsed as part of input.
+// Leading imports, which are in prelude of imports, are skipped, their modules aren't inserted again
+static bool ptcl_parser_import(ptcl_parser *parser)
+{
+    ptcl_tokens_list *input = parser->input;
+    ptcl_tokens_list rest = *input;
+    rest.tokens += parser->imports_count;
+    rest.count -= parser->imports_count;
+    parser->is_expanded = parser->imports_count > 0;
+    if (!ptcl_modules_has_imports(rest.tokens, rest.count))
+    {
+        ptcl_parser_set_tokens(parser, rest.tokens);
+        ptcl_parser_set_count(parser, rest.count);
+        return true;
+    }
+
+    if (!ptcl_parser_create_modules(parser))
+    {
+        ptcl_parser_throw_out_of_memory(parser, rest.tokens[0].location);
+        return false;
+    }
+
+    size_t count;
+    ptcl_modules_failure failure;
+    const bool is_expanded =
+        parser->imports_count > 0
+            ? ptcl_modules_expand_next(parser->modules, &rest, &parser->imported, &parser->imported_capacity, &count, &failure)
+            : ptcl_modules_expand(parser->modules, &rest, &parser->imported, &parser->imported_capacity, &count, &failure);
+    if (!is_expanded)
+    {
+        if (failure.path == NULL)
         {
-            // Statememnt, expression and name already destroyed above
-            ptcl_attributes_destroy(attributes);
-            return NULL;
+            ptcl_parser_throw_out_of_memory(parser, failure.location);
         }
-
-        if (is_null)
+        else
         {
-            // Attributes will be destroyed below
-            statement = NULL;
+            ptcl_parser_throw_unknown_module(parser, failure.path, failure.location);
         }
 
-        // Statement is parsed in function above
-        break;
+        return false;
     }
-    case ptcl_statement_func_decl_type:
-        statement->func_decl = ptcl_parser_func_decl(parser, modifiers);
-        break;
-    case ptcl_statement_typedata_decl_type:
-        statement->typedata_decl = ptcl_parser_typedata_decl(parser, modifiers);
-        break;
-    case ptcl_statement_type_decl_type:
-        statement->type_decl = ptcl_parser_type_decl(parser, modifiers);
-        break;
-    case ptcl_statement_assign_type:
-        statement->assign = ptcl_parser_assign(parser, name, expression, modifiers);
 
-        // By dot
-        if (!ptcl_parser_critical(parser) && !statement->assign.identifier.is_name && statement->assign.identifier.value->return_type.is_static)
+    ptcl_parser_set_tokens(parser, parser->imported);
+    ptcl_parser_set_count(parser, count);
+    parser->is_expanded = true;
+    return true;
+}
+
+size_t ptcl_parser_imported_count(ptcl_parser *parser)
+{
+    return parser->is_expanded ? ptcl_modules_imported_count(parser->modules) : 0;
+}
+
+char *ptcl_parser_imported_path(ptcl_parser *parser, size_t index)
+{
+    return ptcl_modules_imported_path(parser->modules, index);
+}
+
+static void ptcl_parser_move_roots(ptcl_parser *parser, ptcl_func_body *from, ptcl_func_body *to)
+{
+    for (size_t i = 0; i < parser->syntaxes.count; i++)
+    {
+        if (parser->syntaxes.items[i].root == from)
         {
-            ptcl_expression_destroy(statement->assign.identifier.value);
-            ptcl_attributes_destroy(attributes);
-            free(statement);
-            return NULL;
+            parser->syntaxes.items[i].root = to;
         }
+    }
 
-        break;
-    case ptcl_statement_return_type:
-        statement->ret = ptcl_parser_return(parser);
-        break;
-    case ptcl_statement_if_type:
-        statement = ptcl_parser_if(parser, ptcl_statement_modifiers_flags_static(modifiers));
-        break;
-    case ptcl_statement_unsyntax_type:
-        statement->type = ptcl_statement_func_body_type;
-        statement->body = ptcl_parser_unsyntax(parser);
-        break;
-    case ptcl_statement_each_type:
-        ptcl_parser_each(parser);
-        break;
-    case ptcl_statement_syntax_type:
-        ptcl_parser_syntax_decl(parser);
-        break;
-    case ptcl_statement_undefine_type:
-        ptcl_parser_undefine(parser);
-        break;
-    case ptcl_statement_func_body_type:
-        // If we in syntax, then it was already parsed
-        if (parser->state.syntax_depth == 0)
+    for (size_t i = 0; i < parser->typedatas.count; i++)
+    {
+        if (parser->typedatas.items[i].root == from)
         {
-            ptcl_parser_extra_body(parser, false);
+            parser->typedatas.items[i].root = to;
         }
-        else
+    }
+
+    for (size_t i = 0; i < parser->comp_types.count; i++)
+    {
+        if (parser->comp_types.items[i].root == from)
         {
-            ptcl_parser_skip(parser); // Skip '@'
-            ptcl_parser_skip(parser); // Skip '{'
-            ptcl_parser_skip_block_or_expression(parser);
+            parser->comp_types.items[i].root = to;
         }
-
-        break;
-    case ptcl_statement_import_type:
-    case ptcl_statement_none_type:
-        break;
     }
 
-    if (ptcl_parser_critical(parser))
+    for (size_t i = 0; i < parser->functions.count; i++)
     {
-        if (statement != NULL)
+        if (parser->functions.items[i].root == from)
         {
-            ptcl_attributes_destroy(attributes);
-            free(statement);
+            parser->functions.items[i].root = to;
         }
-
-        return NULL;
     }
 
-    // Syntax decl, body, static func call, if, or each
-    // They don't have own statement, so we skip
-    if (!with_own_statement || statement == NULL)
+    for (size_t i = 0; i < parser->variables.count; i++)
     {
-        ptcl_attributes_destroy(attributes);
-        return NULL;
+        if (parser->variables.items[i].root == from)
+        {
+            parser->variables.items[i].root = to;
+        }
     }
 
-    if (ptcl_parser_in_type(parser) && type != ptcl_statement_func_decl_type)
+    for (size_t i = 0; i < parser->this_pairs.count; i++)
     {
-        ptcl_attributes_destroy(attributes);
-        ptcl_parser_except(parser, ptcl_token_function_type);
-        return NULL;
+        if (parser->this_pairs.items[i].body == from)
+        {
+            parser->this_pairs.items[i].body = to;
+        }
+    }
+}
+
+// Copies instances of prelude to arrays of parser, they are owned by prelude and released only with it
+static bool ptcl_parser_enter_prelude(ptcl_parser *parser, ptcl_func_body *root)
+{
+    ptcl_parser_result *prelude = parser->prelude;
+    if (prelude == NULL)
+    {
+        return true;
+    }
+
+    if (!ptcl_parser_worker_extend((void **)&parser->syntaxes.items, &parser->syntaxes.count, &parser->syntaxes.capacity,
+                                   prelude->syntaxes, prelude->syntaxes_count, sizeof(ptcl_parser_syntax)) ||
+        !ptcl_parser_worker_extend((void **)&parser->typedatas.items, &parser->typedatas.count, &parser->typedatas.capacity,
+                                   prelude->typedatas, prelude->typedatas_count, sizeof(ptcl_parser_typedata)) ||
+        !ptcl_parser_worker_extend((void **)&parser->comp_types.items, &parser->comp_types.count, &parser->comp_types.capacity,
+                                   prelude->comp_types, prelude->comp_types_count, sizeof(ptcl_parser_comp_type)) ||
+        !ptcl_parser_worker_extend((void **)&parser->functions.items, &parser->functions.count, &parser->functions.capacity,
+                                   prelude->functions, prelude->functions_count, sizeof(ptcl_parser_function)) ||
+        !ptcl_parser_worker_extend((void **)&parser->variables.items, &parser->variables.count, &parser->variables.capacity,
+                                   prelude->variables, prelude->variables_count, sizeof(ptcl_parser_variable)) ||
+        !ptcl_parser_worker_extend((void **)&parser->lated_states.items, &parser->lated_states.count, &parser->lated_states.capacity,
+                                   prelude->lated_states, prelude->lated_states_count, sizeof(ptcl_parser_tokens_state)) ||
+        !ptcl_parser_worker_extend((void **)&parser->this_pairs.items, &parser->this_pairs.count, &parser->this_pairs.capacity,
+                                   prelude->this_pairs, prelude->this_pairs_count, sizeof(ptcl_parser_this_s_pair)))
+    {
+        // Result doesn't own copied instances, so they are forgotten
+        parser->syntaxes.count = 0;
+        parser->typedatas.count = 0;
+        parser->comp_types.count = 0;
+        parser->functions.count = 0;
+        parser->variables.count = 0;
+        parser->lated_states.count = 0;
+        parser->this_pairs.count = 0;
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        return false;
+    }
+
+    ptcl_parser_move_roots(parser, parser->prelude_root, root);
+    parser->hidden_built_in_types = parser->prelude_hidden_built_in_types;
+    return true;
+}
+
+// Statements of prelude are placed before statements of file, like they are written in it
+static void ptcl_parser_leave_prelude(ptcl_parser *parser, ptcl_func_body *body)
+{
+    ptcl_func_body prelude = parser->prelude->body;
+    if (prelude.count == 0)
+    {
+        return;
+    }
+
+    ptcl_statement **statements = malloc((prelude.count + body->count) * sizeof(ptcl_statement *));
+    if (statements == NULL)
+    {
+        ptcl_func_body_destroy(*body);
+        *body = ptcl_func_body_create(NULL, 0, NULL);
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        return;
+    }
+
+    memcpy(statements, prelude.statements, prelude.count * sizeof(ptcl_statement *));
+    if (body->count > 0)
+    {
+        memcpy(statements + prelude.count, body->statements, body->count * sizeof(ptcl_statement *));
+    }
+
+    free(body->statements);
+    body->statements = statements;
+    body->count += prelude.count;
+}
+
+ptcl_parser_result ptcl_parser_parse(ptcl_parser *parser)
+{
+    // Prelude of imports is parsed before reset, so arrays of parser are left for file
+    parser->imports_count = 0;
+    if (!parser->is_prelude)
+    {
+        ptcl_parser_use_imports(parser);
+    }
+
+    ptcl_parser_reset(parser);
+    if (ptcl_parser_critical(parser))
+    {
+        goto out_of_memory;
+    }
+
+    if (parser->profile != NULL)
+    {
+        ptcl_parser_profile_destroy(parser->profile);
+    }
+
+    ptcl_parser_set_tokens(parser, parser->input->tokens);
+    ptcl_parser_set_count(parser, parser->input->count);
+    const bool is_imported = ptcl_parser_import(parser);
+    parser->temp.main_tokens = ptcl_parser_tokens(parser);
+    if (parser->is_prelude)
+    {
+        parser->prelude_hash = ptcl_incremental_hash_tokens(ptcl_parser_tokens(parser), ptcl_parser_count(parser));
+    }
+
+    if (parser->incremental != NULL && !parser->is_prelude)
+    {
+        ptcl_incremental_begin(parser->incremental, parser->prelude != NULL ? parser->prelude_hash : 0);
+    }
+    if (parser->stats != NULL)
+    {
+        *parser->stats = (ptcl_parser_stats){0};
+        parser->stats->tokens_count = ptcl_parser_count(parser);
+    }
+
+    // Body is root of top-level instances, so it is parsed by its address
+    ptcl_func_body body = ptcl_func_body_create(NULL, 0, NULL);
+    const bool is_entered = ptcl_parser_enter_prelude(parser, &body);
+    if (is_entered && is_imported && ptcl_parser_pair_brackets(parser))
+    {
+        ptcl_parser_func_body_by_pointer(parser, &body, false, true, ptcl_parser_ignore_error(parser));
+    }
+
+    free(parser->deferred_bodies.items);
+    parser->deferred_bodies = (ptcl_deferred_bodies_array){0};
+    if (is_entered && parser->prelude != NULL && !ptcl_parser_critical(parser) && (!parser->is_prelude || parser->is_imports_parsed))
+    {
+        ptcl_parser_leave_prelude(parser, &body);
+    }
+
+    if (parser->is_prelude)
+    {
+        ptcl_parser_move_roots(parser, &body, &ptcl_parser_prelude_root);
+    }
+
+    ptcl_parser_result result = {
+        .configuration = parser->configuration,
+        .body = body,
+        .errors = parser->errors.items,
+        .errors_count = parser->errors.count,
+        .syntaxes = parser->syntaxes.items,
+        .syntaxes_count = parser->syntaxes.count,
+        .comp_types = parser->comp_types.items,
+        .comp_types_count = parser->comp_types.count,
+        .typedatas = parser->typedatas.items,
+        .typedatas_count = parser->typedatas.count,
+        .functions = parser->functions.items,
+        .functions_count = parser->functions.count,
+        .variables = parser->variables.items,
+        .variables_count = parser->variables.count,
+        .lated_states = parser->lated_states.items,
+        .lated_states_count = parser->lated_states.count,
+        .this_pairs = parser->this_pairs.items,
+        .this_pairs_count = parser->this_pairs.count,
+        .arena = parser->arena,
+        .types = parser->types,
+        .stats = parser->stats,
+        .prelude = is_entered ? parser->prelude : NULL,
+        .is_critical = ptcl_parser_critical(parser)};
+
+    if (result.stats != NULL)
+    {
+        if (!result.is_critical)
+        {
+            ptcl_parser_stats_add_body(result.stats, result.body);
+        }
+
+        result.stats->interned_types_count = ptcl_type_interner_count(parser->types);
+        result.stats->arena_bytes = ptcl_arena_get_stats(parser->arena).used;
+    }
+
+    goto success;
+
+out_of_memory:
+    ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+    result = (ptcl_parser_result){
+        .body = ptcl_func_body_create(NULL, 0, NULL),
+        .errors_count = 1,
+        .errors = parser->errors.items,
+        .syntaxes = parser->syntaxes.items,
+        .syntaxes_count = parser->syntaxes.count,
+        .comp_types = parser->comp_types.items,
+        .comp_types_count = parser->comp_types.count,
+        .typedatas = parser->typedatas.items,
+        .typedatas_count = parser->typedatas.count,
+        .functions = parser->functions.items,
+        .functions_count = parser->functions.count,
+        .variables = parser->variables.items,
+        .variables_count = parser->variables.count,
+        .lated_states = NULL,
+        .lated_states_count = 0,
+        .arena = NULL,
+        .types = NULL,
+        .stats = parser->stats,
+        .is_critical = ptcl_parser_critical(parser)};
+
+success:
+    return result;
+}
+
+bool ptcl_parser_parse_get_statement(ptcl_parser *parser, ptcl_parser_statement_info *info)
+{
+    for (size_t i = 0; i < PTCL_PARSER_MAX_MODIFIERS_RECURSION; i++)
+    {
+        bool is_modifier = true;
+        ptcl_token current = ptcl_parser_current(parser);
+        ptcl_statement_modifiers *modifiers = &info->modifiers;
+        switch (current.type)
+        {
+        case ptcl_token_prototype_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_prototype_flag);
+            break;
+        case ptcl_token_const_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_const_flag);
+            break;
+        case ptcl_token_global_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_global_flag);
+            break;
+        case ptcl_token_static_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_static_flag);
+            break;
+        case ptcl_token_auto_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_auto_flag);
+            break;
+        case ptcl_token_caret_type:
+            ptcl_statement_modifiers_flags_set(modifiers, ptcl_statement_modifiers_injection_flag);
+            break;
+        default:
+            is_modifier = false;
+            break;
+        }
+
+        if (!is_modifier)
+        {
+            break;
+        }
+
+        ptcl_parser_skip(parser);
+    }
+
+    ptcl_token current = ptcl_parser_current(parser);
+    ptcl_statement_type *type = &info->type;
+    switch (current.type)
+    {
+    case ptcl_token_tilde_type:
+    case ptcl_token_word_word_type:
+    case ptcl_token_exclamation_mark_type:
+    case ptcl_token_word_type:
+    {
+        ptcl_token current = ptcl_parser_current(parser);
+        info->name = ptcl_parser_name(parser, false);
+        if (ptcl_parser_critical(parser))
+        {
+            return false;
+        }
+
+        ptcl_token next = ptcl_parser_current(parser);
+        switch (next.type)
+        {
+        case ptcl_token_colon_type:
+        case ptcl_token_equals_type:
+            *type = ptcl_statement_assign_type;
+            break;
+        case ptcl_token_dot_type:
+        {
+            ptcl_expression *left = ptcl_parser_func_call_or_var(parser, info->name, current, ptcl_parser_expression_ignore_excepted_flag, false);
+            if (left == NULL)
+            {
+                break;
+            }
+
+            info->expression = ptcl_parser_dot(parser, NULL, left, ptcl_parser_expression_flags_default(false));
+            if (ptcl_parser_critical(parser))
+            {
+                break;
+            }
+
+            switch (ptcl_parser_current(parser).type)
+            {
+            case ptcl_token_equals_type:
+                *type = ptcl_statement_assign_type;
+                break;
+            default:
+                // Can be already evaluated function with static void return type
+                if (info->expression == NULL)
+                {
+                    *type = ptcl_statement_none_type;
+                }
+
+                *type = ptcl_statement_func_call_type;
+                break;
+            }
+
+            break;
+        }
+        default:
+            *type = ptcl_statement_func_call_type;
+            break;
+        }
+
+        break;
+    }
+    case ptcl_token_at_type:
+        if (ptcl_parser_peek(parser, 1).type == ptcl_token_left_curly_type)
+        {
+            *type = ptcl_statement_func_body_type;
+            break;
+        }
+
+        break;
+    case ptcl_token_auto_type:
+    case ptcl_token_optional_type:
+        *type = ptcl_statement_type_decl_type;
+        break;
+    case ptcl_token_return_type:
+        *type = ptcl_statement_return_type;
+        break;
+    case ptcl_token_if_type:
+        *type = ptcl_statement_if_type;
+        break;
+    case ptcl_token_each_type:
+        *type = ptcl_statement_each_type;
+        break;
+    case ptcl_token_syntax_type:
+        *type = ptcl_statement_syntax_type;
+        break;
+    case ptcl_token_unsyntax_type:
+        *type = ptcl_statement_unsyntax_type;
+        break;
+    case ptcl_token_undefine_type:
+        *type = ptcl_statement_undefine_type;
+        break;
+    case ptcl_token_type_type:
+        *type = ptcl_statement_type_decl_type;
+        break;
+    case ptcl_token_typedata_type:
+        *type = ptcl_statement_typedata_decl_type;
+        break;
+    case ptcl_token_function_type:
+        *type = ptcl_statement_func_decl_type;
+        break;
+    case ptcl_token_import_type:
+        *type = ptcl_statement_import_type;
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+static ptcl_statement *ptcl_parser_syntax_stat(ptcl_parser *parser)
+{
+    size_t depth = parser->state.syntax_depth;
+    const uint32_t origin = (uint32_t)parser->state.syntaxes_nodes[depth - 1].syntax.index + 1;
+    ptcl_attributes attributes = ptcl_parser_parse_attributes(parser);
+    if (ptcl_parser_critical(parser))
+    {
+        return NULL;
+    }
+
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_statement *statement = NULL;
+    if (!ptcl_parser_in_type(parser))
+    {
+        statement = ptcl_statement_create(ptcl_statement_func_body_type, ptcl_parser_root(parser), attributes, location);
+        if (statement == NULL)
+        {
+            ptcl_attributes_destroy(attributes);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return NULL;
+        }
+    }
+
+    ptcl_func_body body = ptcl_func_body_create(
+        NULL, 0,
+        parser->temp.inserted_body == NULL                           ? parser->temp.main_root
+        : parser->temp.inserted_body->root == parser->temp.main_root ? parser->temp.inserted_body
+                                                                     : parser->temp.main_root);
+    ptcl_parser_func_body_by_pointer(parser, &body, false, false, ptcl_parser_ignore_error(parser));
+    if (parser->state.syntax_depth == depth)
+    {
+        ptcl_parser_leave_from_syntax(parser);
+    }
+
+    if (ptcl_parser_critical(parser))
+    {
+        free(statement);
+        ptcl_attributes_destroy(attributes);
+        return NULL;
+    }
+
+    ptcl_parser_profile_entry *entry = parser->profile != NULL ? ptcl_parser_profile_at(parser->profile, origin - 1) : NULL;
+    if (entry != NULL)
+    {
+        entry->nodes_count += ptcl_parser_profile_count_nodes(body);
+    }
+
+    if (ptcl_parser_in_type(parser))
+    {
+        ptcl_func_body *previous = ptcl_parser_root(parser);
+        parser->temp.root = body.root;
+
+        ptcl_func_body *root_body = ptcl_parser_root(parser);
+        size_t new_count = root_body->count + body.count;
+        ptcl_statement **new_statements = realloc(root_body->statements,
+                                                  sizeof(ptcl_statement *) * new_count);
+        if (new_statements == NULL && new_count > 0)
+        {
+            ptcl_func_body_destroy(body);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            parser->temp.root = previous;
+            return NULL;
+        }
+
+        for (size_t i = 0; i < body.count; i++)
+        {
+            if (body.statements[i]->origin == 0)
+            {
+                body.statements[i]->origin = origin;
+            }
+
+            new_statements[i + root_body->count] = body.statements[i];
+        }
+
+        free(body.statements);
+        root_body->statements = new_statements;
+        root_body->count = new_count;
+        parser->temp.root = previous;
+    }
+    else
+    {
+        statement->body = ptcl_statement_func_body_create_by_body(body);
+        statement->origin = origin;
+    }
+
+    return statement;
+}
+
+ptcl_statement *ptcl_parser_parse_statement(ptcl_parser *parser)
+{
+    if (ptcl_parser_parse_try_syntax_usage_here(parser, true))
+    {
+        return ptcl_parser_syntax_stat(parser);
+    }
+
+    if (ptcl_parser_critical(parser))
+    {
+        return NULL;
+    }
+
+    ptcl_attributes attributes = ptcl_parser_parse_attributes(parser);
+    if (ptcl_parser_critical(parser))
+    {
+        return NULL;
+    }
+
+    ptcl_statement *statement = NULL;
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_parser_statement_info info = ptcl_parser_statement_info_default(parser);
+    if (!ptcl_parser_parse_get_statement(parser, &info))
+    {
+        ptcl_attributes_destroy(attributes);
+        ptcl_parser_throw_unknown_statement(parser, location);
+        return NULL;
+    }
+
+    ptcl_statement_type type = info.type;
+    // Already parsed in get_statement or just non sense things
+    if (type == ptcl_statement_none_type)
+    {
+        ptcl_attributes_destroy(attributes);
+        return NULL;
+    }
+
+    const bool with_own_statement = ptcl_statement_with_own_statement(type);
+    const ptcl_statement_modifiers modifiers = info.modifiers;
+    ptcl_expression *expression = info.expression;
+    ptcl_name name = info.name;
+
+    // "If" will parse new statement anyway
+    if (with_own_statement && type != ptcl_statement_if_type)
+    {
+        statement = ptcl_statement_create(type, ptcl_parser_root(parser), attributes, location);
+        if (statement == NULL)
+        {
+            ptcl_attributes_destroy(attributes);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return NULL;
+        }
+    }
+
+    switch (type)
+    {
+    case ptcl_statement_func_call_type:
+    {
+        bool is_null = false;
+        if (!ptcl_parser_func_call_stat(parser, &statement, expression, name, modifiers, &is_null))
+        {
+            // Statememnt, expression and name already destroyed above
+            ptcl_attributes_destroy(attributes);
+            return NULL;
+        }
+
+        if (is_null)
+        {
+            // Attributes will be destroyed below
+            statement = NULL;
+        }
+
+        // Statement is parsed in function above
+        break;
+    }
+    case ptcl_statement_func_decl_type:
+        statement->func_decl = ptcl_parser_func_decl(parser, modifiers);
+        break;
+    case ptcl_statement_typedata_decl_type:
+        statement->typedata_decl = ptcl_parser_typedata_decl(parser, modifiers);
+        break;
+    case ptcl_statement_type_decl_type:
+        statement->type_decl = ptcl_parser_type_decl(parser, modifiers);
+        break;
+    case ptcl_statement_assign_type:
+        statement->assign = ptcl_parser_assign(parser, name, expression, modifiers);
+
+        // By dot
+        if (!ptcl_parser_critical(parser) && !statement->assign.identifier.is_name && statement->assign.identifier.value->return_type.is_static)
+        {
+            ptcl_expression_destroy(statement->assign.identifier.value);
+            ptcl_attributes_destroy(attributes);
+            free(statement);
+            return NULL;
+        }
+
+        break;
+    case ptcl_statement_return_type:
+        statement->ret = ptcl_parser_return(parser);
+        break;
+    case ptcl_statement_if_type:
+        statement = ptcl_parser_if(parser, ptcl_statement_modifiers_flags_static(modifiers));
+        break;
+    case ptcl_statement_unsyntax_type:
+        statement->type = ptcl_statement_func_body_type;
+        statement->body = ptcl_parser_unsyntax(parser);
+        break;
+    case ptcl_statement_each_type:
+        ptcl_parser_each(parser);
+        break;
+    case ptcl_statement_syntax_type:
+        ptcl_parser_syntax_decl(parser);
+        break;
+    case ptcl_statement_undefine_type:
+        ptcl_parser_undefine(parser);
+        break;
+    case ptcl_statement_func_body_type:
+        // If we in syntax, then it was already parsed
+        if (parser->state.syntax_depth == 0)
+        {
+            ptcl_parser_extra_body(parser, false);
+        }
+        else
+        {
+            ptcl_parser_skip(parser); // Skip '@'
+            ptcl_parser_skip(parser); // Skip '{'
+            ptcl_parser_skip_block_or_expression(parser);
+        }
+
+        break;
+    case ptcl_statement_import_type:
+        // Top-level imports are already replaced by modules
+        ptcl_parser_throw_not_allowed_token(parser, ptcl_parser_current(parser).value, location);
+        break;
+    case ptcl_statement_none_type:
+        break;
+    }
+
+    if (ptcl_parser_critical(parser))
+    {
+        if (statement != NULL)
+        {
+            ptcl_attributes_destroy(attributes);
+            free(statement);
+        }
+
+        return NULL;
+    }
+
+    // Syntax decl, body, static func call, if, or each
+    // They don't have own statement, so we skip
+    if (!with_own_statement || statement == NULL)
+    {
+        ptcl_attributes_destroy(attributes);
+        return NULL;
+    }
+
+    if (ptcl_parser_in_type(parser) && type != ptcl_statement_func_decl_type)
+    {
+        ptcl_attributes_destroy(attributes);
+        ptcl_parser_except(parser, ptcl_token_function_type);
+        return NULL;
     }
 
     statement->root = ptcl_parser_root(parser);
@@ -2147,2540 +3166,4197 @@ ptcl_statement *ptcl_parser_parse_statement(ptcl_parser *parser)
     return statement;
 }
 
-ptcl_attributes ptcl_parser_parse_attributes(ptcl_parser *parser)
+ptcl_attributes ptcl_parser_parse_attributes(ptcl_parser *parser)
+{
+    ptcl_attributes attributes = ptcl_attributes_create(NULL, 0);
+    while (ptcl_parser_current(parser).type == ptcl_token_at_type && ptcl_parser_peek(parser, 1).type == ptcl_token_left_square_type)
+    {
+        ptcl_parser_skip(parser);
+        ptcl_parser_skip(parser);
+        ptcl_name name = ptcl_parser_name_word(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            return (ptcl_attributes){0};
+        }
+
+        if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+        {
+            ptcl_name_destroy(name);
+            return (ptcl_attributes){0};
+        }
+
+        ptcl_attribute *buffer = realloc(attributes.attributes, (attributes.count + 1) * sizeof(ptcl_attribute));
+        if (buffer == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            ptcl_attributes_destroy(attributes);
+            return (ptcl_attributes){0};
+        }
+
+        attributes.attributes = buffer;
+        attributes.attributes[attributes.count++] = ptcl_attribute_create(name);
+    }
+
+    return attributes;
+}
+
+bool ptcl_parser_parse_try_syntax_usage_here(ptcl_parser *parser, bool is_statement)
+{
+    return ptcl_parser_parse_try_syntax_usage(parser, NULL, 0, -1, false, is_statement);
+}
+
+static ptcl_expression *ptcl_parser_syntax_tokens(ptcl_parser *parser, char *end_token, ptcl_location location)
+{
+    if (!ptcl_parser_in_syntax(parser))
+    {
+        return false;
+    }
+
+    size_t original_capacity = 8;
+    size_t original_count = 0;
+    ptcl_expression **buffer = malloc(original_capacity * sizeof(ptcl_expression *));
+    if (buffer == NULL && original_capacity > 0)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return false;
+    }
+
+    while (true)
+    {
+        if (ptcl_parser_ended(parser))
+        {
+            ptcl_parser_throw_except_token(parser, end_token, location);
+            return false;
+        }
+
+        ptcl_token current = ptcl_parser_current(parser);
+        ptcl_parser_skip(parser);
+        if ((current.value == end_token || strcmp(current.value, end_token) != 0))
+        {
+            if (original_count >= original_capacity)
+            {
+                original_capacity *= 2;
+                ptcl_expression **reallocated = realloc(buffer, original_capacity * sizeof(ptcl_expression *));
+                if (reallocated == NULL)
+                {
+                destroying:
+                    for (size_t i = 0; i < original_count; i++)
+                    {
+                        ptcl_expression_destroy(buffer[i]);
+                    }
+
+                    free(buffer);
+                    ptcl_parser_throw_out_of_memory(parser, location);
+                    return false;
+                }
+
+                buffer = reallocated;
+            }
+
+            ptcl_expression *expression = ptcl_expression_create_token(current);
+            if (expression == NULL)
+            {
+                goto destroying;
+            }
+
+            buffer[original_count++] = expression;
+            continue;
+        }
+
+        ptcl_parser_back(parser);
+        break;
+    }
+
+    ptcl_expression *expression = ptcl_expression_create_array(
+        ptcl_type_create_array(&ptcl_token_t_type, false, original_count),
+        buffer,
+        location);
+    if (expression == NULL)
+    {
+        goto destroying;
+    }
+
+    return expression;
+}
+
+static bool ptcl_parser_parse_try_syntax_usage_with(
+    ptcl_parser *parser, ptcl_parser_syntax_node **nodes, size_t count, int down_start, bool skip_first, bool is_statement,
+    ptcl_parser_syntax_candidates *candidates)
+{
+    const bool is_root = down_start < 0;
+    if (is_root && !ptcl_parser_match(parser, ptcl_token_hashtag_type))
+    {
+        return false;
+    }
+
+    const uint64_t trace_start = PTCL_TRACE_START(parser->trace);
+
+    size_t stop = ptcl_parser_position(parser);
+    const size_t start = is_root ? stop : (size_t)down_start;
+    const size_t original_count = count;
+
+    ptcl_parser_syntax syntax = ptcl_parser_syntax_create(
+        ptcl_name_empty,
+        ptcl_parser_root(parser),
+        nodes ? *nodes : NULL,
+        count, 0);
+    ptcl_parser_syntax result;
+    bool found = false;
+    while (true)
+    {
+        if (ptcl_parser_ended(parser))
+        {
+            bool can_continue = false;
+            char *end_token = NULL;
+            ptcl_parser_syntax *target = NULL;
+            bool current_found = ptcl_parser_syntax_try_find(parser, syntax.nodes, syntax.count, &target, &can_continue, &end_token, candidates);
+            if (current_found)
+            {
+                stop = ptcl_parser_position(parser);
+                result = *target;
+                found = true;
+            }
+
+            break;
+        }
+
+        if (!skip_first)
+        {
+            ptcl_token current = ptcl_parser_current(parser);
+            ptcl_parser_syntax_node *buffer = realloc(syntax.nodes, (syntax.count + 1) * sizeof(ptcl_parser_syntax_node));
+            if (buffer == NULL)
+            {
+                ptcl_parser_throw_out_of_memory(parser, current.location);
+                ptcl_parser_syntax_destroy(syntax);
+                ptcl_parser_set_position(parser, start);
+                break;
+            }
+
+            syntax.nodes = buffer;
+            const size_t position = ptcl_parser_position(parser);
+            ptcl_parser_syntax_node node = ptcl_parser_syntax_node_create_word(
+                current.type,
+                ptcl_name_create(current.value, false, current.location));
+            ptcl_parser_skip(parser);
+            syntax.nodes[syntax.count++] = node;
+            // TODO: cast is danger
+            if (ptcl_parser_parse_try_syntax_usage(parser, &syntax.nodes, syntax.count, (int)start, true, is_statement))
+            {
+                return true;
+            }
+
+            if (ptcl_parser_critical(parser))
+            {
+                // Already destroyed in func below
+                return false;
+            }
+
+            ptcl_parser_set_position(parser, position);
+            PTCL_STATS_ADD(parser->stats, syntax_backtracks, 1);
+            const bool last_mode = ptcl_parser_add_errors(parser);
+            ptcl_parser_set_state(parser, ptcl_parser_add_errors_flag, is_root);
+
+            const ptcl_parser_tokens_state state = parser->state.tokens;
+            const ptcl_parser_checkpoint checkpoint = ptcl_parser_get_checkpoint(parser);
+            ptcl_expression *value = ptcl_parser_cast(parser, NULL, true);
+
+            ptcl_parser_set_state(parser, ptcl_parser_add_errors_flag, last_mode);
+            if (ptcl_parser_critical(parser))
+            {
+                if (!is_root)
+                {
+                    ptcl_parser_rollback(parser, checkpoint);
+                }
+
+                ptcl_parser_disable_state(parser, ptcl_parser_critical_flag);
+                break;
+            }
+            else
+            {
+                node = ptcl_parser_syntax_node_create_value(value, state);
+                syntax.nodes[syntax.count - 1] = node;
+            }
+        }
+        else
+        {
+            skip_first = false;
+        }
+
+        // Try to find matching syntax
+        ptcl_parser_syntax *target = NULL;
+        bool can_continue = false;
+        char *end_token = NULL;
+        bool current_found = ptcl_parser_syntax_try_find(parser, syntax.nodes, syntax.count, &target, &can_continue, &end_token, candidates);
+        if (current_found)
+        {
+            stop = ptcl_parser_position(parser);
+            result = *target;
+            found = true;
+        }
+
+        if (!can_continue)
+        {
+            break;
+        }
+
+        if (end_token != NULL)
+        {
+            ptcl_location location = ptcl_parser_current(parser).location;
+            ptcl_parser_syntax_node *nodes = realloc(syntax.nodes, (syntax.count + 1) * sizeof(ptcl_parser_syntax_node));
+            if (nodes == NULL)
+            {
+                ptcl_parser_throw_out_of_memory(parser, location);
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+
+            syntax.nodes = nodes;
+            ptcl_expression *expression = ptcl_parser_syntax_tokens(parser, end_token, location);
+            if (ptcl_parser_critical(parser))
+            {
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+
+            syntax.nodes[syntax.count++] = ptcl_parser_syntax_node_create_value(expression, (ptcl_parser_tokens_state){0});
+        }
+    }
+
+    if (found)
+    {
+        PTCL_STATS_ADD(parser->stats, syntax_expansions, 1);
+        // Handle syntax depth and memory limits
+        if (parser->state.syntax_depth == 0)
+        {
+            parser->temp.main_root = ptcl_parser_root(parser);
+        }
+
+        if (parser->state.syntax_depth + 1 >= PTCL_PARSER_MAX_DEPTH)
+        {
+            ptcl_parser_throw_max_depth(parser, ptcl_parser_current(parser).location);
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
+        }
+
+        // Create new function body context
+        ptcl_func_body *temp = malloc(sizeof(ptcl_func_body));
+        if (temp == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
+        }
+
+        *temp = ptcl_func_body_create(NULL, 0, parser->temp.main_root);
+        parser->temp.root = temp;
+
+        // Process syntax variables
+        for (size_t i = 0; i < result.count; i++)
+        {
+            ptcl_parser_syntax_node syntax_node = result.nodes[i];
+            ptcl_parser_syntax_node target_node = syntax.nodes[i];
+            if (syntax_node.type != ptcl_parser_syntax_node_variable_type)
+            {
+                ptcl_parser_syntax_node_destroy(target_node);
+                continue;
+            }
+
+            ptcl_expression *expression = target_node.value.value;
+            if (expression->return_type.is_static &&
+                expression->return_type.type == ptcl_value_type_type &&
+                expression->return_type.comp_type->invariant != NULL)
+            {
+                ptcl_expression_destroy(expression);
+                const ptcl_parser_tokens_state previous_state = parser->state.tokens;
+                ptcl_parser_set_tokens_state(parser, target_node.value.state);
+                expression = ptcl_parser_cast(parser, NULL, ptcl_parser_expression_with_word_flag | ptcl_parser_expression_change_the_value_flag);
+            }
+
+            ptcl_parser_variable variable = ptcl_parser_variable_create(
+                ptcl_name_create_fast_w(syntax_node.variable.name, false),
+                syntax_node.variable.type,
+                expression,
+                true,
+                ptcl_parser_root(parser));
+            variable.built_in = expression;
+            if (expression->return_type.is_static && expression->return_type.type == ptcl_value_word_type)
+            {
+                variable.is_syntax_word = true;
+            }
+
+            if (!ptcl_parser_add_instance_variable(parser, variable))
+            {
+                ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+        }
+
+        if (ptcl_parser_critical(parser))
+        {
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
+        }
+
+        if (parser->profile != NULL)
+        {
+            ptcl_parser_profile_entry *entry = ptcl_parser_profile_add(parser, result.index, ptcl_parser_profile_syntax_type, &result, NULL);
+            if (entry == NULL)
+            {
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+
+            entry->expansions_count++;
+            entry->tokens_count += parser->lated_states.items[result.index].count;
+        }
+
+        // Statement parsed from the body is tagged by syntax, which produced it
+        syntax.index = result.index;
+        ptcl_parser_set_position(parser, stop);
+        size_t current = parser->state.syntax_depth++;
+        parser->state.syntaxes_nodes[current] = ptcl_parser_syntax_pair_create(
+            syntax, parser->state.tokens, temp,
+            parser->state.syntax_depth == 1 ? temp->root : parser->state.syntaxes_nodes[current - 1].body);
+        PTCL_STATS_ADD(parser->stats, lated_body_reparses, 1);
+        ptcl_parser_tokens_state lated_body = parser->lated_states.items[result.index];
+        ptcl_parser_set_tokens_state(parser, lated_body);
+        ptcl_parser_set_position(parser, 0);
+        PTCL_TRACE_ADD(parser->trace, "syntax", "expand", result.name.value, trace_start);
+    }
+    else
+    {
+        ptcl_parser_set_position(parser, start);
+        if (is_root)
+        {
+            ptcl_parser_throw_unknown_syntax(parser, syntax, ptcl_parser_tokens(parser)[start].location);
+            ptcl_parser_syntax_destroy(syntax);
+        }
+        else
+        {
+            if (nodes != NULL)
+            {
+                *nodes = syntax.nodes;
+            }
+
+            for (size_t i = original_count; i < syntax.count; i++)
+            {
+                ptcl_parser_syntax_node_destroy(syntax.nodes[i]);
+            }
+        }
+    }
+
+    return found;
+}
+
+bool ptcl_parser_parse_try_syntax_usage(
+    ptcl_parser *parser, ptcl_parser_syntax_node **nodes, size_t count, int down_start, bool skip_first, bool is_statement)
+{
+    ptcl_parser_syntax_candidates candidates = {0};
+    const bool found = ptcl_parser_parse_try_syntax_usage_with(parser, nodes, count, down_start, skip_first, is_statement, &candidates);
+    free(candidates.indices);
+    return found;
+}
+
+void ptcl_parser_leave_from_syntax(ptcl_parser *parser)
+{
+    ptcl_parser_clear_scope(parser);
+
+    ptcl_parser_syntax_pair pair = parser->state.syntaxes_nodes[--parser->state.syntax_depth];
+    if (parser->state.tokens.is_free)
+    {
+        free(ptcl_parser_tokens(parser));
+    }
+
+    ptcl_parser_set_tokens_state(parser, pair.state);
+    ptcl_func_body *temp = pair.body;
+    ptcl_func_body_destroy(*temp);
+    parser->temp.root = pair.previous_body;
+    free(pair.syntax.nodes);
+    free(temp);
+}
+
+void ptcl_parser_leave_from_insert_state(ptcl_parser *parser)
+{
+    if (parser->state.tokens.is_free)
+    {
+        free(ptcl_parser_tokens(parser));
+    }
+
+    ptcl_parser_set_tokens_state(parser, ptcl_parser_insert_state_at(parser, --parser->temp.insert_states_count)->state);
+}
+
+static inline ptcl_statement_func_call ptcl_handle_builtin_execution(ptcl_parser *parser, ptcl_parser_function *target,
+                                                                     ptcl_statement_func_call *func_call, ptcl_location location, bool is_expression)
+{
+    if (ptcl_parser_ignore_error(parser) && strcmp(func_call->func_decl->name.value, PTCL_PARSER_ERROR_FUNC_NAME) == 0)
+    {
+        return *func_call;
+    }
+
+    ptcl_expression *result = target->bind(parser, func_call->arguments, func_call->count, location, is_expression);
+    if (ptcl_parser_critical(parser))
+    {
+        return (ptcl_statement_func_call){0};
+    }
+
+    func_call->is_built_in = true;
+    func_call->built_in = result;
+    return *func_call;
+}
+
+static inline ptcl_statement_func_call ptcl_handle_static_function(ptcl_parser *parser, ptcl_parser_function *target,
+                                                                   ptcl_statement_func_call *func_call, ptcl_expression *self, ptcl_location location)
+{
+    func_call->is_self_used = false;
+    ptcl_interpreter_reset(parser->interpreter);
+    ptcl_expression *result = ptcl_interpreter_evaluate_function_call(parser->interpreter, *func_call, false, self, &func_call->is_self_used, location);
+    if (ptcl_parser_critical(parser))
+    {
+        ptcl_statement_func_call_destroy(*func_call);
+        return (ptcl_statement_func_call){0};
+    }
+
+    func_call->built_in = result;
+    func_call->is_built_in = result != NULL;
+    if (func_call->is_built_in)
+    {
+        ptcl_statement_func_call_destroy(*func_call);
+        if (!func_call->is_self_used)
+        {
+            ptcl_expression_destroy(self);
+        }
+    }
+
+    return *func_call;
+}
+
+// TODO: remove to node
+static ptcl_expression *ptcl_get_self(ptcl_expression *expression)
+{
+    return expression->type == ptcl_expression_cast_type ? ptcl_get_self(expression->cast->value) : expression;
+}
+
+static inline ptcl_statement_func_call ptcl_handle_static_return_function(ptcl_parser *parser, ptcl_parser_function *target,
+                                                                          ptcl_statement_func_call *func_call, ptcl_expression *self, bool is_expression, ptcl_location location)
+{
+    ptcl_statement *statement = ptcl_func_body_create_stat(ptcl_statement_func_body_create(NULL, 0, NULL), parser->temp.root, location);
+    if (statement == NULL)
+    {
+        ptcl_statement_func_call_destroy(*func_call);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return (ptcl_statement_func_call){0};
+    }
+
+    ptcl_statement_func_body *placeholder = malloc(sizeof(ptcl_statement_func_body));
+    if (placeholder == NULL)
+    {
+        ptcl_statement_func_call_destroy(*func_call);
+        free(placeholder);
+        free(statement);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return (ptcl_statement_func_call){0};
+    }
+
+    func_call->is_self_used = false;
+    const bool is_self = self != NULL && self->return_type.is_static;
+    *placeholder = ptcl_statement_func_body_inserted_create(
+        NULL, 0, target->root, NULL, target->func.arguments, target->func.count, is_self ? NULL : self, *func_call);
+    statement->root = &placeholder->body;
+    int self_identifier = -1;
+    if (self != NULL)
+    {
+        ptcl_expression *value = self;
+        const bool is_built_in = self->return_type.is_static;
+        if (is_built_in)
+        {
+            value = ptcl_get_self(value);
+        }
+
+        self_identifier = (int)parser->variables.count;
+        ptcl_type type = value == self ? value->return_type.comp_type->types[0].type : value->return_type;
+        ptcl_parser_variable variable = ptcl_parser_variable_create(ptcl_name_self, type, value, is_built_in, &placeholder->body);
+        if (!ptcl_parser_add_instance_variable(parser, variable))
+        {
+            ptcl_statement_func_call_destroy(*func_call);
+            free(placeholder);
+            free(statement);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return (ptcl_statement_func_call){0};
+        }
+    }
+
+    size_t variables_index = parser->variables.count;
+    for (size_t i = 0; i < func_call->count; i++)
+    {
+        ptcl_expression *argument = func_call->arguments[i];
+        ptcl_parser_variable variable = ptcl_parser_variable_create(
+            target->func.arguments[i].name,
+            argument->return_type,
+            argument,
+            true,
+            &placeholder->body);
+        if (!ptcl_parser_add_instance_variable(parser, variable))
+        {
+            for (size_t j = i; j < func_call->count; j++)
+            {
+                ptcl_expression_destroy(func_call->arguments[j]);
+            }
+
+            free(func_call->arguments);
+            free(placeholder);
+            free(statement);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            if (self_identifier > -1)
+            {
+                parser->variables.items[self_identifier].is_built_in = false;
+            }
+
+            return (ptcl_statement_func_call){0};
+        }
+    }
+
+    bool last_state = ptcl_parser_except_return(parser);
+    const ptcl_type *last_return_type = parser->temp.return_type;
+    ptcl_type func_return_type = target->func.return_type;
+    // static (...): static T -> inline without static return type by specification
+    if (func_return_type.is_static && ptcl_statement_modifiers_flags_static(target->func.modifiers))
+    {
+        func_return_type.is_static = false;
+    }
+
+    ptcl_parser_enable_state(parser, ptcl_parser_except_return_flag);
+    parser->temp.return_type = &func_return_type;
+
+    const ptcl_parser_checkpoint checkpoint = ptcl_parser_get_checkpoint(parser);
+    PTCL_STATS_ADD(parser->stats, lated_body_reparses, 1);
+    ptcl_parser_tokens_state body = parser->lated_states.items[target->func.index];
+    ptcl_parser_set_tokens_state(parser, body);
+    ptcl_parser_set_position(parser, 0);
+
+    ptcl_parser_func_body_by_pointer(parser, &placeholder->body, true, true, false);
+
+    ptcl_parser_set_tokens_state(parser, checkpoint.tokens);
+
+    ptcl_parser_variable *self_variable = NULL;
+    if (self_identifier > -1)
+    {
+        self_variable = &parser->variables.items[self_identifier];
+        self_variable->is_built_in = false;
+    }
+
+    parser->temp.return_type = last_return_type;
+    ptcl_parser_set_state(
+        parser, ptcl_parser_except_return_flag, last_state);
+    if (ptcl_parser_critical(parser))
+    {
+        ptcl_parser_rollback_failed(parser, checkpoint);
+    cleanup:
+        for (size_t i = variables_index; i < parser->variables.count; i++)
+        {
+            parser->variables.items[i].is_built_in = false;
+        }
+
+        ptcl_statement_func_call_destroy(*func_call);
+        if (placeholder != NULL)
+        {
+            free(placeholder);
+        }
+
+        free(statement);
+        return (ptcl_statement_func_call){0};
+    }
+
+    if (parser->profile != NULL)
+    {
+        ptcl_parser_profile_entry *entry = ptcl_parser_profile_add(parser, target->func.index, ptcl_parser_profile_inline_type, NULL, target->func.name.value);
+        if (entry == NULL)
+        {
+            ptcl_func_body_destroy(placeholder->body);
+            goto cleanup;
+        }
+
+        entry->expansions_count++;
+        entry->tokens_count += body.count;
+        entry->nodes_count += ptcl_parser_profile_count_nodes(placeholder->body);
+    }
+
+    if (is_expression)
+    {
+        placeholder->caller = parser->temp.return_value;
+    }
+
+    statement->body = *placeholder;
+    statement->body.func_call = *func_call;
+    statement->origin = (uint32_t)target->func.index + 1;
+    free(placeholder);
+    placeholder = NULL;
+
+    ptcl_func_body *root_body = ptcl_parser_current_body(parser);
+    size_t new_count = root_body->count + 1;
+    ptcl_statement **new_statements = realloc(root_body->statements,
+                                              sizeof(ptcl_statement *) * new_count);
+    if (new_statements == NULL)
+    {
+        goto cleanup;
+    }
+
+    new_statements[root_body->count] = statement;
+    root_body->statements = new_statements;
+    root_body->count = new_count;
+
+    func_call->is_built_in = true;
+    func_call->built_in = parser->temp.return_value;
+    if (self_variable != NULL && !self_variable->is_used)
+    {
+        ptcl_expression_destroy(self);
+    }
+
+    for (size_t i = 0; i < func_call->count; i++)
+    {
+        ptcl_parser_variable *variable = &parser->variables.items[i + variables_index];
+        variable->is_built_in = false;
+    }
+
+    return *func_call;
+}
+
+static bool ptcl_parser_func_call_args(ptcl_parser *parser, ptcl_statement_func_call *func_call, ptcl_statement_func_decl *target, ptcl_location location)
+{
+    size_t expected_arguments = target->is_variadic ? target->count + 4 : target->count;
+    if (expected_arguments > 0)
+    {
+        func_call->arguments = malloc(expected_arguments * sizeof(ptcl_expression *));
+        if (func_call->arguments == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return false;
+        }
+    }
+
+    const size_t start = ptcl_parser_insert_states_count(parser);
+    bool is_parsing_tokens = false;
+
+    const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
+    ptcl_parser_disable_state(parser, ptcl_parser_in_return_flag);
+    while (!ptcl_parser_match(parser, ptcl_token_right_par_type))
+    {
+        if (ptcl_parser_ended(parser))
+        {
+            if (is_parsing_tokens)
+            {
+                ptcl_parser_leave_from_insert_state(parser);
+                if (ptcl_parser_insert_states_count(parser) == start)
+                {
+                    is_parsing_tokens = false;
+                }
+
+                continue;
+            }
+
+            ptcl_parser_throw_except_token(
+                parser,
+                ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_par_type),
+                location);
+            goto leave;
+        }
+
+        ptcl_parser_tokens_state temp_state;
+        bool is_toggle = ptcl_parser_try_parse_insert(parser, &temp_state, ptcl_parser_current(parser).location);
+        if (ptcl_parser_critical(parser))
+        {
+            goto leave;
+        }
+
+        if (ptcl_parser_insert_states_count(parser) >= PTCL_PARSER_DECL_INSERT_DEPTH)
+        {
+            ptcl_parser_throw_out_of_memory(parser, location);
+            goto leave;
+        }
+
+        if (is_toggle)
+        {
+            is_parsing_tokens = true;
+            ptcl_parser_insert_state_add_and_set(parser, ptcl_parser_insert_state_create(temp_state, parser->state.syntax_depth));
+            continue;
+        }
+
+        if (!target->is_variadic && func_call->count >= target->count)
+        {
+            ptcl_parser_throw_wrong_arguments(parser, target->name.value, func_call->arguments,
+                                              func_call->count, target->arguments, target->count, location);
+            goto leave;
+        }
+
+        if (func_call->count >= expected_arguments)
+        {
+            expected_arguments = expected_arguments * 2 + 4;
+            ptcl_expression **buffer = realloc(func_call->arguments, expected_arguments * sizeof(ptcl_expression *));
+            if (buffer == NULL)
+            {
+                ptcl_parser_throw_out_of_memory(parser, location);
+            leave:
+                ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
+                ptcl_statement_func_call_destroy(*func_call);
+                if (ptcl_parser_insert_states_count(parser) > 1)
+                {
+                    for (size_t i = start + 1; i < ptcl_parser_insert_states_count(parser); i++)
+                    {
+                        free(ptcl_parser_insert_state_at(parser, i)->state.tokens);
+                    }
+
+                    free(parser->state.tokens.tokens);
+                    ptcl_parser_set_tokens_state(parser, ptcl_parser_insert_state_at(parser, 0)->state);
+                }
+
+                return false;
+            }
+
+            func_call->arguments = buffer;
+        }
+
+        ptcl_argument *argument = (func_call->count < target->count) ? &target->arguments[func_call->count] : NULL;
+        ptcl_type *excepted = (argument && !argument->is_variadic) ? &argument->type : NULL;
+        func_call->arguments[func_call->count] = ptcl_parser_cast(parser, excepted, ptcl_parser_expression_flags_default(true));
+        if (ptcl_parser_critical(parser))
+        {
+            goto leave;
+        }
+
+        func_call->count++;
+        ptcl_parser_match(parser, ptcl_token_comma_type);
+    }
+
+    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
+    const bool argument_count_mismatch = target->is_variadic
+                                             ? (func_call->count < target->count - 1)
+                                             : (func_call->count != target->count);
+    if (argument_count_mismatch)
+    {
+        ptcl_parser_throw_wrong_arguments(parser, target->name.value, func_call->arguments,
+                                          func_call->count, target->arguments, target->count, location);
+        ptcl_statement_func_call_destroy(*func_call);
+        return false;
+    }
+
+    return true;
+}
+
+static ptcl_name ptcl_parser_name_by_func(ptcl_parser *parser, ptcl_parser_function *function)
+{
+    return (ptcl_parser_current(parser).type == ptcl_token_left_par_type)
+               ? ptcl_name_create_l(function->name.value, function->name.is_anonymous, false, function->name.location)
+               : ptcl_parser_name_word(parser);
+}
+
+ptcl_statement_func_call ptcl_parser_func_call(ptcl_parser *parser, ptcl_parser_function *function, ptcl_expression *self, bool is_expression)
+{
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_identifier identifier;
+    ptcl_name name;
+    if (function != NULL)
+    {
+        name = ptcl_parser_name_by_func(parser, function);
+        identifier = ptcl_identifier_create_by_name(name);
+    }
+    else
+    {
+        const size_t start = ptcl_parser_position(parser);
+        name = ptcl_parser_name_word(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            return (ptcl_statement_func_call){0};
+        }
+
+        if (ptcl_parser_current(parser).type != ptcl_token_left_par_type)
+        {
+            ptcl_parser_expression_flags flags = ptcl_parser_expression_flags_default(is_expression);
+            ptcl_expression *variable = ptcl_parser_func_call_or_var(parser, name, ptcl_parser_current(parser), flags, false);
+            if (ptcl_parser_critical(parser))
+            {
+                return (ptcl_statement_func_call){0};
+            }
+
+            ptcl_expression *expression = ptcl_parser_dot(parser, NULL, variable, flags);
+            if (ptcl_parser_critical(parser))
+            {
+                ptcl_expression_destroy(variable);
+                return (ptcl_statement_func_call){0};
+            }
+
+            identifier = ptcl_identifier_create_by_expr(expression);
+            return ptcl_statement_func_call_create(expression->dot.right->func_call->func_decl, identifier, NULL, 0);
+        }
+
+        identifier = ptcl_identifier_create_by_name(name);
+    }
+
+    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
+    {
+        ptcl_identifier_destroy(identifier);
+        return (ptcl_statement_func_call){0};
+    }
+
+    ptcl_statement_func_decl target;
+    if (function == NULL)
+    {
+        ptcl_parser_function *instance_target = NULL;
+        if (!ptcl_parser_try_get_function(parser, name, &function))
+        {
+            ptcl_identifier_destroy(identifier);
+            ptcl_parser_throw_unknown_function(parser, name.value, location);
+            return (ptcl_statement_func_call){0};
+        }
+    }
+
+    target = function->func;
+    if (is_expression && target.return_type.type == ptcl_value_void_type)
+    {
+        ptcl_identifier_destroy(identifier);
+        ptcl_parser_throw_except_type_specifier(parser, ptcl_parser_current(parser).location);
+        return (ptcl_statement_func_call){0};
+    }
+
+    ptcl_statement_func_call func_call = ptcl_statement_func_call_create(&target, identifier, NULL, 0);
+    if (!ptcl_parser_func_call_args(parser, &func_call, func_call.func_decl, location))
+    {
+        return (ptcl_statement_func_call){0};
+    }
+
+    func_call.return_type = target.return_type;
+    if (function != NULL && function->is_built_in)
+    {
+        return ptcl_handle_builtin_execution(parser, function, &func_call, location, is_expression);
+    }
+    else if (target.return_type.is_static)
+    {
+        return ptcl_handle_static_return_function(parser, function, &func_call, self, is_expression, location);
+    }
+    else if (ptcl_statement_modifiers_flags_static(target.modifiers))
+    {
+        return ptcl_handle_static_function(parser, function, &func_call, self, location);
+    }
+    else
+    {
+        func_call.is_built_in = false;
+    }
+
+    return func_call;
+}
+
+ptcl_func_body ptcl_parser_func_body(ptcl_parser *parser, bool with_brackets, bool change_root, bool is_static)
+{
+    ptcl_func_body func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
+    ptcl_parser_func_body_by_pointer(parser, &func_body, with_brackets, change_root, is_static);
+    return func_body;
+}
+
+static void ptcl_parser_declare(ptcl_parser *parser, ptcl_statement *statement, size_t start, size_t end);
+
+void ptcl_parser_func_body_by_pointer(ptcl_parser *parser, ptcl_func_body *func_body_pointer, bool with_brackets, bool change_root, bool is_ignore_error)
+{
+    ptcl_parser_match(parser, ptcl_token_left_curly_type);
+
+    ptcl_func_body *previous = ptcl_parser_root(parser);
+    ptcl_func_body *previous_main = parser->temp.main_root;
+    const bool is_file = change_root && previous == NULL;
+    const bool is_traced = parser->trace != NULL && is_file;
+    const bool is_incremental = parser->incremental != NULL && is_file && !parser->is_prelude;
+    if (change_root)
+    {
+        parser->temp.root = func_body_pointer;
+        parser->temp.main_root = func_body_pointer;
+    }
+
+    const bool last_ignore_error = ptcl_parser_ignore_error(parser);
+    ptcl_parser_set_state(parser, ptcl_parser_ignore_error_flag, is_ignore_error);
+
+    size_t depth = parser->state.syntax_depth;
+    while (depth <= parser->state.syntax_depth)
+    {
+        if (with_brackets && ptcl_parser_match(parser, ptcl_token_right_curly_type))
+        {
+            break;
+        }
+
+        if (ptcl_parser_ended(parser))
+        {
+            if (with_brackets)
+            {
+                ptcl_location location = ptcl_parser_current(parser).location;
+                char *token = ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type);
+                ptcl_parser_throw_except_token(parser, token, location);
+                ptcl_func_body_destroy(*func_body_pointer);
+            }
+
+            break;
+        }
+
+        const uint64_t trace_start = is_traced ? ptcl_trace_timestamp() : 0;
+        ptcl_parser_temp *temp = &parser->temp;
+        if (is_file)
+        {
+            // Syntaxes hidden by previous statements are dropped from filter
+            parser->syntax_starts.is_built = false;
+        }
+
+        if (is_incremental && !temp->is_declaring)
+        {
+            // Statement can be expanded by syntax into several ones, which are declared together
+            temp->statement_start = parser->state.tokens.position;
+            temp->declared_count = 0;
+            temp->is_declaring = true;
+        }
+
+        ptcl_statement *statement = ptcl_parser_parse_statement(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            // Deferred bodies belong to statements of this body, so they are joined before it is released
+            if (is_file)
+            {
+                ptcl_parser_join_bodies(parser);
+            }
+
+            ptcl_parser_clear_scope(parser);
+            ptcl_func_body_destroy(*func_body_pointer);
+            break;
+        }
+
+        if (is_traced)
+        {
+            ptcl_parser_trace_declaration(parser, statement, trace_start);
+        }
+
+        if (is_incremental)
+        {
+            temp->declared_count++;
+            if (parser->state.tokens.tokens == temp->main_tokens)
+            {
+                ptcl_parser_declare(parser, temp->declared_count == 1 ? statement : NULL, temp->statement_start, parser->state.tokens.position);
+                temp->is_declaring = false;
+            }
+        }
+
+        if (statement == NULL)
+        {
+            continue;
+        }
+
+        if (ptcl_parser_except_return(parser) && statement->type == ptcl_statement_return_type)
+        {
+            parser->temp.return_value = statement->ret.value;
+            free(statement);
+            continue;
+        }
+
+        ptcl_statement **buffer = realloc(func_body_pointer->statements, (func_body_pointer->count + 1) * sizeof(ptcl_statement *));
+        if (buffer == NULL)
+        {
+            if (is_file)
+            {
+                ptcl_parser_join_bodies(parser);
+            }
+
+            ptcl_func_body_destroy(*func_body_pointer);
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            break;
+        }
+
+        func_body_pointer->statements = buffer;
+        func_body_pointer->statements[func_body_pointer->count] = statement;
+        if (ptcl_parser_critical(parser))
+        {
+            if (is_file)
+            {
+                ptcl_parser_join_bodies(parser);
+            }
+
+            ptcl_func_body_destroy(*func_body_pointer);
+            break;
+        }
+
+        func_body_pointer->count++;
+    }
+
+    if (is_file && parser->deferred_bodies.count > 0)
+    {
+        ptcl_parser_join_bodies(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            ptcl_func_body_destroy(*func_body_pointer);
+        }
+    }
+
+    ptcl_parser_set_state(parser, ptcl_parser_ignore_error_flag, last_ignore_error);
+    if (change_root)
+    {
+        if (!is_file || !parser->is_prelude)
+        {
+            ptcl_parser_clear_scope(parser);
+        }
+
+        parser->temp.root = previous;
+        parser->temp.main_root = previous_main;
+    }
+}
+
+ptcl_func_body *ptcl_parser_current_body(ptcl_parser *parser)
+{
+    return parser->temp.inserted_body == NULL                           ? parser->temp.main_root
+           : parser->temp.inserted_body->root == parser->temp.main_root ? parser->temp.inserted_body
+                                                                        : parser->temp.main_root;
+}
+
+void ptcl_parser_extra_body(ptcl_parser *parser, bool is_syntax)
+{
+    if (ptcl_parser_current(parser).type != ptcl_token_at_type || ptcl_parser_peek(parser, 1).type != ptcl_token_left_curly_type)
+    {
+        return;
+    }
+
+    ptcl_parser_skip(parser);
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_func_body body = ptcl_func_body_create(
+        NULL, 0, ptcl_parser_current_body(parser));
+    ptcl_parser_func_body_by_pointer(parser, &body, true, false, ptcl_parser_ignore_error(parser));
+    if (ptcl_parser_critical(parser))
+    {
+        return;
+    }
+
+    ptcl_func_body *previous = ptcl_parser_root(parser);
+    parser->temp.root = body.root;
+
+    ptcl_statement *statement = ptcl_func_body_create_stat(ptcl_statement_func_body_create_by_body(body), body.root, location);
+    if (statement == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_statement_destroy(statement);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        parser->temp.root = previous;
+        return;
+    }
+
+    ptcl_func_body *root_body = ptcl_parser_root(parser);
+    size_t new_count = root_body->count + 1;
+    ptcl_statement **new_statements = realloc(root_body->statements,
+                                              sizeof(ptcl_statement *) * new_count);
+    if (new_statements == NULL)
+    {
+        ptcl_statement_destroy(statement);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        parser->temp.root = previous;
+        return;
+    }
+
+    new_statements[root_body->count] = statement;
+    root_body->statements = new_statements;
+    root_body->count = new_count;
+    parser->temp.root = previous;
+    ptcl_parser_extra_body(parser, is_syntax);
+}
+
+ptcl_type ptcl_parser_type(ptcl_parser *parser, bool with_word, bool with_any, bool with_static)
+{
+    const bool with_syntax = ptcl_parser_parse_try_syntax_usage_here(parser, false);
+    size_t depth = parser->state.syntax_depth;
+    if (ptcl_parser_critical(parser))
+    {
+        return (ptcl_type){0};
+    }
+
+    ptcl_parser_extra_body(parser, with_syntax);
+    if (ptcl_parser_critical(parser))
+    {
+        if (with_syntax && parser->state.syntax_depth == depth)
+        {
+            ptcl_parser_leave_from_syntax(parser);
+        }
+
+        return (ptcl_type){0};
+    }
+
+    bool is_const = ptcl_parser_match(parser, ptcl_token_const_type);
+    bool is_static = ptcl_parser_match(parser, ptcl_token_static_type);
+    if (is_static && !with_static)
+    {
+        ptcl_parser_throw_not_allowed_token(
+            parser,
+            ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_const_type),
+            ptcl_parser_current(parser).location);
+        if (with_syntax && parser->state.syntax_depth == depth)
+        {
+            ptcl_parser_leave_from_syntax(parser);
+        }
+
+        return (ptcl_type){0};
+    }
+
+    ptcl_token current = ptcl_parser_current(parser);
+    ptcl_parser_skip(parser);
+
+    ptcl_type target = {0};
+    bool parse_success = true;
+
+    switch (current.type)
+    {
+    case ptcl_token_word_word_type:
+        if (with_word)
+        {
+            target = ptcl_type_word;
+            break;
+        }
+        // Fallthrough
+    case ptcl_token_character_word_type:
+        target = ptcl_type_character;
+        break;
+    case ptcl_token_double_type:
+        target = ptcl_type_double;
+        break;
+    case ptcl_token_float_type:
+        target = ptcl_type_float;
+        break;
+    case ptcl_token_integer_type:
+        target = ptcl_type_integer;
+        break;
+    case ptcl_token_void_type:
+        target = ptcl_type_void;
+        break;
+    case ptcl_token_pointer_type:
+        target = ptcl_type_any_pointer;
+        break;
+    case ptcl_token_left_par_type:
+    {
+        ptcl_parse_arguments_result arguments = ptcl_parser_parse_arguments(parser, current.location, false, ptcl_parser_args_func_pointer_type);
+        if (ptcl_parser_critical(parser))
+        {
+            return (ptcl_type){0};
+        }
+
+        if (ptcl_parser_not(parser, ptcl_token_colon_type))
+        {
+            ptcl_parse_arguments_result_destroy(arguments);
+            return (ptcl_type){0};
+        }
+
+        ptcl_type *return_type = malloc(sizeof(ptcl_type));
+        if (return_type == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, current.location);
+            ptcl_parse_arguments_result_destroy(arguments);
+            return (ptcl_type){0};
+        }
+
+        *return_type = ptcl_parser_type(parser, is_static, false, false);
+        if (ptcl_parser_critical(parser))
+        {
+            ptcl_parse_arguments_result_destroy(arguments);
+            free(return_type);
+            return (ptcl_type){0};
+        }
+
+        ptcl_type function = ptcl_type_create_func(return_type, NULL, 0, false, arguments.has_variadic);
+        function.function_pointer.arguments = arguments.arguments;
+        function.function_pointer.count = arguments.count;
+        return_type->is_primitive = false;
+        target = function;
+        target.is_static = is_static;
+        break;
+    }
+    case ptcl_token_any_type:
+        if (is_static || with_any)
+        {
+            target = ptcl_type_any;
+            break;
+        }
+        else
+        {
+            parse_success = false;
+            ptcl_parser_throw_unknown_type(parser, current.value, current.location);
+            break;
+        }
+    case ptcl_token_exclamation_mark_type:
+        ptcl_parser_back(parser);
+        ptcl_name name = ptcl_parser_name_word_or_type(parser);
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough="
+        if (ptcl_parser_critical(parser))
+        {
+            break;
+        }
+    case ptcl_token_word_type:
+        // TODO: search type by name in one loop
+        if (current.type == ptcl_token_word_type)
+        {
+            name = ptcl_name_create_fast_w(current.value, false);
+        }
+
+        ptcl_parser_typedata *typedata;
+        ptcl_parser_comp_type *comp_type;
+        ptcl_parser_variable *variable;
+        if (ptcl_parser_try_get_typedata(parser, name, &typedata))
+        {
+            ptcl_name_destroy(name);
+            target = ptcl_type_create_typedata(typedata->typedata, false);
+            break;
+        }
+        else if (ptcl_parser_try_get_comp_type(parser, name, is_static, &comp_type))
+        {
+            ptcl_name_destroy(name);
+            // TODO: add context
+            if (with_static && (is_static || comp_type->is_auto_static))
+            {
+                if (comp_type->static_type == NULL)
+                {
+                    ptcl_parser_throw_except_type_specifier(parser, current.location);
+                    parse_success = false;
+                    break;
+                }
+
+                target = ptcl_type_create_comp_type_t(comp_type->static_type, is_const);
+                is_static = true;
+                break;
+            }
+            else
+            {
+                if (comp_type->comp_type == NULL)
+                {
+                    ptcl_parser_throw_except_type_specifier(parser, current.location);
+                    parse_success = false;
+                    break;
+                }
+
+                target = ptcl_type_create_comp_type_t(comp_type->comp_type, is_const);
+                break;
+            }
+        }
+
+        if (current.type == ptcl_token_exclamation_mark_type)
+        {
+            if (ptcl_parser_try_get_variable(parser, name, &variable))
+            {
+                if (variable->type.type == ptcl_value_object_type_type)
+                {
+                    ptcl_name_destroy(name);
+                    bool is_out_of_memory = false;
+                    target = ptcl_type_copy(variable->built_in->object_type.type, &is_out_of_memory);
+                    if (is_out_of_memory)
+                    {
+                        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+                        parse_success = false;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        ptcl_name_destroy(name);
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough="
+    default:
+        parse_success = false;
+        ptcl_parser_throw_unknown_type(parser, current.value, current.location);
+        break;
+    }
+
+    if (with_syntax && parser->state.syntax_depth == depth)
+    {
+        ptcl_parser_leave_from_syntax(parser);
+    }
+
+    if (!parse_success)
+    {
+        return (ptcl_type){0};
+    }
+
+    if (is_static)
+    {
+        target.is_static = true;
+    }
+
+    if (is_const)
+    {
+        target.is_const = true;
+    }
+
+    if (target.type != ptcl_value_word_type)
+    {
+        ptcl_type parsed_target = ptcl_parser_pointers(parser, target);
+        if (ptcl_parser_critical(parser))
+        {
+            return (ptcl_type){0};
+        }
+
+        target = parsed_target;
+    }
+    else
+    {
+        if (!is_static)
+        {
+            ptcl_parser_throw_must_be_static(parser, current.location);
+            target.is_static = true;
+        }
+    }
+
+    return target;
+}
+
+static ptcl_type *ptcl_parser_register_function(ptcl_parser *parser, ptcl_statement_func_decl func_decl, ptcl_parser_function *prototype_function)
+{
+    const ptcl_statement_modifiers modifiers = func_decl.modifiers;
+    const ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_parser_function function = ptcl_parser_function_create(ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser), func_decl);
+    ptcl_type *variable_return_type = NULL;
+    if (!ptcl_parser_in_type(parser))
+    {
+        if (prototype_function != NULL && !prototype_function->is_built_in)
+        {
+            // TODO: make arguments checks from prototype
+            prototype_function->func = func_decl;
+        }
+        else
+        {
+            bool added = true;
+            if (!func_decl.return_type.is_static)
+            {
+                ptcl_name variable_name = function.name;
+                variable_name.is_free = false;
+                ptcl_type *variable_return_type = malloc(sizeof(ptcl_type));
+                if (variable_return_type == NULL)
+                {
+                    ptcl_statement_func_decl_destroy(func_decl);
+                    ptcl_parser_throw_out_of_memory(parser, location);
+                    return NULL;
+                }
+
+                *variable_return_type = func_decl.return_type;
+                ptcl_type variable_type = ptcl_type_create_func(variable_return_type, func_decl.arguments, func_decl.count, true, func_decl.is_variadic);
+                variable_type.is_static = true;
+                ptcl_parser_variable function_pointer = ptcl_parser_func_variable_create(variable_name, variable_type, function.root);
+                added = ptcl_parser_add_instance_variable(parser, function_pointer);
+            }
+
+            if (!added || !ptcl_parser_add_instance_function(parser, function))
+            {
+                ptcl_statement_func_decl_destroy(func_decl);
+                free(variable_return_type);
+                ptcl_parser_throw_out_of_memory(parser, location);
+                return NULL;
+            }
+        }
+    }
+
+    return variable_return_type;
+}
+
+static size_t ptcl_parser_syntax_starts_hash(const char *word)
 {
-    ptcl_attributes attributes = ptcl_attributes_create(NULL, 0);
-    while (ptcl_parser_current(parser).type == ptcl_token_at_type && ptcl_parser_peek(parser, 1).type == ptcl_token_left_square_type)
+    size_t hash = 14695981039346656037ULL;
+    for (; *word != '\0'; word++)
     {
-        ptcl_parser_skip(parser);
-        ptcl_parser_skip(parser);
-        ptcl_name name = ptcl_parser_name_word(parser);
-        if (ptcl_parser_critical(parser))
+        hash = (hash ^ (unsigned char)*word) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static bool ptcl_parser_syntax_starts_build(ptcl_parser *parser)
+{
+    ptcl_parser_syntax_starts *starts = &parser->syntax_starts;
+    size_t capacity = 16;
+    while (capacity < parser->syntaxes.count * 2)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity != starts->capacity)
+    {
+        free(starts->words);
+        starts->words = malloc(capacity * sizeof(char *));
+        starts->capacity = starts->words != NULL ? capacity : 0;
+        if (starts->words == NULL)
         {
-            return (ptcl_attributes){0};
+            return false;
         }
+    }
 
-        if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+    memset(starts->words, 0, capacity * sizeof(char *));
+    memset(starts->types, 0, sizeof(starts->types));
+    starts->is_any = false;
+    for (size_t i = 0; i < parser->syntaxes.count; i++)
+    {
+        ptcl_parser_syntax *syntax = &parser->syntaxes.items[i];
+        if (syntax->is_out_of_scope || syntax->count == 0)
         {
-            ptcl_name_destroy(name);
-            return (ptcl_attributes){0};
+            continue;
         }
 
-        ptcl_attribute *buffer = realloc(attributes.attributes, (attributes.count + 1) * sizeof(ptcl_attribute));
+        ptcl_parser_syntax_node first = syntax->nodes[0];
+        if (first.type != ptcl_parser_syntax_node_word_type)
+        {
+            starts->is_any = true;
+            continue;
+        }
+
+        if (first.word.type != ptcl_token_word_type)
+        {
+            starts->types[first.word.type] = true;
+            continue;
+        }
+
+        size_t index = ptcl_parser_syntax_starts_hash(first.word.name.value) & (capacity - 1);
+        while (starts->words[index] != NULL && strcmp(starts->words[index], first.word.name.value) != 0)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        starts->words[index] = first.word.name.value;
+    }
+
+    starts->syntaxes_count = parser->syntaxes.count;
+    starts->is_built = true;
+    return true;
+}
+
+// Filter is true if token can start some syntax, scope of syntaxes is checked only then
+static bool ptcl_parser_syntax_starts_contains(ptcl_parser *parser, ptcl_token token)
+{
+    ptcl_parser_syntax_starts *starts = &parser->syntax_starts;
+    if ((!starts->is_built || starts->syntaxes_count != parser->syntaxes.count) && !ptcl_parser_syntax_starts_build(parser))
+    {
+        return true;
+    }
+
+    if (starts->is_any)
+    {
+        return true;
+    }
+
+    if (token.type != ptcl_token_word_type)
+    {
+        return starts->types[token.type];
+    }
+
+    size_t index = ptcl_parser_syntax_starts_hash(token.value) & (starts->capacity - 1);
+    while (starts->words[index] != NULL)
+    {
+        if (strcmp(starts->words[index], token.value) == 0)
+        {
+            return true;
+        }
+
+        index = (index + 1) & (starts->capacity - 1);
+    }
+
+    return false;
+}
+
+static bool ptcl_parser_can_start_syntax(ptcl_parser *parser, ptcl_token token)
+{
+    if (!ptcl_parser_syntax_starts_contains(parser, token))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < parser->syntaxes.count; i++)
+    {
+        ptcl_parser_syntax *syntax = &parser->syntaxes.items[i];
+        if (syntax->is_out_of_scope || syntax->count == 0 || !ptcl_func_body_can_access(syntax->root, ptcl_parser_root(parser)))
+        {
+            continue;
+        }
+
+        // Only words are known before matching, any other first node can start with anything
+        ptcl_parser_syntax_node first = syntax->nodes[0];
+        if (first.type != ptcl_parser_syntax_node_word_type)
+        {
+            return true;
+        }
+
+        if (first.word.type == token.type &&
+            (token.type != ptcl_token_word_type || strcmp(first.word.name.value, token.value) == 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool ptcl_parser_is_runtime_word(ptcl_parser *parser, ptcl_token token)
+{
+    ptcl_name word = ptcl_name_create_fast_w(token.value, false);
+    ptcl_parser_variable *variable;
+    if (ptcl_parser_try_get_variable(parser, word, &variable) &&
+        (variable->is_built_in || variable->is_syntax_word || variable->is_syntax_variable ||
+         (variable->type.is_static && !variable->is_function_pointer)))
+    {
+        return false;
+    }
+
+    ptcl_parser_function *function;
+    if (ptcl_parser_try_get_function(parser, word, &function) &&
+        (function->is_built_in || function->func.return_type.is_static || ptcl_statement_modifiers_flags_static(function->func.modifiers)))
+    {
+        return false;
+    }
+
+    ptcl_parser_comp_type *comp_type;
+    return !ptcl_parser_try_get_comp_type(parser, word, false, &comp_type) &&
+           !ptcl_parser_try_get_comp_type(parser, word, true, &comp_type);
+}
+
+// Token of plain body neither reads nor changes compile time state
+static bool ptcl_parser_is_plain_token(ptcl_parser *parser, ptcl_token *tokens, size_t index)
+{
+    ptcl_token token = tokens[index];
+    switch (token.type)
+    {
+    case ptcl_token_static_type:
+    case ptcl_token_syntax_type:
+    case ptcl_token_unsyntax_type:
+    case ptcl_token_undefine_type:
+    case ptcl_token_each_type:
+    case ptcl_token_typedata_type:
+    case ptcl_token_type_type:
+    case ptcl_token_function_type:
+    case ptcl_token_prototype_type:
+    case ptcl_token_global_type:
+    case ptcl_token_auto_type:
+    case ptcl_token_optional_type:
+    case ptcl_token_up_type:
+    case ptcl_token_is_type:
+    case ptcl_token_word_word_type:
+    case ptcl_token_hashtag_type:
+    case ptcl_token_exclamation_mark_type:
+    case ptcl_token_tilde_type:
+    case ptcl_token_caret_type:
+    case ptcl_token_at_type:
+    case ptcl_token_import_type:
+        return false;
+    case ptcl_token_left_curly_type:
+        // Curly after operator starts lated body expression instead of block
+        switch (tokens[index - 1].type)
+        {
+        case ptcl_token_word_type:
+        case ptcl_token_number_type:
+        case ptcl_token_string_type:
+        case ptcl_token_character_type:
+        case ptcl_token_right_par_type:
+        case ptcl_token_right_square_type:
+        case ptcl_token_else_type:
+            break;
+        default:
+            return false;
+        }
+
+        break;
+    case ptcl_token_word_type:
+        if (!ptcl_parser_is_runtime_word(parser, token))
+        {
+            return false;
+        }
+
+        break;
+    default:
+        break;
+    }
+
+    return !ptcl_parser_can_start_syntax(parser, token);
+}
+
+// Body is plain when it neither reads nor changes compile time state, so it can be parsed later on other thread
+// or taken from incremental cache. Like for invariant each, its tokens are checked before parsing
+static bool ptcl_parser_is_plain_body(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
+{
+    ptcl_parser_tokens_state *state = &parser->state.tokens;
+    ptcl_func_body *root = ptcl_parser_root(parser);
+    if (modifiers != ptcl_statement_modifiers_none_flag ||
+        root == NULL || root->root != NULL || parser->temp.main_root != root ||
+        ptcl_parser_in_type(parser) || parser->state.syntax_depth > 0 || parser->temp.insert_states_count > 0 ||
+        !ptcl_parser_add_errors(parser) || ptcl_parser_ignore_error(parser) ||
+        state->tokens != parser->temp.main_tokens || state->partners == NULL ||
+        state->position >= state->count || state->tokens[state->position].type != ptcl_token_left_curly_type)
+    {
+        return false;
+    }
+
+    const size_t end = state->position + state->partners[state->position];
+    if (end == state->position)
+    {
+        return false;
+    }
+
+    for (size_t i = state->position + 1; i < end; i++)
+    {
+        if (!ptcl_parser_is_plain_token(parser, state->tokens, i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Registers body as parsed and leaves it for workers. Returns false if it must be parsed now
+static bool ptcl_parser_defer_body(ptcl_parser *parser, ptcl_statement_func_decl *func_decl, ptcl_type *return_type, const size_t function_index)
+{
+    ptcl_deferred_bodies_array *bodies = &parser->deferred_bodies;
+    if (bodies->count >= bodies->capacity)
+    {
+        const size_t capacity = bodies->capacity == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : bodies->capacity * 2;
+        ptcl_parser_deferred_body *buffer = realloc(bodies->items, capacity * sizeof(ptcl_parser_deferred_body));
         if (buffer == NULL)
         {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_attributes_destroy(attributes);
-            return (ptcl_attributes){0};
+            return false;
         }
 
-        attributes.attributes = buffer;
-        attributes.attributes[attributes.count++] = ptcl_attribute_create(name);
+        bodies->items = buffer;
+        bodies->capacity = capacity;
     }
 
-    return attributes;
+    func_decl->func_body = malloc(sizeof(ptcl_func_body));
+    if (func_decl->func_body == NULL)
+    {
+        return false;
+    }
+
+    *func_decl->func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
+    ptcl_parser_tokens_state *state = &parser->state.tokens;
+    bodies->items[bodies->count++] = (ptcl_parser_deferred_body){
+        .body = func_decl->func_body,
+        .arguments = func_decl->arguments,
+        .arguments_count = func_decl->count,
+        .return_type = return_type,
+        .tokens = *state,
+        .states = parser->state.states,
+        .syntaxes_count = parser->syntaxes.count,
+        .typedatas_count = parser->typedatas.count,
+        .comp_types_count = parser->comp_types.count,
+        .functions_count = parser->functions.count,
+        .variables_count = parser->variables.count};
+
+    state->position += state->partners[state->position] + 1;
+    ptcl_statement_modifiers_flags_remove(&func_decl->modifiers, ptcl_statement_modifiers_prototype_flag);
+    parser->functions.items[function_index].func = *func_decl;
+    return true;
 }
 
-bool ptcl_parser_parse_try_syntax_usage_here(ptcl_parser *parser, bool is_statement)
+// Top-level statement is named only when its tokens can't change parsing of next ones
+static char *ptcl_parser_declaration_name(ptcl_parser *parser, ptcl_statement *statement, ptcl_token *tokens, size_t count)
 {
-    return ptcl_parser_parse_try_syntax_usage(parser, NULL, 0, -1, false, is_statement);
+    if (statement == NULL)
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        switch (tokens[i].type)
+        {
+        case ptcl_token_static_type:
+        case ptcl_token_syntax_type:
+        case ptcl_token_unsyntax_type:
+        case ptcl_token_undefine_type:
+        case ptcl_token_each_type:
+        case ptcl_token_word_word_type:
+        case ptcl_token_hashtag_type:
+        case ptcl_token_exclamation_mark_type:
+        case ptcl_token_tilde_type:
+        case ptcl_token_caret_type:
+        case ptcl_token_at_type:
+        case ptcl_token_import_type:
+            return NULL;
+        default:
+            break;
+        }
+
+        if (ptcl_parser_can_start_syntax(parser, tokens[i]))
+        {
+            return NULL;
+        }
+    }
+
+    switch (statement->type)
+    {
+    case ptcl_statement_func_decl_type:
+        return statement->func_decl.name.value;
+    case ptcl_statement_typedata_decl_type:
+        return statement->typedata_decl.name.value;
+    case ptcl_statement_type_decl_type:
+        return statement->type_decl.name.value;
+    case ptcl_statement_assign_type:
+        return statement->assign.identifier.is_name ? statement->assign.identifier.name.value : NULL;
+    default:
+        return NULL;
+    }
+}
+
+// Declares tokens of top-level statement, statement is NULL if tokens gave not one statement
+static void ptcl_parser_declare(ptcl_parser *parser, ptcl_statement *statement, size_t start, size_t end)
+{
+    ptcl_token *tokens = parser->temp.main_tokens + start;
+    size_t count = end - start;
+    char *name = ptcl_parser_declaration_name(parser, statement, tokens, count);
+    if (name != NULL && statement->type == ptcl_statement_func_decl_type && statement->func_decl.fingerprint != 0)
+    {
+        // Callers depend on signature of function, but not on its plain body, except inferred return type
+        const size_t signature = parser->temp.body_start - start;
+        bool is_inferred = false;
+        for (size_t i = 0; i < signature; i++)
+        {
+            is_inferred |= tokens[i].type == ptcl_token_auto_type;
+        }
+
+        count = is_inferred ? count : signature;
+    }
+
+    ptcl_incremental_declare(parser->incremental, name, tokens, count);
 }
 
-static ptcl_expression *ptcl_parser_syntax_tokens(ptcl_parser *parser, char *end_token, ptcl_location location)
+// Fingerprints plain body for incremental compilation. Returns true if body is cached, then it isn't parsed at all
+static bool ptcl_parser_reuse_body(ptcl_parser *parser, ptcl_statement_func_decl *func_decl, const size_t function_index)
 {
-    if (!ptcl_parser_in_syntax(parser))
+    if (parser->incremental == NULL || parser->is_prelude)
     {
         return false;
     }
 
-    size_t original_capacity = 8;
-    size_t original_count = 0;
-    ptcl_expression **buffer = malloc(original_capacity * sizeof(ptcl_expression *));
-    if (buffer == NULL && original_capacity > 0)
+    ptcl_parser_tokens_state *state = &parser->state.tokens;
+    const size_t end = state->position + state->partners[state->position];
+    parser->temp.body_start = state->position;
+    func_decl->fingerprint = ptcl_incremental_fingerprint(
+        parser->incremental, state->tokens + parser->temp.statement_start, end + 1 - parser->temp.statement_start);
+    PTCL_STATS_ADD(parser->stats, incremental_bodies_count, 1);
+    if (!ptcl_incremental_contains(parser->incremental, func_decl->fingerprint))
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
         return false;
     }
 
-    while (true)
+    func_decl->func_body = malloc(sizeof(ptcl_func_body));
+    if (func_decl->func_body == NULL)
     {
-        if (ptcl_parser_ended(parser))
-        {
-            ptcl_parser_throw_except_token(parser, end_token, location);
-            return false;
-        }
-
-        ptcl_token current = ptcl_parser_current(parser);
-        ptcl_parser_skip(parser);
-        if ((current.value == end_token || strcmp(current.value, end_token) != 0))
-        {
-            if (original_count >= original_capacity)
-            {
-                original_capacity *= 2;
-                ptcl_expression **reallocated = realloc(buffer, original_capacity * sizeof(ptcl_expression *));
-                if (reallocated == NULL)
-                {
-                destroying:
-                    for (size_t i = 0; i < original_count; i++)
-                    {
-                        ptcl_expression_destroy(buffer[i]);
-                    }
+        return false;
+    }
 
-                    free(buffer);
-                    ptcl_parser_throw_out_of_memory(parser, location);
-                    return false;
-                }
+    *func_decl->func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
+    state->position = end + 1;
+    ptcl_statement_modifiers_flags_remove(&func_decl->modifiers, ptcl_statement_modifiers_prototype_flag);
+    func_decl->is_cached = true;
+    parser->functions.items[function_index].func = *func_decl;
+    PTCL_STATS_ADD(parser->stats, cached_bodies_count, 1);
+    return true;
+}
 
-                buffer = reallocated;
-            }
+static void ptcl_parser_shift_expression(ptcl_expression *expression, size_t first, size_t base);
 
-            ptcl_expression *expression = ptcl_expression_create_token(current);
-            if (expression == NULL)
-            {
-                goto destroying;
-            }
+static void ptcl_parser_shift_body(ptcl_func_body body, size_t first, size_t base);
 
-            buffer[original_count++] = expression;
-            continue;
-        }
+static inline void ptcl_parser_shift_variable_id(size_t *variable_id, size_t first, size_t base)
+{
+    if (*variable_id >= first)
+    {
+        *variable_id = *variable_id - first + base;
+    }
+}
 
-        ptcl_parser_back(parser);
-        break;
+static void ptcl_parser_shift_func_call(ptcl_statement_func_call func_call, size_t first, size_t base)
+{
+    if (!func_call.identifier.is_name)
+    {
+        ptcl_parser_shift_expression(func_call.identifier.value, first, base);
     }
 
-    ptcl_expression *expression = ptcl_expression_create_array(
-        ptcl_type_create_array(&ptcl_token_t_type, false, original_count),
-        buffer,
-        location);
-    if (expression == NULL)
+    for (size_t i = 0; i < func_call.count; i++)
     {
-        goto destroying;
+        ptcl_parser_shift_expression(func_call.arguments[i], first, base);
     }
 
-    return expression;
+    if (func_call.built_in != NULL)
+    {
+        ptcl_parser_shift_expression(func_call.built_in, first, base);
+    }
 }
 
-bool ptcl_parser_parse_try_syntax_usage(
-    ptcl_parser *parser, ptcl_parser_syntax_node **nodes, size_t count, int down_start, bool skip_first, bool is_statement)
+// Copies share children with their originals, so only own identifier of copy is shifted
+static void ptcl_parser_shift_statement(ptcl_statement *statement, size_t first, size_t base)
 {
-    const bool is_root = down_start < 0;
-    if (is_root && !ptcl_parser_match(parser, ptcl_token_hashtag_type))
+    if (statement->type == ptcl_statement_assign_type)
     {
-        return false;
+        ptcl_parser_shift_variable_id(&statement->assign.variable_id, first, base);
     }
 
-    size_t stop = ptcl_parser_position(parser);
-    const size_t start = is_root ? stop : (size_t)down_start;
-    const size_t original_count = count;
+    if (!statement->is_original)
+    {
+        return;
+    }
 
-    ptcl_parser_syntax syntax = ptcl_parser_syntax_create(
-        ptcl_name_empty,
-        ptcl_parser_root(parser),
-        nodes ? *nodes : NULL,
-        count, 0);
-    ptcl_parser_syntax result;
-    bool found = false;
-    while (true)
+    switch (statement->type)
     {
-        if (ptcl_parser_ended(parser))
+    case ptcl_statement_func_call_type:
+        ptcl_parser_shift_func_call(statement->func_call, first, base);
+        break;
+    case ptcl_statement_return_type:
+        ptcl_parser_shift_expression(statement->ret.value, first, base);
+        break;
+    case ptcl_statement_assign_type:
+        ptcl_parser_shift_expression(statement->assign.value, first, base);
+        if (!statement->assign.identifier.is_name)
         {
-            bool can_continue = false;
-            char *end_token = NULL;
-            ptcl_parser_syntax *target = NULL;
-            bool current_found = ptcl_parser_syntax_try_find(parser, syntax.nodes, syntax.count, &target, &can_continue, &end_token);
-            if (current_found)
-            {
-                stop = ptcl_parser_position(parser);
-                result = *target;
-                found = true;
-            }
-
-            break;
+            ptcl_parser_shift_expression(statement->assign.identifier.value, first, base);
         }
 
-        if (!skip_first)
-        {
-            ptcl_token current = ptcl_parser_current(parser);
-            ptcl_parser_syntax_node *buffer = realloc(syntax.nodes, (syntax.count + 1) * sizeof(ptcl_parser_syntax_node));
-            if (buffer == NULL)
-            {
-                ptcl_parser_throw_out_of_memory(parser, current.location);
-                ptcl_parser_syntax_destroy(syntax);
-                ptcl_parser_set_position(parser, start);
-                break;
-            }
-
-            syntax.nodes = buffer;
-            const size_t position = ptcl_parser_position(parser);
-            ptcl_parser_syntax_node node = ptcl_parser_syntax_node_create_word(
-                current.type,
-                ptcl_name_create(current.value, false, current.location));
-            ptcl_parser_skip(parser);
-            syntax.nodes[syntax.count++] = node;
-            // TODO: cast is danger
-            if (ptcl_parser_parse_try_syntax_usage(parser, &syntax.nodes, syntax.count, (int)start, true, is_statement))
-            {
-                return true;
-            }
-
-            if (ptcl_parser_critical(parser))
-            {
-                // Already destroyed in func below
-                return false;
-            }
-
-            ptcl_parser_set_position(parser, position);
-            const bool last_mode = ptcl_parser_add_errors(parser);
-            ptcl_parser_set_state(parser, ptcl_parser_add_errors_flag, is_root);
-
-            const ptcl_parser_tokens_state state = parser->state.tokens;
-            ptcl_expression *value = ptcl_parser_cast(parser, NULL, true);
-
-            ptcl_parser_set_state(parser, ptcl_parser_add_errors_flag, last_mode);
-            if (ptcl_parser_critical(parser))
-            {
-                ptcl_parser_disable_state(parser, ptcl_parser_critical_flag);
-                break;
-            }
-            else
-            {
-                node = ptcl_parser_syntax_node_create_value(value, state);
-                syntax.nodes[syntax.count - 1] = node;
-            }
-        }
-        else
+        break;
+    case ptcl_statement_if_type:
+        ptcl_parser_shift_expression(statement->if_stat.condition, first, base);
+        ptcl_parser_shift_body(statement->if_stat.body, first, base);
+        if (statement->if_stat.with_else)
         {
-            skip_first = false;
+            ptcl_parser_shift_body(statement->if_stat.else_body, first, base);
         }
 
-        // Try to find matching syntax
-        ptcl_parser_syntax *target = NULL;
-        bool can_continue = false;
-        char *end_token = NULL;
-        bool current_found = ptcl_parser_syntax_try_find(parser, syntax.nodes, syntax.count, &target, &can_continue, &end_token);
-        if (current_found)
-        {
-            stop = ptcl_parser_position(parser);
-            result = *target;
-            found = true;
-        }
+        break;
+    case ptcl_statement_func_body_type:
+        ptcl_parser_shift_body(statement->body.body, first, base);
+        break;
+    default:
+        break;
+    }
+}
 
-        if (!can_continue)
-        {
-            break;
-        }
+static void ptcl_parser_shift_body(ptcl_func_body body, size_t first, size_t base)
+{
+    for (size_t i = 0; i < body.count; i++)
+    {
+        ptcl_parser_shift_statement(body.statements[i], first, base);
+    }
+}
 
-        if (end_token != NULL)
-        {
-            ptcl_location location = ptcl_parser_current(parser).location;
-            ptcl_parser_syntax_node *nodes = realloc(syntax.nodes, (syntax.count + 1) * sizeof(ptcl_parser_syntax_node));
-            if (nodes == NULL)
-            {
-                ptcl_parser_throw_out_of_memory(parser, location);
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
-            }
+static void ptcl_parser_shift_expression(ptcl_expression *expression, size_t first, size_t base)
+{
+    if (expression == NULL)
+    {
+        return;
+    }
 
-            syntax.nodes = nodes;
-            ptcl_expression *expression = ptcl_parser_syntax_tokens(parser, end_token, location);
-            if (ptcl_parser_critical(parser))
-            {
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
-            }
+    if (expression->type == ptcl_expression_variable_type)
+    {
+        ptcl_parser_shift_variable_id(&expression->variable.variable_id, first, base);
+    }
 
-            syntax.nodes[syntax.count++] = ptcl_parser_syntax_node_create_value(expression, (ptcl_parser_tokens_state){0});
-        }
+    if (!expression->is_original)
+    {
+        return;
     }
 
-    if (found)
+    switch (expression->type)
     {
-        // Handle syntax depth and memory limits
-        if (parser->state.syntax_depth == 0)
+    case ptcl_expression_func_call_type:
+        ptcl_parser_shift_func_call(*expression->func_call, first, base);
+        break;
+    case ptcl_expression_array_type:
+        for (size_t i = 0; i < expression->array->count; i++)
         {
-            parser->temp.main_root = ptcl_parser_root(parser);
+            ptcl_parser_shift_expression(expression->array->expressions[i], first, base);
         }
 
-        if (parser->state.syntax_depth + 1 >= PTCL_PARSER_MAX_DEPTH)
+        break;
+    case ptcl_expression_binary_type:
+        ptcl_parser_shift_expression(expression->binary.left, first, base);
+        ptcl_parser_shift_expression(expression->binary.right, first, base);
+        break;
+    case ptcl_expression_cast_type:
+        ptcl_parser_shift_expression(expression->cast->value, first, base);
+        break;
+    case ptcl_expression_unary_type:
+        ptcl_parser_shift_expression(expression->unary.child, first, base);
+        break;
+    case ptcl_expression_dot_type:
+        ptcl_parser_shift_expression(expression->dot.left, first, base);
+        if (!expression->dot.is_name)
         {
-            ptcl_parser_throw_max_depth(parser, ptcl_parser_current(parser).location);
-            ptcl_parser_syntax_destroy(syntax);
-            return false;
+            ptcl_parser_shift_expression(expression->dot.right, first, base);
         }
 
-        // Create new function body context
-        ptcl_func_body *temp = malloc(sizeof(ptcl_func_body));
-        if (temp == NULL)
+        break;
+    case ptcl_expression_ctor_type:
+        for (size_t i = 0; i < expression->ctor->count; i++)
         {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_parser_syntax_destroy(syntax);
-            return false;
+            ptcl_parser_shift_expression(expression->ctor->values[i], first, base);
         }
 
-        *temp = ptcl_func_body_create(NULL, 0, parser->temp.main_root);
-        parser->temp.root = temp;
-
-        // Process syntax variables
-        for (size_t i = 0; i < result.count; i++)
-        {
-            ptcl_parser_syntax_node syntax_node = result.nodes[i];
-            ptcl_parser_syntax_node target_node = syntax.nodes[i];
-            if (syntax_node.type != ptcl_parser_syntax_node_variable_type)
-            {
-                ptcl_parser_syntax_node_destroy(target_node);
-                continue;
-            }
-
-            ptcl_expression *expression = target_node.value.value;
-            if (expression->return_type.is_static &&
-                expression->return_type.type == ptcl_value_type_type &&
-                expression->return_type.comp_type->invariant != NULL)
-            {
-                ptcl_expression_destroy(expression);
-                const ptcl_parser_tokens_state previous_state = parser->state.tokens;
-                ptcl_parser_set_tokens_state(parser, target_node.value.state);
-                expression = ptcl_parser_cast(parser, NULL, ptcl_parser_expression_with_word_flag | ptcl_parser_expression_change_the_value_flag);
-            }
-
-            ptcl_parser_variable variable = ptcl_parser_variable_create(
-                ptcl_name_create_fast_w(syntax_node.variable.name, false),
-                syntax_node.variable.type,
-                expression,
-                true,
-                ptcl_parser_root(parser));
-            variable.built_in = expression;
-            if (expression->return_type.is_static && expression->return_type.type == ptcl_value_word_type)
-            {
-                variable.is_syntax_word = true;
-            }
+        break;
+    case ptcl_expression_if_type:
+        ptcl_parser_shift_expression(expression->if_expr.condition, first, base);
+        ptcl_parser_shift_expression(expression->if_expr.body, first, base);
+        ptcl_parser_shift_expression(expression->if_expr.else_body, first, base);
+        break;
+    case ptcl_expression_array_element_type:
+        ptcl_parser_shift_expression(expression->array_element.value, first, base);
+        ptcl_parser_shift_expression(expression->array_element.index, first, base);
+        break;
+    case ptcl_expression_in_statement_type:
+        ptcl_parser_shift_statement(expression->internal_statement, first, base);
+        break;
+    default:
+        break;
+    }
+}
 
-            if (!ptcl_parser_add_instance_variable(parser, variable))
-            {
-                ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
-            }
+typedef struct ptcl_parser_worker
+{
+    ptcl_parser *parser;
+    ptcl_parser local;
+    ptcl_parser_stats stats;
+    size_t first;
+    size_t step;
+} ptcl_parser_worker;
+
+// Main arrays don't change while workers run, so prefix of worker array is just copied once
+static bool ptcl_parser_worker_extend(void **items, size_t *count, size_t *capacity, void *source, size_t target, size_t size)
+{
+    if (target > *capacity || *capacity == 0)
+    {
+        size_t new_capacity = *capacity == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : *capacity;
+        while (new_capacity < target)
+        {
+            new_capacity *= 2;
         }
 
-        if (ptcl_parser_critical(parser))
+        void *buffer = realloc(*items, new_capacity * size);
+        if (buffer == NULL)
         {
-            ptcl_parser_syntax_destroy(syntax);
             return false;
         }
 
-        ptcl_parser_set_position(parser, stop);
-        size_t current = parser->state.syntax_depth++;
-        parser->state.syntaxes_nodes[current] = ptcl_parser_syntax_pair_create(
-            syntax, parser->state.tokens, temp,
-            parser->state.syntax_depth == 1 ? temp->root : parser->state.syntaxes_nodes[current - 1].body);
-        ptcl_parser_tokens_state lated_body = parser->lated_states.items[result.index];
-        ptcl_parser_set_tokens_state(parser, lated_body);
-        ptcl_parser_set_position(parser, 0);
+        *items = buffer;
+        *capacity = new_capacity;
     }
-    else
+
+    if (target > *count)
     {
-        ptcl_parser_set_position(parser, start);
-        if (is_root)
+        memcpy((char *)*items + *count * size, (char *)source + *count * size, (target - *count) * size);
+    }
+
+    *count = target;
+    return true;
+}
+
+static bool ptcl_parser_worker_enter(ptcl_parser *local, ptcl_parser *parser, ptcl_parser_deferred_body *body)
+{
+    return ptcl_parser_worker_extend((void **)&local->syntaxes.items, &local->syntaxes.count, &local->syntaxes.capacity,
+                                     parser->syntaxes.items, body->syntaxes_count, sizeof(ptcl_parser_syntax)) &&
+           ptcl_parser_worker_extend((void **)&local->typedatas.items, &local->typedatas.count, &local->typedatas.capacity,
+                                     parser->typedatas.items, body->typedatas_count, sizeof(ptcl_parser_typedata)) &&
+           ptcl_parser_worker_extend((void **)&local->comp_types.items, &local->comp_types.count, &local->comp_types.capacity,
+                                     parser->comp_types.items, body->comp_types_count, sizeof(ptcl_parser_comp_type)) &&
+           ptcl_parser_worker_extend((void **)&local->functions.items, &local->functions.count, &local->functions.capacity,
+                                     parser->functions.items, body->functions_count, sizeof(ptcl_parser_function)) &&
+           ptcl_parser_worker_extend((void **)&local->variables.items, &local->variables.count, &local->variables.capacity,
+                                     parser->variables.items, body->variables_count, sizeof(ptcl_parser_variable));
+}
+
+// Instances of body are already out of scope, so they are released instead of being kept until result.
+// Only variables are kept, because nodes refer to them by index in result
+static bool ptcl_parser_worker_leave(ptcl_parser *local, ptcl_parser_deferred_body *body)
+{
+    for (size_t i = body->syntaxes_count; i < local->syntaxes.count; i++)
+    {
+        ptcl_parser_syntax_destroy(local->syntaxes.items[i]);
+    }
+
+    for (size_t i = body->typedatas_count; i < local->typedatas.count; i++)
+    {
+        ptcl_parser_typedata_destroy(local->typedatas.items[i]);
+    }
+
+    for (size_t i = body->comp_types_count; i < local->comp_types.count; i++)
+    {
+        ptcl_parser_comp_type_destroy(local->comp_types.items[i]);
+    }
+
+    body->declared_count = local->variables.count - body->variables_count;
+    body->declared = NULL;
+    bool is_kept = true;
+    if (body->declared_count > 0)
+    {
+        body->declared = malloc(body->declared_count * sizeof(ptcl_parser_variable));
+        if (body->declared != NULL)
         {
-            ptcl_parser_throw_unknown_syntax(parser, syntax, ptcl_parser_tokens(parser)[start].location);
-            ptcl_parser_syntax_destroy(syntax);
+            memcpy(body->declared, &local->variables.items[body->variables_count], body->declared_count * sizeof(ptcl_parser_variable));
         }
         else
         {
-            if (nodes != NULL)
+            for (size_t i = body->variables_count; i < local->variables.count; i++)
             {
-                *nodes = syntax.nodes;
+                ptcl_parser_variable_destroy(local->variables.items[i]);
             }
 
-            for (size_t i = original_count; i < syntax.count; i++)
-            {
-                ptcl_parser_syntax_node_destroy(syntax.nodes[i]);
-            }
+            body->declared_count = 0;
+            is_kept = false;
         }
     }
 
-    return found;
+    local->syntaxes.count = body->syntaxes_count;
+    local->typedatas.count = body->typedatas_count;
+    local->comp_types.count = body->comp_types_count;
+    local->functions.count = body->functions_count;
+    local->variables.count = body->variables_count;
+    return is_kept;
 }
 
-void ptcl_parser_leave_from_syntax(ptcl_parser *parser)
+static void ptcl_parser_parse_deferred_body(ptcl_parser *local, ptcl_parser *parser, ptcl_parser_deferred_body *body)
 {
-    ptcl_parser_clear_scope(parser);
+    ptcl_func_body *root = body->body->root;
+    local->state = (ptcl_parser_status){0};
+    local->state.tokens = body->tokens;
+    local->state.states = body->states;
+    local->temp = (ptcl_parser_temp){0};
+    local->temp.root = root;
+    local->temp.main_root = root;
+    local->temp.return_type = body->return_type;
+    local->errors = (ptcl_error_array){0};
 
-    ptcl_parser_syntax_pair pair = parser->state.syntaxes_nodes[--parser->state.syntax_depth];
-    if (parser->state.tokens.is_free)
+    const ptcl_location location = ptcl_parser_current(local).location;
+    if (!ptcl_parser_worker_enter(local, parser, body))
     {
-        free(ptcl_parser_tokens(parser));
+        ptcl_parser_throw_out_of_memory(local, location);
+        body->errors = local->errors.items;
+        body->errors_count = local->errors.count;
+        body->declared_count = 0;
+        body->is_critical = true;
+        return;
     }
 
-    ptcl_parser_set_tokens_state(parser, pair.state);
-    ptcl_func_body *temp = pair.body;
-    ptcl_func_body_destroy(*temp);
-    parser->temp.root = pair.previous_body;
-    free(pair.syntax.nodes);
-    free(temp);
-}
-
-void ptcl_parser_leave_from_insert_state(ptcl_parser *parser)
-{
-    if (parser->state.tokens.is_free)
+    for (size_t i = 0; i < body->arguments_count && !ptcl_parser_critical(local); i++)
     {
-        free(ptcl_parser_tokens(parser));
+        ptcl_argument argument = body->arguments[i];
+        ptcl_parser_variable variable = ptcl_parser_variable_create(argument.name, argument.type, NULL, false, body->body);
+        if (!ptcl_parser_add_instance_variable(local, variable))
+        {
+            ptcl_parser_throw_out_of_memory(local, location);
+        }
     }
 
-    ptcl_parser_set_tokens_state(parser, ptcl_parser_insert_state_at(parser, --parser->temp.insert_states_count)->state);
-}
+    if (!ptcl_parser_critical(local))
+    {
+        ptcl_parser_func_body_by_pointer(local, body->body, true, true, false);
+    }
 
-static inline ptcl_statement_func_call ptcl_handle_builtin_execution(ptcl_parser *parser, ptcl_parser_function *target,
-                                                                     ptcl_statement_func_call *func_call, ptcl_location location, bool is_expression)
-{
-    if (ptcl_parser_ignore_error(parser) && strcmp(func_call->func_decl->name.value, PTCL_PARSER_ERROR_FUNC_NAME) == 0)
+    if (ptcl_parser_critical(local))
     {
-        return *func_call;
+        // Statements are already released with body
+        *body->body = ptcl_func_body_create(NULL, 0, root);
     }
 
-    ptcl_expression *result = target->bind(parser, func_call->arguments, func_call->count, location, is_expression);
-    if (ptcl_parser_critical(parser))
+    if (!ptcl_parser_worker_leave(local, body) && !ptcl_parser_critical(local))
     {
-        return (ptcl_statement_func_call){0};
+        ptcl_func_body_destroy(*body->body);
+        *body->body = ptcl_func_body_create(NULL, 0, root);
+        ptcl_parser_throw_out_of_memory(local, location);
     }
 
-    func_call->is_built_in = true;
-    func_call->built_in = result;
-    return *func_call;
+    body->errors = local->errors.items;
+    body->errors_count = local->errors.count;
+    body->is_critical = ptcl_parser_critical(local);
 }
 
-static inline ptcl_statement_func_call ptcl_handle_static_function(ptcl_parser *parser, ptcl_parser_function *target,
-                                                                   ptcl_statement_func_call *func_call, ptcl_expression *self, ptcl_location location)
+static void ptcl_parser_worker_run(void *argument)
 {
-    func_call->is_self_used = false;
-    ptcl_interpreter_reset(parser->interpreter);
-    ptcl_expression *result = ptcl_interpreter_evaluate_function_call(parser->interpreter, *func_call, false, self, &func_call->is_self_used, location);
-    if (ptcl_parser_critical(parser))
+    ptcl_parser_worker *worker = argument;
+    ptcl_deferred_bodies_array *bodies = &worker->parser->deferred_bodies;
+    for (size_t i = worker->first; i < bodies->count; i += worker->step)
     {
-        ptcl_statement_func_call_destroy(*func_call);
-        return (ptcl_statement_func_call){0};
+        ptcl_parser_parse_deferred_body(&worker->local, worker->parser, &bodies->items[i]);
     }
+}
 
-    func_call->built_in = result;
-    func_call->is_built_in = result != NULL;
-    if (func_call->is_built_in)
+static bool ptcl_parser_worker_create(ptcl_parser_worker *worker, ptcl_parser *parser)
+{
+    worker->parser = parser;
+    worker->stats = (ptcl_parser_stats){0};
+    ptcl_parser *local = &worker->local;
+    *local = *parser;
+    local->syntaxes = (ptcl_syntax_array){0};
+    local->typedatas = (ptcl_typedata_array){0};
+    local->comp_types = (ptcl_comptype_array){0};
+    local->functions = (ptcl_function_array){0};
+    local->variables = (ptcl_variable_array){0};
+    local->deferred_bodies = (ptcl_deferred_bodies_array){0};
+    local->each_slots = (ptcl_parser_each_slots){.variable = (size_t)-1};
+    local->syntax_starts = (ptcl_parser_syntax_starts){0};
+    local->stats = parser->stats != NULL ? &worker->stats : NULL;
+    local->profile = NULL;
+    local->trace = NULL;
+    local->jobs = 1;
+
+    // Lated states and this pairs are only read by ordinary bodies, own arena is adopted by result after join
+    local->interpreter = ptcl_interpreter_create(local);
+    local->arena = ptcl_arena_create(PTCL_ARENA_DEFAULT_CHUNK_SIZE / 16);
+    local->types = ptcl_type_interner_create_local(parser->types);
+    if (local->interpreter == NULL || local->arena == NULL || local->types == NULL)
     {
-        ptcl_statement_func_call_destroy(*func_call);
-        if (!func_call->is_self_used)
+        if (local->interpreter != NULL)
         {
-            ptcl_expression_destroy(self);
+            ptcl_interpreter_destroy(local->interpreter);
         }
-    }
 
-    return *func_call;
-}
+        ptcl_arena_destroy(local->arena);
+        ptcl_type_interner_destroy(local->types);
+        return false;
+    }
 
-// TODO: remove to node
-static ptcl_expression *ptcl_get_self(ptcl_expression *expression)
-{
-    return expression->type == ptcl_expression_cast_type ? ptcl_get_self(expression->cast.value) : expression;
+    return true;
 }
 
-static inline ptcl_statement_func_call ptcl_handle_static_return_function(ptcl_parser *parser, ptcl_parser_function *target,
-                                                                          ptcl_statement_func_call *func_call, ptcl_expression *self, bool is_expression, ptcl_location location)
+static void ptcl_parser_worker_destroy(ptcl_parser_worker *worker)
 {
-    ptcl_statement *statement = ptcl_func_body_create_stat(ptcl_statement_func_body_create(NULL, 0, NULL), parser->temp.root, location);
-    if (statement == NULL)
+    ptcl_parser *local = &worker->local;
+    ptcl_parser_stats *stats = worker->parser->stats;
+    if (stats != NULL)
     {
-        ptcl_statement_func_call_destroy(*func_call);
-        ptcl_parser_throw_out_of_memory(parser, location);
-        return (ptcl_statement_func_call){0};
+        stats->lookups_count += worker->stats.lookups_count;
+        stats->lookups_scanned += worker->stats.lookups_scanned;
+        stats->syntax_match_attempts += worker->stats.syntax_match_attempts;
+        stats->syntax_backtracks += worker->stats.syntax_backtracks;
+        stats->syntax_expansions += worker->stats.syntax_expansions;
+        stats->lated_body_reparses += worker->stats.lated_body_reparses;
+        stats->cast_checks += worker->stats.cast_checks;
+        stats->interpreter_calls += worker->stats.interpreter_calls;
+        stats->interpreter_statements += worker->stats.interpreter_statements;
     }
 
-    ptcl_statement_func_body *placeholder = malloc(sizeof(ptcl_statement_func_body));
-    if (placeholder == NULL)
+    // Nodes of bodies refer to local types, so interner keeps them until result is released
+    if (!ptcl_type_interner_adopt(worker->parser->types, local->types))
     {
-        ptcl_statement_func_call_destroy(*func_call);
-        free(placeholder);
-        free(statement);
-        ptcl_parser_throw_out_of_memory(parser, location);
-        return (ptcl_statement_func_call){0};
+        ptcl_parser_throw_out_of_memory(worker->parser, ptcl_parser_current(worker->parser).location);
     }
 
-    func_call->is_self_used = false;
-    const bool is_self = self != NULL && self->return_type.is_static;
-    *placeholder = ptcl_statement_func_body_inserted_create(
-        NULL, 0, target->root, NULL, target->func.arguments, target->func.count, is_self ? NULL : self, *func_call);
-    statement->root = &placeholder->body;
-    int self_identifier = -1;
-    if (self != NULL)
+    ptcl_interpreter_destroy(local->interpreter);
+    ptcl_arena_adopt(worker->parser->arena, local->arena);
+    free(local->syntaxes.items);
+    free(local->typedatas.items);
+    free(local->comp_types.items);
+    free(local->functions.items);
+    free(local->variables.items);
+    free(local->syntax_starts.words);
+}
+
+// Variables of body get indices after already known ones, so identifiers in its nodes are shifted
+static void ptcl_parser_append_declared(ptcl_parser *parser)
+{
+    ptcl_deferred_bodies_array *bodies = &parser->deferred_bodies;
+    bool is_out_of_memory = false;
+    for (size_t i = 0; i < bodies->count; i++)
     {
-        ptcl_expression *value = self;
-        const bool is_built_in = self->return_type.is_static;
-        if (is_built_in)
+        ptcl_parser_deferred_body *body = &bodies->items[i];
+        const size_t base = parser->variables.count;
+        for (size_t j = 0; j < body->declared_count; j++)
         {
-            value = ptcl_get_self(value);
+            if (is_out_of_memory || !ptcl_parser_add_instance_variable(parser, body->declared[j]))
+            {
+                ptcl_parser_variable_destroy(body->declared[j]);
+                is_out_of_memory = true;
+            }
         }
 
-        self_identifier = (int)parser->variables.count;
-        ptcl_type type = value == self ? value->return_type.comp_type->types[0].type : value->return_type;
-        ptcl_parser_variable variable = ptcl_parser_variable_create(ptcl_name_self, type, value, is_built_in, &placeholder->body);
-        if (!ptcl_parser_add_instance_variable(parser, variable))
+        free(body->declared);
+        if (!is_out_of_memory)
         {
-            ptcl_statement_func_call_destroy(*func_call);
-            free(placeholder);
-            free(statement);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            return (ptcl_statement_func_call){0};
+            ptcl_parser_shift_body(*body->body, body->variables_count, base);
         }
     }
 
-    size_t variables_index = parser->variables.count;
-    for (size_t i = 0; i < func_call->count; i++)
+    if (is_out_of_memory)
     {
-        ptcl_expression *argument = func_call->arguments[i];
-        ptcl_parser_variable variable = ptcl_parser_variable_create(
-            target->func.arguments[i].name,
-            argument->return_type,
-            argument,
-            true,
-            &placeholder->body);
-        if (!ptcl_parser_add_instance_variable(parser, variable))
-        {
-            for (size_t j = i; j < func_call->count; j++)
-            {
-                ptcl_expression_destroy(func_call->arguments[j]);
-            }
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+    }
+}
 
-            free(func_call->arguments);
-            free(placeholder);
-            free(statement);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            if (self_identifier > -1)
+// Errors of bodies are placed by source order. Serial parsing stops on first critical error, so nothing after it is kept
+static void ptcl_parser_merge_deferred_errors(ptcl_parser *parser)
+{
+    ptcl_deferred_bodies_array *bodies = &parser->deferred_bodies;
+    ptcl_error_array *errors = &parser->errors;
+    size_t capacity = errors->count;
+    for (size_t i = 0; i < bodies->count; i++)
+    {
+        capacity += bodies->items[i].errors_count;
+    }
+
+    if (capacity == errors->count)
+    {
+        return;
+    }
+
+    ptcl_parser_error *merged = malloc(capacity * sizeof(ptcl_parser_error));
+    if (merged == NULL)
+    {
+        for (size_t i = 0; i < bodies->count; i++)
+        {
+            for (size_t j = 0; j < bodies->items[i].errors_count; j++)
             {
-                parser->variables.items[self_identifier].is_built_in = false;
+                ptcl_parser_error_destroy(bodies->items[i].errors[j]);
             }
 
-            return (ptcl_statement_func_call){0};
+            free(bodies->items[i].errors);
         }
-    }
 
-    bool last_state = ptcl_parser_except_return(parser);
-    ptcl_type *last_return_type = parser->temp.return_type;
-    ptcl_type func_return_type = target->func.return_type;
-    // static (...): static T -> inline without static return type by specification
-    if (func_return_type.is_static && ptcl_statement_modifiers_flags_static(target->func.modifiers))
-    {
-        func_return_type.is_static = false;
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        return;
     }
 
-    ptcl_parser_enable_state(parser, ptcl_parser_except_return_flag);
-    parser->temp.return_type = &func_return_type;
-
-    ptcl_parser_tokens_state last_tokens = parser->state.tokens;
-    ptcl_parser_tokens_state body = parser->lated_states.items[target->func.index];
-    ptcl_parser_set_tokens_state(parser, body);
-    ptcl_parser_set_position(parser, 0);
+    size_t count = 0;
+    size_t next = 0;
+    bool is_stopped = false;
+    for (size_t i = 0; i < bodies->count; i++)
+    {
+        ptcl_parser_deferred_body *body = &bodies->items[i];
+        const size_t position = body->tokens.tokens[body->tokens.position].location.position;
+        while (!is_stopped && next < errors->count && errors->items[next].location.position < position)
+        {
+            merged[count++] = errors->items[next++];
+        }
 
-    ptcl_parser_func_body_by_pointer(parser, &placeholder->body, true, true, false);
+        for (size_t j = 0; j < body->errors_count; j++)
+        {
+            if (is_stopped)
+            {
+                ptcl_parser_error_destroy(body->errors[j]);
+                continue;
+            }
 
-    ptcl_parser_set_tokens_state(parser, last_tokens);
+            merged[count++] = body->errors[j];
+        }
 
-    ptcl_parser_variable *self_variable = NULL;
-    if (self_identifier > -1)
-    {
-        self_variable = &parser->variables.items[self_identifier];
-        self_variable->is_built_in = false;
+        free(body->errors);
+        is_stopped = is_stopped || body->is_critical;
     }
 
-    parser->temp.return_type = last_return_type;
-    ptcl_parser_set_state(
-        parser, ptcl_parser_except_return_flag, last_state);
-    if (ptcl_parser_critical(parser))
+    for (; next < errors->count; next++)
     {
-    cleanup:
-        for (size_t i = variables_index; i < parser->variables.count; i++)
+        if (is_stopped)
         {
-            parser->variables.items[i].is_built_in = false;
+            ptcl_parser_error_destroy(errors->items[next]);
+            continue;
         }
 
-        ptcl_statement_func_call_destroy(*func_call);
-        if (placeholder != NULL)
-        {
-            free(placeholder);
-        }
+        merged[count++] = errors->items[next];
+    }
 
-        free(statement);
-        return (ptcl_statement_func_call){0};
+    free(errors->items);
+    errors->items = merged;
+    errors->count = count;
+    errors->capacity = capacity;
+    if (is_stopped)
+    {
+        ptcl_parser_enable_state(parser, ptcl_parser_critical_flag);
     }
+}
 
-    if (is_expression)
+// Parses deferred bodies on workers, the calling thread is one of them
+static void ptcl_parser_join_bodies(ptcl_parser *parser)
+{
+    ptcl_deferred_bodies_array *bodies = &parser->deferred_bodies;
+    if (bodies->count == 0)
     {
-        placeholder->caller = parser->temp.return_value;
+        return;
     }
 
-    statement->body = *placeholder;
-    statement->body.func_call = *func_call;
-    free(placeholder);
-    placeholder = NULL;
+    const uint64_t trace_start = PTCL_TRACE_START(parser->trace);
+    const size_t jobs = parser->jobs < bodies->count ? parser->jobs : bodies->count;
+    ptcl_parser_worker *workers = malloc(jobs * sizeof(ptcl_parser_worker));
+    ptcl_thread **threads = malloc(jobs * sizeof(ptcl_thread *));
+    size_t count = 0;
+    while (workers != NULL && threads != NULL && count < jobs && ptcl_parser_worker_create(&workers[count], parser))
+    {
+        count++;
+    }
 
-    ptcl_func_body *root_body = ptcl_parser_current_body(parser);
-    size_t new_count = root_body->count + 1;
-    ptcl_statement **new_statements = realloc(root_body->statements,
-                                              sizeof(ptcl_statement *) * new_count);
-    if (new_statements == NULL)
+    if (count == 0)
     {
-        goto cleanup;
+        free(workers);
+        free(threads);
+        bodies->count = 0;
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        return;
     }
 
-    new_statements[root_body->count] = statement;
-    root_body->statements = new_statements;
-    root_body->count = new_count;
+    for (size_t i = 0; i < count; i++)
+    {
+        workers[i].first = i;
+        workers[i].step = count;
+        threads[i] = i == 0 ? NULL : ptcl_thread_create(ptcl_parser_worker_run, &workers[i]);
+    }
 
-    func_call->is_built_in = true;
-    func_call->built_in = parser->temp.return_value;
-    if (self_variable != NULL && !self_variable->is_used)
+    ptcl_parser_worker_run(&workers[0]);
+    for (size_t i = 1; i < count; i++)
     {
-        ptcl_expression_destroy(self);
+        if (threads[i] == NULL)
+        {
+            ptcl_parser_worker_run(&workers[i]);
+            continue;
+        }
+
+        ptcl_thread_join(threads[i]);
     }
 
-    for (size_t i = 0; i < func_call->count; i++)
+    for (size_t i = 0; i < count; i++)
     {
-        ptcl_parser_variable *variable = &parser->variables.items[i + variables_index];
-        variable->is_built_in = false;
+        ptcl_parser_worker_destroy(&workers[i]);
     }
 
-    return *func_call;
+    free(workers);
+    free(threads);
+    ptcl_parser_append_declared(parser);
+    ptcl_parser_merge_deferred_errors(parser);
+    bodies->count = 0;
+    PTCL_TRACE_ADD(parser->trace, "parser", "deferred bodies", NULL, trace_start);
 }
 
-static bool ptcl_parser_func_call_args(ptcl_parser *parser, ptcl_statement_func_call *func_call, ptcl_statement_func_decl *target, ptcl_location location)
+static bool ptcl_parser_parse_dynamic_body(
+    ptcl_parser *parser,
+    ptcl_statement_func_decl *func_decl,
+    ptcl_type *return_type,
+    const size_t variable_index,
+    const size_t function_index)
 {
-    size_t expected_arguments = target->is_variadic ? target->count + 4 : target->count;
-    if (expected_arguments > 0)
+    ptcl_location location = ptcl_parser_current(parser).location;
+    func_decl->func_body = malloc(sizeof(ptcl_func_body));
+    if (func_decl->func_body == NULL)
     {
-        func_call->arguments = malloc(expected_arguments * sizeof(ptcl_expression *));
-        if (func_call->arguments == NULL)
+        ptcl_parser_throw_out_of_memory(parser, location);
+    cleanup:
+        free(func_decl->func_body);
+        ptcl_statement_func_decl_destroy(*func_decl);
+        free(return_type);
+        if (!ptcl_parser_in_type(parser))
+        {
+            parser->variables.items[variable_index].is_out_of_scope = true;
+            parser->functions.items[function_index].is_out_of_scope = true;
+        }
+
+        return false;
+    }
+
+    *func_decl->func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
+    const ptcl_type *previous_type = parser->temp.return_type;
+    parser->temp.return_type = return_type;
+    for (size_t i = 0; i < func_decl->count; i++)
+    {
+        ptcl_argument argument = func_decl->arguments[i];
+        ptcl_parser_variable variable = ptcl_parser_variable_create(argument.name, argument.type, NULL, false, func_decl->func_body);
+        variable.type.is_static = variable.type.is_static;
+        if (!ptcl_parser_add_instance_variable(parser, variable))
         {
             ptcl_parser_throw_out_of_memory(parser, location);
-            return false;
+            goto cleanup;
         }
     }
 
-    const size_t start = ptcl_parser_insert_states_count(parser);
-    bool is_parsing_tokens = false;
+    const bool is_static = ptcl_statement_modifiers_flags_static(func_decl->modifiers);
+    const bool last_state = ptcl_parser_in_type(parser);
+    ptcl_parser_disable_state(parser, ptcl_parser_in_type_flag);
+    ptcl_parser_func_body_by_pointer(parser, func_decl->func_body, true, true, is_static);
 
-    const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
-    ptcl_parser_disable_state(parser, ptcl_parser_in_return_flag);
-    while (!ptcl_parser_match(parser, ptcl_token_right_par_type))
+    ptcl_parser_set_state(parser, ptcl_parser_in_type_flag, last_state);
+    if (ptcl_parser_critical(parser))
     {
-        if (ptcl_parser_ended(parser))
-        {
-            if (is_parsing_tokens)
-            {
-                ptcl_parser_leave_from_insert_state(parser);
-                if (ptcl_parser_insert_states_count(parser) == start)
-                {
-                    is_parsing_tokens = false;
-                }
+        parser->temp.return_type = previous_type;
+        goto cleanup;
+    }
 
-                continue;
-            }
+    ptcl_statement_modifiers_flags_remove(&func_decl->modifiers, ptcl_statement_modifiers_prototype_flag);
+    if (!ptcl_parser_in_type(parser))
+    {
+        ptcl_parser_function *original = &parser->functions.items[function_index];
+        original->func = *func_decl;
+    }
 
-            ptcl_parser_throw_except_token(
-                parser,
-                ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_par_type),
-                location);
-            goto leave;
-        }
+    parser->temp.return_type = previous_type;
+    return true;
+}
 
-        ptcl_parser_tokens_state temp_state;
-        bool is_toggle = ptcl_parser_try_parse_insert(parser, &temp_state, ptcl_parser_current(parser).location);
-        if (ptcl_parser_critical(parser))
+static bool ptcl_parser_parse_static_body(ptcl_parser *parser, ptcl_statement_func_decl *func_decl, const size_t function_identifier)
+{
+    size_t start = ptcl_parser_position(parser);
+    ptcl_parser_skip(parser);
+    ptcl_parser_skip_block_or_expression(parser);
+    if (ptcl_parser_critical(parser))
+    {
+    cleanup:
+        ptcl_statement_func_decl_destroy(*func_decl);
+        if (!ptcl_parser_in_type(parser))
         {
-            goto leave;
+            parser->functions.items[function_identifier].is_out_of_scope = true;
         }
 
-        if (ptcl_parser_insert_states_count(parser) >= PTCL_PARSER_DECL_INSERT_DEPTH)
-        {
-            ptcl_parser_throw_out_of_memory(parser, location);
-            goto leave;
-        }
+        return false;
+    }
 
-        if (is_toggle)
-        {
-            is_parsing_tokens = true;
-            ptcl_parser_insert_state_add_and_set(parser, ptcl_parser_insert_state_create(temp_state, parser->state.syntax_depth));
-            continue;
-        }
+    const ptcl_location location = ptcl_parser_current(parser).location;
+    // With curly
+    const size_t tokens_count = (ptcl_parser_position(parser) - start);
+    const size_t index = ptcl_parser_add_lated_body(parser, start, tokens_count, false, location);
+    if (ptcl_parser_critical(parser))
+    {
+        goto cleanup;
+    }
 
-        if (!target->is_variadic && func_call->count >= target->count)
-        {
-            ptcl_parser_throw_wrong_arguments(parser, target->name.value, func_call->arguments,
-                                              func_call->count, target->arguments, target->count, location);
-            goto leave;
-        }
+    func_decl->index = index;
+    if (!ptcl_parser_in_type(parser))
+    {
+        ptcl_parser_function *original = &parser->functions.items[function_identifier];
+        original->func = *func_decl;
+    }
 
-        if (func_call->count >= expected_arguments)
-        {
-            expected_arguments = expected_arguments * 2 + 4;
-            ptcl_expression **buffer = realloc(func_call->arguments, expected_arguments * sizeof(ptcl_expression *));
-            if (buffer == NULL)
-            {
-                ptcl_parser_throw_out_of_memory(parser, location);
-            leave:
-                ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
-                ptcl_statement_func_call_destroy(*func_call);
-                if (ptcl_parser_insert_states_count(parser) > 1)
-                {
-                    for (size_t i = start + 1; i < ptcl_parser_insert_states_count(parser); i++)
-                    {
-                        free(ptcl_parser_insert_state_at(parser, i)->state.tokens);
-                    }
+    return true;
+}
 
-                    free(parser->state.tokens.tokens);
-                    ptcl_parser_set_tokens_state(parser, ptcl_parser_insert_state_at(parser, 0)->state);
-                }
+static void ptcl_parser_func_decl_set_from_args(ptcl_statement_func_decl *func_decl, ptcl_parse_arguments_result arguments)
+{
+    func_decl->arguments = arguments.arguments;
+    func_decl->count = arguments.count;
+    func_decl->is_variadic = arguments.has_variadic;
+    func_decl->with_self = arguments.with_self;
+    func_decl->is_self_const = arguments.is_const;
+}
 
-                return false;
-            }
+ptcl_statement_func_decl ptcl_parser_func_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
+{
+    ptcl_parser_match(parser, ptcl_token_function_type);
 
-            func_call->arguments = buffer;
-        }
+    ptcl_token current = ptcl_parser_current(parser);
+    ptcl_location location = current.location;
+    const bool is_constructor = current.type == ptcl_token_left_par_type;
 
-        ptcl_argument *argument = (func_call->count < target->count) ? &target->arguments[func_call->count] : NULL;
-        ptcl_type *excepted = (argument && !argument->is_variadic) ? &argument->type : NULL;
-        func_call->arguments[func_call->count] = ptcl_parser_cast(parser, excepted, ptcl_parser_expression_flags_default(true));
+    ptcl_name name = ptcl_name_empty;
+    if (!is_constructor)
+    {
+        name = ptcl_parser_name_word(parser);
         if (ptcl_parser_critical(parser))
         {
-            goto leave;
+            return (ptcl_statement_func_decl){0};
+        }
+    }
+    else
+    {
+        if (!ptcl_parser_in_type(parser))
+        {
+            ptcl_parser_except(parser, ptcl_token_word_type);
+            return (ptcl_statement_func_decl){0};
         }
+    }
 
-        func_call->count++;
-        ptcl_parser_match(parser, ptcl_token_comma_type);
+    ptcl_parser_function *prototype_function = NULL;
+    if (!is_constructor &&
+        ptcl_parser_try_get_function(parser, name, &prototype_function) &&
+        !ptcl_statement_modifiers_flags_prototype(prototype_function->func.modifiers))
+    {
+        ptcl_parser_throw_redefination(parser, name.value, location);
+    }
+
+    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
+    {
+        ptcl_name_destroy(name);
+        return (ptcl_statement_func_decl){0};
+    }
+
+    // We set prototype, because on freeing we dont have body
+    ptcl_statement_func_decl func_decl = ptcl_statement_func_decl_create(
+        modifiers | ptcl_statement_modifiers_prototype_flag,
+        parser->temp.root,
+        name,
+        NULL,
+        0,
+        NULL,
+        ptcl_type_integer,
+        false,
+        is_constructor);
+    ptcl_parse_arguments_result arguments = ptcl_parser_parse_arguments(
+        parser,
+        location,
+        !ptcl_statement_modifiers_flags_global(modifiers) && ptcl_parser_in_type(parser),
+        ptcl_parser_args_func_type);
+    if (ptcl_parser_critical(parser))
+    {
+        ptcl_name_destroy(name);
+        free(func_decl.func_body);
+        return (ptcl_statement_func_decl){0};
     }
 
-    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
-    const bool argument_count_mismatch = target->is_variadic
-                                             ? (func_call->count < target->count - 1)
-                                             : (func_call->count != target->count);
-    if (argument_count_mismatch)
+    if (ptcl_parser_not(parser, ptcl_token_colon_type))
     {
-        ptcl_parser_throw_wrong_arguments(parser, target->name.value, func_call->arguments,
-                                          func_call->count, target->arguments, target->count, location);
-        ptcl_statement_func_call_destroy(*func_call);
-        return false;
+    prototype_cleanup:
+        ptcl_parse_arguments_result_destroy(arguments);
+        ptcl_name_destroy(name);
+        free(func_decl.func_body);
+        return (ptcl_statement_func_decl){0};
     }
 
-    return true;
-}
+    ptcl_type return_type = ptcl_parser_type(parser, false, false, true);
+    if (ptcl_parser_critical(parser))
+    {
+        goto prototype_cleanup;
+    }
 
-static ptcl_name ptcl_parser_name_by_func(ptcl_parser *parser, ptcl_parser_function *function)
-{
-    return (ptcl_parser_current(parser).type == ptcl_token_left_par_type)
-               ? ptcl_name_create_l(function->name.value, function->name.is_anonymous, false, function->name.location)
-               : ptcl_parser_name_word(parser);
-}
+    func_decl.return_type = return_type;
+    ptcl_parser_func_decl_set_from_args(&func_decl, arguments);
 
-ptcl_statement_func_call ptcl_parser_func_call(ptcl_parser *parser, ptcl_parser_function *function, ptcl_expression *self, bool is_expression)
-{
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_identifier identifier;
-    ptcl_name name;
-    if (function != NULL)
+    const size_t variable_identifier = parser->variables.count;
+    const size_t function_identifier = parser->functions.count;
+    ptcl_type *variable_return_type = ptcl_parser_register_function(parser, func_decl, prototype_function);
+    if (ptcl_parser_critical(parser))
     {
-        name = ptcl_parser_name_by_func(parser, function);
-        identifier = ptcl_identifier_create_by_name(name);
+        // Already destroyed above
+        return (ptcl_statement_func_decl){0};
     }
-    else
-    {
-        const size_t start = ptcl_parser_position(parser);
-        name = ptcl_parser_name_word(parser);
-        if (ptcl_parser_critical(parser))
-        {
-            return (ptcl_statement_func_call){0};
-        }
 
-        if (ptcl_parser_current(parser).type != ptcl_token_left_par_type)
+    if (!ptcl_statement_modifiers_flags_prototype(modifiers))
+    {
+        if (!func_decl.return_type.is_static)
         {
-            ptcl_parser_expression_flags flags = ptcl_parser_expression_flags_default(is_expression);
-            ptcl_expression *variable = ptcl_parser_func_call_or_var(parser, name, ptcl_parser_current(parser), flags, false);
-            if (ptcl_parser_critical(parser))
+            if ((parser->jobs > 1 || parser->incremental != NULL) && ptcl_parser_is_plain_body(parser, modifiers) &&
+                (ptcl_parser_reuse_body(parser, &func_decl, function_identifier) ||
+                 (parser->jobs > 1 && ptcl_parser_defer_body(parser, &func_decl, variable_return_type, function_identifier))))
             {
-                return (ptcl_statement_func_call){0};
+                return func_decl;
             }
 
-            ptcl_expression *expression = ptcl_parser_dot(parser, NULL, variable, flags);
-            if (ptcl_parser_critical(parser))
+            if (!ptcl_parser_parse_dynamic_body(parser, &func_decl, variable_return_type, variable_identifier, function_identifier))
             {
-                ptcl_expression_destroy(variable);
-                return (ptcl_statement_func_call){0};
+                // Already destroyed above
+                return (ptcl_statement_func_decl){0};
+            }
+        }
+        else
+        {
+            if (!ptcl_parser_parse_static_body(parser, &func_decl, function_identifier))
+            {
+                // Already destroyed above
+                return (ptcl_statement_func_decl){0};
             }
-
-            identifier = ptcl_identifier_create_by_expr(expression);
-            return ptcl_statement_func_call_create(expression->dot.right->func_call.func_decl, identifier, NULL, 0);
         }
-
-        identifier = ptcl_identifier_create_by_name(name);
     }
 
-    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
-    {
-        ptcl_identifier_destroy(identifier);
-        return (ptcl_statement_func_call){0};
-    }
+    return func_decl;
+}
 
-    ptcl_statement_func_decl target;
-    if (function == NULL)
+ptcl_statement_typedata_decl ptcl_parser_typedata_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
+{
+    ptcl_parser_match(parser, ptcl_token_typedata_type);
+
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_name name = ptcl_parser_name_word(parser);
+    if (ptcl_parser_critical(parser))
     {
-        ptcl_parser_function *instance_target = NULL;
-        if (!ptcl_parser_try_get_function(parser, name, &function))
-        {
-            ptcl_identifier_destroy(identifier);
-            ptcl_parser_throw_unknown_function(parser, name.value, location);
-            return (ptcl_statement_func_call){0};
-        }
+        return (ptcl_statement_typedata_decl){0};
     }
 
-    target = function->func;
-    if (is_expression && target.return_type.type == ptcl_value_void_type)
+    if (ptcl_parser_is_typedata_defined(parser, name))
     {
-        ptcl_identifier_destroy(identifier);
-        ptcl_parser_throw_except_type_specifier(parser, ptcl_parser_current(parser).location);
-        return (ptcl_statement_func_call){0};
+        ptcl_parser_throw_redefination(parser, name.value, location);
     }
 
-    ptcl_statement_func_call func_call = ptcl_statement_func_call_create(&target, identifier, NULL, 0);
-    if (!ptcl_parser_func_call_args(parser, &func_call, func_call.func_decl, location))
+    ptcl_statement_typedata_decl decl = ptcl_statement_typedata_decl_create(modifiers, name, NULL, 0, true, true);
+    if (ptcl_statement_modifiers_flags_prototype(decl.modifiers))
     {
-        return (ptcl_statement_func_call){0};
+        return decl;
     }
 
-    func_call.return_type = target.return_type;
-    if (function != NULL && function->is_built_in)
+    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
     {
-        return ptcl_handle_builtin_execution(parser, function, &func_call, location, is_expression);
+        ptcl_statement_typedata_decl_destroy(decl);
+        return (ptcl_statement_typedata_decl){0};
     }
-    else if (target.return_type.is_static)
+
+    decl.is_prototype = false;
+    ptcl_parse_arguments_result members = ptcl_parser_parse_arguments(parser, ptcl_parser_current(parser).location, false, ptcl_parser_args_typedata_type);
+    if (ptcl_parser_critical(parser))
     {
-        return ptcl_handle_static_return_function(parser, function, &func_call, self, is_expression, location);
+        ptcl_statement_typedata_decl_destroy(decl);
+        return (ptcl_statement_typedata_decl){0};
     }
-    else if (ptcl_statement_modifiers_flags_static(target.modifiers))
+
+    decl.members = members.arguments;
+    decl.count = members.count;
+    decl.is_static = !members.has_unstatic_member;
+    ptcl_type_typedata *typedata = malloc(sizeof(ptcl_type_typedata));
+    if (typedata == NULL)
     {
-        return ptcl_handle_static_function(parser, function, &func_call, self, location);
+        ptcl_statement_typedata_decl_destroy(decl);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return (ptcl_statement_typedata_decl){0};
     }
-    else
+
+    *typedata = ptcl_type_typedata_create(decl.name, decl.members, decl.count, !members.has_unstatic_member);
+    ptcl_parser_typedata instance = ptcl_parser_typedata_create(
+        ptcl_statement_modifiers_flags_global(decl.modifiers) ? NULL : ptcl_parser_root(parser),
+        typedata);
+    if (!ptcl_parser_add_instance_typedata(parser, instance))
     {
-        func_call.is_built_in = false;
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_statement_typedata_decl_destroy(decl);
+        free(typedata);
+        return (ptcl_statement_typedata_decl){0};
     }
 
-    return func_call;
-}
-
-ptcl_func_body ptcl_parser_func_body(ptcl_parser *parser, bool with_brackets, bool change_root, bool is_static)
-{
-    ptcl_func_body func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
-    ptcl_parser_func_body_by_pointer(parser, &func_body, with_brackets, change_root, is_static);
-    return func_body;
+    return decl;
 }
 
-void ptcl_parser_func_body_by_pointer(ptcl_parser *parser, ptcl_func_body *func_body_pointer, bool with_brackets, bool change_root, bool is_ignore_error)
+static bool ptcl_parser_type_decl_types(ptcl_parser *parser, ptcl_statement_type_decl *decl, ptcl_location location)
 {
-    ptcl_parser_match(parser, ptcl_token_left_curly_type);
-
-    ptcl_func_body *previous = ptcl_parser_root(parser);
-    ptcl_func_body *previous_main = parser->temp.main_root;
-    if (change_root)
-    {
-        parser->temp.root = func_body_pointer;
-        parser->temp.main_root = func_body_pointer;
-    }
-
-    const bool last_ignore_error = ptcl_parser_ignore_error(parser);
-    ptcl_parser_set_state(parser, ptcl_parser_ignore_error_flag, is_ignore_error);
-
-    size_t depth = parser->state.syntax_depth;
-    while (depth <= parser->state.syntax_depth)
+    while (true)
     {
-        if (with_brackets && ptcl_parser_match(parser, ptcl_token_right_curly_type))
+        ptcl_type_member *buffer = realloc(decl->types, (decl->types_count + 1) * sizeof(ptcl_type_member));
+        if (buffer == NULL)
         {
-            break;
+            ptcl_statement_type_decl_destroy(*decl);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return false;
         }
 
-        if (ptcl_parser_ended(parser))
+        decl->types = buffer;
+        bool is_up = ptcl_parser_match(parser, ptcl_token_up_type);
+        ptcl_type type = ptcl_parser_type(parser, false, false, true);
+        if (ptcl_parser_critical(parser))
         {
-            if (with_brackets)
+            if (decl->types_count == 0)
             {
-                ptcl_location location = ptcl_parser_current(parser).location;
-                char *token = ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type);
-                ptcl_parser_throw_except_token(parser, token, location);
-                ptcl_func_body_destroy(*func_body_pointer);
+                free(decl->types);
             }
 
-            break;
+            ptcl_statement_type_decl_destroy(*decl);
+            return false;
         }
 
-        ptcl_statement *statement = ptcl_parser_parse_statement(parser);
-        if (ptcl_parser_critical(parser))
+        if (decl->types_count > 0)
         {
-            ptcl_parser_clear_scope(parser);
-            ptcl_func_body_destroy(*func_body_pointer);
-            break;
+            ptcl_type_member expected = decl->types[decl->types_count - 1];
+            if (!ptcl_parser_is_castable(parser, expected.type, type))
+            {
+                ptcl_parser_throw_fast_incorrect_type(parser, expected.type, type, location);
+                ptcl_statement_type_decl_destroy(*decl);
+                return false;
+            }
         }
 
-        if (statement == NULL)
+        decl->types[decl->types_count++] = ptcl_type_member_create(type, is_up);
+        if (!ptcl_parser_match(parser, ptcl_token_comma_type))
         {
-            continue;
+            break;
         }
+    }
 
-        if (ptcl_parser_except_return(parser) && statement->type == ptcl_statement_return_type)
-        {
-            parser->temp.return_value = statement->ret.value;
-            free(statement);
-            continue;
-        }
+    return true;
+}
+
+static bool ptcl_parser_type_decl_body(ptcl_parser *parser, ptcl_statement_type_decl *decl, ptcl_type_comp_type *comp_type, ptcl_location location)
+{
+    ptcl_func_body *body = malloc(sizeof(ptcl_func_body));
+    if (body == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_statement_type_decl_destroy(*decl);
+        return false;
+    }
+
+    *body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
+    comp_type->functions = body;
+    ptcl_parser_variable this_var = ptcl_parser_variable_not_static_create(
+        ptcl_name_create_fast_w("this", false),
+        ptcl_type_create_comp_type_t(comp_type, false), NULL, false, body);
+    this_var.type.is_static = this_var.type.is_static;
+    this_var.type.is_static = false;
+    ptcl_parser_variable self_var = ptcl_parser_variable_not_static_create(
+        ptcl_name_create_fast_w("self", false),
+        decl->types[0].type, NULL, false, body);
+    self_var.type.is_static = self_var.type.is_static;
+    if (!ptcl_parser_add_instance_variable(parser, this_var) || !ptcl_parser_add_instance_variable(parser, self_var))
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_statement_type_decl_destroy(*decl);
+        ptcl_func_body_destroy(*body);
+        free(body);
+        return false;
+    }
 
-        ptcl_statement **buffer = realloc(func_body_pointer->statements, (func_body_pointer->count + 1) * sizeof(ptcl_statement *));
-        if (buffer == NULL)
-        {
-            ptcl_func_body_destroy(*func_body_pointer);
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            break;
-        }
+    const bool last_state = ptcl_parser_in_type(parser);
+    ptcl_parser_enable_state(parser, ptcl_parser_in_type_flag);
 
-        func_body_pointer->statements = buffer;
-        func_body_pointer->statements[func_body_pointer->count] = statement;
-        if (ptcl_parser_critical(parser))
-        {
-            ptcl_func_body_destroy(*func_body_pointer);
-            break;
-        }
+    ptcl_parser_func_body_by_pointer(parser, body, true, true, false);
 
-        func_body_pointer->count++;
-    }
+    ptcl_parser_set_state(parser, ptcl_parser_in_type_flag, last_state);
 
-    ptcl_parser_set_state(parser, ptcl_parser_ignore_error_flag, last_ignore_error);
-    if (change_root)
+    if (ptcl_parser_critical(parser))
     {
-        ptcl_parser_clear_scope(parser);
-        parser->temp.root = previous;
-        parser->temp.main_root = previous_main;
+        free(body);
+        ptcl_statement_type_decl_destroy(*decl);
+        return false;
     }
-}
 
-ptcl_func_body *ptcl_parser_current_body(ptcl_parser *parser)
-{
-    return parser->temp.inserted_body == NULL                           ? parser->temp.main_root
-           : parser->temp.inserted_body->root == parser->temp.main_root ? parser->temp.inserted_body
-                                                                        : parser->temp.main_root;
+    decl->body = body;
+    decl->functions = comp_type->functions;
+    return true;
 }
 
-void ptcl_parser_extra_body(ptcl_parser *parser, bool is_syntax)
+ptcl_statement_type_decl ptcl_parser_type_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
 {
-    if (ptcl_parser_current(parser).type != ptcl_token_at_type || ptcl_parser_peek(parser, 1).type != ptcl_token_left_curly_type)
+    ptcl_parser_match(parser, ptcl_token_type_type);
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_name name = ptcl_parser_name_word(parser);
+    if (ptcl_parser_critical(parser))
     {
-        return;
+        return (ptcl_statement_type_decl){0};
     }
 
-    ptcl_parser_skip(parser);
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_func_body body = ptcl_func_body_create(
-        NULL, 0, ptcl_parser_current_body(parser));
-    ptcl_parser_func_body_by_pointer(parser, &body, true, false, ptcl_parser_ignore_error(parser));
-    if (ptcl_parser_critical(parser))
+    if (ptcl_parser_not(parser, ptcl_token_colon_type))
     {
-        return;
+        ptcl_name_destroy(name);
+        return (ptcl_statement_type_decl){0};
     }
 
-    ptcl_func_body *previous = ptcl_parser_root(parser);
-    parser->temp.root = body.root;
+    ptcl_statement_type_decl decl = ptcl_statement_type_decl_create(modifiers, name, NULL, 0, NULL, 0);
+    if (!ptcl_parser_type_decl_types(parser, &decl, location))
+    {
+        return (ptcl_statement_type_decl){0};
+    }
 
-    ptcl_statement *statement = ptcl_func_body_create_stat(ptcl_statement_func_body_create_by_body(body), body.root, location);
-    if (statement == NULL)
+    const bool is_static = decl.types[0].type.is_static;
+    if (ptcl_parser_is_comp_type_defined(parser, name, is_static))
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_destroy(statement);
-        ptcl_parser_throw_out_of_memory(parser, location);
-        parser->temp.root = previous;
-        return;
+        ptcl_parser_throw_redefination(parser, name.value, location);
     }
 
-    ptcl_func_body *root_body = ptcl_parser_root(parser);
-    size_t new_count = root_body->count + 1;
-    ptcl_statement **new_statements = realloc(root_body->statements,
-                                              sizeof(ptcl_statement *) * new_count);
-    if (new_statements == NULL)
+    ptcl_type_comp_type *comp_type = malloc(sizeof(ptcl_type_comp_type));
+    if (comp_type == NULL)
     {
-        ptcl_statement_destroy(statement);
         ptcl_parser_throw_out_of_memory(parser, location);
-        parser->temp.root = previous;
-        return;
+        ptcl_statement_type_decl_destroy(decl);
+        return (ptcl_statement_type_decl){0};
     }
 
-    new_statements[root_body->count] = statement;
-    root_body->statements = new_statements;
-    root_body->count = new_count;
-    parser->temp.root = previous;
-    ptcl_parser_extra_body(parser, is_syntax);
-}
-
-ptcl_type ptcl_parser_type(ptcl_parser *parser, bool with_word, bool with_any, bool with_static)
-{
-    const bool with_syntax = ptcl_parser_parse_try_syntax_usage_here(parser, false);
-    size_t depth = parser->state.syntax_depth;
-    if (ptcl_parser_critical(parser))
+    *comp_type = ptcl_type_create_comp_type(decl, is_static);
+    ptcl_parser_comp_type instance = ptcl_parser_comp_type_create(
+        ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser),
+        name,
+        comp_type,
+        comp_type->is_static,
+        ptcl_statement_modifiers_flags_auto(modifiers) && comp_type->is_static);
+    if (!ptcl_parser_add_instance_comp_type(parser, instance))
     {
-        return (ptcl_type){0};
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_statement_type_decl_destroy(decl);
+        return (ptcl_statement_type_decl){0};
     }
 
-    ptcl_parser_extra_body(parser, with_syntax);
-    if (ptcl_parser_critical(parser))
+    if (ptcl_parser_match(parser, ptcl_token_left_curly_type))
     {
-        if (with_syntax && parser->state.syntax_depth == depth)
+        if (!ptcl_parser_type_decl_body(parser, &decl, comp_type, location))
         {
-            ptcl_parser_leave_from_syntax(parser);
+            return (ptcl_statement_type_decl){0};
         }
-
-        return (ptcl_type){0};
     }
 
-    bool is_const = ptcl_parser_match(parser, ptcl_token_const_type);
-    bool is_static = ptcl_parser_match(parser, ptcl_token_static_type);
-    if (is_static && !with_static)
+    return decl;
+}
+
+ptcl_statement_assign ptcl_parser_assign(ptcl_parser *parser, ptcl_name name, ptcl_expression *left, ptcl_statement_modifiers modifiers)
+{
+    const ptcl_location location = ptcl_parser_current(parser).location;
+    const size_t position = ptcl_parser_position(parser);
+    const ptcl_token current_identifier = ptcl_parser_current(parser);
+    ptcl_identifier identifier;
+    ptcl_argument *typedata_member = NULL;
+    ptcl_expression *ctor = NULL;
+    size_t ctor_member_index;
+
+    // Parse left side: name or dot expression
+    if (left == NULL)
     {
-        ptcl_parser_throw_not_allowed_token(
-            parser,
-            ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_const_type),
-            ptcl_parser_current(parser).location);
-        if (with_syntax && parser->state.syntax_depth == depth)
+        identifier = ptcl_identifier_create_by_name(name);
+    }
+    else
+    {
+        identifier = ptcl_identifier_create_by_expr(left);
+        if (identifier.value->return_type.type == ptcl_value_type_type && identifier.value->return_type.is_static)
         {
-            ptcl_parser_leave_from_syntax(parser);
+            ctor = ptcl_parser_get_ctor_from_dot(parser, identifier.value, true);
+            if (!ptcl_type_get_member(ctor->return_type.typedata, identifier.value->dot.name, &typedata_member, &ctor_member_index))
+            {
+                ptcl_parser_throw_unknown_member(parser, name.value, location);
+                ptcl_expression_destroy(identifier.value);
+                return (ptcl_statement_assign){0};
+            }
         }
-
-        return (ptcl_type){0};
     }
 
-    ptcl_token current = ptcl_parser_current(parser);
-    ptcl_parser_skip(parser);
+    if (ptcl_parser_critical(parser))
+    {
+        ptcl_identifier_destroy(identifier);
+        return (ptcl_statement_assign){0};
+    }
 
-    ptcl_type target = {0};
-    bool parse_success = true;
+    ptcl_type type;
+    bool has_explicit_type = ptcl_parser_match(parser, ptcl_token_colon_type);
+    bool is_auto = false;
+    bool is_new_variable = true;
+    ptcl_parser_variable *existing_variable = NULL;
 
-    switch (current.type)
-    {
-    case ptcl_token_word_word_type:
-        if (with_word)
-        {
-            target = ptcl_type_word;
-            break;
-        }
-        // Fallthrough
-    case ptcl_token_character_word_type:
-        target = ptcl_type_character;
-        break;
-    case ptcl_token_double_type:
-        target = ptcl_type_double;
-        break;
-    case ptcl_token_float_type:
-        target = ptcl_type_float;
-        break;
-    case ptcl_token_integer_type:
-        target = ptcl_type_integer;
-        break;
-    case ptcl_token_void_type:
-        target = ptcl_type_void;
-        break;
-    case ptcl_token_pointer_type:
-        target = ptcl_type_any_pointer;
-        break;
-    case ptcl_token_left_par_type:
+    // Handle explicit type declaration
+    if (has_explicit_type)
     {
-        ptcl_parse_arguments_result arguments = ptcl_parser_parse_arguments(parser, current.location, false, ptcl_parser_args_func_pointer_type);
-        if (ptcl_parser_critical(parser))
+        if (ptcl_parser_is_variable_defined(parser, name))
         {
-            return (ptcl_type){0};
+            ptcl_parser_throw_variable_redefinition(parser, name.value, location);
+            ptcl_identifier_destroy(identifier);
+            return (ptcl_statement_assign){0};
         }
 
-        if (ptcl_parser_not(parser, ptcl_token_colon_type))
+        if (ptcl_parser_current(parser).type == ptcl_token_equals_type)
         {
-            ptcl_parse_arguments_result_destroy(arguments);
-            return (ptcl_type){0};
+            is_auto = true;
+            has_explicit_type = false;
         }
-
-        ptcl_type *return_type = malloc(sizeof(ptcl_type));
-        if (return_type == NULL)
+        else
         {
-            ptcl_parser_throw_out_of_memory(parser, current.location);
-            ptcl_parse_arguments_result_destroy(arguments);
-            return (ptcl_type){0};
-        }
+            type = ptcl_parser_type(parser, true, false, true);
+            if (ptcl_parser_critical(parser))
+            {
+                ptcl_identifier_destroy(identifier);
+                return (ptcl_statement_assign){0};
+            }
 
-        *return_type = ptcl_parser_type(parser, is_static, false, false);
-        if (ptcl_parser_critical(parser))
-        {
-            ptcl_parse_arguments_result_destroy(arguments);
-            free(return_type);
-            return (ptcl_type){0};
+            type.is_const = ptcl_statement_modifiers_flags_const(modifiers);
         }
-
-        ptcl_type function = ptcl_type_create_func(return_type, NULL, 0, false, arguments.has_variadic);
-        function.function_pointer.arguments = arguments.arguments;
-        function.function_pointer.count = arguments.count;
-        return_type->is_primitive = false;
-        target = function;
-        target.is_static = is_static;
-        break;
     }
-    case ptcl_token_any_type:
-        if (is_static || with_any)
-        {
-            target = ptcl_type_any;
-            break;
-        }
-        else
+    else
+    {
+        // No explicit type – variable or expression must already exist
+        if (identifier.is_name && !ptcl_parser_try_get_variable(parser, name, &existing_variable))
         {
-            parse_success = false;
-            ptcl_parser_throw_unknown_type(parser, current.value, current.location);
-            break;
+            ptcl_parser_throw_unknown_variable_or_type(parser, name.value, location);
+            ptcl_identifier_destroy(identifier);
+            return (ptcl_statement_assign){0};
         }
-    case ptcl_token_exclamation_mark_type:
-        ptcl_parser_back(parser);
-        ptcl_name name = ptcl_parser_name_word_or_type(parser);
-#pragma GCC diagnostic ignored "-Wimplicit-fallthrough="
-        if (ptcl_parser_critical(parser))
+
+        has_explicit_type = true;
+        is_new_variable = false;
+        if (identifier.is_name)
         {
-            break;
+            type = existing_variable->type;
         }
-    case ptcl_token_word_type:
-        // TODO: search type by name in one loop
-        if (current.type == ptcl_token_word_type)
+        else
         {
-            name = ptcl_name_create_fast_w(current.value, false);
+            if (typedata_member == NULL)
+            {
+                type = identifier.value->return_type;
+            }
+            else
+            {
+                type = typedata_member->type;
+            }
         }
+    }
 
-        ptcl_parser_typedata *typedata;
-        ptcl_parser_comp_type *comp_type;
-        ptcl_parser_variable *variable;
-        if (ptcl_parser_try_get_typedata(parser, name, &typedata))
+    // Expect '='
+    if (ptcl_parser_not(parser, ptcl_token_equals_type))
+    {
+        if (has_explicit_type)
         {
-            ptcl_name_destroy(name);
-            target = ptcl_type_create_typedata(typedata->typedata, false);
-            break;
+            ptcl_type_destroy(type);
         }
-        else if (ptcl_parser_try_get_comp_type(parser, name, is_static, &comp_type))
+
+        ptcl_identifier_destroy(identifier);
+        return (ptcl_statement_assign){0};
+    }
+
+    // Determine expected type for right-hand side
+    bool is_static_type = false;
+    ptcl_type expected;
+    ptcl_parser_expression_flags flags = ptcl_parser_expression_flags_default(true);
+    ptcl_parser_expression_flags_remove(&flags, ptcl_parser_expression_with_word_flag);
+    if (has_explicit_type && !is_auto)
+    {
+        if (type.is_static)
         {
-            ptcl_name_destroy(name);
-            // TODO: add context
-            if (with_static && (is_static || comp_type->is_auto_static))
+            if (type.type == ptcl_value_type_type && type.comp_type->invariant != NULL)
             {
-                if (comp_type->static_type == NULL)
-                {
-                    ptcl_parser_throw_except_type_specifier(parser, current.location);
-                    parse_success = false;
-                    break;
-                }
-
-                target = ptcl_type_create_comp_type_t(comp_type->static_type, is_const);
-                is_static = true;
-                break;
+                expected = type;
+                expected.comp_type = type.comp_type->invariant;
+                expected.is_static = false;
             }
             else
             {
-                if (comp_type->comp_type == NULL)
+                if (type.type == ptcl_value_word_type)
                 {
-                    ptcl_parser_throw_except_type_specifier(parser, current.location);
-                    parse_success = false;
-                    break;
+                    ptcl_parser_expression_flags_set(&flags, ptcl_parser_expression_with_word_flag);
                 }
 
-                target = ptcl_type_create_comp_type_t(comp_type->comp_type, is_const);
-                break;
+                expected = type;
             }
         }
-
-        if (current.type == ptcl_token_exclamation_mark_type)
+        else
         {
-            if (ptcl_parser_try_get_variable(parser, name, &variable))
-            {
-                if (variable->type.type == ptcl_value_object_type_type)
-                {
-                    ptcl_name_destroy(name);
-                    bool is_out_of_memory = false;
-                    target = ptcl_type_copy(variable->built_in->object_type.type, &is_out_of_memory);
-                    if (is_out_of_memory)
-                    {
-                        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-                        parse_success = false;
-                    }
-
-                    break;
-                }
-            }
+            expected = type;
         }
-
-        ptcl_name_destroy(name);
-#pragma GCC diagnostic ignored "-Wimplicit-fallthrough="
-    default:
-        parse_success = false;
-        ptcl_parser_throw_unknown_type(parser, current.value, current.location);
-        break;
     }
-
-    if (with_syntax && parser->state.syntax_depth == depth)
+    else
     {
-        ptcl_parser_leave_from_syntax(parser);
+        expected = ptcl_type_any;
+        expected.is_static = false;
+        expected.is_const = true;
+        flags |= ptcl_parser_expression_ignore_excepted_flag;
     }
 
-    if (!parse_success)
+    // Parse value
+    ptcl_expression *value = ptcl_parser_cast(parser, &expected, flags);
+    if (ptcl_parser_critical(parser))
     {
-        return (ptcl_type){0};
-    }
+        if (has_explicit_type)
+        {
+            ptcl_type_destroy(type);
+        }
 
-    if (is_static)
-    {
-        target.is_static = true;
+        ptcl_identifier_destroy(identifier);
+        return (ptcl_statement_assign){0};
     }
 
-    if (is_const)
+    // Substitute into constructor (dot case)
+    if (ctor != NULL)
     {
-        target.is_const = true;
+        // TODO: Add references counter to avoid memory leaks
+        ctor->ctor->values[ctor_member_index] = value;
     }
 
-    if (target.type != ptcl_value_word_type)
+    // Adjust type based on assigned value
+    if (has_explicit_type)
     {
-        ptcl_type parsed_target = ptcl_parser_pointers(parser, target);
-        if (ptcl_parser_critical(parser))
-        {
-            return (ptcl_type){0};
-        }
-
-        target = parsed_target;
+        type = ptcl_parser_set_arrays_length(parser, type, &value->return_type);
     }
     else
     {
-        if (!is_static)
-        {
-            ptcl_parser_throw_must_be_static(parser, current.location);
-            target.is_static = true;
-        }
-    }
-
-    return target;
-}
-
-static ptcl_type *ptcl_parser_register_function(ptcl_parser *parser, ptcl_statement_func_decl func_decl, ptcl_parser_function *prototype_function)
-{
-    const ptcl_statement_modifiers modifiers = func_decl.modifiers;
-    const ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_parser_function function = ptcl_parser_function_create(ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser), func_decl);
-    ptcl_type *variable_return_type = NULL;
-    if (!ptcl_parser_in_type(parser))
-    {
-        if (prototype_function != NULL)
+        type = value->return_type;
+        if (type.type == ptcl_value_pointer_type && type.pointer.is_null)
         {
-            // TODO: make arguments checks from prototype
-            prototype_function->func = func_decl;
+            type.pointer.is_any = true;
+            type.pointer.is_null = false;
         }
-        else
+        else if (is_new_variable)
         {
-            bool added = true;
-            if (!func_decl.return_type.is_static)
+            if (type.type == ptcl_value_typedata_type)
             {
-                ptcl_name variable_name = function.name;
-                variable_name.is_free = false;
-                ptcl_type *variable_return_type = malloc(sizeof(ptcl_type));
-                if (variable_return_type == NULL)
-                {
-                    ptcl_statement_func_decl_destroy(func_decl);
-                    ptcl_parser_throw_out_of_memory(parser, location);
-                    return NULL;
-                }
-
-                *variable_return_type = func_decl.return_type;
-                ptcl_type variable_type = ptcl_type_create_func(variable_return_type, func_decl.arguments, func_decl.count, true, func_decl.is_variadic);
-                variable_type.is_static = true;
-                ptcl_parser_variable function_pointer = ptcl_parser_func_variable_create(variable_name, variable_type, function.root);
-                added = ptcl_parser_add_instance_variable(parser, function_pointer);
+                type.is_static = type.typedata->is_static;
             }
-
-            if (!added || !ptcl_parser_add_instance_function(parser, function))
+            else if (type.type != ptcl_value_type_type)
             {
-                ptcl_statement_func_decl_destroy(func_decl);
-                free(variable_return_type);
-                ptcl_parser_throw_out_of_memory(parser, location);
-                return NULL;
+                type.is_static = !ptcl_type_is_castable_to_unstatic(type);
             }
         }
     }
 
-    return variable_return_type;
-}
-
-static bool ptcl_parser_parse_dynamic_body(
-    ptcl_parser *parser,
-    ptcl_statement_func_decl *func_decl,
-    ptcl_type *return_type,
-    const size_t variable_index,
-    const size_t function_index)
-{
-    ptcl_location location = ptcl_parser_current(parser).location;
-    func_decl->func_body = malloc(sizeof(ptcl_func_body));
-    if (func_decl->func_body == NULL)
-    {
-        ptcl_parser_throw_out_of_memory(parser, location);
-    cleanup:
-        free(func_decl->func_body);
-        ptcl_statement_func_decl_destroy(*func_decl);
-        free(return_type);
-        if (!ptcl_parser_in_type(parser))
-        {
-            parser->variables.items[variable_index].is_out_of_scope = true;
-            parser->functions.items[function_index].is_out_of_scope = true;
-        }
-
-        return false;
-    }
+    // Create assign statement and register variable
+    ptcl_statement_assign assign = ptcl_statement_assign_create(
+        modifiers, identifier, type, has_explicit_type, value, is_new_variable, 0);
 
-    *func_decl->func_body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
-    ptcl_type *previous_type = parser->temp.return_type;
-    parser->temp.return_type = return_type;
-    for (size_t i = 0; i < func_decl->count; i++)
+    if (identifier.is_name && existing_variable == NULL)
     {
-        ptcl_argument argument = func_decl->arguments[i];
-        ptcl_parser_variable variable = ptcl_parser_variable_create(argument.name, argument.type, NULL, false, func_decl->func_body);
-        variable.type.is_static = variable.type.is_static;
+        ptcl_parser_variable variable = ptcl_parser_variable_create(
+            name,
+            type,
+            value,
+            false,
+            ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser));
+        const size_t variable_index = parser->variables.count;
         if (!ptcl_parser_add_instance_variable(parser, variable))
-        {
-            ptcl_parser_throw_out_of_memory(parser, location);
-            goto cleanup;
-        }
-    }
-
-    const bool is_static = ptcl_statement_modifiers_flags_static(func_decl->modifiers);
-    const bool last_state = ptcl_parser_in_type(parser);
-    ptcl_parser_disable_state(parser, ptcl_parser_in_type_flag);
-    ptcl_parser_func_body_by_pointer(parser, func_decl->func_body, true, true, is_static);
+        {
+            ptcl_statement_assign_destroy(assign);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return (ptcl_statement_assign){0};
+        }
 
-    ptcl_parser_set_state(parser, ptcl_parser_in_type_flag, last_state);
-    if (ptcl_parser_critical(parser))
-    {
-        parser->temp.return_type = previous_type;
-        goto cleanup;
+        assign.variable_id = variable_index;
     }
-
-    ptcl_statement_modifiers_flags_remove(&func_decl->modifiers, ptcl_statement_modifiers_prototype_flag);
-    if (!ptcl_parser_in_type(parser))
+    else if (existing_variable != NULL)
     {
-        ptcl_parser_function *original = &parser->functions.items[function_index];
-        original->func = *func_decl;
+        assign.variable_id = existing_variable - parser->variables.items;
+        existing_variable->built_in = value;
+        if (is_static_type && !value->return_type.is_static)
+        {
+            ptcl_parser_make_unstatic(&parser->variables.items[assign.variable_id]);
+        }
     }
 
-    parser->temp.return_type = previous_type;
-    return true;
+    return assign;
 }
 
-static bool ptcl_parser_parse_static_body(ptcl_parser *parser, ptcl_statement_func_decl *func_decl, const size_t function_identifier)
+ptcl_statement_return ptcl_parser_return(ptcl_parser *parser)
 {
-    size_t start = ptcl_parser_position(parser);
-    ptcl_parser_skip(parser);
-    ptcl_parser_skip_block_or_expression(parser);
-    if (ptcl_parser_critical(parser))
+    ptcl_parser_match(parser, ptcl_token_return_type);
+    if (parser->temp.return_type != NULL)
     {
-    cleanup:
-        ptcl_statement_func_decl_destroy(*func_decl);
-        if (!ptcl_parser_in_type(parser))
+        if (parser->temp.return_type->type == ptcl_value_void_type)
         {
-            parser->functions.items[function_identifier].is_out_of_scope = true;
+            ptcl_parser_match(parser, ptcl_token_none_type);
+            return ptcl_statement_return_create(NULL);
         }
-
-        return false;
     }
 
-    const ptcl_location location = ptcl_parser_current(parser).location;
-    // With curly
-    const size_t tokens_count = (ptcl_parser_position(parser) - start);
-    const size_t index = ptcl_parser_add_lated_body(parser, start, tokens_count, false, location);
+    const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
+    ptcl_parser_enable_state(parser, ptcl_parser_in_return_flag);
+    ptcl_expression *value = ptcl_parser_cast(parser, parser->temp.return_type, false);
+
+    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
     if (ptcl_parser_critical(parser))
     {
-        goto cleanup;
+        return (ptcl_statement_return){0};
     }
 
-    func_decl->index = index;
-    if (!ptcl_parser_in_type(parser))
+    if (value->return_type.type == ptcl_value_void_type)
     {
-        ptcl_parser_function *original = &parser->functions.items[function_identifier];
-        original->func = *func_decl;
+        ptcl_parser_throw_except_type_specifier(parser, ptcl_parser_current(parser).location);
+        return (ptcl_statement_return){0};
     }
 
-    return true;
-}
-
-static void ptcl_parser_func_decl_set_from_args(ptcl_statement_func_decl *func_decl, ptcl_parse_arguments_result arguments)
-{
-    func_decl->arguments = arguments.arguments;
-    func_decl->count = arguments.count;
-    func_decl->is_variadic = arguments.has_variadic;
-    func_decl->with_self = arguments.with_self;
-    func_decl->is_self_const = arguments.is_const;
+    return ptcl_statement_return_create(value);
 }
 
-ptcl_statement_func_decl ptcl_parser_func_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
+static ptcl_statement *ptcl_parser_static_if_body(ptcl_parser *parser, ptcl_expression *condition)
 {
-    ptcl_parser_match(parser, ptcl_token_function_type);
-
-    ptcl_token current = ptcl_parser_current(parser);
-    ptcl_location location = current.location;
-    const bool is_constructor = current.type == ptcl_token_left_par_type;
-
-    ptcl_name name = ptcl_name_empty;
-    if (!is_constructor)
+    ptcl_func_body result;
+    const bool condition_value = condition->integer_n;
+    ptcl_location location = condition->location;
+    ptcl_expression_destroy(condition);
+    if (condition_value)
     {
-        name = ptcl_parser_name_word(parser);
+        result = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
         if (ptcl_parser_critical(parser))
         {
-            return (ptcl_statement_func_decl){0};
+            return NULL;
+        }
+
+        if (ptcl_parser_match(parser, ptcl_token_else_type))
+        {
+            if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
+            {
+                ptcl_func_body_destroy(result);
+                return NULL;
+            }
+
+            ptcl_parser_skip_block_or_expression(parser);
+            if (ptcl_parser_critical(parser))
+            {
+                ptcl_func_body_destroy(result);
+                return NULL;
+            }
         }
     }
     else
     {
-        if (!ptcl_parser_in_type(parser))
+        ptcl_parser_skip(parser);
+        ptcl_parser_skip_block_or_expression(parser);
+        if (ptcl_parser_critical(parser))
         {
-            ptcl_parser_except(parser, ptcl_token_word_type);
-            return (ptcl_statement_func_decl){0};
+            return NULL;
         }
-    }
-
-    ptcl_parser_function *prototype_function = NULL;
-    if (!is_constructor &&
-        ptcl_parser_try_get_function(parser, name, &prototype_function) &&
-        !ptcl_statement_modifiers_flags_prototype(prototype_function->func.modifiers))
-    {
-        ptcl_parser_throw_redefination(parser, name.value, location);
-    }
-
-    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
-    {
-        ptcl_name_destroy(name);
-        return (ptcl_statement_func_decl){0};
-    }
-
-    // We set prototype, because on freeing we dont have body
-    ptcl_statement_func_decl func_decl = ptcl_statement_func_decl_create(
-        modifiers | ptcl_statement_modifiers_prototype_flag,
-        parser->temp.root,
-        name,
-        NULL,
-        0,
-        NULL,
-        ptcl_type_integer,
-        false,
-        is_constructor);
-    ptcl_parse_arguments_result arguments = ptcl_parser_parse_arguments(
-        parser,
-        location,
-        !ptcl_statement_modifiers_flags_global(modifiers) && ptcl_parser_in_type(parser),
-        ptcl_parser_args_func_type);
-    if (ptcl_parser_critical(parser))
-    {
-        ptcl_name_destroy(name);
-        free(func_decl.func_body);
-        return (ptcl_statement_func_decl){0};
-    }
-
-    if (ptcl_parser_not(parser, ptcl_token_colon_type))
-    {
-    prototype_cleanup:
-        ptcl_parse_arguments_result_destroy(arguments);
-        ptcl_name_destroy(name);
-        free(func_decl.func_body);
-        return (ptcl_statement_func_decl){0};
-    }
-
-    ptcl_type return_type = ptcl_parser_type(parser, false, false, true);
-    if (ptcl_parser_critical(parser))
-    {
-        goto prototype_cleanup;
-    }
-
-    func_decl.return_type = return_type;
-    ptcl_parser_func_decl_set_from_args(&func_decl, arguments);
-
-    const size_t variable_identifier = parser->variables.count;
-    const size_t function_identifier = parser->functions.count;
-    ptcl_type *variable_return_type = ptcl_parser_register_function(parser, func_decl, prototype_function);
-    if (ptcl_parser_critical(parser))
-    {
-        // Already destroyed above
-        return (ptcl_statement_func_decl){0};
-    }
 
-    if (!ptcl_statement_modifiers_flags_prototype(modifiers))
-    {
-        if (!func_decl.return_type.is_static)
+        if (ptcl_parser_match(parser, ptcl_token_else_type))
         {
-            if (!ptcl_parser_parse_dynamic_body(parser, &func_decl, variable_return_type, variable_identifier, function_identifier))
+            result = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
+            if (ptcl_parser_critical(parser))
             {
-                // Already destroyed above
-                return (ptcl_statement_func_decl){0};
+                return NULL;
             }
         }
         else
         {
-            if (!ptcl_parser_parse_static_body(parser, &func_decl, function_identifier))
-            {
-                // Already destroyed above
-                return (ptcl_statement_func_decl){0};
-            }
+            return NULL;
         }
     }
 
-    return func_decl;
+    return ptcl_func_body_create_stat(ptcl_statement_func_body_create_by_body(result), result.root, location);
 }
 
-ptcl_statement_typedata_decl ptcl_parser_typedata_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
+ptcl_statement *ptcl_parser_if(ptcl_parser *parser, bool is_static)
 {
-    ptcl_parser_match(parser, ptcl_token_typedata_type);
+    ptcl_parser_match(parser, ptcl_token_if_type);
 
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_name name = ptcl_parser_name_word(parser);
+    ptcl_type type = ptcl_type_integer;
+    type.is_static = is_static;
+    ptcl_expression *condition = ptcl_parser_cast(parser, &type, ptcl_parser_expression_flags_default(true));
     if (ptcl_parser_critical(parser))
     {
-        return (ptcl_statement_typedata_decl){0};
-    }
-
-    if (ptcl_parser_is_typedata_defined(parser, name))
-    {
-        ptcl_parser_throw_redefination(parser, name.value, location);
+        return NULL;
     }
 
-    ptcl_statement_typedata_decl decl = ptcl_statement_typedata_decl_create(modifiers, name, NULL, 0, true, true);
-    if (ptcl_statement_modifiers_flags_prototype(decl.modifiers))
+    if (condition->return_type.is_static || is_static)
     {
-        return decl;
+        return ptcl_parser_static_if_body(parser, condition);
     }
 
-    if (ptcl_parser_not(parser, ptcl_token_left_par_type))
-    {
-        ptcl_statement_typedata_decl_destroy(decl);
-        return (ptcl_statement_typedata_decl){0};
-    }
+    const bool last_state = ptcl_parser_in_if(parser);
+    ptcl_parser_enable_state(parser, ptcl_parser_in_if_flag);
 
-    decl.is_prototype = false;
-    ptcl_parse_arguments_result members = ptcl_parser_parse_arguments(parser, ptcl_parser_current(parser).location, false, ptcl_parser_args_typedata_type);
+    ptcl_func_body body = ptcl_parser_func_body(parser, true, true, ptcl_parser_ignore_error(parser));
     if (ptcl_parser_critical(parser))
     {
-        ptcl_statement_typedata_decl_destroy(decl);
-        return (ptcl_statement_typedata_decl){0};
+        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+        ptcl_expression_destroy(condition);
+        return NULL;
     }
 
-    decl.members = members.arguments;
-    decl.count = members.count;
-    decl.is_static = !members.has_unstatic_member;
-    ptcl_type_typedata *typedata = malloc(sizeof(ptcl_type_typedata));
-    if (typedata == NULL)
+    ptcl_statement_if if_stat = ptcl_statement_if_create(condition, body, false, (ptcl_func_body){0});
+    if (ptcl_parser_match(parser, ptcl_token_else_type))
     {
-        ptcl_statement_typedata_decl_destroy(decl);
-        ptcl_parser_throw_out_of_memory(parser, location);
-        return (ptcl_statement_typedata_decl){0};
+        if_stat.else_body = ptcl_parser_func_body(parser, true, true, ptcl_parser_ignore_error(parser));
+        if_stat.with_else = !ptcl_parser_critical(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+            ptcl_statement_if_destroy(if_stat);
+            return NULL;
+        }
     }
 
-    *typedata = ptcl_type_typedata_create(decl.name, decl.members, decl.count, !members.has_unstatic_member);
-    ptcl_parser_typedata instance = ptcl_parser_typedata_create(
-        ptcl_statement_modifiers_flags_global(decl.modifiers) ? NULL : ptcl_parser_root(parser),
-        typedata);
-    if (!ptcl_parser_add_instance_typedata(parser, instance))
+    ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+    ptcl_statement *statement = ptcl_statement_create(ptcl_statement_if_type, ptcl_parser_root(parser), ptcl_attributes_create(NULL, 0), condition->location);
+    if (statement == NULL)
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_typedata_decl_destroy(decl);
-        free(typedata);
-        return (ptcl_statement_typedata_decl){0};
+        ptcl_statement_if_destroy(if_stat);
+        ptcl_parser_throw_out_of_memory(parser, condition->location);
+        return NULL;
     }
 
-    return decl;
+    statement->if_stat = if_stat;
+    return statement;
 }
 
-static bool ptcl_parser_type_decl_types(ptcl_parser *parser, ptcl_statement_type_decl *decl, ptcl_location location)
+static ptcl_expression *ptcl_parser_static_if_expr_body(ptcl_parser *parser, ptcl_expression *condition)
 {
-    while (true)
+    ptcl_expression *result;
+
+    int condition_value = condition->integer_n;
+    ptcl_expression_destroy(condition);
+    if (condition_value)
     {
-        ptcl_type_member *buffer = realloc(decl->types, (decl->types_count + 1) * sizeof(ptcl_type_member));
-        if (buffer == NULL)
+        result = ptcl_parser_cast(parser, NULL, false);
+        if (ptcl_parser_critical(parser))
         {
-            ptcl_statement_type_decl_destroy(*decl);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            return false;
+            return NULL;
         }
 
-        decl->types = buffer;
-        bool is_up = ptcl_parser_match(parser, ptcl_token_up_type);
-        ptcl_type type = ptcl_parser_type(parser, false, false, true);
+        if (ptcl_parser_not(parser, ptcl_token_right_curly_type) ||
+            ptcl_parser_not(parser, ptcl_token_else_type) ||
+            ptcl_parser_not(parser, ptcl_token_left_curly_type))
+        {
+            ptcl_expression_destroy(result);
+            return NULL;
+        }
+
+        ptcl_parser_skip_block_or_expression(parser);
         if (ptcl_parser_critical(parser))
         {
-            if (decl->types_count == 0)
-            {
-                free(decl->types);
-            }
+            ptcl_expression_destroy(result);
+            return NULL;
+        }
+    }
+    else
+    {
+        ptcl_parser_skip_block_or_expression(parser);
+        if (ptcl_parser_critical(parser))
+        {
+            return NULL;
+        }
 
-            ptcl_statement_type_decl_destroy(*decl);
-            return false;
+        if (ptcl_parser_not(parser, ptcl_token_else_type) || ptcl_parser_not(parser, ptcl_token_left_curly_type))
+        {
+            return NULL;
         }
 
-        if (decl->types_count > 0)
+        result = ptcl_parser_cast(parser, NULL, false);
+        if (ptcl_parser_critical(parser))
         {
-            ptcl_type_member expected = decl->types[decl->types_count - 1];
-            if (!ptcl_type_is_castable(expected.type, type))
-            {
-                ptcl_parser_throw_fast_incorrect_type(parser, expected.type, type, location);
-                ptcl_statement_type_decl_destroy(*decl);
-                return false;
-            }
+            return NULL;
         }
 
-        decl->types[decl->types_count++] = ptcl_type_member_create(type, is_up);
-        if (!ptcl_parser_match(parser, ptcl_token_comma_type))
+        if (ptcl_parser_not(parser, ptcl_token_right_curly_type))
         {
-            break;
+            ptcl_expression_destroy(result);
+            return NULL;
         }
     }
 
-    return true;
+    return result;
 }
 
-static bool ptcl_parser_type_decl_body(ptcl_parser *parser, ptcl_statement_type_decl *decl, ptcl_type_comp_type *comp_type, ptcl_location location)
+ptcl_expression *ptcl_parser_if_expression(ptcl_parser *parser, bool is_static)
 {
-    ptcl_func_body *body = malloc(sizeof(ptcl_func_body));
-    if (body == NULL)
-    {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_type_decl_destroy(*decl);
-        return false;
-    }
-
-    *body = ptcl_func_body_create(NULL, 0, ptcl_parser_root(parser));
-    comp_type->functions = body;
-    ptcl_parser_variable this_var = ptcl_parser_variable_not_static_create(
-        ptcl_name_create_fast_w("this", false),
-        ptcl_type_create_comp_type_t(comp_type, false), NULL, false, body);
-    this_var.type.is_static = this_var.type.is_static;
-    this_var.type.is_static = false;
-    ptcl_parser_variable self_var = ptcl_parser_variable_not_static_create(
-        ptcl_name_create_fast_w("self", false),
-        decl->types[0].type, NULL, false, body);
-    self_var.type.is_static = self_var.type.is_static;
-    if (!ptcl_parser_add_instance_variable(parser, this_var) || !ptcl_parser_add_instance_variable(parser, self_var))
-    {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_type_decl_destroy(*decl);
-        ptcl_func_body_destroy(*body);
-        free(body);
-        return false;
-    }
-
-    const bool last_state = ptcl_parser_in_type(parser);
-    ptcl_parser_enable_state(parser, ptcl_parser_in_type_flag);
-
-    ptcl_parser_func_body_by_pointer(parser, body, true, true, false);
-
-    ptcl_parser_set_state(parser, ptcl_parser_in_type_flag, last_state);
+    ptcl_parser_match(parser, ptcl_token_if_type);
+    ptcl_type type = ptcl_type_integer;
+    type.is_static = is_static;
 
+    ptcl_expression *condition = ptcl_parser_cast(parser, &type, false);
     if (ptcl_parser_critical(parser))
     {
-        free(body);
-        ptcl_statement_type_decl_destroy(*decl);
-        return false;
+        return NULL;
     }
 
-    decl->body = body;
-    decl->functions = comp_type->functions;
-    return true;
-}
-
-ptcl_statement_type_decl ptcl_parser_type_decl(ptcl_parser *parser, ptcl_statement_modifiers modifiers)
-{
-    ptcl_parser_match(parser, ptcl_token_type_type);
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_name name = ptcl_parser_name_word(parser);
-    if (ptcl_parser_critical(parser))
+    if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
     {
-        return (ptcl_statement_type_decl){0};
+        return NULL;
     }
 
-    if (ptcl_parser_not(parser, ptcl_token_colon_type))
+    if (condition->return_type.is_static || is_static)
     {
-        ptcl_name_destroy(name);
-        return (ptcl_statement_type_decl){0};
+        return ptcl_parser_static_if_expr_body(parser, condition);
     }
 
-    ptcl_statement_type_decl decl = ptcl_statement_type_decl_create(modifiers, name, NULL, 0, NULL, 0);
-    if (!ptcl_parser_type_decl_types(parser, &decl, location))
+    const bool last_state = ptcl_parser_in_if(parser);
+    ptcl_parser_enable_state(parser, ptcl_parser_in_if_flag);
+
+    ptcl_expression *body = ptcl_parser_cast(parser, NULL, false);
+    if (ptcl_parser_critical(parser))
     {
-        return (ptcl_statement_type_decl){0};
+        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+        ptcl_expression_destroy(condition);
+        return NULL;
     }
 
-    const bool is_static = decl.types[0].type.is_static;
-    if (ptcl_parser_is_comp_type_defined(parser, name, is_static))
+    if (ptcl_parser_not(parser, ptcl_token_right_curly_type) ||
+        ptcl_parser_not(parser, ptcl_token_else_type) ||
+        ptcl_parser_not(parser, ptcl_token_left_curly_type))
     {
-        ptcl_parser_throw_redefination(parser, name.value, location);
+        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+        ptcl_expression_destroy(condition);
+        ptcl_expression_destroy(body);
+        return NULL;
     }
 
-    ptcl_type_comp_type *comp_type = malloc(sizeof(ptcl_type_comp_type));
-    if (comp_type == NULL)
+    ptcl_expression *else_expression = ptcl_parser_cast(parser, &body->return_type, false);
+    ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
+    if (ptcl_parser_critical(parser))
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_type_decl_destroy(decl);
-        return (ptcl_statement_type_decl){0};
+        ptcl_expression_destroy(condition);
+        ptcl_expression_destroy(body);
+        return NULL;
     }
 
-    *comp_type = ptcl_type_create_comp_type(decl, is_static);
-    ptcl_parser_comp_type instance = ptcl_parser_comp_type_create(
-        ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser),
-        name,
-        comp_type,
-        comp_type->is_static,
-        ptcl_statement_modifiers_flags_auto(modifiers) && comp_type->is_static);
-    if (!ptcl_parser_add_instance_comp_type(parser, instance))
+    if (ptcl_parser_not(parser, ptcl_token_right_curly_type))
     {
-        ptcl_parser_throw_out_of_memory(parser, location);
-        ptcl_statement_type_decl_destroy(decl);
-        return (ptcl_statement_type_decl){0};
+        ptcl_expression_destroy(condition);
+        ptcl_expression_destroy(body);
+        ptcl_expression_destroy(else_expression);
+        return NULL;
     }
 
-    if (ptcl_parser_match(parser, ptcl_token_left_curly_type))
+    ptcl_expression_if if_expr = ptcl_expression_if_create(condition, body, else_expression);
+    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_if_type, if_expr.body->return_type, condition->location);
+    if (expression == NULL)
     {
-        if (!ptcl_parser_type_decl_body(parser, &decl, comp_type, location))
-        {
-            return (ptcl_statement_type_decl){0};
-        }
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        ptcl_expression_if_destroy(if_expr);
+        return NULL;
     }
 
-    return decl;
+    expression->if_expr = if_expr;
+    return expression;
 }
 
-ptcl_statement_assign ptcl_parser_assign(ptcl_parser *parser, ptcl_name name, ptcl_expression *left, ptcl_statement_modifiers modifiers)
+ptcl_statement_func_body ptcl_parser_unsyntax(ptcl_parser *parser)
 {
-    const ptcl_location location = ptcl_parser_current(parser).location;
-    const size_t position = ptcl_parser_position(parser);
-    const ptcl_token current_identifier = ptcl_parser_current(parser);
-    ptcl_identifier identifier;
-    ptcl_argument *typedata_member = NULL;
-    ptcl_expression *ctor = NULL;
-    size_t ctor_member_index;
-
-    // Parse left side: name or dot expression
-    if (left == NULL)
-    {
-        identifier = ptcl_identifier_create_by_name(name);
-    }
-    else
-    {
-        identifier = ptcl_identifier_create_by_expr(left);
-        if (identifier.value->return_type.type == ptcl_value_type_type && identifier.value->return_type.is_static)
-        {
-            ctor = ptcl_parser_get_ctor_from_dot(parser, identifier.value, true);
-            if (!ptcl_type_get_member(ctor->return_type.typedata, identifier.value->dot.name, &typedata_member, &ctor_member_index))
-            {
-                ptcl_parser_throw_unknown_member(parser, name.value, location);
-                ptcl_expression_destroy(identifier.value);
-                return (ptcl_statement_assign){0};
-            }
-        }
-    }
-
-    if (ptcl_parser_critical(parser))
-    {
-        ptcl_identifier_destroy(identifier);
-        return (ptcl_statement_assign){0};
-    }
+    ptcl_parser_match(parser, ptcl_token_unsyntax_type);
+    ptcl_parser_disable_state(parser, ptcl_parser_in_syntax_flag);
 
-    ptcl_type type;
-    bool has_explicit_type = ptcl_parser_match(parser, ptcl_token_colon_type);
-    bool is_auto = false;
-    bool is_new_variable = true;
-    ptcl_parser_variable *existing_variable = NULL;
+    ptcl_func_body body = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
 
-    // Handle explicit type declaration
-    if (has_explicit_type)
-    {
-        if (ptcl_parser_is_variable_defined(parser, name))
-        {
-            ptcl_parser_throw_variable_redefinition(parser, name.value, location);
-            ptcl_identifier_destroy(identifier);
-            return (ptcl_statement_assign){0};
-        }
+    ptcl_parser_enable_state(parser, ptcl_parser_in_syntax_flag);
 
-        if (ptcl_parser_current(parser).type == ptcl_token_equals_type)
-        {
-            is_auto = true;
-            has_explicit_type = false;
-        }
-        else
-        {
-            type = ptcl_parser_type(parser, true, false, true);
-            if (ptcl_parser_critical(parser))
-            {
-                ptcl_identifier_destroy(identifier);
-                return (ptcl_statement_assign){0};
-            }
+    return ptcl_statement_func_body_create_by_body(body);
+}
 
-            type.is_const = ptcl_statement_modifiers_flags_const(modifiers);
-        }
-    }
-    else
+bool ptcl_parser_syntax_try_this(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
+{
+    if (strcmp(next.value, "this") == 0)
     {
-        // No explicit type – variable or expression must already exist
-        if (identifier.is_name && !ptcl_parser_try_get_variable(parser, name, &existing_variable))
+        if (syntax.count != 0)
         {
-            ptcl_parser_throw_unknown_variable_or_type(parser, name.value, location);
-            ptcl_identifier_destroy(identifier);
-            return (ptcl_statement_assign){0};
+            ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
         }
 
-        has_explicit_type = true;
-        is_new_variable = false;
-        if (identifier.is_name)
-        {
-            type = existing_variable->type;
-        }
-        else
+        if (ptcl_parser_not(parser, ptcl_token_right_square_type))
         {
-            if (typedata_member == NULL)
-            {
-                type = identifier.value->return_type;
-            }
-            else
-            {
-                type = typedata_member->type;
-            }
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
         }
-    }
 
-    // Expect '='
-    if (ptcl_parser_not(parser, ptcl_token_equals_type))
-    {
-        if (has_explicit_type)
+        if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
         {
-            ptcl_type_destroy(type);
+            ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), current.location);
+            ptcl_parser_syntax_destroy(syntax);
+            return false;
         }
 
-        ptcl_identifier_destroy(identifier);
-        return (ptcl_statement_assign){0};
+        return true;
     }
 
-    // Determine expected type for right-hand side
-    bool is_static_type = false;
-    ptcl_type expected;
-    ptcl_parser_expression_flags flags = ptcl_parser_expression_flags_default(true);
-    ptcl_parser_expression_flags_remove(&flags, ptcl_parser_expression_with_word_flag);
-    if (has_explicit_type && !is_auto)
+    return false;
+}
+
+bool ptcl_parser_syntax_arg(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
+{
+    ptcl_parser_variable *variable = NULL;
+    if (ptcl_parser_match(parser, ptcl_token_colon_type))
     {
-        if (type.is_static)
+        if (ptcl_parser_match(parser, ptcl_token_elipsis_type))
         {
-            if (type.type == ptcl_value_type_type && type.comp_type->invariant != NULL)
+            if (ptcl_parser_not(parser, ptcl_token_right_square_type))
             {
-                expected = type;
-                expected.comp_type = type.comp_type->invariant;
-                expected.is_static = false;
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
             }
-            else
-            {
-                if (type.type == ptcl_value_word_type)
-                {
-                    ptcl_parser_expression_flags_set(&flags, ptcl_parser_expression_with_word_flag);
-                }
 
-                expected = type;
+            ptcl_token end_token = ptcl_parser_current(parser);
+            if (end_token.type == ptcl_token_left_curly_type)
+            {
+                ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
             }
+
+            *node = ptcl_parser_syntax_node_create_end_token(next.value);
+            return true;
         }
         else
         {
-            expected = type;
+            ptcl_type type = ptcl_parser_type(parser, true, true, true);
+            if (ptcl_parser_critical(parser))
+            {
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+
+            if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+            {
+                ptcl_type_destroy(type);
+                ptcl_parser_syntax_destroy(syntax);
+                return false;
+            }
+
+            *node = ptcl_parser_syntax_node_create_variable(type, next.value);
+            return true;
         }
     }
-    else
-    {
-        expected = ptcl_type_any;
-        expected.is_static = false;
-        expected.is_const = true;
-        flags |= ptcl_parser_expression_ignore_excepted_flag;
-    }
 
-    // Parse value
-    ptcl_expression *value = ptcl_parser_cast(parser, &expected, flags);
+    ptcl_parser_syntax_destroy(syntax);
+    ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+    return false;
+}
+
+bool ptcl_parser_syntax_expansion(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
+{
+    ptcl_parser_variable *variable;
+    size_t start = ptcl_parser_position(parser);
+    ptcl_parser_back(parser); // comeback to '!'
+    ptcl_name word = ptcl_parser_name_word(parser);
     if (ptcl_parser_critical(parser))
     {
-        if (has_explicit_type)
-        {
-            ptcl_type_destroy(type);
-        }
-
-        ptcl_identifier_destroy(identifier);
-        return (ptcl_statement_assign){0};
+        ptcl_parser_syntax_destroy(syntax);
+        return false;
     }
 
-    // Substitute into constructor (dot case)
-    if (ctor != NULL)
+    if (ptcl_parser_try_get_variable(parser, word, &variable) && variable->type.type == ptcl_value_object_type_type)
     {
-        // TODO: Add references counter to avoid memory leaks
-        ctor->ctor.values[ctor_member_index] = value;
+        *node = ptcl_parser_syntax_node_create_object_type(*ptcl_type_get_target(variable->type));
+        ptcl_name_destroy(word);
+        return true;
     }
 
-    // Adjust type based on assigned value
-    if (has_explicit_type)
+    ptcl_name_destroy(word);
+    ptcl_parser_syntax_destroy(syntax);
+    ptcl_parser_set_position(parser, start);
+    ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+    return false;
+}
+
+bool ptcl_parser_syntax_token(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
+{
+    if (ptcl_parser_not(parser, ptcl_token_right_square_type))
     {
-        ptcl_parser_set_arrays_length(&type, &value->return_type);
+        ptcl_parser_syntax_destroy(syntax);
+        return false;
     }
-    else
+
+    *node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(next.value, false, current.location));
+    return true;
+}
+
+bool ptcl_parser_syntax_format(ptcl_parser *parser, ptcl_parser_syntax *syntax, bool *is_injector, ptcl_location location)
+{
+    ptcl_location last_location = {0};
+    size_t depth = 0;
+    bool except_end_token = false;
+    while (true)
     {
-        type = value->return_type;
-        if (type.type == ptcl_value_pointer_type && type.pointer.is_null)
+        if (ptcl_parser_ended(parser))
         {
-            type.pointer.is_any = true;
-            type.pointer.is_null = false;
+            ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_left_curly_type), location);
+            ptcl_parser_syntax_destroy(*syntax);
+            return false;
         }
-        else if (is_new_variable)
+
+        ptcl_token current = ptcl_parser_current(parser);
+        ptcl_parser_skip(parser);
+        if (current.type == ptcl_token_left_curly_type)
         {
-            if (type.type == ptcl_value_typedata_type)
-            {
-                type.is_static = type.typedata->is_static;
-            }
-            else if (type.type != ptcl_value_type_type)
-            {
-                type.is_static = !ptcl_type_is_castable_to_unstatic(type);
-            }
+            break;
         }
-    }
-
-    // Create assign statement and register variable
-    ptcl_statement_assign assign = ptcl_statement_assign_create(
-        modifiers, identifier, type, has_explicit_type, value, is_new_variable, 0);
-
-    if (identifier.is_name && existing_variable == NULL)
-    {
-        ptcl_parser_variable variable = ptcl_parser_variable_create(
-            name,
-            type,
-            value,
-            false,
-            ptcl_statement_modifiers_flags_global(modifiers) ? NULL : ptcl_parser_root(parser));
-        const size_t variable_index = parser->variables.count;
-        if (!ptcl_parser_add_instance_variable(parser, variable))
+        else if (current.type == ptcl_token_right_curly_type)
         {
-            ptcl_statement_assign_destroy(assign);
-            ptcl_parser_throw_out_of_memory(parser, location);
-            return (ptcl_statement_assign){0};
+            ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+            ptcl_parser_syntax_destroy(*syntax);
+            return false;
         }
 
-        assign.variable_id = variable_index;
-    }
-    else if (existing_variable != NULL)
-    {
-        assign.variable_id = existing_variable - parser->variables.items;
-        existing_variable->built_in = value;
-        if (is_static_type && !value->return_type.is_static)
+        bool breaked = false;
+        ptcl_parser_syntax_node node = {0};
+        switch (current.type)
         {
-            ptcl_parser_make_unstatic(&parser->variables.items[assign.variable_id]);
-        }
-    }
+        case ptcl_token_left_square_type:
+        {
+            ptcl_token next = ptcl_parser_current(parser);
+            ptcl_parser_skip(parser);
+            switch (next.type)
+            {
+            case ptcl_token_word_type:
+            {
+                if (ptcl_parser_syntax_try_this(parser, *syntax, next, current, &node))
+                {
+                    *is_injector = true;
+                    breaked = true;
+                    break;
+                }
+                else if (ptcl_parser_critical(parser) || !ptcl_parser_syntax_arg(parser, *syntax, next, current, &node))
+                {
+                    // Already destroyed in 'this' parsing or above
+                    return false;
+                }
 
-    return assign;
-}
+                break;
+            }
+            case ptcl_token_exclamation_mark_type:
+            {
+                if (!ptcl_parser_syntax_expansion(parser, *syntax, next, current, &node))
+                {
+                    // Already destroyed above
+                    return false;
+                }
 
-ptcl_statement_return ptcl_parser_return(ptcl_parser *parser)
-{
-    ptcl_parser_match(parser, ptcl_token_return_type);
-    if (parser->temp.return_type != NULL)
-    {
-        if (parser->temp.return_type->type == ptcl_value_void_type)
-        {
-            ptcl_parser_match(parser, ptcl_token_none_type);
-            return ptcl_statement_return_create(NULL);
-        }
-    }
+                break;
+            }
+            case ptcl_token_left_curly_type:
+                if (!ptcl_parser_syntax_token(parser, *syntax, next, current, &node))
+                {
+                    // Already destroyed above
+                    return false;
+                }
 
-    const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
-    ptcl_parser_enable_state(parser, ptcl_parser_in_return_flag);
-    ptcl_expression *value = ptcl_parser_cast(parser, parser->temp.return_type, false);
+                depth++;
+                last_location = next.location;
+                break;
+            case ptcl_token_right_curly_type:
+                if (depth == 0)
+                {
+                    ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), next.location);
+                    ptcl_parser_syntax_destroy(*syntax);
+                    return false;
+                }
 
-    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
-    if (ptcl_parser_critical(parser))
-    {
-        return (ptcl_statement_return){0};
-    }
+                if (!ptcl_parser_syntax_token(parser, *syntax, next, current, &node))
+                {
+                    // Already destroyed above
+                    return false;
+                }
 
-    if (value->return_type.type == ptcl_value_void_type)
-    {
-        ptcl_parser_throw_except_type_specifier(parser, ptcl_parser_current(parser).location);
-        return (ptcl_statement_return){0};
-    }
+                depth--;
+                break;
+            default:
+                ptcl_parser_back(parser);
+                node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(current.value, false, current.location));
+                break;
+            }
 
-    return ptcl_statement_return_create(value);
-}
+            break;
+        }
+        default:
+            node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(current.value, false, current.location));
+            break;
+        }
 
-static ptcl_statement *ptcl_parser_static_if_body(ptcl_parser *parser, ptcl_expression *condition)
-{
-    ptcl_func_body result;
-    const bool condition_value = condition->integer_n;
-    ptcl_location location = condition->location;
-    ptcl_expression_destroy(condition);
-    if (condition_value)
-    {
-        result = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
-        if (ptcl_parser_critical(parser))
+        if (breaked)
         {
-            return NULL;
+            break;
         }
 
-        if (ptcl_parser_match(parser, ptcl_token_else_type))
+        if (except_end_token)
         {
-            if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
+            if (node.type != ptcl_parser_syntax_node_word_type)
             {
-                ptcl_func_body_destroy(result);
-                return NULL;
+                ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
+                ptcl_parser_syntax_node_destroy(node);
+                ptcl_parser_syntax_destroy(*syntax);
+                return false;
             }
 
-            ptcl_parser_skip_block_or_expression(parser);
-            if (ptcl_parser_critical(parser))
-            {
-                ptcl_func_body_destroy(result);
-                return NULL;
-            }
+            except_end_token = false;
         }
-    }
-    else
-    {
-        ptcl_parser_skip(parser);
-        ptcl_parser_skip_block_or_expression(parser);
-        if (ptcl_parser_critical(parser))
+        else
         {
-            return NULL;
+            except_end_token = node.type == ptcl_parser_syntax_node_variable_type && node.variable.is_variadic;
         }
 
-        if (ptcl_parser_match(parser, ptcl_token_else_type))
-        {
-            result = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
-            if (ptcl_parser_critical(parser))
-            {
-                return NULL;
-            }
-        }
-        else
+        ptcl_parser_syntax_node *buffer = realloc(syntax->nodes, (syntax->count + 1) * sizeof(ptcl_parser_syntax_node));
+        if (buffer == NULL)
         {
-            return NULL;
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            ptcl_parser_syntax_node_destroy(node);
+            ptcl_parser_syntax_destroy(*syntax);
+            return false;
         }
+
+        syntax->nodes = buffer;
+        syntax->nodes[syntax->count++] = node;
     }
 
-    return ptcl_func_body_create_stat(ptcl_statement_func_body_create_by_body(result), result.root, location);
+    if (depth != 0)
+    {
+        ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), last_location);
+        ptcl_parser_syntax_destroy(*syntax);
+        return false;
+    }
+
+    return true;
 }
 
-ptcl_statement *ptcl_parser_if(ptcl_parser *parser, bool is_static)
+void ptcl_parser_syntax_decl(ptcl_parser *parser)
 {
-    ptcl_parser_match(parser, ptcl_token_if_type);
+    ptcl_parser_match(parser, ptcl_token_syntax_type);
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_parser_syntax syntax = ptcl_parser_syntax_create(ptcl_name_empty, ptcl_parser_root(parser), NULL, 0, 0);
+    bool is_injector = false;
 
-    ptcl_type type = ptcl_type_integer;
-    type.is_static = is_static;
-    ptcl_expression *condition = ptcl_parser_cast(parser, &type, ptcl_parser_expression_flags_default(true));
-    if (ptcl_parser_critical(parser))
+    if (!ptcl_parser_syntax_format(parser, &syntax, &is_injector, location))
     {
-        return NULL;
+        return;
     }
 
-    if (condition->return_type.is_static || is_static)
+    size_t start = ptcl_parser_position(parser);
+    ptcl_parser_skip_block_or_expression(parser);
+    if (ptcl_parser_critical(parser))
     {
-        return ptcl_parser_static_if_body(parser, condition);
+        ptcl_parser_syntax_destroy(syntax);
+        return;
     }
 
-    const bool last_state = ptcl_parser_in_if(parser);
-    ptcl_parser_enable_state(parser, ptcl_parser_in_if_flag);
+    size_t tokens_count = (ptcl_parser_position(parser) - start);
+    if (tokens_count > 0)
+    {
+        // -1 because of curly
+        tokens_count -= 1;
+    }
 
-    ptcl_func_body body = ptcl_parser_func_body(parser, true, true, ptcl_parser_ignore_error(parser));
+    size_t index = ptcl_parser_add_lated_body(parser, start, tokens_count, false, location);
     if (ptcl_parser_critical(parser))
     {
-        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-        ptcl_expression_destroy(condition);
-        return NULL;
+        ptcl_parser_syntax_destroy(syntax);
+        return;
     }
 
-    ptcl_statement_if if_stat = ptcl_statement_if_create(condition, body, false, (ptcl_func_body){0});
-    if (ptcl_parser_match(parser, ptcl_token_else_type))
+    syntax.index = index;
+    if (!is_injector)
     {
-        if_stat.else_body = ptcl_parser_func_body(parser, true, true, ptcl_parser_ignore_error(parser));
-        if_stat.with_else = !ptcl_parser_critical(parser);
-        if (ptcl_parser_critical(parser))
+        if (!ptcl_parser_add_instance_syntax(parser, syntax))
         {
-            ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-            ptcl_statement_if_destroy(if_stat);
-            return NULL;
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            ptcl_parser_syntax_destroy(syntax);
+            return;
         }
     }
-
-    ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-    ptcl_statement *statement = ptcl_statement_create(ptcl_statement_if_type, ptcl_parser_root(parser), ptcl_attributes_create(NULL, 0), condition->location);
-    if (statement == NULL)
+    else
     {
-        ptcl_statement_if_destroy(if_stat);
-        ptcl_parser_throw_out_of_memory(parser, condition->location);
-        return NULL;
+        if (!ptcl_parser_add_this_pair(parser, ptcl_parser_this_s_pair_create(parser->temp.main_root, syntax.index)))
+        {
+            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+            ptcl_parser_syntax_destroy(syntax);
+            return;
+        }
     }
-
-    statement->if_stat = if_stat;
-    return statement;
 }
 
-static ptcl_expression *ptcl_parser_static_if_expr_body(ptcl_parser *parser, ptcl_expression *condition)
+// Body of each can be parsed once and shared between elements only if it can't change compile-time state
+// between iterations, so its tokens must be plain like deferred body ones. Body, which uses element, is parsed
+// with first element and nodes made from it are recorded, so next elements only replace their values
+static bool ptcl_parser_each_is_invariant(ptcl_parser *parser, ptcl_name name, bool *uses_element)
 {
-    ptcl_expression *result;
+    ptcl_token *tokens = ptcl_parser_tokens(parser);
+    size_t count = ptcl_parser_count(parser);
+    size_t position = ptcl_parser_position(parser);
+    *uses_element = false;
+    if (position >= count || tokens[position].type != ptcl_token_left_curly_type)
+    {
+        return false;
+    }
 
-    int condition_value = condition->integer_n;
-    ptcl_expression_destroy(condition);
-    if (condition_value)
+    size_t depth = 1;
+    for (size_t i = position + 1; i < count; i++)
     {
-        result = ptcl_parser_cast(parser, NULL, false);
-        if (ptcl_parser_critical(parser))
+        ptcl_token token = tokens[i];
+        switch (token.type)
         {
-            return NULL;
-        }
+        case ptcl_token_left_curly_type:
+            depth++;
+            break;
+        case ptcl_token_right_curly_type:
+            if (--depth == 0)
+            {
+                return true;
+            }
 
-        if (ptcl_parser_not(parser, ptcl_token_right_curly_type) ||
-            ptcl_parser_not(parser, ptcl_token_else_type) ||
-            ptcl_parser_not(parser, ptcl_token_left_curly_type))
-        {
-            ptcl_expression_destroy(result);
-            return NULL;
-        }
+            continue;
+        case ptcl_token_return_type:
+            return false;
+        case ptcl_token_word_type:
+            if (ptcl_name_compare(ptcl_name_create_fast_w(token.value, false), name))
+            {
+                *uses_element = true;
+                continue;
+            }
 
-        ptcl_parser_skip_block_or_expression(parser);
-        if (ptcl_parser_critical(parser))
-        {
-            ptcl_expression_destroy(result);
-            return NULL;
-        }
-    }
-    else
-    {
-        ptcl_parser_skip_block_or_expression(parser);
-        if (ptcl_parser_critical(parser))
-        {
-            return NULL;
+            break;
+        default:
+            break;
         }
 
-        if (ptcl_parser_not(parser, ptcl_token_else_type) || ptcl_parser_not(parser, ptcl_token_left_curly_type))
+        if (!ptcl_parser_is_plain_token(parser, tokens, i))
         {
-            return NULL;
+            return false;
         }
+    }
 
-        result = ptcl_parser_cast(parser, NULL, false);
-        if (ptcl_parser_critical(parser))
-        {
-            return NULL;
-        }
+    return false;
+}
 
-        if (ptcl_parser_not(parser, ptcl_token_right_curly_type))
+// Values are replaced in place, so elements must be literals of one kind
+static bool ptcl_parser_each_is_bindable(ptcl_expression *value)
+{
+    ptcl_expression_type type = value->array->expressions[0]->type;
+    if (type != ptcl_expression_character_type && type != ptcl_expression_integer_type &&
+        type != ptcl_expression_double_type && type != ptcl_expression_float_type)
+    {
+        return false;
+    }
+
+    for (size_t i = 1; i < value->array->count; i++)
+    {
+        if (value->array->expressions[i]->type != type)
         {
-            ptcl_expression_destroy(result);
-            return NULL;
+            return false;
         }
     }
 
-    return result;
+    return true;
 }
 
-ptcl_expression *ptcl_parser_if_expression(ptcl_parser *parser, bool is_static)
+static bool ptcl_parser_each_literal_equals(ptcl_expression *left, ptcl_expression *right)
 {
-    ptcl_parser_match(parser, ptcl_token_if_type);
-    ptcl_type type = ptcl_type_integer;
-    type.is_static = is_static;
+    if (left->type != right->type)
+    {
+        return false;
+    }
 
-    ptcl_expression *condition = ptcl_parser_cast(parser, &type, false);
-    if (ptcl_parser_critical(parser))
+    switch (left->type)
     {
-        return NULL;
+    case ptcl_expression_character_type:
+        return left->character == right->character;
+    case ptcl_expression_integer_type:
+        return left->integer_n == right->integer_n;
+    case ptcl_expression_double_type:
+        return left->double_n == right->double_n;
+    case ptcl_expression_float_type:
+        return left->float_n == right->float_n;
+    default:
+        return false;
     }
+}
 
-    if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
+static bool ptcl_parser_each_find_expression(ptcl_parser_each_slots *slots, ptcl_expression *expression, ptcl_expression *element);
+
+static bool ptcl_parser_each_find_body(ptcl_parser_each_slots *slots, ptcl_func_body body, ptcl_expression *element);
+
+static bool ptcl_parser_each_find_func_call(ptcl_parser_each_slots *slots, ptcl_statement_func_call func_call, ptcl_expression *element)
+{
+    if (func_call.built_in != NULL || (!func_call.identifier.is_name && !ptcl_parser_each_find_expression(slots, func_call.identifier.value, element)))
     {
-        return NULL;
+        return false;
     }
 
-    if (condition->return_type.is_static || is_static)
+    for (size_t i = 0; i < func_call.count; i++)
     {
-        return ptcl_parser_static_if_expr_body(parser, condition);
+        if (!ptcl_parser_each_find_expression(slots, func_call.arguments[i], element))
+        {
+            return false;
+        }
     }
 
-    const bool last_state = ptcl_parser_in_if(parser);
-    ptcl_parser_enable_state(parser, ptcl_parser_in_if_flag);
+    return true;
+}
 
-    ptcl_expression *body = ptcl_parser_cast(parser, NULL, false);
-    if (ptcl_parser_critical(parser))
+// Each recorded node must be found once with value of element, otherwise parser has folded, copied or changed it.
+// Found ones are moved to end of list, so count is zero if all of them are in body
+static bool ptcl_parser_each_find_expression(ptcl_parser_each_slots *slots, ptcl_expression *expression, ptcl_expression *element)
+{
+    if (expression->is_slot)
     {
-        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-        ptcl_expression_destroy(condition);
-        return NULL;
+        for (size_t i = 0; i < slots->count; i++)
+        {
+            if (slots->items[i] == expression)
+            {
+                slots->items[i] = slots->items[--slots->count];
+                slots->items[slots->count] = expression;
+                return ptcl_parser_each_literal_equals(expression, element);
+            }
+        }
+
+        return false;
     }
 
-    if (ptcl_parser_not(parser, ptcl_token_right_curly_type) ||
-        ptcl_parser_not(parser, ptcl_token_else_type) ||
-        ptcl_parser_not(parser, ptcl_token_left_curly_type))
+    switch (expression->type)
     {
-        ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-        ptcl_expression_destroy(condition);
-        ptcl_expression_destroy(body);
-        return NULL;
+    case ptcl_expression_character_type:
+    case ptcl_expression_integer_type:
+    case ptcl_expression_double_type:
+    case ptcl_expression_float_type:
+    case ptcl_expression_string_type:
+    case ptcl_expression_null_type:
+    case ptcl_expression_variable_type:
+        return true;
+    case ptcl_expression_binary_type:
+        return ptcl_parser_each_find_expression(slots, expression->binary.left, element) &&
+               ptcl_parser_each_find_expression(slots, expression->binary.right, element);
+    case ptcl_expression_unary_type:
+        return ptcl_parser_each_find_expression(slots, expression->unary.child, element);
+    case ptcl_expression_cast_type:
+        return ptcl_parser_each_find_expression(slots, expression->cast->value, element);
+    case ptcl_expression_array_element_type:
+        return ptcl_parser_each_find_expression(slots, expression->array_element.value, element) &&
+               ptcl_parser_each_find_expression(slots, expression->array_element.index, element);
+    case ptcl_expression_func_call_type:
+        return ptcl_parser_each_find_func_call(slots, *expression->func_call, element);
+    default:
+        return false;
     }
+}
 
-    ptcl_expression *else_expression = ptcl_parser_cast(parser, &body->return_type, false);
-    ptcl_parser_set_state(parser, ptcl_parser_in_if_flag, last_state);
-    if (ptcl_parser_critical(parser))
+static bool ptcl_parser_each_find_statement(ptcl_parser_each_slots *slots, ptcl_statement *statement, ptcl_expression *element)
+{
+    if (statement->attributes.count > 0)
     {
-        ptcl_expression_destroy(condition);
-        ptcl_expression_destroy(body);
-        return NULL;
+        return false;
     }
 
-    if (ptcl_parser_not(parser, ptcl_token_right_curly_type))
+    switch (statement->type)
     {
-        ptcl_expression_destroy(condition);
-        ptcl_expression_destroy(body);
-        ptcl_expression_destroy(else_expression);
-        return NULL;
+    case ptcl_statement_func_call_type:
+        return ptcl_parser_each_find_func_call(slots, statement->func_call, element);
+    case ptcl_statement_assign_type:
+        return (statement->assign.identifier.is_name || ptcl_parser_each_find_expression(slots, statement->assign.identifier.value, element)) &&
+               (statement->assign.value == NULL || ptcl_parser_each_find_expression(slots, statement->assign.value, element));
+    case ptcl_statement_if_type:
+        return ptcl_parser_each_find_expression(slots, statement->if_stat.condition, element) &&
+               ptcl_parser_each_find_body(slots, statement->if_stat.body, element) &&
+               (!statement->if_stat.with_else || ptcl_parser_each_find_body(slots, statement->if_stat.else_body, element));
+    case ptcl_statement_func_body_type:
+        return statement->body.arguments == NULL && statement->body.self == NULL &&
+               ptcl_parser_each_find_body(slots, statement->body.body, element);
+    default:
+        return false;
     }
+}
 
-    ptcl_expression_if if_expr = ptcl_expression_if_create(condition, body, else_expression);
-    ptcl_expression *expression = ptcl_expression_create(ptcl_expression_if_type, if_expr.body->return_type, condition->location);
-    if (expression == NULL)
+static bool ptcl_parser_each_find_body(ptcl_parser_each_slots *slots, ptcl_func_body body, ptcl_expression *element)
+{
+    for (size_t i = 0; i < body.count; i++)
     {
-        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-        ptcl_expression_if_destroy(if_expr);
-        return NULL;
+        if (!ptcl_parser_each_find_statement(slots, body.statements[i], element))
+        {
+            return false;
+        }
     }
 
-    expression->if_expr = if_expr;
-    return expression;
+    return true;
 }
 
-ptcl_statement_func_body ptcl_parser_unsyntax(ptcl_parser *parser)
-{
-    ptcl_parser_match(parser, ptcl_token_unsyntax_type);
-    ptcl_parser_disable_state(parser, ptcl_parser_in_syntax_flag);
+static ptcl_expression *ptcl_parser_each_clone_expression(ptcl_expression *target, ptcl_expression *element);
 
-    ptcl_func_body body = ptcl_parser_func_body(parser, true, false, ptcl_parser_ignore_error(parser));
+static ptcl_statement *ptcl_parser_each_clone_statement(ptcl_statement *target, ptcl_expression *element);
 
-    ptcl_parser_enable_state(parser, ptcl_parser_in_syntax_flag);
+static bool ptcl_parser_each_clone_body(ptcl_func_body *body, ptcl_func_body target, ptcl_expression *element)
+{
+    *body = ptcl_func_body_create(NULL, 0, target.root);
+    if (target.count == 0)
+    {
+        return true;
+    }
 
-    return ptcl_statement_func_body_create_by_body(body);
-}
+    body->statements = malloc(target.count * sizeof(ptcl_statement *));
+    if (body->statements == NULL)
+    {
+        return false;
+    }
 
-bool ptcl_parser_syntax_try_this(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
-{
-    if (strcmp(next.value, "this") == 0)
+    for (; body->count < target.count; body->count++)
     {
-        if (syntax.count != 0)
+        body->statements[body->count] = ptcl_parser_each_clone_statement(target.statements[body->count], element);
+        if (body->statements[body->count] == NULL)
         {
-            ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-            ptcl_parser_syntax_destroy(syntax);
             return false;
         }
+    }
 
-        if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+    return true;
+}
+
+// Clone owns all its nodes, names and nodes it doesn't visit are shared with body of first element
+static bool ptcl_parser_each_clone_func_call(ptcl_statement_func_call *func_call, ptcl_statement_func_call target, ptcl_expression *element)
+{
+    *func_call = target;
+    func_call->arguments = NULL;
+    func_call->count = 0;
+    if (target.identifier.is_name)
+    {
+        func_call->identifier.name.is_free = false;
+    }
+    else
+    {
+        func_call->identifier = (ptcl_identifier){.is_name = true, .name = ptcl_name_empty};
+        ptcl_expression *identifier = ptcl_parser_each_clone_expression(target.identifier.value, element);
+        if (identifier == NULL)
         {
-            ptcl_parser_syntax_destroy(syntax);
             return false;
         }
 
-        if (ptcl_parser_not(parser, ptcl_token_left_curly_type))
+        func_call->identifier = (ptcl_identifier){.is_name = false, .value = identifier};
+    }
+
+    if (target.count == 0)
+    {
+        return true;
+    }
+
+    func_call->arguments = malloc(target.count * sizeof(ptcl_expression *));
+    if (func_call->arguments == NULL)
+    {
+        return false;
+    }
+
+    for (; func_call->count < target.count; func_call->count++)
+    {
+        func_call->arguments[func_call->count] = ptcl_parser_each_clone_expression(target.arguments[func_call->count], element);
+        if (func_call->arguments[func_call->count] == NULL)
         {
-            ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), current.location);
-            ptcl_parser_syntax_destroy(syntax);
             return false;
         }
-
-        return true;
     }
 
-    return false;
+    return true;
 }
 
-bool ptcl_parser_syntax_arg(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
+static ptcl_expression *ptcl_parser_each_clone_expression(ptcl_expression *target, ptcl_expression *element)
 {
-    ptcl_parser_variable *variable = NULL;
-    if (ptcl_parser_match(parser, ptcl_token_colon_type))
+    ptcl_expression *expression = ptcl_expression_create(target->type, target->return_type, target->location);
+    if (expression == NULL)
     {
-        if (ptcl_parser_match(parser, ptcl_token_elipsis_type))
+        return NULL;
+    }
+
+    // Children are cloned before node owns them, so failed clone is released without them
+    *expression = *target;
+    expression->type = ptcl_expression_null_type;
+    expression->is_original = true;
+    expression->is_slot = false;
+    expression->with_type = false;
+    bool is_cloned = true;
+    switch (target->type)
+    {
+    case ptcl_expression_character_type:
+    case ptcl_expression_integer_type:
+    case ptcl_expression_double_type:
+    case ptcl_expression_float_type:
+        if (target->is_slot)
         {
-            if (ptcl_parser_not(parser, ptcl_token_right_square_type))
-            {
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
-            }
+            expression->long_n = 0;
+            expression->character = element->character;
+            expression->integer_n = element->type == ptcl_expression_integer_type ? element->integer_n : expression->integer_n;
+            expression->double_n = element->type == ptcl_expression_double_type ? element->double_n : expression->double_n;
+            expression->float_n = element->type == ptcl_expression_float_type ? element->float_n : expression->float_n;
+        }
 
-            ptcl_token end_token = ptcl_parser_current(parser);
-            if (end_token.type == ptcl_token_left_curly_type)
+        break;
+    case ptcl_expression_string_type:
+        expression->string.value = malloc(target->string.length + 1);
+        is_cloned = expression->string.value != NULL;
+        if (is_cloned)
+        {
+            memcpy(expression->string.value, target->string.value, target->string.length + 1);
+        }
+
+        break;
+    case ptcl_expression_variable_type:
+        expression->variable.name.is_free = false;
+        break;
+    case ptcl_expression_binary_type:
+        expression->binary.left = ptcl_parser_each_clone_expression(target->binary.left, element);
+        expression->binary.right = expression->binary.left == NULL ? NULL : ptcl_parser_each_clone_expression(target->binary.right, element);
+        if (expression->binary.right == NULL)
+        {
+            if (expression->binary.left != NULL)
             {
-                ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
+                ptcl_expression_destroy(expression->binary.left);
             }
 
-            *node = ptcl_parser_syntax_node_create_end_token(next.value);
-            return true;
+            is_cloned = false;
         }
-        else
+
+        break;
+    case ptcl_expression_unary_type:
+        expression->unary.child = ptcl_parser_each_clone_expression(target->unary.child, element);
+        is_cloned = expression->unary.child != NULL;
+        break;
+    case ptcl_expression_cast_type:
+    {
+        expression->cast = malloc(sizeof(ptcl_expression_cast));
+        if (expression->cast == NULL)
         {
-            ptcl_type type = ptcl_parser_type(parser, true, true, true);
-            if (ptcl_parser_critical(parser))
+            is_cloned = false;
+            break;
+        }
+
+        bool is_out_of_memory = false;
+        *expression->cast = *target->cast;
+        expression->cast->value = ptcl_parser_each_clone_expression(target->cast->value, element);
+        if (expression->cast->value != NULL && target->cast->is_free)
+        {
+            expression->cast->type = ptcl_type_copy(target->cast->type, &is_out_of_memory);
+        }
+
+        if (expression->cast->value == NULL || is_out_of_memory)
+        {
+            if (expression->cast->value != NULL)
             {
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
+                ptcl_expression_destroy(expression->cast->value);
             }
 
-            if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+            free(expression->cast);
+            is_cloned = false;
+        }
+
+        break;
+    }
+    case ptcl_expression_array_element_type:
+        expression->array_element.value = ptcl_parser_each_clone_expression(target->array_element.value, element);
+        expression->array_element.index = expression->array_element.value == NULL ? NULL : ptcl_parser_each_clone_expression(target->array_element.index, element);
+        if (expression->array_element.index == NULL)
+        {
+            if (expression->array_element.value != NULL)
             {
-                ptcl_type_destroy(type);
-                ptcl_parser_syntax_destroy(syntax);
-                return false;
+                ptcl_expression_destroy(expression->array_element.value);
             }
 
-            *node = ptcl_parser_syntax_node_create_variable(type, next.value);
-            return true;
+            is_cloned = false;
         }
-    }
 
-    ptcl_parser_syntax_destroy(syntax);
-    ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-    return false;
-}
+        break;
+    case ptcl_expression_func_call_type:
+        expression->func_call = malloc(sizeof(ptcl_statement_func_call));
+        is_cloned = expression->func_call != NULL;
+        if (is_cloned && !ptcl_parser_each_clone_func_call(expression->func_call, *target->func_call, element))
+        {
+            ptcl_statement_func_call_destroy(*expression->func_call);
+            free(expression->func_call);
+            is_cloned = false;
+        }
 
-bool ptcl_parser_syntax_expansion(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
-{
-    ptcl_parser_variable *variable;
-    size_t start = ptcl_parser_position(parser);
-    ptcl_parser_back(parser); // comeback to '!'
-    ptcl_name word = ptcl_parser_name_word(parser);
-    if (ptcl_parser_critical(parser))
-    {
-        ptcl_parser_syntax_destroy(syntax);
-        return false;
+        break;
+    default:
+        break;
     }
 
-    if (ptcl_parser_try_get_variable(parser, word, &variable) && variable->type.type == ptcl_value_object_type_type)
+    if (!is_cloned)
     {
-        *node = ptcl_parser_syntax_node_create_object_type(*ptcl_type_get_target(variable->type));
-        ptcl_name_destroy(word);
-        return true;
+        free(expression);
+        return NULL;
     }
 
-    ptcl_name_destroy(word);
-    ptcl_parser_syntax_destroy(syntax);
-    ptcl_parser_set_position(parser, start);
-    ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-    return false;
-}
-
-bool ptcl_parser_syntax_token(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_token next, ptcl_token current, ptcl_parser_syntax_node *node)
-{
-    if (ptcl_parser_not(parser, ptcl_token_right_square_type))
+    expression->type = target->type;
+    if (target->with_type && ptcl_expression_with_own_type(target->type))
     {
-        ptcl_parser_syntax_destroy(syntax);
-        return false;
+        bool is_out_of_memory = false;
+        expression->return_type = ptcl_type_copy(target->return_type, &is_out_of_memory);
+        if (is_out_of_memory)
+        {
+            ptcl_expression_destroy(expression);
+            return NULL;
+        }
+
+        expression->with_type = true;
     }
 
-    *node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(next.value, false, current.location));
-    return true;
+    return expression;
 }
 
-bool ptcl_parser_syntax_format(ptcl_parser *parser, ptcl_parser_syntax *syntax, bool *is_injector, ptcl_location location)
+static ptcl_statement *ptcl_parser_each_clone_statement(ptcl_statement *target, ptcl_expression *element)
 {
-    ptcl_location last_location = {0};
-    size_t depth = 0;
-    bool except_end_token = false;
-    while (true)
+    ptcl_statement *statement = ptcl_statement_create(ptcl_statement_none_type, target->root, target->attributes, target->location);
+    if (statement == NULL)
     {
-        if (ptcl_parser_ended(parser))
+        return NULL;
+    }
+
+    *statement = *target;
+    statement->type = ptcl_statement_none_type;
+    statement->is_original = true;
+    statement->attributes = ptcl_attributes_create(NULL, 0);
+    bool is_cloned = true;
+    switch (target->type)
+    {
+    case ptcl_statement_func_call_type:
+        is_cloned = ptcl_parser_each_clone_func_call(&statement->func_call, target->func_call, element);
+        if (!is_cloned)
         {
-            ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_left_curly_type), location);
-            ptcl_parser_syntax_destroy(*syntax);
-            return false;
+            ptcl_statement_func_call_destroy(statement->func_call);
         }
 
-        ptcl_token current = ptcl_parser_current(parser);
-        ptcl_parser_skip(parser);
-        if (current.type == ptcl_token_left_curly_type)
+        break;
+    case ptcl_statement_assign_type:
+    {
+        ptcl_statement_assign *assign = &statement->assign;
+        bool is_out_of_memory = false;
+        assign->value = NULL;
+        if (target->assign.identifier.is_name)
         {
-            break;
+            assign->identifier.name.is_free = false;
         }
-        else if (current.type == ptcl_token_right_curly_type)
+        else
         {
-            ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-            ptcl_parser_syntax_destroy(*syntax);
-            return false;
+            assign->identifier.value = ptcl_parser_each_clone_expression(target->assign.identifier.value, element);
+            is_cloned = assign->identifier.value != NULL;
         }
 
-        bool breaked = false;
-        ptcl_parser_syntax_node node = {0};
-        switch (current.type)
-        {
-        case ptcl_token_left_square_type:
+        if (is_cloned && target->assign.value != NULL)
         {
-            ptcl_token next = ptcl_parser_current(parser);
-            ptcl_parser_skip(parser);
-            switch (next.type)
-            {
-            case ptcl_token_word_type:
-            {
-                if (ptcl_parser_syntax_try_this(parser, *syntax, next, current, &node))
-                {
-                    *is_injector = true;
-                    breaked = true;
-                    break;
-                }
-                else if (ptcl_parser_critical(parser) || !ptcl_parser_syntax_arg(parser, *syntax, next, current, &node))
-                {
-                    // Already destroyed in 'this' parsing or above
-                    return false;
-                }
-
-                break;
-            }
-            case ptcl_token_exclamation_mark_type:
-            {
-                if (!ptcl_parser_syntax_expansion(parser, *syntax, next, current, &node))
-                {
-                    // Already destroyed above
-                    return false;
-                }
-
-                break;
-            }
-            case ptcl_token_left_curly_type:
-                if (!ptcl_parser_syntax_token(parser, *syntax, next, current, &node))
-                {
-                    // Already destroyed above
-                    return false;
-                }
-
-                depth++;
-                last_location = next.location;
-                break;
-            case ptcl_token_right_curly_type:
-                if (depth == 0)
-                {
-                    ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), next.location);
-                    ptcl_parser_syntax_destroy(*syntax);
-                    return false;
-                }
-
-                if (!ptcl_parser_syntax_token(parser, *syntax, next, current, &node))
-                {
-                    // Already destroyed above
-                    return false;
-                }
-
-                depth--;
-                break;
-            default:
-                ptcl_parser_back(parser);
-                node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(current.value, false, current.location));
-                break;
-            }
-
-            break;
+            assign->value = ptcl_parser_each_clone_expression(target->assign.value, element);
+            is_cloned = assign->value != NULL;
         }
-        default:
-            node = ptcl_parser_syntax_node_create_word(current.type, ptcl_name_create(current.value, false, current.location));
-            break;
+
+        if (is_cloned && target->assign.with_type && target->assign.is_define)
+        {
+            assign->type = ptcl_type_copy(target->assign.type, &is_out_of_memory);
+            is_cloned = !is_out_of_memory;
         }
 
-        if (breaked)
+        if (!is_cloned)
         {
-            break;
+            assign->with_type = false;
+            ptcl_statement_assign_destroy(*assign);
         }
 
-        if (except_end_token)
+        break;
+    }
+    case ptcl_statement_if_type:
+    {
+        ptcl_statement_if *if_stat = &statement->if_stat;
+        if_stat->body = ptcl_func_body_create(NULL, 0, target->if_stat.body.root);
+        if_stat->else_body = ptcl_func_body_create(NULL, 0, target->if_stat.else_body.root);
+        if_stat->condition = ptcl_parser_each_clone_expression(target->if_stat.condition, element);
+        is_cloned = if_stat->condition != NULL &&
+                    ptcl_parser_each_clone_body(&if_stat->body, target->if_stat.body, element) &&
+                    (!target->if_stat.with_else || ptcl_parser_each_clone_body(&if_stat->else_body, target->if_stat.else_body, element));
+        if (!is_cloned)
         {
-            if (node.type != ptcl_parser_syntax_node_word_type)
+            if (if_stat->condition != NULL)
             {
-                ptcl_parser_throw_not_allowed_token(parser, current.value, current.location);
-                ptcl_parser_syntax_node_destroy(node);
-                ptcl_parser_syntax_destroy(*syntax);
-                return false;
+                ptcl_expression_destroy(if_stat->condition);
             }
 
-            except_end_token = false;
-        }
-        else
-        {
-            except_end_token = node.type == ptcl_parser_syntax_node_variable_type && node.variable.is_variadic;
+            ptcl_func_body_destroy(if_stat->body);
+            ptcl_func_body_destroy(if_stat->else_body);
         }
 
-        ptcl_parser_syntax_node *buffer = realloc(syntax->nodes, (syntax->count + 1) * sizeof(ptcl_parser_syntax_node));
-        if (buffer == NULL)
+        break;
+    }
+    case ptcl_statement_func_body_type:
+        is_cloned = ptcl_parser_each_clone_body(&statement->body.body, target->body.body, element);
+        if (!is_cloned)
         {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_parser_syntax_node_destroy(node);
-            ptcl_parser_syntax_destroy(*syntax);
-            return false;
+            ptcl_func_body_destroy(statement->body.body);
         }
 
-        syntax->nodes = buffer;
-        syntax->nodes[syntax->count++] = node;
+        break;
+    default:
+        break;
     }
 
-    if (depth != 0)
+    if (!is_cloned)
     {
-        ptcl_parser_throw_except_token(parser, ptcl_lexer_configuration_get_value(parser->configuration, ptcl_token_right_curly_type), last_location);
-        ptcl_parser_syntax_destroy(*syntax);
-        return false;
+        free(statement);
+        return NULL;
     }
 
-    return true;
+    statement->type = target->type;
+    return statement;
 }
 
-void ptcl_parser_syntax_decl(ptcl_parser *parser)
+// Only found nodes are released, others could be freed by parser
+static void ptcl_parser_each_release(ptcl_parser *parser, size_t found)
 {
-    ptcl_parser_match(parser, ptcl_token_syntax_type);
-    ptcl_location location = ptcl_parser_current(parser).location;
-    ptcl_parser_syntax syntax = ptcl_parser_syntax_create(ptcl_name_empty, ptcl_parser_root(parser), NULL, 0, 0);
-    bool is_injector = false;
-
-    if (!ptcl_parser_syntax_format(parser, &syntax, &is_injector, location))
+    for (size_t i = found; i < parser->each_slots.count; i++)
     {
-        return;
+        parser->each_slots.items[i]->is_slot = false;
     }
 
-    size_t start = ptcl_parser_position(parser);
-    ptcl_parser_skip_block_or_expression(parser);
-    if (ptcl_parser_critical(parser))
-    {
-        ptcl_parser_syntax_destroy(syntax);
-        return;
-    }
+    parser->each_slots.count = 0;
+}
 
-    size_t tokens_count = (ptcl_parser_position(parser) - start);
-    if (tokens_count > 0)
+static bool ptcl_parser_each_instantiate(ptcl_parser *parser, ptcl_func_body *body, size_t template_count, ptcl_expression *element, ptcl_location location)
+{
+    if (template_count == 0)
     {
-        // -1 because of curly
-        tokens_count -= 1;
+        return true;
     }
 
-    size_t index = ptcl_parser_add_lated_body(parser, start, tokens_count, false, location);
-    if (ptcl_parser_critical(parser))
+    ptcl_statement **buffer = realloc(body->statements, (body->count + template_count) * sizeof(ptcl_statement *));
+    if (buffer == NULL)
     {
-        ptcl_parser_syntax_destroy(syntax);
-        return;
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return false;
     }
 
-    syntax.index = index;
-    if (!is_injector)
-    {
-        if (!ptcl_parser_add_instance_syntax(parser, syntax))
-        {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_parser_syntax_destroy(syntax);
-            return;
-        }
-    }
-    else
+    body->statements = buffer;
+    for (size_t i = 0; i < template_count; i++)
     {
-        if (!ptcl_parser_add_this_pair(parser, ptcl_parser_this_s_pair_create(parser->temp.main_root, syntax.index)))
+        // Body, which doesn't use element, is shared
+        ptcl_statement *statement = body->statements[i];
+        ptcl_statement *copy = element == NULL ? ptcl_statement_copy(statement, statement->location) : ptcl_parser_each_clone_statement(statement, element);
+        if (copy == NULL)
         {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            ptcl_parser_syntax_destroy(syntax);
-            return;
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return false;
         }
+
+        body->statements[body->count++] = copy;
     }
+
+    return true;
 }
 
 void ptcl_parser_each(ptcl_parser *parser)
@@ -4700,10 +7376,7 @@ void ptcl_parser_each(ptcl_parser *parser)
         return;
     }
 
-    ptcl_type *type = &ptcl_type_any;
-    type->is_const = true;
-
-    ptcl_type array = ptcl_type_create_pointer(type, true);
+    ptcl_type array = ptcl_type_create_pointer(&ptcl_type_const_any, true);
     array.is_static = true;
 
     ptcl_expression *value = ptcl_parser_cast(parser, &array, false);
@@ -4712,15 +7385,49 @@ void ptcl_parser_each(ptcl_parser *parser)
         return;
     }
 
+    if (value->type == ptcl_expression_string_type)
+    {
+        ptcl_expression *characters = ptcl_expression_string_to_array(value);
+        ptcl_expression_destroy(value);
+        if (characters == NULL)
+        {
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return;
+        }
+
+        value = characters;
+    }
+
     ptcl_parser_match(parser, ptcl_token_right_par_type);
     ptcl_func_body empty = {
         .statements = NULL,
         .count = 0,
         .root = ptcl_parser_root(parser)};
     size_t position = ptcl_parser_position(parser);
-    for (size_t i = 0; i < value->array.count; i++)
+    bool uses_element = false;
+    bool is_invariant = value->array->count > 1 && ptcl_parser_each_is_invariant(parser, name, &uses_element);
+    if (uses_element && !ptcl_parser_each_is_bindable(value))
     {
-        ptcl_expression *expression = value->array.expressions[i];
+        is_invariant = false;
+    }
+
+    size_t template_count = 0;
+    size_t found = 0;
+    for (size_t i = 0; i < value->array->count; i++)
+    {
+        if (is_invariant && i > 0)
+        {
+            if (!ptcl_parser_each_instantiate(parser, &empty, template_count, uses_element ? value->array->expressions[i] : NULL, location))
+            {
+                ptcl_func_body_destroy(empty);
+                ptcl_expression_destroy(value);
+                return;
+            }
+
+            continue;
+        }
+
+        ptcl_expression *expression = value->array->expressions[i];
         expression->is_original = false;
 
         ptcl_parser_variable variable = ptcl_parser_variable_create(name, *ptcl_type_get_target(value->return_type), expression, true, &empty);
@@ -4733,9 +7440,31 @@ void ptcl_parser_each(ptcl_parser *parser)
             return;
         }
 
+        if (is_invariant && uses_element)
+        {
+            parser->each_slots.variable = idenitifer;
+            parser->each_slots.count = 0;
+            parser->each_slots.is_out_of_memory = false;
+        }
+
         // TODO: root problem that can be copies of types with same name, and we need to remember about anonymous vars
         ptcl_parser_func_body_by_pointer(parser, &empty, true, true, ptcl_parser_ignore_error(parser));
-        if (i != value->array.count - 1)
+        parser->each_slots.variable = (size_t)-1;
+        if (is_invariant && uses_element && !ptcl_parser_critical(parser))
+        {
+            // Body is parsed for each element if some of recorded nodes were folded or copied
+            ptcl_parser_each_slots slots = parser->each_slots;
+            is_invariant = !slots.is_out_of_memory &&
+                           ptcl_parser_each_find_body(&slots, empty, expression) &&
+                           slots.count == 0;
+            found = slots.count;
+            if (!is_invariant)
+            {
+                ptcl_parser_each_release(parser, found);
+            }
+        }
+
+        if (i != value->array->count - 1 && !is_invariant)
         {
             ptcl_parser_set_position(parser, position);
         }
@@ -4747,6 +7476,13 @@ void ptcl_parser_each(ptcl_parser *parser)
             ptcl_expression_destroy(value);
             return;
         }
+
+        template_count = empty.count;
+    }
+
+    if (is_invariant && uses_element)
+    {
+        ptcl_parser_each_release(parser, found);
     }
 
     ptcl_func_body *body_root = ptcl_parser_root(parser);
@@ -4773,6 +7509,8 @@ void ptcl_parser_each(ptcl_parser *parser)
 
 void ptcl_parser_undefine(ptcl_parser *parser)
 {
+    // Deferred bodies must see instances which are going to be removed
+    ptcl_parser_join_bodies(parser);
     ptcl_parser_match(parser, ptcl_token_undefine_type);
     ptcl_parser_match(parser, ptcl_token_left_par_type);
     ptcl_name name = ptcl_parser_name_word(parser);
@@ -4807,6 +7545,15 @@ void ptcl_parser_undefine(ptcl_parser *parser)
         goto here;
     }
 
+    for (size_t i = 0; i < PTCL_PARSER_BUILT_IN_TYPES_COUNT; i++)
+    {
+        if (ptcl_name_compare(ptcl_parser_built_in_types[i].identifier, name))
+        {
+            parser->hidden_built_in_types |= 1u << i;
+            goto here;
+        }
+    }
+
     for (size_t j = 0; j < parser->typedatas.count; j++)
     {
         const size_t index = parser->typedatas.count - 1 - j;
@@ -4826,296 +7573,240 @@ void ptcl_parser_undefine(ptcl_parser *parser)
         ptcl_parser_variable *instance = &parser->variables.items[index];
         if (!ptcl_name_compare(instance->name, name) || !ptcl_func_body_can_access(instance->root, ptcl_parser_root(parser)))
         {
-            continue;
-        }
-
-        instance->is_out_of_scope = true;
-        goto here;
-    }
-
-here:
-    ptcl_parser_match(parser, ptcl_token_right_par_type);
-}
-
-ptcl_expression *ptcl_parser_cast(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
-{
-    if (ptcl_parser_match(parser, ptcl_token_auto_type))
-    {
-        ptcl_location location = ptcl_parser_current(parser).location;
-        ptcl_expression *value = ptcl_parser_cast(parser, expected, flags);
-        if (ptcl_parser_critical(parser))
-        {
-            return NULL;
-        }
-
-        ptcl_expression *cast = ptcl_expression_cast_create(value, *expected, false, location);
-        if (cast == NULL)
-        {
-            ptcl_parser_throw_out_of_memory(parser, location);
-            ptcl_expression_destroy(value);
-            return NULL;
+            continue;
         }
 
-        return ptcl_expression_static_cast(cast);
+        instance->is_out_of_scope = true;
+        goto here;
     }
 
-    ptcl_expression *left = ptcl_parser_binary(parser, expected, flags);
+here:
+    ptcl_parser_match(parser, ptcl_token_right_par_type);
+}
+
+typedef enum ptcl_parser_precedence
+{
+    ptcl_parser_none_precedence,
+    ptcl_parser_cast_precedence,
+    // Comparisons and logic take the rest of expression as right operand
+    ptcl_parser_binary_precedence,
+    ptcl_parser_additive_precedence,
+    ptcl_parser_multiplicative_precedence,
+    ptcl_parser_unary_precedence
+} ptcl_parser_precedence;
+
+typedef struct ptcl_parser_operator
+{
+    ptcl_parser_precedence precedence;
+    // Highest precedence of operator which can follow this one in the same loop
+    ptcl_parser_precedence follow;
+} ptcl_parser_operator;
+
+static const ptcl_parser_operator ptcl_parser_cast_operator = {ptcl_parser_cast_precedence, ptcl_parser_cast_precedence};
+
+static const ptcl_parser_operator ptcl_parser_operators[] = {
+    [ptcl_binary_operator_none_type] = {ptcl_parser_none_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_plus_type] = {ptcl_parser_additive_precedence, ptcl_parser_unary_precedence},
+    [ptcl_binary_operator_minus_type] = {ptcl_parser_additive_precedence, ptcl_parser_unary_precedence},
+    [ptcl_binary_operator_multiplicative_type] = {ptcl_parser_multiplicative_precedence, ptcl_parser_unary_precedence},
+    [ptcl_binary_operator_division_type] = {ptcl_parser_multiplicative_precedence, ptcl_parser_unary_precedence},
+    [ptcl_binary_operator_negation_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_and_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_or_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_not_equals_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_equals_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_type_equals_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_reference_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_dereference_type] = {ptcl_parser_none_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_greater_than_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_less_than_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_greater_equals_than_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+    [ptcl_binary_operator_less_equals_than_type] = {ptcl_parser_binary_precedence, ptcl_parser_none_precedence},
+};
+
+static ptcl_expression *ptcl_parser_cast_operand(ptcl_parser *parser, ptcl_expression *left)
+{
+    ptcl_location location = ptcl_parser_current(parser).location;
+    ptcl_parser_skip(parser);
+    ptcl_parser_skip(parser);
+
+    ptcl_type type = ptcl_parser_type(parser, true, false, true);
     if (ptcl_parser_critical(parser))
     {
+        ptcl_expression_destroy(left);
         return NULL;
     }
 
-    while (true)
+    if (type.type == ptcl_value_type_type)
     {
-        if (ptcl_parser_ended(parser) ||
-            ptcl_parser_current(parser).type != ptcl_token_colon_type ||
-            ptcl_parser_peek(parser, 1).type != ptcl_token_colon_type)
-        {
-            break;
-        }
-
-        ptcl_location location = ptcl_parser_current(parser).location;
-        ptcl_parser_skip(parser);
-        ptcl_parser_skip(parser);
-
-        ptcl_type type = ptcl_parser_type(parser, true, false, true);
-        if (ptcl_parser_critical(parser))
+        ptcl_type base = type.comp_type->types[0].type;
+        if (!ptcl_parser_is_castable(parser, base, left->return_type))
         {
+            ptcl_parser_throw_fast_incorrect_type(parser, base, left->return_type, location);
             ptcl_expression_destroy(left);
+            ptcl_type_destroy(type);
             return NULL;
         }
+    }
 
-        if (type.type == ptcl_value_type_type)
-        {
-            ptcl_type base = type.comp_type->types[0].type;
-            if (!ptcl_type_is_castable(base, left->return_type))
-            {
-                ptcl_parser_throw_fast_incorrect_type(parser, base, left->return_type, location);
-                ptcl_expression_destroy(left);
-                ptcl_type_destroy(type);
-                return NULL;
-            }
-        }
+    ptcl_expression *cast = ptcl_expression_cast_create(left, type, true, location);
+    if (cast == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        ptcl_expression_destroy(left);
+        ptcl_type_destroy(type);
+        return NULL;
+    }
 
-        ptcl_expression *cast = ptcl_expression_cast_create(left, type, true, location);
-        if (cast == NULL)
-        {
-            ptcl_parser_throw_out_of_memory(parser, location);
-            ptcl_expression_destroy(left);
-            ptcl_type_destroy(type);
-            return NULL;
-        }
+    return ptcl_expression_static_cast(cast);
+}
+
+static ptcl_expression *ptcl_parser_climb(ptcl_parser *parser, const ptcl_type *expected, ptcl_parser_expression_flags flags, ptcl_parser_precedence min);
+
+static ptcl_expression *ptcl_parser_binary_operand(ptcl_parser *parser, ptcl_expression *left, ptcl_binary_operator_type type, ptcl_parser_precedence precedence)
+{
+    ptcl_type expected = left->return_type;
+    if (precedence == ptcl_parser_binary_precedence && type == ptcl_binary_operator_type_equals_type)
+    {
+        expected = ptcl_type_any_type;
+    }
+
+    ptcl_parser_skip(parser);
+    const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
+    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, !left->return_type.is_static);
+    ptcl_expression *right = precedence == ptcl_parser_binary_precedence
+                                 ? ptcl_parser_cast(parser, NULL, ptcl_parser_expression_flags_default(true))
+                                 : ptcl_parser_climb(parser, NULL, ptcl_parser_expression_flags_default(true), precedence + 1);
 
-        left = ptcl_expression_static_cast(cast);
+    ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
+    if (ptcl_parser_critical(parser))
+    {
+        ptcl_expression_destroy(left);
+        return NULL;
     }
 
-    if (expected != NULL && !ptcl_type_is_castable(*expected, left->return_type))
+    if (!ptcl_parser_is_castable(parser, expected, right->return_type))
     {
-        ptcl_parser_throw_fast_incorrect_type(parser, *expected, left->return_type, left->location);
+        ptcl_parser_throw_fast_incorrect_type(parser, left->return_type, right->return_type, left->location);
+        ptcl_expression_destroy(right);
         ptcl_expression_destroy(left);
         return NULL;
     }
 
+    left = ptcl_expression_binary_static_evaluate(type, left, right);
+    if (left == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+    }
+
     return left;
 }
 
-ptcl_expression *ptcl_parser_binary(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
+// Single precedence climbing loop over ptcl_parser_operators, so new operator is one line in the table
+static ptcl_expression *ptcl_parser_climb(ptcl_parser *parser, const ptcl_type *expected, ptcl_parser_expression_flags flags, ptcl_parser_precedence min)
 {
-    ptcl_expression *left = ptcl_parser_additive(parser, expected, flags);
+    ptcl_expression *left = ptcl_parser_unary(parser, expected, flags);
     if (ptcl_parser_critical(parser))
     {
-        return left;
+        return NULL;
     }
 
-    while (true)
+    ptcl_parser_precedence follow = ptcl_parser_unary_precedence;
+    while (!ptcl_parser_ended(parser))
     {
-        if (ptcl_parser_ended(parser))
+        const ptcl_token_type token = ptcl_parser_current(parser).type;
+        const bool is_cast = token == ptcl_token_colon_type && ptcl_parser_peek(parser, 1).type == ptcl_token_colon_type;
+        ptcl_binary_operator_type type = ptcl_binary_operator_type_from_token(token);
+        const ptcl_parser_operator binary_operator = is_cast ? ptcl_parser_cast_operator : ptcl_parser_operators[type];
+        if (binary_operator.precedence == ptcl_parser_none_precedence || binary_operator.precedence < min || binary_operator.precedence > follow)
         {
             break;
         }
 
-        ptcl_binary_operator_type type = ptcl_binary_operator_type_from_token(ptcl_parser_current(parser).type);
-        if (type == ptcl_binary_operator_none_type ||
-            type == ptcl_binary_operator_multiplicative_type ||
-            type == ptcl_binary_operator_division_type ||
-            type == ptcl_binary_operator_plus_type ||
-            type == ptcl_binary_operator_minus_type)
+        if (binary_operator.precedence >= ptcl_parser_additive_precedence && !ptcl_value_is_number(left->return_type.type))
         {
             break;
         }
 
-        if (ptcl_parser_peek(parser, 1).type == ptcl_token_equals_type)
+        if (binary_operator.precedence == ptcl_parser_binary_precedence)
         {
-            switch (type)
+            if (ptcl_parser_peek(parser, 1).type == ptcl_token_equals_type)
             {
-            case ptcl_binary_operator_equals_type:
-                type = ptcl_binary_operator_equals_type;
-                break;
-            case ptcl_binary_operator_negation_type:
-                type = ptcl_binary_operator_not_equals_type;
-                break;
-            case ptcl_binary_operator_greater_than_type:
-                type = ptcl_binary_operator_greater_equals_than_type;
-                break;
-            case ptcl_binary_operator_less_than_type:
-                type = ptcl_binary_operator_less_equals_than_type;
-                break;
-            default:
-                break;
-            }
+                switch (type)
+                {
+                case ptcl_binary_operator_negation_type:
+                    type = ptcl_binary_operator_not_equals_type;
+                    break;
+                case ptcl_binary_operator_greater_than_type:
+                    type = ptcl_binary_operator_greater_equals_than_type;
+                    break;
+                case ptcl_binary_operator_less_than_type:
+                    type = ptcl_binary_operator_less_equals_than_type;
+                    break;
+                default:
+                    break;
+                }
 
-            ptcl_parser_skip(parser);
-        }
-        else
-        {
-            if (type == ptcl_binary_operator_equals_type || type == ptcl_binary_operator_negation_type)
+                ptcl_parser_skip(parser);
+            }
+            else if (type == ptcl_binary_operator_equals_type || type == ptcl_binary_operator_negation_type)
             {
                 break;
             }
         }
 
-        ptcl_type expected = left->return_type;
-        if (type == ptcl_binary_operator_type_equals_type)
-        {
-            expected = ptcl_type_any_type;
-        }
-
-        ptcl_parser_skip(parser);
-        const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, !left->return_type.is_static);
-        ptcl_expression *right = ptcl_parser_cast(parser, NULL, ptcl_parser_expression_flags_default(true));
-
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
-        if (ptcl_parser_critical(parser))
-        {
-            ptcl_expression_destroy(left);
-            return NULL;
-        }
-
-        if (!ptcl_type_is_castable(expected, right->return_type))
+        left = is_cast ? ptcl_parser_cast_operand(parser, left)
+                       : ptcl_parser_binary_operand(parser, left, type, binary_operator.precedence);
+        if (left == NULL)
         {
-            ptcl_parser_throw_fast_incorrect_type(parser, left->return_type, right->return_type, left->location);
-            ptcl_expression_destroy(right);
-            ptcl_expression_destroy(left);
             return NULL;
         }
 
-        left = ptcl_expression_binary_static_evaluate(type, left, right);
-        if (left == NULL)
-        {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            return left;
-        }
+        follow = binary_operator.follow;
     }
 
     return left;
 }
 
-ptcl_expression *ptcl_parser_additive(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
+ptcl_expression *ptcl_parser_cast(ptcl_parser *parser, const ptcl_type *expected, ptcl_parser_expression_flags flags)
 {
-    ptcl_expression *left = ptcl_parser_multiplicative(parser, expected, flags);
-    if (ptcl_parser_critical(parser) || !ptcl_value_is_number(left->return_type.type))
-    {
-        return left;
-    }
-
-    while (true)
+    if (ptcl_parser_match(parser, ptcl_token_auto_type))
     {
-        if (ptcl_parser_ended(parser))
-        {
-            break;
-        }
-
-        ptcl_binary_operator_type type = ptcl_binary_operator_type_from_token(ptcl_parser_current(parser).type);
-        if (type != ptcl_binary_operator_plus_type && type != ptcl_binary_operator_minus_type)
-        {
-            break;
-        }
-
-        ptcl_parser_skip(parser);
-        const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, !left->return_type.is_static);
-        ptcl_expression *right = ptcl_parser_multiplicative(parser, NULL, ptcl_parser_expression_flags_default(true));
-
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
+        ptcl_location location = ptcl_parser_current(parser).location;
+        ptcl_expression *value = ptcl_parser_cast(parser, expected, flags);
         if (ptcl_parser_critical(parser))
         {
-            ptcl_expression_destroy(left);
             return NULL;
         }
 
-        if (!ptcl_type_is_castable(left->return_type, right->return_type))
+        ptcl_expression *cast = ptcl_expression_cast_create(value, *expected, false, location);
+        if (cast == NULL)
         {
-            ptcl_parser_throw_fast_incorrect_type(parser, left->return_type, right->return_type, left->location);
-            ptcl_expression_destroy(right);
-            ptcl_expression_destroy(left);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            ptcl_expression_destroy(value);
             return NULL;
         }
 
-        left = ptcl_expression_binary_static_evaluate(type, left, right);
-        if (left == NULL)
-        {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            return left;
-        }
+        return ptcl_expression_static_cast(cast);
     }
 
-    return left;
-}
-
-ptcl_expression *ptcl_parser_multiplicative(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
-{
-    ptcl_expression *left = ptcl_parser_unary(parser, expected, flags);
-    if (ptcl_parser_critical(parser) || !ptcl_value_is_number(left->return_type.type))
+    ptcl_expression *left = ptcl_parser_climb(parser, expected, flags, ptcl_parser_cast_precedence);
+    if (ptcl_parser_critical(parser))
     {
-        return left;
+        return NULL;
     }
 
-    while (true)
+    if (expected != NULL && !ptcl_parser_is_castable(parser, *expected, left->return_type))
     {
-        if (ptcl_parser_ended(parser))
-        {
-            break;
-        }
-
-        ptcl_binary_operator_type type = ptcl_binary_operator_type_from_token(ptcl_parser_current(parser).type);
-        if (type != ptcl_binary_operator_multiplicative_type && type != ptcl_binary_operator_division_type)
-        {
-            break;
-        }
-
-        ptcl_parser_skip(parser);
-        const bool last_state = ptcl_parser_has_state(parser, ptcl_parser_in_return_flag);
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, !left->return_type.is_static);
-        ptcl_expression *right = ptcl_parser_unary(parser, NULL, ptcl_parser_expression_flags_default(true));
-
-        ptcl_parser_set_state(parser, ptcl_parser_in_return_flag, last_state);
-        if (ptcl_parser_critical(parser))
-        {
-            ptcl_expression_destroy(left);
-            return NULL;
-        }
-
-        if (!ptcl_type_is_castable(left->return_type, right->return_type))
-        {
-            ptcl_parser_throw_fast_incorrect_type(parser, left->return_type, right->return_type, left->location);
-            ptcl_expression_destroy(right);
-            ptcl_expression_destroy(left);
-            return NULL;
-        }
-
-        left = ptcl_expression_binary_static_evaluate(type, left, right);
-        if (left == NULL)
-        {
-            ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
-            return left;
-        }
+        ptcl_parser_throw_fast_incorrect_type(parser, *expected, left->return_type, left->location);
+        ptcl_expression_destroy(left);
+        return NULL;
     }
 
     return left;
 }
 
-ptcl_expression *ptcl_parser_unary(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
+ptcl_expression *ptcl_parser_unary(ptcl_parser *parser, const ptcl_type *expected, ptcl_parser_expression_flags flags)
 {
     if (ptcl_parser_ended(parser))
     {
@@ -5262,10 +7953,7 @@ static ptcl_expression *ptcl_parser_type_dot(ptcl_parser *parser, ptcl_expressio
 
     func_call.is_built_in = false;
     func_call.return_type = function->return_type;
-    ptcl_expression *func = ptcl_expression_create(
-        ptcl_expression_func_call_type,
-        func_call.return_type,
-        location);
+    ptcl_expression *func = ptcl_expression_func_call_create(func_call, func_call.return_type, location);
     if (func == NULL)
     {
         ptcl_statement_func_call_destroy(func_call);
@@ -5275,7 +7963,6 @@ static ptcl_expression *ptcl_parser_type_dot(ptcl_parser *parser, ptcl_expressio
         return NULL;
     }
 
-    func->func_call = func_call;
     ptcl_expression *expression = ptcl_expression_create(
         ptcl_expression_dot_type,
         func_call.return_type,
@@ -5312,7 +7999,7 @@ static ptcl_expression *ptcl_parser_typedata_dot(ptcl_parser *parser, ptcl_expre
         ptcl_expression *target = NULL;
         if (left->type == ptcl_expression_ctor_type)
         {
-            target = left->ctor.values[index];
+            target = left->ctor->values[index];
         }
 
         if (member->type.is_static)
@@ -5368,7 +8055,7 @@ static ptcl_expression *ptcl_parser_typedata_dot(ptcl_parser *parser, ptcl_expre
     return dot_expr;
 }
 
-ptcl_expression *ptcl_parser_dot(ptcl_parser *parser, ptcl_type *expected, ptcl_expression *left, ptcl_parser_expression_flags flags)
+ptcl_expression *ptcl_parser_dot(ptcl_parser *parser, const ptcl_type *expected, ptcl_expression *left, ptcl_parser_expression_flags flags)
 {
     if (left == NULL)
     {
@@ -5425,7 +8112,7 @@ ptcl_expression *ptcl_parser_dot(ptcl_parser *parser, ptcl_type *expected, ptcl_
     return left;
 }
 
-ptcl_expression *ptcl_parser_array_element(ptcl_parser *parser, ptcl_type *expected, ptcl_expression *left, ptcl_parser_expression_flags flags)
+ptcl_expression *ptcl_parser_array_element(ptcl_parser *parser, const ptcl_type *expected, ptcl_expression *left, ptcl_parser_expression_flags flags)
 {
     if (left == NULL)
     {
@@ -5503,7 +8190,7 @@ static ptcl_expression *ptcl_parser_try_name(ptcl_parser *parser, ptcl_location
     return word;
 }
 
-static ptcl_expression *ptcl_parser_at(ptcl_parser *parser, ptcl_type *expected, bool with_word, ptcl_location location)
+static ptcl_expression *ptcl_parser_at(ptcl_parser *parser, const ptcl_type *expected, bool with_word, ptcl_location location)
 {
     if (ptcl_parser_peek(parser, 1).type == ptcl_token_left_curly_type)
     {
@@ -5522,7 +8209,7 @@ static ptcl_expression *ptcl_parser_at(ptcl_parser *parser, ptcl_type *expected,
 
 static ptcl_expression *ptcl_parser_lated_body_void(ptcl_parser *parser, ptcl_location location)
 {
-    ptcl_type *previous = parser->temp.return_type;
+    const ptcl_type *previous = parser->temp.return_type;
     parser->temp.return_type = &ptcl_type_void;
     size_t block_start = ptcl_parser_position(parser) - 1;
 
@@ -5556,59 +8243,22 @@ static ptcl_expression *ptcl_parser_lated_body_void(ptcl_parser *parser, ptcl_lo
 static ptcl_expression *ptcl_parser_string(ptcl_parser *parser, ptcl_token current)
 {
     size_t length = strlen(current.value);
-    ptcl_expression **expressions = malloc((length + 1) * sizeof(ptcl_expression *));
-    if (expressions == NULL)
-    {
-        ptcl_parser_throw_out_of_memory(parser, current.location);
-        return NULL;
-    }
-
-    for (size_t i = 0; i < length; i++)
+    char *value = malloc((length + 1) * sizeof(char));
+    if (value == NULL)
     {
-        ptcl_expression *character = ptcl_expression_create_character(current.value[i], current.location);
-        if (character == NULL)
-        {
-            for (size_t j = 0; j < i; j++)
-            {
-                ptcl_expression_destroy(expressions[j]);
-            }
-
-            free(expressions);
-            ptcl_parser_throw_out_of_memory(parser, current.location);
-            return NULL;
-        }
-
-        expressions[i] = character;
-    }
-
-    ptcl_expression *eof = ptcl_expression_create_character('\0', current.location);
-    if (eof == NULL)
-    {
-        for (size_t i = 0; i < length; i++)
-        {
-            ptcl_expression_destroy(expressions[i]);
-        }
-
-        free(expressions);
         ptcl_parser_throw_out_of_memory(parser, current.location);
         return NULL;
     }
 
-    expressions[length] = eof;
-    ptcl_expression *result = ptcl_expression_create_characters(expressions, length + 1, current.location);
+    memcpy(value, current.value, length + 1);
+    ptcl_expression *result = ptcl_expression_create_string(value, length, current.location);
     if (result == NULL)
     {
-        for (size_t i = 0; i < length; i++)
-        {
-            ptcl_expression_destroy(expressions[i]);
-        }
-
-        free(expressions);
+        free(value);
         ptcl_parser_throw_out_of_memory(parser, current.location);
         return NULL;
     }
 
-    result->return_type.is_static = true;
     return result;
 }
 
@@ -5686,7 +8336,7 @@ static ptcl_expression *ptcl_parser_type_object(ptcl_parser *parser, ptcl_locati
     return result;
 }
 
-static ptcl_expression *ptcl_parse_none(ptcl_parser *parser, ptcl_type *expected, ptcl_location location)
+static ptcl_expression *ptcl_parse_none(ptcl_parser *parser, const ptcl_type *expected, ptcl_location location)
 {
     ptcl_expression *result = NULL;
     if (ptcl_parser_match(parser, ptcl_token_left_par_type))
@@ -5752,7 +8402,7 @@ static ptcl_expression *ptcl_parse_none(ptcl_parser *parser, ptcl_type *expected
     return result;
 }
 
-ptcl_expression *ptcl_parser_value(ptcl_parser *parser, ptcl_type *expected, ptcl_parser_expression_flags flags)
+ptcl_expression *ptcl_parser_value(ptcl_parser *parser, const ptcl_type *expected, ptcl_parser_expression_flags flags)
 {
     if (ptcl_parser_parse_try_syntax_usage_here(parser, false))
     {
@@ -6228,7 +8878,8 @@ ptcl_expression *ptcl_parser_get_default(ptcl_parser *parser, ptcl_type type, pt
 
         ptcl_name typedata_name = instance->identifier;
         typedata_name.is_free = false;
-        ptcl_expression *ctor = ptcl_expression_create(ptcl_expression_ctor_type, ptcl_type_create_typedata(type.typedata, false), location);
+        ptcl_expression *ctor = ptcl_expression_ctor_node_create(
+            ptcl_expression_ctor_create(typedata_name, expressions, instance->members, instance->count), ptcl_type_create_typedata(type.typedata, false), location);
         if (ctor == NULL)
         {
             for (size_t i = 0; i < instance->count; i++)
@@ -6240,7 +8891,6 @@ ptcl_expression *ptcl_parser_get_default(ptcl_parser *parser, ptcl_type type, pt
             return NULL;
         }
 
-        ctor->ctor = ptcl_expression_ctor_create(typedata_name, expressions, instance->members, instance->count);
         return ctor;
     }
     case ptcl_value_function_pointer_type:
@@ -6307,68 +8957,57 @@ bool ptcl_parser_not(ptcl_parser *parser, ptcl_token_type token_type)
 
 bool ptcl_parser_match(ptcl_parser *parser, ptcl_token_type token_type)
 {
-    if (ptcl_parser_count(parser) == 0)
+    if (parser->state.tokens.count == 0 || ptcl_parser_cursor(parser)->type != token_type)
     {
         return false;
     }
 
-    if (ptcl_parser_current(parser).type == token_type)
-    {
-        ptcl_parser_skip(parser);
-        return true;
-    }
-
-    return false;
+    // Cursor may leave ended range, so position is taken from the new state
+    parser->state.tokens.position++;
+    return true;
 }
 
 ptcl_token ptcl_parser_peek(ptcl_parser *parser, size_t offset)
 {
-    size_t position = ptcl_parser_position(parser) + offset;
-    size_t count = ptcl_parser_count(parser) - 1;
-    if (position > count)
-    {
-        return parser->state.tokens.tokens[count];
-    }
-
-    return parser->state.tokens.tokens[position];
+    ptcl_parser_tokens_state *tokens = &parser->state.tokens;
+    const size_t position = tokens->position + offset;
+    const size_t last = tokens->count - 1;
+    return tokens->tokens[position > last ? last : position];
 }
 
-ptcl_token *ptcl_parser_current_ptr(ptcl_parser *parser)
+static ptcl_token *ptcl_parser_cross_boundary(ptcl_parser *parser)
 {
-    ptcl_token *tokens = ptcl_parser_tokens(parser);
-    size_t count = ptcl_parser_count(parser);
-    if (ptcl_parser_ended(parser))
+    if (ptcl_parser_insert_states_count(parser) > 0)
     {
-        if (ptcl_parser_insert_states_count(parser) > 0)
-        {
-            // Don't need - 1 cuz we have only inserted root at 0
-            // TODO: reake syntaxes for first
-            ptcl_parser_insert_state *state = ptcl_parser_insert_state_at(parser, ptcl_parser_insert_states_count(parser));
-            if (state->syntax_depth == parser->state.syntax_depth)
-            {
-                ptcl_parser_leave_from_insert_state(parser);
-                return &ptcl_parser_tokens(parser)[ptcl_parser_position(parser)];
-            }
-        }
-
-        if (parser->state.syntax_depth > 0)
+        // Don't need - 1 cuz we have only inserted root at 0
+        // TODO: reake syntaxes for first
+        ptcl_parser_insert_state *state = ptcl_parser_insert_state_at(parser, ptcl_parser_insert_states_count(parser));
+        if (state->syntax_depth == parser->state.syntax_depth)
         {
-            ptcl_parser_leave_from_syntax(parser);
-            return ptcl_parser_current_ptr(parser);
+            ptcl_parser_leave_from_insert_state(parser);
+            return &ptcl_parser_tokens(parser)[ptcl_parser_position(parser)];
         }
+    }
 
-        if (count > 0)
-        {
-            return &tokens[count - 1];
-        }
+    if (parser->state.syntax_depth > 0)
+    {
+        ptcl_parser_leave_from_syntax(parser);
+        return ptcl_parser_cursor(parser);
     }
 
-    return &tokens[ptcl_parser_position(parser)];
+    ptcl_token *tokens = ptcl_parser_tokens(parser);
+    const size_t count = ptcl_parser_count(parser);
+    return count > 0 ? &tokens[count - 1] : &tokens[ptcl_parser_position(parser)];
+}
+
+ptcl_token *ptcl_parser_current_ptr(ptcl_parser *parser)
+{
+    return ptcl_parser_cursor(parser);
 }
 
 ptcl_token ptcl_parser_current(ptcl_parser *parser)
 {
-    return *ptcl_parser_current_ptr(parser);
+    return *ptcl_parser_cursor(parser);
 }
 
 inline ptcl_parser_tokens_state ptcl_parser_get_tokens_state(ptcl_parser *parser)
@@ -6389,6 +9028,7 @@ inline ptcl_token *ptcl_parser_tokens(ptcl_parser *parser)
 void ptcl_parser_set_tokens(ptcl_parser *parser, ptcl_token *tokens)
 {
     parser->state.tokens.tokens = tokens;
+    parser->state.tokens.partners = NULL;
 }
 
 inline size_t ptcl_parser_count(ptcl_parser *parser)
@@ -6534,13 +9174,19 @@ bool ptcl_parser_has_state(ptcl_parser *parser, ptcl_parser_flags flag)
 
 bool ptcl_parser_add_this_pair(ptcl_parser *parser, ptcl_parser_this_s_pair instance)
 {
-    ptcl_parser_this_s_pair *buffer = realloc(parser->this_pairs.items, (parser->this_pairs.count + 1) * sizeof(ptcl_parser_this_s_pair));
-    if (buffer == NULL)
+    if (parser->this_pairs.count >= parser->this_pairs.capacity)
     {
-        return false;
+        const size_t capacity = parser->this_pairs.capacity == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : parser->this_pairs.capacity * 2;
+        ptcl_parser_this_s_pair *buffer = realloc(parser->this_pairs.items, capacity * sizeof(ptcl_parser_this_s_pair));
+        if (buffer == NULL)
+        {
+            return false;
+        }
+
+        parser->this_pairs.items = buffer;
+        parser->this_pairs.capacity = capacity;
     }
 
-    parser->this_pairs.items = buffer;
     parser->this_pairs.items[parser->this_pairs.count++] = instance;
     return true;
 }
@@ -6593,20 +9239,22 @@ ptcl_statement *ptcl_parser_insert_pairs(ptcl_parser *parser, ptcl_statement *st
             return NULL;
         }
 
-        ptcl_parser_tokens_state last_state = parser->state.tokens;
+        const ptcl_parser_checkpoint checkpoint = ptcl_parser_get_checkpoint(parser);
         ptcl_func_body *last_body = parser->temp.inserted_body;
 
+        PTCL_STATS_ADD(parser->stats, lated_body_reparses, 1);
         ptcl_parser_set_tokens_state(parser, parser->lated_states.items[target->index]);
         ptcl_parser_set_position(parser, 0);
         parser->temp.inserted_body = &paired_statement->body.body;
 
         ptcl_parser_func_body_by_pointer(parser, parser->temp.inserted_body, false, false, ptcl_parser_ignore_error(parser));
 
-        ptcl_parser_set_tokens_state(parser, last_state);
+        ptcl_parser_set_tokens_state(parser, checkpoint.tokens);
         parser->temp.inserted_body = last_body;
 
         if (ptcl_parser_critical(parser))
         {
+            ptcl_parser_rollback_failed(parser, checkpoint);
             content->count--;
             free(paired_statement);
             ptcl_statement_destroy(statement);
@@ -6651,7 +9299,7 @@ bool ptcl_parser_add_instance_comp_type(ptcl_parser *parser, ptcl_parser_comp_ty
 
     ptcl_parser_comp_type *target;
     // TODO: optimize in type_decl
-    if (ptcl_parser_try_get_any_comp_type(parser, instance.identifier, &target))
+    if (ptcl_parser_try_get_any_comp_type(parser, instance.identifier, &target) && !ptcl_parser_is_built_in_type(target))
     {
         if (instance.comp_type == NULL)
         {
@@ -6777,10 +9425,12 @@ bool ptcl_parser_try_get_syntax(ptcl_parser *parser, ptcl_name name, ptcl_parser
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = syntax;
         return true;
     }
 
+    ptcl_parser_count_lookup(parser, parser->syntaxes.count);
     return false;
 }
 
@@ -6803,10 +9453,18 @@ bool ptcl_parser_try_get_comp_type(ptcl_parser *parser, ptcl_name name, bool is_
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = comp_type;
         return true;
     }
 
+    // Built-in types have no static version
+    if (!is_static)
+    {
+        return ptcl_parser_try_get_built_in_type(parser, name, parser->comp_types.count, instance);
+    }
+
+    ptcl_parser_count_lookup(parser, parser->comp_types.count);
     return false;
 }
 
@@ -6821,11 +9479,12 @@ bool ptcl_parser_try_get_any_comp_type(ptcl_parser *parser, ptcl_name name, ptcl
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = comp_type;
         return true;
     }
 
-    return false;
+    return ptcl_parser_try_get_built_in_type(parser, name, parser->comp_types.count, instance);
 }
 
 bool ptcl_parser_try_get_typedata(ptcl_parser *parser, ptcl_name name, ptcl_parser_typedata **instance)
@@ -6839,10 +9498,12 @@ bool ptcl_parser_try_get_typedata(ptcl_parser *parser, ptcl_name name, ptcl_pars
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = typedata;
         return true;
     }
 
+    ptcl_parser_count_lookup(parser, parser->typedatas.count);
     return false;
 }
 
@@ -6857,10 +9518,22 @@ bool ptcl_parser_try_get_function(ptcl_parser *parser, ptcl_name name, ptcl_pars
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = function;
         return true;
     }
 
+    for (size_t i = 0; i < PTCL_PARSER_BUILT_IN_FUNCTIONS_COUNT; i++)
+    {
+        if (ptcl_name_compare(ptcl_parser_built_in_functions[i].name, name))
+        {
+            ptcl_parser_count_lookup(parser, parser->functions.count + i + 1);
+            *instance = (ptcl_parser_function *)&ptcl_parser_built_in_functions[i];
+            return true;
+        }
+    }
+
+    ptcl_parser_count_lookup(parser, parser->functions.count + PTCL_PARSER_BUILT_IN_FUNCTIONS_COUNT);
     return false;
 }
 
@@ -6875,10 +9548,12 @@ bool ptcl_parser_try_get_variable(ptcl_parser *parser, ptcl_name name, ptcl_pars
             continue;
         }
 
+        ptcl_parser_count_lookup(parser, j + 1);
         *instance = variable;
         return true;
     }
 
+    ptcl_parser_count_lookup(parser, parser->variables.count);
     return false;
 }
 
@@ -6887,17 +9562,15 @@ size_t ptcl_parser_add_lated_body(ptcl_parser *parser, size_t start, size_t toke
     ptcl_token *body_tokens = NULL;
     if (tokens_count > 0)
     {
-        body_tokens = malloc(sizeof(ptcl_token) * tokens_count);
-        if (body_tokens == NULL && tokens_count > 0)
+        // Lated bodies live as long as result, so they are released with arena in one go
+        body_tokens = ptcl_arena_allocate(parser->arena, sizeof(ptcl_token) * tokens_count);
+        if (body_tokens == NULL)
         {
             ptcl_parser_throw_out_of_memory(parser, location);
             return -1;
         }
 
-        for (size_t i = 0; i < tokens_count; i++)
-        {
-            body_tokens[i] = ptcl_parser_tokens(parser)[start + i];
-        }
+        memcpy(body_tokens, ptcl_parser_tokens(parser) + start, sizeof(ptcl_token) * tokens_count);
     }
 
     if (parser->lated_states.count >= parser->lated_states.capacity)
@@ -6907,12 +9580,6 @@ size_t ptcl_parser_add_lated_body(ptcl_parser *parser, size_t start, size_t toke
                                                    sizeof(ptcl_parser_tokens_state) * new_capacity);
         if (buffer == NULL)
         {
-            for (size_t i = 0; i < tokens_count; i++)
-            {
-                ptcl_token_destroy(body_tokens[i]);
-            }
-
-            free(body_tokens);
             ptcl_parser_throw_out_of_memory(parser, location);
             return -1;
         }
@@ -6922,12 +9589,90 @@ size_t ptcl_parser_add_lated_body(ptcl_parser *parser, size_t start, size_t toke
     }
 
     ptcl_parser_tokens_state *body = &parser->lated_states.items[parser->lated_states.count];
+    // Partners are relative, so slice of them stays valid for copied tokens
+    size_t *partners = parser->state.tokens.partners;
     body->tokens = body_tokens;
+    body->partners = partners != NULL && tokens_count > 0 ? partners + start : NULL;
     body->count = tokens_count;
     body->is_free = is_free;
     return parser->lated_states.count++;
 }
 
+ptcl_parser_checkpoint ptcl_parser_get_checkpoint(ptcl_parser *parser)
+{
+    return (ptcl_parser_checkpoint){
+        .tokens = parser->state.tokens,
+        .syntax_depth = parser->state.syntax_depth,
+        .insert_states_count = parser->temp.insert_states_count,
+        .arena = ptcl_arena_get_checkpoint(parser->arena),
+        .errors_count = parser->errors.count,
+        .syntaxes_count = parser->syntaxes.count,
+        .typedatas_count = parser->typedatas.count,
+        .comp_types_count = parser->comp_types.count,
+        .functions_count = parser->functions.count,
+        .variables_count = parser->variables.count,
+        .lated_states_count = parser->lated_states.count,
+        .this_pairs_count = parser->this_pairs.count};
+}
+
+void ptcl_parser_rollback(ptcl_parser *parser, ptcl_parser_checkpoint checkpoint)
+{
+    for (size_t i = checkpoint.errors_count; i < parser->errors.count; i++)
+    {
+        ptcl_parser_error_destroy(parser->errors.items[i]);
+    }
+
+    parser->errors.count = checkpoint.errors_count;
+
+    // Nodes of attempt are already destroyed, so instances own the rest of their memory like in result.
+    // Functions are owned by statements and this pairs refer to bodies, they are only truncated
+    for (size_t i = checkpoint.syntaxes_count; i < parser->syntaxes.count; i++)
+    {
+        ptcl_parser_syntax_destroy(parser->syntaxes.items[i]);
+    }
+
+    for (size_t i = checkpoint.typedatas_count; i < parser->typedatas.count; i++)
+    {
+        ptcl_parser_typedata_destroy(parser->typedatas.items[i]);
+    }
+
+    for (size_t i = checkpoint.comp_types_count; i < parser->comp_types.count; i++)
+    {
+        ptcl_parser_comp_type_destroy(parser->comp_types.items[i]);
+    }
+
+    for (size_t i = checkpoint.variables_count; i < parser->variables.count; i++)
+    {
+        ptcl_parser_variable_destroy(parser->variables.items[i]);
+    }
+
+    parser->syntaxes.count = checkpoint.syntaxes_count;
+    parser->syntax_starts.is_built = false;
+    parser->typedatas.count = checkpoint.typedatas_count;
+    parser->comp_types.count = checkpoint.comp_types_count;
+    parser->functions.count = checkpoint.functions_count;
+    parser->variables.count = checkpoint.variables_count;
+    parser->this_pairs.count = checkpoint.this_pairs_count;
+
+    // Tokens of syntax or insert that wasn't left yet can be placed in arena after checkpoint
+    if (parser->state.syntax_depth != checkpoint.syntax_depth ||
+        parser->temp.insert_states_count != checkpoint.insert_states_count)
+    {
+        return;
+    }
+
+    parser->lated_states.count = checkpoint.lated_states_count;
+    ptcl_arena_rollback(parser->arena, checkpoint.arena);
+    parser->state.tokens = checkpoint.tokens;
+}
+
+// Errors of failed body are reported, so only its instances, lated bodies and memory are released
+static void ptcl_parser_rollback_failed(ptcl_parser *parser, ptcl_parser_checkpoint checkpoint)
+{
+    checkpoint.errors_count = parser->errors.count;
+    ptcl_parser_rollback(parser, checkpoint);
+}
+
 bool ptcl_parser_is_syntax_defined(ptcl_parser *parser, ptcl_name name)
 {
     ptcl_parser_syntax *placeholder = NULL;
@@ -6960,31 +9705,16 @@ bool ptcl_parser_is_variable_defined(ptcl_parser *parser, ptcl_name name)
 
 bool ptcl_parser_is_defined(ptcl_parser *parser, ptcl_name name)
 {
-    void *placeholder = NULL;
-#pragma warning(push)
-#pragma warning(disable : 4133)
-    if (ptcl_parser_try_get_syntax(parser, name, &placeholder))
-    {
-        return true;
-    }
-    else if (ptcl_parser_try_get_any_comp_type(parser, name, &placeholder))
-    {
-        return true;
-    }
-    else if (ptcl_parser_try_get_typedata(parser, name, &placeholder))
-    {
-        return true;
-    }
-    else if (ptcl_parser_try_get_function(parser, name, &placeholder))
-    {
-        return true;
-    }
-    else if (ptcl_parser_try_get_variable(parser, name, &placeholder))
-    {
-        return true;
-    }
-#pragma warning(pop)
-    return false;
+    ptcl_parser_syntax *syntax = NULL;
+    ptcl_parser_comp_type *comp_type = NULL;
+    ptcl_parser_typedata *typedata = NULL;
+    ptcl_parser_function *function = NULL;
+    ptcl_parser_variable *variable = NULL;
+    return ptcl_parser_try_get_syntax(parser, name, &syntax) ||
+           ptcl_parser_try_get_any_comp_type(parser, name, &comp_type) ||
+           ptcl_parser_try_get_typedata(parser, name, &typedata) ||
+           ptcl_parser_try_get_function(parser, name, &function) ||
+           ptcl_parser_try_get_variable(parser, name, &variable);
 }
 
 bool ptcl_parser_check_arguments(ptcl_parser *parser, ptcl_parser_function *function, ptcl_expression **arguments, size_t count)
@@ -7012,7 +9742,7 @@ bool ptcl_parser_check_arguments(ptcl_parser *parser, ptcl_parser_function *func
             break;
         }
 
-        if (ptcl_type_is_castable(argument.type, arguments[j]->return_type))
+        if (ptcl_parser_is_castable(parser, argument.type, arguments[j]->return_type))
         {
             continue;
         }
@@ -7023,7 +9753,7 @@ bool ptcl_parser_check_arguments(ptcl_parser *parser, ptcl_parser_function *func
     return true;
 }
 
-static bool compare_syntax_nodes(ptcl_parser_syntax_node *left, ptcl_parser_syntax_node *right)
+static bool compare_syntax_nodes(ptcl_parser *parser, ptcl_parser_syntax_node *left, ptcl_parser_syntax_node *right)
 {
     switch (left->type)
     {
@@ -7036,90 +9766,120 @@ static bool compare_syntax_nodes(ptcl_parser_syntax_node *left, ptcl_parser_synt
         return ptcl_name_compare(left->word.name, right->word.name);
     case ptcl_parser_syntax_node_variable_type:
         return right->type == ptcl_parser_syntax_node_value_type &&
-               ptcl_type_is_castable(left->variable.type, right->value.value->return_type);
+               ptcl_parser_is_castable(parser, left->variable.type, right->value.value->return_type);
     case ptcl_parser_syntax_node_object_type_type:
         if (right->type != ptcl_parser_syntax_node_value_type)
         {
             return false;
         }
 
-        return ptcl_type_is_castable(left->object_type, right->value.value->return_type);
+        return ptcl_parser_is_castable(parser, left->object_type, right->value.value->return_type);
     default:
         return false;
     }
 }
 
+static bool ptcl_parser_syntax_candidates_build(ptcl_parser *parser, ptcl_parser_syntax_candidates *candidates)
+{
+    free(candidates->indices);
+    candidates->indices = malloc(parser->syntaxes.count * sizeof(size_t));
+    candidates->is_built = candidates->indices != NULL || parser->syntaxes.count == 0;
+    if (!candidates->is_built)
+    {
+        return false;
+    }
+
+    for (size_t j = 0; j < parser->syntaxes.count; j++)
+    {
+        candidates->indices[j] = parser->syntaxes.count - 1 - j;
+    }
+
+    candidates->count = parser->syntaxes.count;
+    candidates->matched = 0;
+    candidates->syntaxes_count = parser->syntaxes.count;
+    return true;
+}
+
 bool ptcl_parser_syntax_try_find(ptcl_parser *parser, ptcl_parser_syntax_node *nodes, size_t count,
-                                 ptcl_parser_syntax **syntax, bool *can_continue, char **end_token)
+                                 ptcl_parser_syntax **syntax, bool *can_continue, char **end_token,
+                                 ptcl_parser_syntax_candidates *candidates)
 {
     *syntax = NULL;
     *can_continue = false;
     *end_token = NULL;
-    bool full_match_found = false;
+    PTCL_STATS_ADD(parser->stats, syntax_match_attempts, 1);
 
-    for (size_t j = 0; j < parser->syntaxes.count; j++)
+    ptcl_parser_syntax_candidates all = {0};
+    if (candidates == NULL || !candidates->is_built ||
+        candidates->syntaxes_count != parser->syntaxes.count || candidates->matched > count)
     {
-        const size_t index = parser->syntaxes.count - 1 - j;
+        if (candidates == NULL || !ptcl_parser_syntax_candidates_build(parser, candidates))
+        {
+            // Without memory for candidates just check every syntax from scratch
+            candidates = &all;
+            all.count = parser->syntaxes.count;
+        }
+    }
+
+    size_t remaining = 0;
+    for (size_t j = 0; j < candidates->count; j++)
+    {
+        const size_t index = candidates->indices != NULL ? candidates->indices[j] : parser->syntaxes.count - 1 - j;
         ptcl_parser_syntax *target = &parser->syntaxes.items[index];
-        if (target->is_out_of_scope || target->count != count)
+        if (target->is_out_of_scope || target->count < count)
         {
             continue;
         }
 
         bool match = true;
-        for (size_t k = 0; k < count; k++)
+        for (size_t k = candidates->matched; k < count; k++)
         {
-            if (!compare_syntax_nodes(&target->nodes[k], &nodes[k]))
+            if (!compare_syntax_nodes(parser, &target->nodes[k], &nodes[k]))
             {
                 match = false;
                 break;
             }
         }
 
-        if (match)
+        if (!match)
         {
-            *syntax = target;
-            full_match_found = true;
-            break;
+            continue;
         }
-    }
 
-    for (size_t j = 0; j < parser->syntaxes.count; j++)
-    {
-        const size_t index = parser->syntaxes.count - 1 - j;
-        ptcl_parser_syntax *target = &parser->syntaxes.items[index];
-        if (target->is_out_of_scope || target->count <= count)
+        if (candidates->indices != NULL)
         {
-            continue;
+            candidates->indices[remaining] = index;
         }
 
-        bool partial_match = true;
-        for (size_t k = 0; k < count; k++)
+        remaining++;
+        if (target->count == count)
         {
-            if (!compare_syntax_nodes(&target->nodes[k], &nodes[k]))
+            // The latest defined syntax wins
+            if (*syntax == NULL)
             {
-                partial_match = false;
-                break;
+                *syntax = target;
             }
+
+            continue;
         }
 
-        if (partial_match)
+        if (*can_continue)
         {
-            if (target->count > count)
-            {
-                ptcl_parser_syntax_node last = target->nodes[count];
-                if (last.type == ptcl_parser_syntax_node_variable_type && last.variable.is_variadic)
-                {
-                    *end_token = target->nodes[count + 1].word.name.value;
-                }
-            }
+            continue;
+        }
 
-            *can_continue = true;
-            break;
+        ptcl_parser_syntax_node last = target->nodes[count];
+        if (last.type == ptcl_parser_syntax_node_variable_type && last.variable.is_variadic)
+        {
+            *end_token = target->nodes[count + 1].word.name.value;
         }
+
+        *can_continue = true;
     }
 
-    return full_match_found;
+    candidates->count = remaining;
+    candidates->matched = count;
+    return *syntax != NULL;
 }
 
 bool ptcl_parser_try_get_typedata_member(ptcl_parser *parser, ptcl_name name, char *member_name, ptcl_argument **member, size_t *index)
@@ -7223,7 +9983,7 @@ ptcl_expression *ptcl_parser_get_ctor_from_dot(ptcl_parser *parser, ptcl_express
     }
 
     ptcl_name name = dot->dot.name;
-    ptcl_expression_ctor ctor = left->ctor;
+    ptcl_expression_ctor ctor = *left->ctor;
     ptcl_argument *member;
     size_t index;
     if (!ptcl_type_get_member(left->return_type.typedata, name, &member, &index))
@@ -7251,376 +10011,722 @@ ptcl_expression *ptcl_parser_get_ctor_from_dot(ptcl_parser *parser, ptcl_express
     return static_value;
 }
 
-void ptcl_parser_throw_out_of_memory(ptcl_parser *parser, ptcl_location location)
+// Speculative parsing doesn't collect errors, so nothing is copied or formatted for them
+static bool ptcl_parser_skip_error(ptcl_parser *parser, bool is_critical)
+{
+    if (ptcl_parser_add_errors(parser))
+    {
+        return false;
+    }
+
+    if (!ptcl_parser_critical(parser))
+    {
+        ptcl_parser_set_state(parser, ptcl_parser_critical_flag, is_critical);
+    }
+
+    return true;
+}
+
+static void ptcl_parser_throw(ptcl_parser *parser, ptcl_parser_error_type type, bool is_critical, ptcl_location location, size_t count, ...)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_out_of_memory_type, true, "Out of memory", false, location);
+    if (ptcl_parser_skip_error(parser, is_critical))
+    {
+        return;
+    }
+
+    ptcl_parser_error error = ptcl_parser_error_create(type, is_critical, location);
+    va_list operands;
+    va_start(operands, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        error.operands[i] = ptcl_string_duplicate(va_arg(operands, char *));
+        if (error.operands[i] == NULL)
+        {
+            va_end(operands);
+            ptcl_parser_error_destroy(error);
+            ptcl_parser_throw_out_of_memory(parser, location);
+            return;
+        }
+    }
+
+    va_end(operands);
     ptcl_parser_add_error(parser, error);
 }
 
+void ptcl_parser_throw_out_of_memory(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_add_error(parser, ptcl_parser_error_create(ptcl_parser_error_out_of_memory_type, true, location));
+}
+
 void ptcl_parser_throw_not_allowed_token(ptcl_parser *parser, char *token, ptcl_location location)
 {
-    char *message = ptcl_string("Token '", token, "' not allowed", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_not_allowed_token_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_not_allowed_token_type, true, location, 1, token);
 }
 
 void ptcl_parser_throw_except_token(ptcl_parser *parser, char *value, ptcl_location location)
 {
-    char *message = ptcl_string("Except token '", value, "'", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_except_token_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_except_token_type, true, location, 1, value);
 }
 
 void ptcl_parser_throw_except_type_specifier(ptcl_parser *parser, ptcl_location location)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_except_type_specifier_type, true, "Expect type specifier", false, location);
+    ptcl_parser_throw(parser, ptcl_parser_error_except_type_specifier_type, true, location, 0);
+}
+
+void ptcl_parser_throw_incorrect_type(ptcl_parser *parser, char *excepted, char *received, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_incorrect_type_type, true, location, 2, excepted, received);
+}
+
+void ptcl_parser_throw_fast_incorrect_type(ptcl_parser *parser, ptcl_type excepted, ptcl_type received, ptcl_location location)
+{
+    if (ptcl_parser_skip_error(parser, true))
+    {
+        return;
+    }
+
+    // Types don't outlive the parsing, so they are presented right now
+    ptcl_parser_error error = ptcl_parser_error_create(ptcl_parser_error_incorrect_type_type, true, location);
+    error.operands[0] = ptcl_type_to_present_string_copy(excepted);
+    error.operands[1] = ptcl_type_to_present_string_copy(received);
+    if (error.operands[0] == NULL || error.operands[1] == NULL)
+    {
+        ptcl_parser_error_destroy(error);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return;
+    }
+
+    ptcl_parser_add_error(parser, error);
+}
+
+void ptcl_parser_throw_variable_redefinition(ptcl_parser *parser, char *name, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_variable_redefinition_type, false, location, 1, name);
+}
+
+void ptcl_parser_throw_none_type(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_none_type_type, true, location, 0);
+}
+
+void ptcl_parser_throw_must_be_variable(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_must_be_variable_type, false, location, 0);
+}
+
+void ptcl_parser_throw_must_be_static(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_must_be_static_type, false, location, 0);
+}
+
+void ptcl_parser_throw_unknown_member(ptcl_parser *parser, char *name, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_member_type, true, location, 1, name);
+}
+
+void ptcl_parser_throw_unknown_statement(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_statement_type, true, location, 0);
+}
+
+void ptcl_parser_throw_unknown_expression(ptcl_parser *parser, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_expression_type, true, location, 0);
+}
+
+void ptcl_parser_throw_unknown_variable(ptcl_parser *parser, char *name, ptcl_location location)
+{
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_variable_type, true, location, 1, name);
+}
+
+void ptcl_parser_throw_unknown_syntax(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_location location)
+{
+    if (ptcl_parser_skip_error(parser, true))
+    {
+        return;
+    }
+
+    ptcl_parser_error error = ptcl_parser_error_create(ptcl_parser_error_unknown_syntax_type, true, location);
+    char *nodes = ptcl_string_duplicate("");
+    for (size_t i = 0; i < syntax.count && nodes != NULL; i++)
+    {
+        ptcl_parser_syntax_node node = syntax.nodes[i];
+        const char *separator = i != syntax.count - 1 ? " " : "";
+        if (node.type == ptcl_parser_syntax_node_word_type)
+        {
+            nodes = ptcl_string_append(nodes, node.word.name.value, separator, NULL);
+        }
+        else if (node.type == ptcl_parser_syntax_node_value_type)
+        {
+            char *type = ptcl_type_to_present_string_copy(node.value.value->return_type);
+            if (type == NULL)
+            {
+                free(nodes);
+                nodes = NULL;
+                break;
+            }
+
+            nodes = ptcl_string_append(nodes, "[", type, "]", separator, NULL);
+            free(type);
+        }
+        else
+        {
+            nodes = ptcl_string_append(nodes, separator, NULL);
+        }
+    }
+
+    if (nodes == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return;
+    }
+
+    error.operands[0] = nodes;
     ptcl_parser_add_error(parser, error);
 }
 
-void ptcl_parser_throw_incorrect_type(ptcl_parser *parser, char *excepted, char *received, ptcl_location location)
-{
-    char *message = ptcl_string("Except '", excepted, "' type, but received '", received, "'", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_incorrect_type_type, true, message, true, location);
+static char *ptcl_parser_present_types(ptcl_expression **values, ptcl_argument *arguments, size_t count)
+{
+    char *result = ptcl_string_duplicate("");
+    for (size_t i = 0; i < count && result != NULL; i++)
+    {
+        char *type;
+        if (values != NULL)
+        {
+            type = ptcl_type_to_present_string_copy(values[i]->return_type);
+        }
+        else if (arguments[i].is_variadic)
+        {
+            type = ptcl_string_duplicate("...");
+        }
+        else
+        {
+            type = ptcl_type_to_present_string_copy(arguments[i].type);
+        }
+
+        if (type == NULL)
+        {
+            free(result);
+            return NULL;
+        }
+
+        result = ptcl_string_append(result, type, i != count - 1 ? ", " : NULL, NULL);
+        free(type);
+    }
+
+    return result;
+}
+
+void ptcl_parser_throw_wrong_arguments(ptcl_parser *parser, char *name, ptcl_expression **values, size_t count, ptcl_argument *arguments, size_t arguments_count, ptcl_location location)
+{
+    if (ptcl_parser_skip_error(parser, true))
+    {
+        return;
+    }
+
+    ptcl_parser_error error = ptcl_parser_error_create(ptcl_parser_error_wrong_arguments_type, true, location);
+    error.operands[0] = ptcl_string_duplicate(name);
+    error.operands[1] = ptcl_parser_present_types(values, NULL, count);
+    error.operands[2] = ptcl_parser_present_types(NULL, arguments, arguments_count);
+    if (error.operands[0] == NULL || error.operands[1] == NULL || error.operands[2] == NULL)
+    {
+        ptcl_parser_error_destroy(error);
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return;
+    }
+
     ptcl_parser_add_error(parser, error);
 }
 
-void ptcl_parser_throw_fast_incorrect_type(ptcl_parser *parser, ptcl_type excepted, ptcl_type received, ptcl_location location)
+void ptcl_parser_throw_max_depth(ptcl_parser *parser, ptcl_location location)
 {
-    char *excepted_message = ptcl_type_to_present_string_copy(excepted);
-    char *received_message = ptcl_type_to_present_string_copy(received);
-    ptcl_parser_throw_incorrect_type(parser, excepted_message, received_message, location);
-
-    free(excepted_message);
-    free(received_message);
+    ptcl_parser_throw(parser, ptcl_parser_error_max_depth_type, true, location, 0);
 }
 
-void ptcl_parser_throw_variable_redefinition(ptcl_parser *parser, char *name, ptcl_location location)
+void ptcl_parser_throw_unknown_function(ptcl_parser *parser, char *name, ptcl_location location)
 {
-    char *message = ptcl_string("Redefination variable with '", name, "'", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_variable_redefinition_type, false, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_function_type, true, location, 1, name);
 }
 
-void ptcl_parser_throw_none_type(ptcl_parser *parser, ptcl_location location)
+void ptcl_parser_throw_unknown_variable_or_type(ptcl_parser *parser, char *name, ptcl_location location)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_none_type_type, true, "Type must be specified to use 'none'", false, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_variable_or_type_type, true, location, 1, name);
 }
 
-void ptcl_parser_throw_must_be_variable(ptcl_parser *parser, ptcl_location location)
+void ptcl_parser_throw_unknown_type(ptcl_parser *parser, char *value, ptcl_location location)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_must_be_variable_type, false, "Must be variable", false, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_type_type, true, location, 1, value);
 }
 
-void ptcl_parser_throw_must_be_static(ptcl_parser *parser, ptcl_location location)
+void ptcl_parser_throw_unknown_module(ptcl_parser *parser, char *path, ptcl_location location)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_must_be_static_type, false, "Must be static", false, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_unknown_module_type, true, location, 1, path);
 }
 
-void ptcl_parser_throw_unknown_member(ptcl_parser *parser, char *name, ptcl_location location)
+void ptcl_parser_throw_redefination(ptcl_parser *parser, char *name, ptcl_location location)
 {
-    char *message = ptcl_string("Unknown member with '", name, "' name", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_member_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_throw(parser, ptcl_parser_error_redefinition_type, false, location, 1, name);
 }
 
-void ptcl_parser_throw_unknown_statement(ptcl_parser *parser, ptcl_location location)
+void ptcl_parser_throw_user(ptcl_parser *parser, char *message, ptcl_location location)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_statement_type, true, "Unknown statement", false, location);
-    ptcl_parser_add_error(parser, error);
-}
+    if (message == NULL)
+    {
+        ptcl_parser_throw_out_of_memory(parser, location);
+        return;
+    }
 
-void ptcl_parser_throw_unknown_expression(ptcl_parser *parser, ptcl_location location)
-{
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_expression_type, true, "Unknown expression", false, location);
+    ptcl_parser_error error = ptcl_parser_error_create(ptcl_parser_error_user_type, true, location);
+    error.operands[0] = message;
     ptcl_parser_add_error(parser, error);
 }
 
-void ptcl_parser_throw_unknown_variable(ptcl_parser *parser, char *name, ptcl_location location)
+void ptcl_parser_add_error(ptcl_parser *parser, ptcl_parser_error error)
 {
-    char *message = ptcl_string("Unknown variable with '", name, "' name", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_variable_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
-}
+    if (ptcl_parser_skip_error(parser, error.is_critical))
+    {
+        ptcl_parser_error_destroy(error);
+        return;
+    }
 
-void ptcl_parser_throw_unknown_syntax(ptcl_parser *parser, ptcl_parser_syntax syntax, ptcl_location location)
-{
-    char *message = ptcl_string("Unknown syntax: '", NULL);
-    for (size_t i = 0; i < syntax.count; i++)
+    if (parser->errors.count >= parser->errors.capacity)
     {
-        ptcl_parser_syntax_node node = syntax.nodes[i];
-        if (node.type == ptcl_parser_syntax_node_word_type)
-        {
-            message = ptcl_string_append(message, node.word.name.value, NULL);
-        }
-        else if (node.type == ptcl_parser_syntax_node_value_type)
+        const size_t capacity = parser->errors.capacity == 0 ? PTCL_PARSER_DEFAULT_INSTANCE_CAPACITY : parser->errors.capacity * 2;
+        ptcl_parser_error *buffer = realloc(parser->errors.items, capacity * sizeof(ptcl_parser_error));
+        if (buffer == NULL)
         {
-            char *type = ptcl_type_to_present_string_copy(node.value.value->return_type);
-            message = ptcl_string_append(message, "[", type, "]", NULL);
-            free(type);
+            ptcl_parser_enable_state(parser, ptcl_parser_critical_flag);
+            ptcl_parser_error_destroy(error);
+            return;
         }
 
-        if (i != syntax.count - 1)
-        {
-            message = ptcl_string_append(message, " ", NULL);
-        }
+        parser->errors.items = buffer;
+        parser->errors.capacity = capacity;
     }
 
-    message = ptcl_string_append(message, "'", NULL);
-
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_syntax_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    parser->errors.items[parser->errors.count++] = error;
+    ptcl_parser_set_state(parser, ptcl_parser_critical_flag, error.is_critical);
 }
 
-void ptcl_parser_throw_wrong_arguments(ptcl_parser *parser, char *name, ptcl_expression **values, size_t count, ptcl_argument *arguments, size_t arguments_count, ptcl_location location)
+// Leading items of result, which are copies of prelude ones, are released only with prelude
+static void ptcl_parser_result_destroy_items(ptcl_parser_result result)
 {
-    char *message = ptcl_string("Wrong arguments '", name, "(", NULL);
-    if (message == NULL)
+    ptcl_parser_result empty = {0};
+    ptcl_parser_result *prelude = result.prelude != NULL ? result.prelude : &empty;
+    for (size_t i = 0; i < result.errors_count; i++)
     {
-        return;
+        ptcl_parser_error_destroy(result.errors[i]);
     }
 
-    for (size_t i = 0; i < count; i++)
+    for (size_t i = prelude->syntaxes_count; i < result.syntaxes_count; i++)
     {
-        char *type = ptcl_type_to_present_string_copy(values[i]->return_type);
-        if (type == NULL)
-        {
-            free(message);
-            return;
-        }
-
-        char *new_message = ptcl_string_append(message, type, NULL);
-        free(type);
+        ptcl_parser_syntax_destroy(result.syntaxes[i]);
+    }
 
-        if (new_message == NULL)
-        {
-            free(message);
-            return;
-        }
+    for (size_t i = prelude->comp_types_count; i < result.comp_types_count; i++)
+    {
+        ptcl_parser_comp_type_destroy(result.comp_types[i]);
+    }
 
-        message = new_message;
-        if (i != count - 1)
-        {
-            new_message = ptcl_string_append(message, ", ", NULL);
-            if (!new_message)
-            {
-                free(message);
-                return;
-            }
+    for (size_t i = prelude->typedatas_count; i < result.typedatas_count; i++)
+    {
+        ptcl_parser_typedata_destroy(result.typedatas[i]);
+    }
 
-            message = new_message;
-        }
+    for (size_t i = prelude->variables_count; i < result.variables_count; i++)
+    {
+        ptcl_parser_variable_destroy(result.variables[i]);
     }
 
-    char *new_message = ptcl_string_append(message, ")', expected (", NULL);
-    if (new_message == NULL)
+    if (result.is_critical)
     {
-        free(message);
         return;
     }
 
-    message = new_message;
-    for (size_t i = 0; i < arguments_count; i++)
+    for (size_t i = prelude->body.count; i < result.body.count; i++)
     {
-        ptcl_argument argument = arguments[i];
-        char *type;
-        if (argument.is_variadic)
-        {
-            type = ptcl_string_duplicate("...");
-            if (type == NULL)
-            {
-                free(message);
-                return;
-            }
-        }
-        else
-        {
-            type = ptcl_type_to_present_string_copy(argument.type);
-            if (type == NULL)
-            {
-                free(message);
-                return;
-            }
-        }
+        ptcl_statement_destroy(result.body.statements[i]);
+    }
 
-        char *new_message = ptcl_string_append(message, type, NULL);
-        free(type);
+    free(result.body.statements);
+}
 
-        if (new_message == NULL)
-        {
-            free(message);
-            return;
-        }
+void ptcl_parser_result_destroy(ptcl_parser_result result)
+{
+    ptcl_parser_result_destroy_items(result);
+    free(result.errors);
+    free(result.syntaxes);
+    free(result.comp_types);
+    free(result.typedatas);
+    free(result.functions);
+    free(result.variables);
+    free(result.lated_states);
+    free(result.this_pairs);
+    ptcl_arena_destroy(result.arena);
 
-        message = new_message;
-        if (i != arguments_count - 1)
-        {
-            new_message = ptcl_string_append(message, ", ", NULL);
-            if (!new_message)
-            {
-                free(message);
-                return;
-            }
+    // Types of nodes and symbols refer to interned ones, so it must be released last
+    ptcl_type_interner_destroy(result.types);
+}
 
-            message = new_message;
-        }
+void ptcl_parser_recycle(ptcl_parser *parser, ptcl_parser_result result, bool keep_types)
+{
+    // Result of out of memory or of earlier parse doesn't own arrays of parser
+    if (result.arena == NULL || result.arena != parser->arena || result.syntaxes != parser->syntaxes.items)
+    {
+        ptcl_parser_result_destroy(result);
+        return;
     }
 
-    new_message = ptcl_string_append(message, ")", NULL);
-    if (new_message == NULL)
+    ptcl_parser_result_destroy_items(result);
+    ptcl_arena_clear(result.arena);
+    if (keep_types)
     {
-        free(message);
-        return;
+        ptcl_type_interner_clear(result.types);
+    }
+    else
+    {
+        ptcl_type_interner_destroy(result.types);
+        parser->types = NULL;
     }
 
-    message = new_message;
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_wrong_arguments_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    parser->is_recycled = true;
 }
 
-void ptcl_parser_throw_max_depth(ptcl_parser *parser, ptcl_location location)
+// Releases prelude, which parses start with. Prelude below prelude of imports isn't changed
+static void ptcl_parser_release_top(ptcl_parser *parser)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_max_depth_type, true, "Max syntaxes depth", false, location);
-    ptcl_parser_add_error(parser, error);
+    if (parser->prelude == NULL)
+    {
+        return;
+    }
+
+    // Recycled interner reads types of prelude
+    if (parser->is_recycled)
+    {
+        ptcl_type_interner_destroy(parser->types);
+        parser->types = NULL;
+    }
+
+    if (parser->is_prelude_set)
+    {
+        ptcl_type_interner_destroy(parser->prelude->types);
+    }
+    else
+    {
+        ptcl_parser_result_destroy(*parser->prelude);
+    }
+
+    free(parser->prelude);
+    free(parser->prelude_imported);
+    parser->prelude = NULL;
+    parser->prelude_root = NULL;
+    parser->prelude_imported = NULL;
+    parser->prelude_hidden_built_in_types = 0;
+    parser->prelude_hash = 0;
+    parser->is_prelude_set = false;
 }
 
-void ptcl_parser_throw_unknown_function(ptcl_parser *parser, char *name, ptcl_location location)
+// Prelude is put below prelude of imports, which is placed next
+static void ptcl_parser_keep_base(ptcl_parser *parser)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_function_type, true, ptcl_string("Unknown function '", name, "'", NULL), true, location);
-    ptcl_parser_add_error(parser, error);
+    parser->base = (ptcl_parser_base){
+        .prelude = parser->prelude,
+        .root = parser->prelude_root,
+        .imported = parser->prelude_imported,
+        .hidden_built_in_types = parser->prelude_hidden_built_in_types,
+        .hash = parser->prelude_hash,
+        .is_set = parser->is_prelude_set};
+    parser->prelude = NULL;
+    parser->prelude_root = NULL;
+    parser->prelude_imported = NULL;
+    parser->prelude_hidden_built_in_types = 0;
+    parser->prelude_hash = 0;
+    parser->is_prelude_set = false;
 }
 
-void ptcl_parser_throw_unknown_variable_or_type(ptcl_parser *parser, char *name, ptcl_location location)
+static void ptcl_parser_restore_base(ptcl_parser *parser)
 {
-    char *message = ptcl_string("Unknown variable with '", name, "' name or expected type", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_variable_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    parser->prelude = parser->base.prelude;
+    parser->prelude_root = parser->base.root;
+    parser->prelude_imported = parser->base.imported;
+    parser->prelude_hidden_built_in_types = parser->base.hidden_built_in_types;
+    parser->prelude_hash = parser->base.hash;
+    parser->is_prelude_set = parser->base.is_set;
+    parser->base = (ptcl_parser_base){0};
 }
 
-void ptcl_parser_throw_unknown_type(ptcl_parser *parser, char *value, ptcl_location location)
+// Prelude of imports is released, parses start with prelude below it again
+static void ptcl_parser_drop_imports(ptcl_parser *parser)
 {
-    char *message = ptcl_string("Unknown type '", value, "'", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_unknown_type_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    if (!parser->is_imports)
+    {
+        return;
+    }
+
+    ptcl_parser_release_top(parser);
+    ptcl_snapshot_destroy(parser->imports_snapshot);
+    parser->imports_snapshot = NULL;
+    ptcl_parser_restore_base(parser);
+    parser->is_imports = false;
 }
 
-void ptcl_parser_throw_redefination(ptcl_parser *parser, char *name, ptcl_location location)
+static void ptcl_parser_release_prelude(ptcl_parser *parser)
 {
-    char *message = ptcl_string("Redefination '", name, "'", NULL);
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_redefinition_type, false, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_drop_imports(parser);
+    ptcl_parser_release_top(parser);
 }
 
-void ptcl_parser_throw_user(ptcl_parser *parser, char *message, ptcl_location location)
+// Arrays, arena and interner of result are given to prelude, so next parse allocates its own ones.
+// Imported tokens are taken too, because lated states of prelude refer to them
+static bool ptcl_parser_take_prelude(ptcl_parser *parser, ptcl_parser_result result)
 {
-    ptcl_parser_error error = ptcl_parser_error_create(
-        ptcl_parser_error_max_depth_type, true, message, true, location);
-    ptcl_parser_add_error(parser, error);
+    ptcl_parser_result *prelude = malloc(sizeof(ptcl_parser_result));
+    if (prelude == NULL)
+    {
+        return false;
+    }
+
+    *prelude = result;
+    prelude->stats = NULL;
+    parser->prelude = prelude;
+    parser->prelude_root = &ptcl_parser_prelude_root;
+    parser->prelude_imported = parser->imported;
+    parser->prelude_hidden_built_in_types = parser->hidden_built_in_types;
+    parser->imported = NULL;
+    parser->imported_capacity = 0;
+    parser->is_recycled = false;
+    parser->arena = NULL;
+    parser->types = NULL;
+    return true;
 }
 
-void ptcl_parser_add_error(ptcl_parser *parser, ptcl_parser_error error)
+ptcl_parser_result ptcl_parser_parse_prelude(ptcl_parser *parser)
 {
-    if (!ptcl_parser_add_errors(parser))
+    ptcl_parser_release_prelude(parser);
+    parser->is_prelude = true;
+    ptcl_parser_result result = ptcl_parser_parse(parser);
+    parser->is_prelude = false;
+    if (result.is_critical || result.errors_count > 0)
     {
-        ptcl_parser_error_destroy(error);
-        if (!ptcl_parser_critical(parser))
-        {
-            ptcl_parser_set_state(parser, ptcl_parser_critical_flag, error.is_critical);
-        }
-
-        return;
+        return result;
     }
 
-    ptcl_parser_error *buffer = realloc(parser->errors.items, (parser->errors.count + 1) * sizeof(ptcl_parser_error));
-    if (buffer == NULL)
+    if (!ptcl_parser_take_prelude(parser, result))
     {
-        ptcl_parser_enable_state(parser, ptcl_parser_critical_flag);
-        ptcl_parser_error_destroy(error);
+        ptcl_func_body_destroy(result.body);
+        ptcl_parser_throw_out_of_memory(parser, ptcl_parser_current(parser).location);
+        result.errors = parser->errors.items;
+        result.errors_count = parser->errors.count;
+        result.is_critical = true;
+        return result;
     }
-    else
+
+    return (ptcl_parser_result){.configuration = parser->configuration};
+}
+
+bool ptcl_parser_get_prelude(ptcl_parser *parser, ptcl_parser_prelude *prelude)
+{
+    if (parser->prelude == NULL)
     {
-        parser->errors.items = buffer;
-        parser->errors.items[parser->errors.count++] = error;
-        ptcl_parser_set_state(parser, ptcl_parser_critical_flag, error.is_critical);
+        return false;
     }
+
+    *prelude = (ptcl_parser_prelude){
+        .result = *parser->prelude,
+        .root = parser->prelude_root,
+        .hash = parser->prelude_hash,
+        .hidden_built_in_types = parser->prelude_hidden_built_in_types};
+    return true;
 }
 
-void ptcl_parser_result_destroy(ptcl_parser_result result)
+static bool ptcl_parser_place_prelude(ptcl_parser *parser, ptcl_parser_prelude prelude)
 {
-    for (size_t i = 0; i < result.errors_count; i++)
+    ptcl_parser_result *result = malloc(sizeof(ptcl_parser_result));
+    ptcl_type_interner *types = ptcl_type_interner_create();
+    if (result == NULL || types == NULL)
     {
-        ptcl_parser_error_destroy(result.errors[i]);
+        free(result);
+        ptcl_type_interner_destroy(types);
+        return false;
     }
 
-    free(result.errors);
-    for (size_t i = 0; i < result.syntaxes_count; i++)
+    // Recycled interner reads types of prelude, which was used before
+    if (parser->is_recycled)
     {
-        ptcl_parser_syntax_destroy(result.syntaxes[i]);
+        ptcl_type_interner_destroy(parser->types);
+        parser->types = NULL;
     }
 
-    free(result.syntaxes);
-    for (size_t i = 0; i < result.comp_types_count; i++)
+    // Types of prelude aren't interned again, interner only shares types of its files
+    *result = prelude.result;
+    result->configuration = parser->configuration;
+    result->types = types;
+    result->arena = NULL;
+    result->stats = NULL;
+    result->prelude = NULL;
+    parser->prelude = result;
+    parser->prelude_root = prelude.root;
+    parser->prelude_hash = prelude.hash;
+    parser->prelude_hidden_built_in_types = prelude.hidden_built_in_types;
+    parser->is_prelude_set = true;
+    return true;
+}
+
+bool ptcl_parser_set_prelude(ptcl_parser *parser, ptcl_parser_prelude prelude)
+{
+    ptcl_parser_release_prelude(parser);
+    return ptcl_parser_place_prelude(parser, prelude);
+}
+
+// Image of prelude of imports is next to importer: script.ptcl has script.ptclm
+static char *ptcl_parser_imports_path(char *executor)
+{
+    const size_t length = strlen(executor);
+    const size_t extension = strlen(PTCL_MODULE_EXTENSION);
+    return length > extension && strcmp(executor + length - extension, PTCL_MODULE_EXTENSION) == 0
+               ? ptcl_string(executor, PTCL_SNAPSHOT_IMPORTS_EXTENSION + extension, NULL)
+               : ptcl_string(executor, PTCL_SNAPSHOT_IMPORTS_EXTENSION, NULL);
+}
+
+// Prelude of imports depends on prelude below it, on tokens of inserted modules and on their paths, which are in locations
+static uint64_t ptcl_parser_imports_key(ptcl_parser *parser, uint64_t base, size_t count)
+{
+    uint64_t key = (base * 0x100000001b3ULL) ^ ptcl_incremental_hash_tokens(parser->imported, count);
+    for (size_t i = 0; i < ptcl_modules_imported_count(parser->modules); i++)
     {
-        ptcl_parser_comp_type_destroy(result.comp_types[i]);
+        for (char *path = ptcl_modules_imported_path(parser->modules, i); *path != '\0'; path++)
+        {
+            key = (key ^ (unsigned char)*path) * 0x100000001b3ULL;
+        }
     }
 
-    free(result.comp_types);
-    for (size_t i = 0; i < result.typedatas_count; i++)
+    return key;
+}
+
+static bool ptcl_parser_load_imports(ptcl_parser *parser, uint64_t key)
+{
+    char *path = parser->input->executor != NULL ? ptcl_parser_imports_path(parser->input->executor) : NULL;
+    ptcl_snapshot *snapshot = path != NULL ? ptcl_snapshot_load_prelude(path, key) : NULL;
+    free(path);
+    if (snapshot == NULL)
     {
-        ptcl_parser_typedata_destroy(result.typedatas[i]);
+        return false;
     }
 
-    free(result.typedatas);
-    free(result.functions);
-    for (size_t i = 0; i < result.variables_count; i++)
+    ptcl_parser_keep_base(parser);
+    if (!ptcl_parser_place_prelude(parser, ptcl_snapshot_get_prelude(snapshot)))
     {
-        ptcl_parser_variable_destroy(result.variables[i]);
+        ptcl_parser_restore_base(parser);
+        ptcl_snapshot_destroy(snapshot);
+        return false;
     }
 
-    free(result.variables);
+    parser->prelude_hash = key;
+    parser->imports_snapshot = snapshot;
+    parser->is_imports = true;
+    return true;
+}
+
+// Leading imports are parsed like prelude, which starts with instances and statements of prelude below it
+static bool ptcl_parser_parse_imports(ptcl_parser *parser, ptcl_tokens_list *leading, uint64_t key)
+{
+    ptcl_tokens_list *input = parser->input;
+    const uint64_t hash = parser->prelude_hash;
+    parser->input = leading;
+    parser->is_prelude = true;
+    parser->is_imports_parsed = true;
+    ptcl_parser_result result = ptcl_parser_parse(parser);
+    parser->is_prelude = false;
+    parser->is_imports_parsed = false;
+    parser->input = input;
+    parser->prelude_hash = hash;
+    if (result.is_critical || result.errors_count > 0)
+    {
+        ptcl_parser_recycle(parser, result, false);
+        return false;
+    }
 
-#pragma warning(push)
-#pragma warning(disable : 6001)
+    ptcl_parser_keep_base(parser);
+    if (!ptcl_parser_take_prelude(parser, result))
+    {
+        ptcl_parser_restore_base(parser);
+        ptcl_parser_recycle(parser, result, false);
+        return false;
+    }
 
-    for (size_t i = 0; i < result.lated_states_count; i++)
+    parser->prelude_hash = key;
+    parser->is_imports = true;
+    char *path = parser->is_imports_saved && input->executor != NULL ? ptcl_parser_imports_path(input->executor) : NULL;
+    ptcl_parser_prelude prelude;
+    if (path != NULL && ptcl_parser_get_prelude(parser, &prelude))
     {
-        free(result.lated_states[i].tokens);
+        // Image only spares parsing of next runs, prelude of imports, which can't be saved, is still used
+        ptcl_snapshot_save_prelude(&prelude, key, path);
     }
 
-#pragma warning(pop)
+    free(path);
+    return true;
+}
 
-    free(result.lated_states);
-    free(result.this_pairs);
-    if (!result.is_critical)
+// Files, which start with the same imports, share their prelude of imports, so modules are parsed once.
+// If imports can't be expanded or parsed, file parses them by itself and reports their errors
+static void ptcl_parser_use_imports(ptcl_parser *parser)
+{
+    ptcl_tokens_list leading = *parser->input;
+    leading.count = ptcl_modules_leading_imports(leading.tokens, leading.count);
+    size_t count;
+    ptcl_modules_failure failure;
+    if (leading.count == 0 || !ptcl_parser_create_modules(parser) ||
+        !ptcl_modules_expand(parser->modules, &leading, &parser->imported, &parser->imported_capacity, &count, &failure))
     {
-        ptcl_func_body_destroy(result.body);
+        ptcl_parser_drop_imports(parser);
+        return;
+    }
+
+    const uint64_t key = ptcl_parser_imports_key(parser, parser->is_imports ? parser->base.hash : parser->prelude_hash, count);
+    if (!parser->is_imports || parser->prelude_hash != key)
+    {
+        ptcl_parser_drop_imports(parser);
+        if (!ptcl_parser_load_imports(parser, key) && !ptcl_parser_parse_imports(parser, &leading, key))
+        {
+            return;
+        }
     }
+
+    parser->imports_count = leading.count;
+}
+
+void ptcl_parser_set_imports_saved(ptcl_parser *parser, bool is_saved)
+{
+    parser->is_imports_saved = is_saved;
 }
 
 void ptcl_parser_destroy(ptcl_parser *parser)
 {
-    ptcl_interpreter_destroy(parser->interpreter);
+    if (parser->is_recycled)
+    {
+        free(parser->errors.items);
+        free(parser->syntaxes.items);
+        free(parser->comp_types.items);
+        free(parser->typedatas.items);
+        free(parser->functions.items);
+        free(parser->variables.items);
+        free(parser->lated_states.items);
+        free(parser->this_pairs.items);
+        ptcl_arena_destroy(parser->arena);
+        ptcl_type_interner_destroy(parser->types);
+        parser->is_recycled = false;
+    }
+
+    ptcl_parser_release_prelude(parser);
+    if (parser->interpreter != NULL)
+    {
+        ptcl_interpreter_destroy(parser->interpreter);
+    }
+
+    ptcl_modules_destroy(parser->modules);
+    free(parser->imported);
+    free(parser->each_slots.items);
+    free(parser->syntax_starts.words);
     free(parser);
 }
\ No newline at end of file
@@ -0,0 +1,582 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_server.h>
+#include <ptcl_batch.h>
+#include <ptcl_context.h>
+#include <ptcl_thread.h>
+#include <ptcl_file.h>
+#include <ptcl_trace.h>
+#include <ptcl_string_buffer.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET ptcl_socket;
+#define PTCL_SERVER_INVALID_SOCKET INVALID_SOCKET
+#define ptcl_server_close_socket closesocket
+#else
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int ptcl_socket;
+#define PTCL_SERVER_INVALID_SOCKET (-1)
+#define ptcl_server_close_socket close
+#endif
+
+// Client, which has closed connection, mustn't kill server by signal
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Other files at socket path, mistyped by user, are kept and then bind fails on them
+static void ptcl_server_remove_socket(char *path)
+{
+#ifdef _WIN32
+    // Unix sockets are reparse points on Windows
+    const DWORD attributes = GetFileAttributesA(path);
+    if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+    {
+        DeleteFileA(path);
+    }
+#else
+    struct stat status;
+    if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        unlink(path);
+    }
+#endif
+}
+
+// Client, which connects and sends nothing, mustn't hold worker and stop of server forever
+static void ptcl_server_set_timeout(ptcl_socket client)
+{
+#ifdef _WIN32
+    const DWORD timeout = PTCL_SERVER_TIMEOUT;
+#else
+    const struct timeval timeout = {
+        .tv_sec = PTCL_SERVER_TIMEOUT / 1000,
+        .tv_usec = (PTCL_SERVER_TIMEOUT % 1000) * 1000};
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+}
+
+typedef struct ptcl_server
+{
+    ptcl_lexer_configuration *configuration;
+    char *path;
+    // Name and source of prelude, NULL if there is none. Contexts keep its tokens, so source lives as long as server
+    char *prelude_path;
+    char *prelude;
+    size_t jobs;
+    size_t workers_count;
+    ptcl_socket socket;
+    // Guards everything below
+    ptcl_mutex *mutex;
+    uint64_t latencies[PTCL_SERVER_LATENCIES_CAPACITY];
+    size_t requests_count;
+    size_t failures_count;
+    bool is_stopped;
+} ptcl_server;
+
+typedef struct ptcl_server_worker
+{
+    ptcl_server *server;
+    ptcl_context *context;
+    // Errors of prelude, they are answer to every compile request
+    char *prelude_diagnostics;
+    // Reused by all requests of worker
+    ptcl_string_buffer *request;
+    ptcl_string_buffer *response;
+} ptcl_server_worker;
+
+static bool ptcl_server_address(char *path, struct sockaddr_un *address)
+{
+    if (strlen(path) >= sizeof(address->sun_path))
+    {
+        return false;
+    }
+
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+ptcl_server *ptcl_server_create(ptcl_lexer_configuration *configuration, char *path, char *prelude, size_t jobs)
+{
+    struct sockaddr_un address;
+    if (!ptcl_server_address(path, &address))
+    {
+        return NULL;
+    }
+
+    ptcl_server *server = malloc(sizeof(ptcl_server));
+    if (server == NULL)
+    {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        free(server);
+        return NULL;
+    }
+#endif
+
+    server->configuration = configuration;
+    server->path = path;
+    server->prelude_path = prelude;
+    server->prelude = NULL;
+    server->jobs = jobs == 0 ? ptcl_thread_hardware_count() : jobs;
+    server->workers_count = 0;
+    server->mutex = ptcl_mutex_create();
+    server->requests_count = 0;
+    server->failures_count = 0;
+    server->is_stopped = false;
+    server->socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server->mutex == NULL || server->socket == PTCL_SERVER_INVALID_SOCKET)
+    {
+        goto failure;
+    }
+
+    ptcl_server_remove_socket(path);
+    if (bind(server->socket, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(server->socket, SOMAXCONN) != 0)
+    {
+        goto failure;
+    }
+
+    // Unreadable prelude is reported by every compile request
+    if (prelude != NULL)
+    {
+        server->prelude = ptcl_file_read(prelude, NULL);
+    }
+
+    return server;
+
+failure:
+    if (server->socket != PTCL_SERVER_INVALID_SOCKET)
+    {
+        ptcl_server_close_socket(server->socket);
+    }
+
+    ptcl_mutex_destroy(server->mutex);
+    free(server);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return NULL;
+}
+
+static bool ptcl_server_receive(ptcl_socket client, ptcl_string_buffer *request)
+{
+    char chunk[4096];
+    while (true)
+    {
+        const int received = recv(client, chunk, sizeof(chunk), 0);
+        if (received == 0)
+        {
+            return true;
+        }
+
+        if (received < 0)
+        {
+#ifndef _WIN32
+            if (errno == EINTR)
+            {
+                continue;
+            }
+#endif
+            return false;
+        }
+
+        if (ptcl_string_buffer_length(request) + (size_t)received > PTCL_SERVER_MAX_REQUEST ||
+            !ptcl_string_buffer_append_str(request, chunk, (size_t)received))
+        {
+            return false;
+        }
+    }
+}
+
+static void ptcl_server_send(ptcl_socket client, ptcl_string_buffer *response)
+{
+    char *data = ptcl_string_buffer_get_data(response);
+    size_t length = ptcl_string_buffer_length(response);
+    while (length > 0)
+    {
+        const int chunk = length > INT_MAX ? INT_MAX : (int)length;
+        const int sent = send(client, data, chunk, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+#ifndef _WIN32
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+#endif
+            return;
+        }
+
+        data += sent;
+        length -= (size_t)sent;
+    }
+}
+
+static void ptcl_server_fail(ptcl_server_worker *worker, char *message)
+{
+    ptcl_string_buffer_clear(worker->response);
+    ptcl_string_buffer_append_str(worker->response, "error\n", 6);
+    ptcl_string_buffer_append_str(worker->response, message, strlen(message));
+    ptcl_string_buffer_append(worker->response, '\n');
+}
+
+static bool ptcl_server_compile(ptcl_server_worker *worker, char *name, char *source)
+{
+    ptcl_string_buffer *response = worker->response;
+    if (worker->prelude_diagnostics != NULL)
+    {
+        ptcl_string_buffer_append_str(response, "error\n", 6);
+        ptcl_string_buffer_append_str(response, worker->prelude_diagnostics, strlen(worker->prelude_diagnostics));
+        return false;
+    }
+
+    ptcl_parser_result *result = ptcl_context_parse(worker->context, name, source);
+    if (result->errors_count != 0)
+    {
+        ptcl_string_buffer_append_str(response, "error\n", 6);
+        ptcl_batch_add_errors(response, name, source, result);
+        ptcl_context_reset(worker->context);
+        return false;
+    }
+
+    char *transpiled = ptcl_context_transpile(worker->context);
+    ptcl_context_reset(worker->context);
+    if (transpiled == NULL)
+    {
+        ptcl_server_fail(worker, "Memory allocation failed");
+        return false;
+    }
+
+    ptcl_string_buffer_append_str(response, "ok\n", 3);
+    ptcl_string_buffer_append_str(response, transpiled, strlen(transpiled));
+    free(transpiled);
+    return true;
+}
+
+static int ptcl_server_compare_latencies(const void *left, const void *right)
+{
+    const uint64_t first = *(const uint64_t *)left;
+    const uint64_t second = *(const uint64_t *)right;
+    return first < second ? -1 : first > second;
+}
+
+ptcl_server_latencies ptcl_server_get_latencies(ptcl_server *server)
+{
+    ptcl_server_latencies latencies = {0};
+    uint64_t *values = malloc(PTCL_SERVER_LATENCIES_CAPACITY * sizeof(uint64_t));
+    ptcl_mutex_lock(server->mutex);
+    latencies.requests_count = server->requests_count;
+    latencies.failures_count = server->failures_count;
+    const size_t count = latencies.requests_count < PTCL_SERVER_LATENCIES_CAPACITY ? latencies.requests_count : PTCL_SERVER_LATENCIES_CAPACITY;
+    if (values != NULL)
+    {
+        memcpy(values, server->latencies, count * sizeof(uint64_t));
+    }
+
+    ptcl_mutex_unlock(server->mutex);
+    if (values == NULL || count == 0)
+    {
+        free(values);
+        return latencies;
+    }
+
+    qsort(values, count, sizeof(uint64_t), ptcl_server_compare_latencies);
+    latencies.p50 = values[(count - 1) * 50 / 100];
+    latencies.p90 = values[(count - 1) * 90 / 100];
+    latencies.p99 = values[(count - 1) * 99 / 100];
+    latencies.max = values[count - 1];
+    free(values);
+    return latencies;
+}
+
+static void ptcl_server_stats(ptcl_server_worker *worker)
+{
+    const ptcl_server_latencies latencies = ptcl_server_get_latencies(worker->server);
+    char json[256];
+    const int length = snprintf(json, sizeof(json),
+                                "{\"requests\": %zu, \"failures\": %zu, \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}\n",
+                                latencies.requests_count,
+                                latencies.failures_count,
+                                (unsigned long long)latencies.p50,
+                                (unsigned long long)latencies.p90,
+                                (unsigned long long)latencies.p99,
+                                (unsigned long long)latencies.max);
+    ptcl_string_buffer_append_str(worker->response, "ok\n", 3);
+    ptcl_string_buffer_append_str(worker->response, json, length > 0 ? (size_t)length : 0);
+}
+
+// Workers blocked in accept are woken by connections, each of them stops after its next accept
+static void ptcl_server_stop(ptcl_server *server)
+{
+    ptcl_mutex_lock(server->mutex);
+    server->is_stopped = true;
+    const size_t count = server->workers_count;
+    ptcl_mutex_unlock(server->mutex);
+
+    struct sockaddr_un address;
+    ptcl_server_address(server->path, &address);
+    for (size_t i = 1; i < count; i++)
+    {
+        ptcl_socket wake = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (wake == PTCL_SERVER_INVALID_SOCKET)
+        {
+            continue;
+        }
+
+        connect(wake, (struct sockaddr *)&address, sizeof(address));
+        ptcl_server_close_socket(wake);
+    }
+}
+
+// Returns true if request stops server
+static bool ptcl_server_handle(ptcl_server_worker *worker, ptcl_socket client)
+{
+    ptcl_server *server = worker->server;
+    const uint64_t start = ptcl_trace_timestamp();
+    ptcl_string_buffer_clear(worker->request);
+    ptcl_string_buffer_clear(worker->response);
+    if (!ptcl_server_receive(client, worker->request))
+    {
+        ptcl_server_fail(worker, "Failed to read request");
+        ptcl_server_send(client, worker->response);
+        return false;
+    }
+
+    // Header is first line, the rest is source
+    char *header = ptcl_string_buffer_get_data(worker->request);
+    char *body = strchr(header, '\n');
+    if (body != NULL)
+    {
+        *body++ = '\0';
+    }
+    else
+    {
+        body = header + strlen(header);
+    }
+
+    char *argument = strchr(header, ' ');
+    if (argument != NULL)
+    {
+        *argument++ = '\0';
+    }
+
+    bool is_request = true;
+    bool is_compiled = false;
+    bool is_stop = false;
+    if (strcmp(header, "compile") == 0 && argument != NULL)
+    {
+        is_compiled = ptcl_server_compile(worker, argument, body);
+    }
+    else if (strcmp(header, "file") == 0 && argument != NULL)
+    {
+        char *source = ptcl_file_read(argument, NULL);
+        if (source == NULL)
+        {
+            ptcl_server_fail(worker, "Failed to read file");
+        }
+        else
+        {
+            is_compiled = ptcl_server_compile(worker, argument, source);
+            free(source);
+        }
+    }
+    else
+    {
+        is_request = false;
+        if (strcmp(header, "stats") == 0)
+        {
+            ptcl_server_stats(worker);
+        }
+        else if (strcmp(header, "stop") == 0)
+        {
+            ptcl_string_buffer_append_str(worker->response, "ok\n", 3);
+            is_stop = true;
+        }
+        else
+        {
+            ptcl_server_fail(worker, "Unknown request");
+        }
+    }
+
+    ptcl_server_send(client, worker->response);
+    if (is_request)
+    {
+        const uint64_t latency = ptcl_trace_timestamp() - start;
+        ptcl_mutex_lock(server->mutex);
+        server->latencies[server->requests_count % PTCL_SERVER_LATENCIES_CAPACITY] = latency;
+        server->requests_count++;
+        server->failures_count += !is_compiled;
+        ptcl_mutex_unlock(server->mutex);
+    }
+
+    return is_stop;
+}
+
+// Prelude is parsed by thread of worker, so its instances are made by the same parser that uses them
+static void ptcl_server_parse_prelude(ptcl_server_worker *worker)
+{
+    ptcl_server *server = worker->server;
+    if (server->prelude_path == NULL)
+    {
+        return;
+    }
+
+    ptcl_string_buffer *diagnostics = worker->response;
+    if (server->prelude == NULL)
+    {
+        ptcl_string_buffer_append_str(diagnostics, "Failed to read prelude\n", 23);
+        worker->prelude_diagnostics = ptcl_string_buffer_copy_and_clear(diagnostics);
+        return;
+    }
+
+    ptcl_parser_result *result = ptcl_context_parse_prelude(worker->context, server->prelude_path, server->prelude);
+    if (result->errors_count != 0)
+    {
+        ptcl_string_buffer_append_str(diagnostics, "Failed to parse prelude\n", 24);
+        ptcl_batch_add_errors(diagnostics, server->prelude_path, server->prelude, result);
+        worker->prelude_diagnostics = ptcl_string_buffer_copy_and_clear(diagnostics);
+    }
+
+    ptcl_context_reset(worker->context);
+}
+
+static void ptcl_server_worker_run(void *argument)
+{
+    ptcl_server_worker *worker = argument;
+    ptcl_server *server = worker->server;
+    ptcl_server_parse_prelude(worker);
+    while (true)
+    {
+        ptcl_socket client = accept(server->socket, NULL, NULL);
+        if (client == PTCL_SERVER_INVALID_SOCKET)
+        {
+#ifndef _WIN32
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+#endif
+            break;
+        }
+
+        ptcl_mutex_lock(server->mutex);
+        const bool is_stopped = server->is_stopped;
+        ptcl_mutex_unlock(server->mutex);
+        if (is_stopped)
+        {
+            ptcl_server_close_socket(client);
+            break;
+        }
+
+        ptcl_server_set_timeout(client);
+        const bool is_stop = ptcl_server_handle(worker, client);
+        ptcl_server_close_socket(client);
+        if (is_stop)
+        {
+            ptcl_server_stop(server);
+            break;
+        }
+    }
+}
+
+bool ptcl_server_run(ptcl_server *server)
+{
+    size_t jobs = server->jobs;
+    ptcl_server_worker *workers = malloc(jobs * sizeof(ptcl_server_worker));
+    ptcl_thread **threads = malloc(jobs * sizeof(ptcl_thread *));
+    if (workers == NULL || threads == NULL)
+    {
+        free(workers);
+        free(threads);
+        return false;
+    }
+
+    for (size_t i = 0; i < jobs; i++)
+    {
+        workers[i] = (ptcl_server_worker){
+            .server = server,
+            .context = ptcl_context_create(server->configuration),
+            .prelude_diagnostics = NULL,
+            .request = ptcl_string_buffer_create(),
+            .response = ptcl_string_buffer_create()};
+        if (workers[i].context == NULL || workers[i].request == NULL || workers[i].response == NULL)
+        {
+            ptcl_context_destroy(workers[i].context);
+            if (workers[i].request != NULL)
+            {
+                ptcl_string_buffer_destroy(workers[i].request);
+            }
+
+            if (workers[i].response != NULL)
+            {
+                ptcl_string_buffer_destroy(workers[i].response);
+            }
+
+            jobs = i;
+            break;
+        }
+    }
+
+    // Workers, whose threads aren't started, aren't counted, so stop doesn't wait for them.
+    // Stop can't be handled before they are counted, because it needs lock
+    ptcl_mutex_lock(server->mutex);
+    server->workers_count = jobs == 0 ? 0 : 1;
+    for (size_t i = 1; i < jobs; i++)
+    {
+        threads[i] = ptcl_thread_create(ptcl_server_worker_run, &workers[i]);
+        server->workers_count += threads[i] != NULL;
+    }
+
+    ptcl_mutex_unlock(server->mutex);
+    if (jobs > 0)
+    {
+        ptcl_server_worker_run(&workers[0]);
+    }
+
+    for (size_t i = 0; i < jobs; i++)
+    {
+        if (i > 0 && threads[i] != NULL)
+        {
+            ptcl_thread_join(threads[i]);
+        }
+
+        free(workers[i].prelude_diagnostics);
+        ptcl_context_destroy(workers[i].context);
+        ptcl_string_buffer_destroy(workers[i].request);
+        ptcl_string_buffer_destroy(workers[i].response);
+    }
+
+    free(workers);
+    free(threads);
+    return jobs > 0;
+}
+
+void ptcl_server_destroy(ptcl_server *server)
+{
+    ptcl_server_close_socket(server->socket);
+    ptcl_server_remove_socket(server->path);
+    ptcl_mutex_destroy(server->mutex);
+    free(server->prelude);
+    free(server);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
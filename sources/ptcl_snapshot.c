@@ -0,0 +1,1697 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_snapshot.h>
+#include <ptcl_file.h>
+
+#define PTCL_SNAPSHOT_MAGIC 0x53544350u
+#define PTCL_SNAPSHOT_DEFAULT_CAPACITY 256
+
+// Image is header, nodes, empty body for released scopes, strings and offsets of pointers in image
+typedef struct ptcl_snapshot_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t layout;
+    // Hash of header with zero checksum and of everything after it
+    uint64_t checksum;
+    uint64_t size;
+    uint64_t body;
+    uint64_t variables;
+    uint64_t variables_count;
+    uint64_t relocations;
+    uint64_t relocations_count;
+    // Prelude of parser, zero in image of program. Key is given by saver and must be given again by loader
+    uint64_t prelude;
+    uint64_t key;
+} ptcl_snapshot_header;
+
+typedef struct ptcl_snapshot
+{
+    char *image;
+    size_t size;
+    ptcl_snapshot_header header;
+} ptcl_snapshot;
+
+typedef enum ptcl_snapshot_kind
+{
+    ptcl_snapshot_statement_kind,
+    ptcl_snapshot_expression_kind,
+    ptcl_snapshot_func_body_kind,
+    ptcl_snapshot_func_call_kind,
+    ptcl_snapshot_array_kind,
+    ptcl_snapshot_cast_kind,
+    ptcl_snapshot_ctor_kind,
+    ptcl_snapshot_type_kind,
+    ptcl_snapshot_comp_type_kind,
+    ptcl_snapshot_typedata_kind
+} ptcl_snapshot_kind;
+
+typedef enum ptcl_snapshot_slot_type
+{
+    // Node is saved too
+    ptcl_snapshot_node_slot,
+    // Scope or declaration, which can be released after parsing, so it isn't followed
+    ptcl_snapshot_weak_slot,
+    ptcl_snapshot_string_slot,
+    // Used only by parser, saved as NULL
+    ptcl_snapshot_clear_slot
+} ptcl_snapshot_slot_type;
+
+// Memory of nodes in process, which saves them. Overlapped ones are merged, so pointers inside of node are kept
+typedef struct ptcl_snapshot_object
+{
+    uintptr_t address;
+    uintptr_t end;
+    size_t offset;
+} ptcl_snapshot_object;
+
+typedef struct ptcl_snapshot_slot
+{
+    uintptr_t address;
+    uintptr_t target;
+    // Size of string with terminator, then its offset in image
+    size_t size;
+    size_t offset;
+    ptcl_snapshot_slot_type type;
+} ptcl_snapshot_slot;
+
+typedef struct ptcl_snapshot_visit
+{
+    uintptr_t address;
+    ptcl_snapshot_kind kind;
+    bool is_used;
+} ptcl_snapshot_visit;
+
+// Follows nodes to save them, or to check loaded image, then image is set
+typedef struct ptcl_snapshot_walker
+{
+    ptcl_snapshot_object *objects;
+    size_t objects_count;
+    size_t objects_capacity;
+    ptcl_snapshot_slot *slots;
+    size_t slots_count;
+    size_t slots_capacity;
+    // Followed nodes, open addressing by address and kind
+    ptcl_snapshot_visit *visits;
+    size_t visits_count;
+    size_t visits_capacity;
+    // Relocated image, its end of nodes and strings, bits of relocated pointers and of them, reached by walk
+    char *image;
+    size_t end;
+    uint64_t *relocated;
+    uint64_t *reached;
+    size_t reached_count;
+    // Type isn't read by transpiler, so it can be left zeroed by parser
+    bool is_unread;
+    // Prelude is read by parser too, so values of built-in variables are saved and indices of lated bodies are checked
+    bool is_prelude;
+    size_t lated_states_count;
+    bool is_failed;
+} ptcl_snapshot_walker;
+
+static void ptcl_snapshot_visit_type(ptcl_snapshot_walker *walker, ptcl_type *type);
+static void ptcl_snapshot_visit_expression(ptcl_snapshot_walker *walker, ptcl_expression **slot);
+static void ptcl_snapshot_visit_statement(ptcl_snapshot_walker *walker, ptcl_statement **slot);
+static void ptcl_snapshot_visit_func_body(ptcl_snapshot_walker *walker, ptcl_func_body *body);
+
+// Nodes are used in place, so snapshot is refused by build with other sizes of them or places of their fields
+static uint64_t ptcl_snapshot_layout()
+{
+    const uint64_t sizes[] = {
+        sizeof(void *),
+        sizeof(size_t),
+        sizeof(ptcl_statement),
+        sizeof(ptcl_expression),
+        sizeof(ptcl_type),
+        sizeof(ptcl_func_body),
+        sizeof(ptcl_name),
+        sizeof(ptcl_argument),
+        sizeof(ptcl_attribute),
+        sizeof(ptcl_type_member),
+        sizeof(ptcl_statement_func_call),
+        sizeof(ptcl_expression_array),
+        sizeof(ptcl_expression_cast),
+        sizeof(ptcl_expression_ctor),
+        sizeof(ptcl_statement_func_decl),
+        sizeof(ptcl_type_comp_type),
+        sizeof(ptcl_type_typedata),
+        sizeof(ptcl_parser_variable),
+        sizeof(ptcl_token),
+        sizeof(ptcl_parser_tokens_state),
+        sizeof(ptcl_parser_syntax),
+        sizeof(ptcl_parser_syntax_node),
+        sizeof(ptcl_parser_typedata),
+        sizeof(ptcl_parser_comp_type),
+        sizeof(ptcl_parser_function),
+        sizeof(ptcl_parser_this_s_pair),
+        sizeof(ptcl_parser_result),
+        sizeof(ptcl_parser_prelude),
+        offsetof(ptcl_location, executor),
+        offsetof(ptcl_name, value),
+        offsetof(ptcl_identifier, name),
+        offsetof(ptcl_identifier, value),
+        offsetof(ptcl_type, comp_type),
+        offsetof(ptcl_type, pointer.target),
+        offsetof(ptcl_type, array.target),
+        offsetof(ptcl_type, array.count),
+        offsetof(ptcl_type, function_pointer.return_type),
+        offsetof(ptcl_type, function_pointer.arguments),
+        offsetof(ptcl_type, function_pointer.count),
+        offsetof(ptcl_type_comp_type, identifier),
+        offsetof(ptcl_type_comp_type, types),
+        offsetof(ptcl_type_comp_type, functions),
+        offsetof(ptcl_type_comp_type, count),
+        offsetof(ptcl_type_typedata, members),
+        offsetof(ptcl_type_typedata, count),
+        offsetof(ptcl_argument, name),
+        offsetof(ptcl_argument, default_value),
+        offsetof(ptcl_func_body, count),
+        offsetof(ptcl_func_body, root),
+        offsetof(ptcl_statement_func_call, identifier),
+        offsetof(ptcl_statement_func_call, arguments),
+        offsetof(ptcl_statement_func_call, count),
+        offsetof(ptcl_statement_func_call, return_type),
+        offsetof(ptcl_statement_func_call, built_in),
+        offsetof(ptcl_statement_func_decl, root),
+        offsetof(ptcl_statement_func_decl, name),
+        offsetof(ptcl_statement_func_decl, arguments),
+        offsetof(ptcl_statement_func_decl, count),
+        offsetof(ptcl_statement_func_decl, func_body),
+        offsetof(ptcl_statement_func_decl, return_type),
+        offsetof(ptcl_statement_func_decl, is_cached),
+        offsetof(ptcl_statement, location),
+        offsetof(ptcl_statement, root),
+        offsetof(ptcl_statement, attributes),
+        offsetof(ptcl_statement, func_call),
+        offsetof(ptcl_statement, typedata_decl.members),
+        offsetof(ptcl_statement, typedata_decl.count),
+        offsetof(ptcl_statement, type_decl.types),
+        offsetof(ptcl_statement, type_decl.types_count),
+        offsetof(ptcl_statement, type_decl.body),
+        offsetof(ptcl_statement, type_decl.functions),
+        offsetof(ptcl_statement, assign.identifier),
+        offsetof(ptcl_statement, assign.type),
+        offsetof(ptcl_statement, assign.value),
+        offsetof(ptcl_statement, if_stat.condition),
+        offsetof(ptcl_statement, if_stat.body),
+        offsetof(ptcl_statement, if_stat.else_body),
+        offsetof(ptcl_statement, body.arguments),
+        offsetof(ptcl_statement, body.arguments_count),
+        offsetof(ptcl_statement, body.caller),
+        offsetof(ptcl_statement, body.self),
+        offsetof(ptcl_statement, body.func_call),
+        offsetof(ptcl_expression, location),
+        offsetof(ptcl_expression, return_type),
+        offsetof(ptcl_expression, func_call),
+        offsetof(ptcl_expression, array),
+        offsetof(ptcl_expression_array, type),
+        offsetof(ptcl_expression_array, expressions),
+        offsetof(ptcl_expression_array, count),
+        offsetof(ptcl_expression, string.length),
+        offsetof(ptcl_expression, binary.left),
+        offsetof(ptcl_expression, binary.right),
+        offsetof(ptcl_expression, cast),
+        offsetof(ptcl_expression_cast, type),
+        offsetof(ptcl_expression, unary.child),
+        offsetof(ptcl_expression, array_element.index),
+        offsetof(ptcl_expression, dot.name),
+        offsetof(ptcl_expression, dot.right),
+        offsetof(ptcl_expression, ctor),
+        offsetof(ptcl_expression_ctor, values),
+        offsetof(ptcl_expression_ctor, members),
+        offsetof(ptcl_expression_ctor, count),
+        offsetof(ptcl_expression, if_expr.else_body),
+        offsetof(ptcl_expression, variable.name),
+        offsetof(ptcl_expression, internal_token.value),
+        offsetof(ptcl_expression, internal_token.location),
+        offsetof(ptcl_parser_variable, name),
+        offsetof(ptcl_parser_variable, root),
+        offsetof(ptcl_parser_variable, type),
+        offsetof(ptcl_parser_variable, built_in),
+        offsetof(ptcl_token, value),
+        offsetof(ptcl_token, location),
+        offsetof(ptcl_parser_tokens_state, tokens),
+        offsetof(ptcl_parser_tokens_state, partners),
+        offsetof(ptcl_parser_tokens_state, count),
+        offsetof(ptcl_parser_syntax, root),
+        offsetof(ptcl_parser_syntax, nodes),
+        offsetof(ptcl_parser_syntax, count),
+        offsetof(ptcl_parser_syntax_node, word.name),
+        offsetof(ptcl_parser_syntax_node, variable.name),
+        offsetof(ptcl_parser_syntax_node, value.state),
+        offsetof(ptcl_parser_typedata, typedata),
+        offsetof(ptcl_parser_comp_type, comp_type),
+        offsetof(ptcl_parser_comp_type, static_type),
+        offsetof(ptcl_parser_function, root),
+        offsetof(ptcl_parser_function, bind),
+        offsetof(ptcl_parser_function, func),
+        offsetof(ptcl_parser_result, body),
+        offsetof(ptcl_parser_result, syntaxes),
+        offsetof(ptcl_parser_result, typedatas),
+        offsetof(ptcl_parser_result, comp_types),
+        offsetof(ptcl_parser_result, functions),
+        offsetof(ptcl_parser_result, variables),
+        offsetof(ptcl_parser_result, lated_states),
+        offsetof(ptcl_parser_result, this_pairs),
+        offsetof(ptcl_parser_result, types),
+        offsetof(ptcl_parser_result, prelude),
+        offsetof(ptcl_parser_prelude, root),
+        offsetof(ptcl_parser_prelude, hash)};
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const unsigned char *bytes = (const unsigned char *)sizes;
+    for (size_t i = 0; i < sizeof(sizes); i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+// Image is multiple of words, checksum of header is zero while it is counted
+static uint64_t ptcl_snapshot_checksum(const char *image, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, image + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+
+    return hash;
+}
+
+static size_t ptcl_snapshot_align(size_t offset)
+{
+    return (offset + PTCL_SNAPSHOT_ALIGNMENT - 1) / PTCL_SNAPSHOT_ALIGNMENT * PTCL_SNAPSHOT_ALIGNMENT;
+}
+
+static bool ptcl_snapshot_reserve(void **items, size_t *capacity, size_t count, size_t size)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    const size_t new_capacity = *capacity == 0 ? PTCL_SNAPSHOT_DEFAULT_CAPACITY : *capacity * 2;
+    void *buffer = realloc(*items, new_capacity * size);
+    if (buffer == NULL)
+    {
+        return false;
+    }
+
+    *items = buffer;
+    *capacity = new_capacity;
+    return true;
+}
+
+static size_t ptcl_snapshot_hash_address(uintptr_t address, ptcl_snapshot_kind kind)
+{
+    return (size_t)((((uint64_t)address ^ (uint64_t)kind) * 0x9e3779b97f4a7c15ULL) >> 17);
+}
+
+static bool ptcl_snapshot_grow_visits(ptcl_snapshot_walker *walker)
+{
+    const size_t capacity = walker->visits_capacity == 0 ? PTCL_SNAPSHOT_DEFAULT_CAPACITY : walker->visits_capacity * 2;
+    ptcl_snapshot_visit *visits = calloc(capacity, sizeof(ptcl_snapshot_visit));
+    if (visits == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < walker->visits_capacity; i++)
+    {
+        const ptcl_snapshot_visit visit = walker->visits[i];
+        if (!visit.is_used)
+        {
+            continue;
+        }
+
+        size_t index = ptcl_snapshot_hash_address(visit.address, visit.kind) & (capacity - 1);
+        while (visits[index].is_used)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        visits[index] = visit;
+    }
+
+    free(walker->visits);
+    walker->visits = visits;
+    walker->visits_capacity = capacity;
+    return true;
+}
+
+// Returns true only for first visit of node, so shared nodes are followed once
+static bool ptcl_snapshot_enter(ptcl_snapshot_walker *walker, void *node, ptcl_snapshot_kind kind)
+{
+    if (walker->visits_count * 2 >= walker->visits_capacity && !ptcl_snapshot_grow_visits(walker))
+    {
+        walker->is_failed = true;
+        return false;
+    }
+
+    const uintptr_t address = (uintptr_t)node;
+    const size_t mask = walker->visits_capacity - 1;
+    size_t index = ptcl_snapshot_hash_address(address, kind) & mask;
+    while (walker->visits[index].is_used)
+    {
+        if (walker->visits[index].address == address && walker->visits[index].kind == kind)
+        {
+            return false;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    walker->visits[index] = (ptcl_snapshot_visit){.address = address, .kind = kind, .is_used = true};
+    walker->visits_count++;
+    return true;
+}
+
+static void ptcl_snapshot_add_object(ptcl_snapshot_walker *walker, void *node, size_t size)
+{
+    if (!ptcl_snapshot_reserve((void **)&walker->objects, &walker->objects_capacity, walker->objects_count, sizeof(ptcl_snapshot_object)))
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    walker->objects[walker->objects_count++] = (ptcl_snapshot_object){
+        .address = (uintptr_t)node,
+        .end = (uintptr_t)node + size};
+}
+
+static void ptcl_snapshot_add_slot(ptcl_snapshot_walker *walker, void *slot, void *target, size_t size, ptcl_snapshot_slot_type type)
+{
+    if (!ptcl_snapshot_reserve((void **)&walker->slots, &walker->slots_capacity, walker->slots_count, sizeof(ptcl_snapshot_slot)))
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    walker->slots[walker->slots_count++] = (ptcl_snapshot_slot){
+        .address = (uintptr_t)slot,
+        .target = (uintptr_t)target,
+        .size = size,
+        .type = type};
+}
+
+// Slot is address of pointer, it is read by bytes, because pointers of all nodes are passed here
+static void *ptcl_snapshot_read(void *slot)
+{
+    void *target;
+    memcpy(&target, slot, sizeof(target));
+    return target;
+}
+
+static bool ptcl_snapshot_is_checking(ptcl_snapshot_walker *walker)
+{
+    return walker->image != NULL;
+}
+
+// Pointer of loaded image must be relocated and point to room of its target or be not relocated and be NULL,
+// each relocation must be reached by some pointer. Returns false if image is broken
+static bool ptcl_snapshot_check(ptcl_snapshot_walker *walker, void *slot, size_t size, size_t alignment)
+{
+    const size_t position = (size_t)((char *)slot - walker->image);
+    const size_t index = position / sizeof(uint64_t);
+    const uint64_t bit = 1ULL << (index % 64);
+    char *target = ptcl_snapshot_read(slot);
+    if ((walker->relocated[index / 64] & bit) == 0)
+    {
+        walker->is_failed |= target != NULL;
+        return !walker->is_failed;
+    }
+
+    if ((walker->reached[index / 64] & bit) == 0)
+    {
+        walker->reached[index / 64] |= bit;
+        walker->reached_count++;
+    }
+
+    const size_t offset = (size_t)(target - walker->image);
+    if (offset % alignment != 0 || size > walker->end - offset)
+    {
+        walker->is_failed = true;
+    }
+
+    return !walker->is_failed;
+}
+
+// Flags of loaded image must be bools, they are read as them
+static void ptcl_snapshot_check_flags(ptcl_snapshot_walker *walker, size_t count, ...)
+{
+    if (!ptcl_snapshot_is_checking(walker))
+    {
+        return;
+    }
+
+    va_list flags;
+    va_start(flags, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char value;
+        memcpy(&value, va_arg(flags, bool *), sizeof(value));
+        walker->is_failed |= value > 1;
+    }
+
+    va_end(flags);
+}
+
+// Returns node, if it must be followed
+static void *ptcl_snapshot_node(ptcl_snapshot_walker *walker, void *slot, size_t size, size_t alignment, ptcl_snapshot_kind kind)
+{
+    if (ptcl_snapshot_is_checking(walker) && !ptcl_snapshot_check(walker, slot, size, alignment))
+    {
+        return NULL;
+    }
+
+    void *node = ptcl_snapshot_read(slot);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    if (!ptcl_snapshot_is_checking(walker))
+    {
+        ptcl_snapshot_add_slot(walker, slot, node, 0, ptcl_snapshot_node_slot);
+    }
+
+    if (!ptcl_snapshot_enter(walker, node, kind))
+    {
+        return NULL;
+    }
+
+    if (!ptcl_snapshot_is_checking(walker))
+    {
+        ptcl_snapshot_add_object(walker, node, size);
+    }
+
+    return node;
+}
+
+// Arrays are followed by each owner, so items of array, shared by owners, are visited again
+static void *ptcl_snapshot_array(ptcl_snapshot_walker *walker, void *slot, size_t count, size_t size, size_t alignment)
+{
+    if (ptcl_snapshot_is_checking(walker))
+    {
+        // Saved empty arrays are NULL, set ones can't be read past end
+        if (count > walker->end / size || !ptcl_snapshot_check(walker, slot, count * size, alignment) ||
+            (count > 0) != (ptcl_snapshot_read(slot) != NULL))
+        {
+            walker->is_failed = true;
+            return NULL;
+        }
+
+        return ptcl_snapshot_read(slot);
+    }
+
+    void *items = ptcl_snapshot_read(slot);
+    if (items == NULL)
+    {
+        return NULL;
+    }
+
+    if (count == 0)
+    {
+        ptcl_snapshot_add_slot(walker, slot, items, 0, ptcl_snapshot_clear_slot);
+        return NULL;
+    }
+
+    ptcl_snapshot_add_slot(walker, slot, items, 0, ptcl_snapshot_node_slot);
+    ptcl_snapshot_add_object(walker, items, count * size);
+    return items;
+}
+
+// Bytes are string with terminator at end
+static void ptcl_snapshot_bytes(ptcl_snapshot_walker *walker, char **slot, size_t size)
+{
+    if (ptcl_snapshot_is_checking(walker))
+    {
+        if (size == 0 || (ptcl_snapshot_check(walker, slot, size, 1) && *slot != NULL && (*slot)[size - 1] != '\0'))
+        {
+            walker->is_failed = true;
+        }
+
+        return;
+    }
+
+    if (*slot != NULL)
+    {
+        ptcl_snapshot_add_slot(walker, slot, *slot, size, ptcl_snapshot_string_slot);
+    }
+}
+
+static void ptcl_snapshot_string(ptcl_snapshot_walker *walker, char **slot)
+{
+    if (ptcl_snapshot_is_checking(walker))
+    {
+        if (ptcl_snapshot_check(walker, slot, 1, 1) && *slot != NULL &&
+            memchr(*slot, '\0', walker->end - (size_t)(*slot - walker->image)) == NULL)
+        {
+            walker->is_failed = true;
+        }
+
+        return;
+    }
+
+    if (*slot != NULL)
+    {
+        ptcl_snapshot_bytes(walker, slot, strlen(*slot) + 1);
+    }
+}
+
+// Target isn't followed, but it is read by transpiler, so it must have room of its type
+static void ptcl_snapshot_weak(ptcl_snapshot_walker *walker, void *slot, size_t size, size_t alignment)
+{
+    if (ptcl_snapshot_is_checking(walker))
+    {
+        ptcl_snapshot_check(walker, slot, size, alignment);
+        return;
+    }
+
+    void *target = ptcl_snapshot_read(slot);
+    if (target != NULL)
+    {
+        ptcl_snapshot_add_slot(walker, slot, target, 0, ptcl_snapshot_weak_slot);
+    }
+}
+
+static void ptcl_snapshot_clear(ptcl_snapshot_walker *walker, void *slot)
+{
+    if (ptcl_snapshot_is_checking(walker))
+    {
+        // Cleared pointer is never relocated
+        walker->is_failed |= ptcl_snapshot_read(slot) != NULL;
+        return;
+    }
+
+    void *target = ptcl_snapshot_read(slot);
+    if (target != NULL)
+    {
+        ptcl_snapshot_add_slot(walker, slot, target, 0, ptcl_snapshot_clear_slot);
+    }
+}
+
+// Transpiler reads such pointer without checking it, so it can't be NULL in loaded image
+static void ptcl_snapshot_require(ptcl_snapshot_walker *walker, void *slot)
+{
+    walker->is_failed |= ptcl_snapshot_is_checking(walker) && ptcl_snapshot_read(slot) == NULL;
+}
+
+// Parser reads tokens of lated body by its index without checking it
+static void ptcl_snapshot_check_lated(ptcl_snapshot_walker *walker, size_t index)
+{
+    walker->is_failed |= ptcl_snapshot_is_checking(walker) && walker->is_prelude && index >= walker->lated_states_count;
+}
+
+static void ptcl_snapshot_visit_location(ptcl_snapshot_walker *walker, ptcl_location *location)
+{
+    ptcl_snapshot_string(walker, &location->executor);
+}
+
+static void ptcl_snapshot_visit_name(ptcl_snapshot_walker *walker, ptcl_name *name)
+{
+    ptcl_snapshot_check_flags(walker, 2, &name->is_anonymous, &name->is_free);
+    ptcl_snapshot_visit_location(walker, &name->location);
+    ptcl_snapshot_string(walker, &name->value);
+    // Names are written by transpiler as they are
+    walker->is_failed |= ptcl_snapshot_is_checking(walker) && name->value == NULL;
+}
+
+static void ptcl_snapshot_visit_type_target(ptcl_snapshot_walker *walker, ptcl_type **slot)
+{
+    ptcl_type *type = ptcl_snapshot_node(walker, slot, sizeof(ptcl_type), _Alignof(ptcl_type), ptcl_snapshot_type_kind);
+    if (type != NULL)
+    {
+        ptcl_snapshot_visit_type(walker, type);
+    }
+}
+
+static void ptcl_snapshot_visit_unread_type(ptcl_snapshot_walker *walker, ptcl_type *type)
+{
+    const bool is_unread = walker->is_unread;
+    walker->is_unread = true;
+    ptcl_snapshot_visit_type(walker, type);
+    walker->is_unread = is_unread;
+}
+
+static void ptcl_snapshot_visit_arguments(ptcl_snapshot_walker *walker, ptcl_argument **slot, size_t count)
+{
+    ptcl_argument *arguments = ptcl_snapshot_array(walker, slot, count, sizeof(ptcl_argument), _Alignof(ptcl_argument));
+    for (size_t i = 0; arguments != NULL && i < count; i++)
+    {
+        ptcl_snapshot_check_flags(walker, 1, &arguments[i].is_variadic);
+        if (walker->is_failed)
+        {
+            return;
+        }
+
+        // Type of variadic argument isn't set by every declaration, it is neither destroyed nor written
+        if (!arguments[i].is_variadic)
+        {
+            ptcl_snapshot_visit_type(walker, &arguments[i].type);
+        }
+
+        ptcl_snapshot_visit_name(walker, &arguments[i].name);
+        ptcl_snapshot_visit_expression(walker, &arguments[i].default_value);
+    }
+}
+
+static void ptcl_snapshot_visit_members(ptcl_snapshot_walker *walker, ptcl_type_member **slot, size_t count)
+{
+    ptcl_type_member *members = ptcl_snapshot_array(walker, slot, count, sizeof(ptcl_type_member), _Alignof(ptcl_type_member));
+    for (size_t i = 0; members != NULL && i < count; i++)
+    {
+        ptcl_snapshot_check_flags(walker, 1, &members[i].is_up);
+        ptcl_snapshot_visit_type(walker, &members[i].type);
+    }
+}
+
+static void ptcl_snapshot_visit_func_body_target(ptcl_snapshot_walker *walker, ptcl_func_body **slot)
+{
+    ptcl_func_body *body = ptcl_snapshot_node(walker, slot, sizeof(ptcl_func_body), _Alignof(ptcl_func_body), ptcl_snapshot_func_body_kind);
+    if (body != NULL)
+    {
+        ptcl_snapshot_visit_func_body(walker, body);
+    }
+}
+
+static void ptcl_snapshot_visit_comp_type(ptcl_snapshot_walker *walker, ptcl_type_comp_type **slot)
+{
+    ptcl_type_comp_type *comp_type = ptcl_snapshot_node(walker, slot, sizeof(ptcl_type_comp_type), _Alignof(ptcl_type_comp_type), ptcl_snapshot_comp_type_kind);
+    if (comp_type == NULL)
+    {
+        return;
+    }
+
+    ptcl_snapshot_check_flags(walker, 3, &comp_type->is_static, &comp_type->is_optional, &comp_type->is_any);
+    ptcl_snapshot_visit_comp_type(walker, &comp_type->invariant);
+    ptcl_snapshot_visit_name(walker, &comp_type->identifier);
+    ptcl_snapshot_visit_members(walker, &comp_type->types, comp_type->count);
+    ptcl_snapshot_visit_func_body_target(walker, &comp_type->functions);
+}
+
+static void ptcl_snapshot_visit_typedata(ptcl_snapshot_walker *walker, ptcl_type_typedata **slot)
+{
+    ptcl_type_typedata *typedata = ptcl_snapshot_node(walker, slot, sizeof(ptcl_type_typedata), _Alignof(ptcl_type_typedata), ptcl_snapshot_typedata_kind);
+    if (typedata != NULL)
+    {
+        ptcl_snapshot_check_flags(walker, 1, &typedata->is_static);
+        ptcl_snapshot_visit_name(walker, &typedata->identifier);
+        ptcl_snapshot_visit_arguments(walker, &typedata->members, typedata->count);
+    }
+}
+
+static void ptcl_snapshot_visit_type(ptcl_snapshot_walker *walker, ptcl_type *type)
+{
+    // Tags of loaded image are checked, so transpiler meets only known nodes
+    if (ptcl_snapshot_is_checking(walker) && (unsigned)type->type > ptcl_value_void_type)
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    ptcl_snapshot_check_flags(walker, 3, &type->is_primitive, &type->is_static, &type->is_const);
+    switch (type->type)
+    {
+    case ptcl_value_function_pointer_type:
+        ptcl_snapshot_check_flags(walker, 2, &type->function_pointer.is_variadic, &type->function_pointer.is_static_by_declaration);
+        if (!walker->is_unread)
+        {
+            ptcl_snapshot_require(walker, &type->function_pointer.return_type);
+        }
+
+        ptcl_snapshot_visit_type_target(walker, &type->function_pointer.return_type);
+        ptcl_snapshot_visit_arguments(walker, &type->function_pointer.arguments, type->function_pointer.count);
+        break;
+    case ptcl_value_object_type_type:
+        ptcl_snapshot_require(walker, &type->object_type.target);
+        ptcl_snapshot_visit_type_target(walker, &type->object_type.target);
+        break;
+    case ptcl_value_typedata_type:
+        ptcl_snapshot_require(walker, &type->typedata);
+        ptcl_snapshot_visit_typedata(walker, &type->typedata);
+        break;
+    case ptcl_value_array_type:
+        ptcl_snapshot_require(walker, &type->array.target);
+        ptcl_snapshot_visit_type_target(walker, &type->array.target);
+        break;
+    case ptcl_value_pointer_type:
+        ptcl_snapshot_check_flags(walker, 3, &type->pointer.is_any, &type->pointer.is_null, &type->pointer.is_const);
+        if (!walker->is_failed && !type->pointer.is_any && !type->pointer.is_null)
+        {
+            ptcl_snapshot_require(walker, &type->pointer.target);
+        }
+
+        ptcl_snapshot_visit_type_target(walker, &type->pointer.target);
+        break;
+    case ptcl_value_type_type:
+        ptcl_snapshot_require(walker, &type->comp_type);
+        ptcl_snapshot_visit_comp_type(walker, &type->comp_type);
+        break;
+    default:
+        break;
+    }
+}
+
+static void ptcl_snapshot_visit_expressions(ptcl_snapshot_walker *walker, ptcl_expression ***slot, size_t count)
+{
+    ptcl_expression **expressions = ptcl_snapshot_array(walker, slot, count, sizeof(ptcl_expression *), _Alignof(ptcl_expression *));
+    for (size_t i = 0; expressions != NULL && i < count; i++)
+    {
+        ptcl_snapshot_require(walker, &expressions[i]);
+        ptcl_snapshot_visit_expression(walker, &expressions[i]);
+    }
+}
+
+static void ptcl_snapshot_visit_identifier(ptcl_snapshot_walker *walker, ptcl_identifier *identifier)
+{
+    ptcl_snapshot_check_flags(walker, 1, &identifier->is_name);
+    if (walker->is_failed)
+    {
+        return;
+    }
+
+    if (identifier->is_name)
+    {
+        ptcl_snapshot_visit_name(walker, &identifier->name);
+    }
+    else
+    {
+        ptcl_snapshot_visit_expression(walker, &identifier->value);
+    }
+}
+
+static void ptcl_snapshot_visit_func_call(ptcl_snapshot_walker *walker, ptcl_statement_func_call *func_call)
+{
+    // Declaration is usually copy on stack of parser, transpiler only checks that it is set
+    ptcl_snapshot_weak(walker, &func_call->func_decl, sizeof(ptcl_statement_func_decl), _Alignof(ptcl_statement_func_decl));
+    ptcl_snapshot_check_flags(walker, 2, &func_call->is_built_in, &func_call->is_self_used);
+    ptcl_snapshot_visit_identifier(walker, &func_call->identifier);
+    ptcl_snapshot_visit_expressions(walker, &func_call->arguments, func_call->count);
+    // Type of call is only read by parser, transpiler writes type of expression
+    ptcl_snapshot_visit_unread_type(walker, &func_call->return_type);
+    ptcl_snapshot_visit_expression(walker, &func_call->built_in);
+}
+
+static void ptcl_snapshot_visit_func_decl(ptcl_snapshot_walker *walker, ptcl_statement_func_decl *func_decl)
+{
+    // Code of such body is only in incremental cache of its file
+    ptcl_snapshot_check_flags(walker, 1, &func_decl->is_cached);
+    if (walker->is_failed || func_decl->is_cached)
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    ptcl_snapshot_check_flags(walker, 4, &func_decl->is_variadic, &func_decl->is_self_const, &func_decl->with_self, &func_decl->is_constructor);
+    ptcl_snapshot_weak(walker, &func_decl->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    ptcl_snapshot_visit_name(walker, &func_decl->name);
+    ptcl_snapshot_visit_arguments(walker, &func_decl->arguments, func_decl->count);
+    ptcl_snapshot_visit_type(walker, &func_decl->return_type);
+    if (ptcl_statement_modifiers_flags_prototype(func_decl->modifiers))
+    {
+        ptcl_snapshot_clear(walker, &func_decl->func_body);
+    }
+    else
+    {
+        // Only body with static return type is lated, it is inlined by each call
+        if (!walker->is_failed && func_decl->return_type.is_static)
+        {
+            ptcl_snapshot_check_lated(walker, func_decl->index);
+        }
+
+        ptcl_snapshot_require(walker, &func_decl->func_body);
+        ptcl_snapshot_visit_func_body_target(walker, &func_decl->func_body);
+    }
+}
+
+static void ptcl_snapshot_visit_func_body(ptcl_snapshot_walker *walker, ptcl_func_body *body)
+{
+    ptcl_statement **statements = ptcl_snapshot_array(walker, &body->statements, body->count, sizeof(ptcl_statement *), _Alignof(ptcl_statement *));
+    for (size_t i = 0; statements != NULL && i < body->count; i++)
+    {
+        ptcl_snapshot_require(walker, &statements[i]);
+        ptcl_snapshot_visit_statement(walker, &statements[i]);
+    }
+
+    ptcl_snapshot_weak(walker, &body->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+}
+
+static void ptcl_snapshot_visit_statement(ptcl_snapshot_walker *walker, ptcl_statement **slot)
+{
+    ptcl_statement *statement = ptcl_snapshot_node(walker, slot, sizeof(ptcl_statement), _Alignof(ptcl_statement), ptcl_snapshot_statement_kind);
+    if (statement == NULL)
+    {
+        return;
+    }
+
+    if (ptcl_snapshot_is_checking(walker) && (unsigned)statement->type > ptcl_statement_import_type)
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    ptcl_snapshot_check_flags(walker, 1, &statement->is_original);
+    ptcl_snapshot_visit_location(walker, &statement->location);
+    ptcl_snapshot_weak(walker, &statement->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    ptcl_attribute *attributes = ptcl_snapshot_array(
+        walker, &statement->attributes.attributes, statement->attributes.count, sizeof(ptcl_attribute), _Alignof(ptcl_attribute));
+    for (size_t i = 0; attributes != NULL && i < statement->attributes.count; i++)
+    {
+        ptcl_snapshot_visit_name(walker, &attributes[i].name);
+    }
+
+    switch (statement->type)
+    {
+    case ptcl_statement_func_call_type:
+        ptcl_snapshot_visit_func_call(walker, &statement->func_call);
+        break;
+    case ptcl_statement_func_decl_type:
+        ptcl_snapshot_visit_func_decl(walker, &statement->func_decl);
+        break;
+    case ptcl_statement_typedata_decl_type:
+        ptcl_snapshot_check_flags(walker, 2, &statement->typedata_decl.is_prototype, &statement->typedata_decl.is_static);
+        ptcl_snapshot_visit_name(walker, &statement->typedata_decl.name);
+        ptcl_snapshot_visit_arguments(walker, &statement->typedata_decl.members, statement->typedata_decl.count);
+        break;
+    case ptcl_statement_type_decl_type:
+        ptcl_snapshot_visit_name(walker, &statement->type_decl.name);
+        ptcl_snapshot_visit_members(walker, &statement->type_decl.types, statement->type_decl.types_count);
+        ptcl_snapshot_visit_func_body_target(walker, &statement->type_decl.body);
+        ptcl_snapshot_visit_func_body_target(walker, &statement->type_decl.functions);
+        break;
+    case ptcl_statement_assign_type:
+        ptcl_snapshot_check_flags(walker, 2, &statement->assign.is_define, &statement->assign.with_type);
+        ptcl_snapshot_visit_identifier(walker, &statement->assign.identifier);
+        // Type is set only for definitions and explicit types
+        if (!walker->is_failed && (statement->assign.is_define || statement->assign.with_type))
+        {
+            ptcl_snapshot_visit_type(walker, &statement->assign.type);
+        }
+
+        ptcl_snapshot_visit_expression(walker, &statement->assign.value);
+        break;
+    case ptcl_statement_return_type:
+        ptcl_snapshot_visit_expression(walker, &statement->ret.value);
+        break;
+    case ptcl_statement_if_type:
+        ptcl_snapshot_require(walker, &statement->if_stat.condition);
+        ptcl_snapshot_visit_expression(walker, &statement->if_stat.condition);
+        ptcl_snapshot_visit_func_body(walker, &statement->if_stat.body);
+        ptcl_snapshot_check_flags(walker, 1, &statement->if_stat.with_else);
+        if (!walker->is_failed && statement->if_stat.with_else)
+        {
+            ptcl_snapshot_visit_func_body(walker, &statement->if_stat.else_body);
+        }
+
+        break;
+    case ptcl_statement_func_body_type:
+        ptcl_snapshot_visit_func_body(walker, &statement->body.body);
+        ptcl_snapshot_visit_arguments(walker, &statement->body.arguments, statement->body.arguments_count);
+        ptcl_snapshot_visit_expression(walker, &statement->body.caller);
+        ptcl_snapshot_visit_expression(walker, &statement->body.self);
+        // Call is only set for inserted body, transpiler gives its arguments to arguments of body
+        if (ptcl_snapshot_read(&statement->body.func_call.func_decl) != NULL)
+        {
+            ptcl_snapshot_visit_func_call(walker, &statement->body.func_call);
+            walker->is_failed |= statement->body.func_call.count < statement->body.arguments_count;
+        }
+
+        break;
+    default:
+        break;
+    }
+}
+
+static void ptcl_snapshot_visit_expression(ptcl_snapshot_walker *walker, ptcl_expression **slot)
+{
+    ptcl_expression *expression = ptcl_snapshot_node(walker, slot, sizeof(ptcl_expression), _Alignof(ptcl_expression), ptcl_snapshot_expression_kind);
+    if (expression == NULL)
+    {
+        return;
+    }
+
+    if (ptcl_snapshot_is_checking(walker) &&
+        ((unsigned)expression->type > ptcl_expression_in_token_type ||
+         (expression->type == ptcl_expression_binary_type && (unsigned)expression->binary.type > ptcl_binary_operator_less_equals_than_type) ||
+         (expression->type == ptcl_expression_unary_type && (unsigned)expression->unary.type > ptcl_binary_operator_less_equals_than_type)))
+    {
+        walker->is_failed = true;
+        return;
+    }
+
+    ptcl_snapshot_check_flags(walker, 3, &expression->is_original, &expression->with_type, &expression->is_slot);
+    ptcl_snapshot_visit_location(walker, &expression->location);
+    ptcl_snapshot_visit_type(walker, &expression->return_type);
+    switch (expression->type)
+    {
+    case ptcl_expression_func_call_type:
+    {
+        ptcl_snapshot_require(walker, &expression->func_call);
+        ptcl_statement_func_call *func_call = ptcl_snapshot_node(
+            walker, &expression->func_call, sizeof(ptcl_statement_func_call), _Alignof(ptcl_statement_func_call), ptcl_snapshot_func_call_kind);
+        if (func_call != NULL)
+        {
+            ptcl_snapshot_visit_func_call(walker, func_call);
+        }
+
+        break;
+    }
+    case ptcl_expression_array_type:
+    {
+        ptcl_snapshot_require(walker, &expression->array);
+        ptcl_expression_array *array = ptcl_snapshot_node(walker, &expression->array, sizeof(ptcl_expression_array), _Alignof(ptcl_expression_array), ptcl_snapshot_array_kind);
+        if (array != NULL)
+        {
+            ptcl_snapshot_visit_type(walker, &array->type);
+            ptcl_snapshot_visit_expressions(walker, &array->expressions, array->count);
+        }
+
+        break;
+    }
+    case ptcl_expression_string_type:
+        ptcl_snapshot_bytes(walker, &expression->string.value, expression->string.length + 1);
+        break;
+    case ptcl_expression_binary_type:
+        ptcl_snapshot_require(walker, &expression->binary.left);
+        ptcl_snapshot_require(walker, &expression->binary.right);
+        ptcl_snapshot_visit_expression(walker, &expression->binary.left);
+        ptcl_snapshot_visit_expression(walker, &expression->binary.right);
+        break;
+    case ptcl_expression_cast_type:
+    {
+        ptcl_snapshot_require(walker, &expression->cast);
+        ptcl_expression_cast *cast = ptcl_snapshot_node(walker, &expression->cast, sizeof(ptcl_expression_cast), _Alignof(ptcl_expression_cast), ptcl_snapshot_cast_kind);
+        if (cast != NULL)
+        {
+            ptcl_snapshot_check_flags(walker, 1, &cast->is_free);
+            ptcl_snapshot_require(walker, &cast->value);
+            ptcl_snapshot_visit_expression(walker, &cast->value);
+            ptcl_snapshot_visit_type(walker, &cast->type);
+        }
+
+        break;
+    }
+    case ptcl_expression_unary_type:
+        ptcl_snapshot_require(walker, &expression->unary.child);
+        ptcl_snapshot_visit_expression(walker, &expression->unary.child);
+        break;
+    case ptcl_expression_array_element_type:
+        ptcl_snapshot_require(walker, &expression->array_element.value);
+        ptcl_snapshot_require(walker, &expression->array_element.index);
+        ptcl_snapshot_visit_expression(walker, &expression->array_element.value);
+        ptcl_snapshot_visit_expression(walker, &expression->array_element.index);
+        break;
+    case ptcl_expression_dot_type:
+        ptcl_snapshot_check_flags(walker, 1, &expression->dot.is_name);
+        ptcl_snapshot_require(walker, &expression->dot.left);
+        ptcl_snapshot_visit_expression(walker, &expression->dot.left);
+        if (walker->is_failed)
+        {
+            break;
+        }
+
+        if (expression->dot.is_name)
+        {
+            ptcl_snapshot_visit_name(walker, &expression->dot.name);
+        }
+        else
+        {
+            ptcl_snapshot_require(walker, &expression->dot.right);
+            ptcl_snapshot_visit_expression(walker, &expression->dot.right);
+        }
+
+        break;
+    case ptcl_expression_ctor_type:
+    {
+        ptcl_snapshot_require(walker, &expression->ctor);
+        ptcl_expression_ctor *ctor = ptcl_snapshot_node(walker, &expression->ctor, sizeof(ptcl_expression_ctor), _Alignof(ptcl_expression_ctor), ptcl_snapshot_ctor_kind);
+        if (ctor != NULL)
+        {
+            ptcl_snapshot_visit_name(walker, &ctor->name);
+            ptcl_snapshot_visit_expressions(walker, &ctor->values, ctor->count);
+            ptcl_snapshot_visit_arguments(walker, &ctor->members, ctor->count);
+        }
+
+        break;
+    }
+    case ptcl_expression_if_type:
+        ptcl_snapshot_require(walker, &expression->if_expr.condition);
+        ptcl_snapshot_require(walker, &expression->if_expr.body);
+        ptcl_snapshot_require(walker, &expression->if_expr.else_body);
+        ptcl_snapshot_visit_expression(walker, &expression->if_expr.condition);
+        ptcl_snapshot_visit_expression(walker, &expression->if_expr.body);
+        ptcl_snapshot_visit_expression(walker, &expression->if_expr.else_body);
+        break;
+    case ptcl_expression_word_type:
+        ptcl_snapshot_visit_name(walker, &expression->word);
+        break;
+    case ptcl_expression_variable_type:
+        ptcl_snapshot_weak(walker, &expression->variable.root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+        ptcl_snapshot_visit_name(walker, &expression->variable.name);
+        break;
+    case ptcl_expression_object_type_type:
+        ptcl_snapshot_visit_type(walker, &expression->object_type.type);
+        break;
+    case ptcl_expression_in_statement_type:
+        ptcl_snapshot_require(walker, &expression->internal_statement);
+        ptcl_snapshot_visit_statement(walker, &expression->internal_statement);
+        break;
+    case ptcl_expression_in_token_type:
+        ptcl_snapshot_string(walker, &expression->internal_token.value);
+        ptcl_snapshot_visit_location(walker, &expression->internal_token.location);
+        break;
+    case ptcl_expression_lated_func_body_type:
+        ptcl_snapshot_check_lated(walker, expression->lated_body.index);
+        break;
+    default:
+        break;
+    }
+}
+
+static void ptcl_snapshot_visit_variable(ptcl_snapshot_walker *walker, ptcl_parser_variable *variable)
+{
+    ptcl_snapshot_check_flags(walker, 7, &variable->is_built_in, &variable->is_syntax_word, &variable->is_function_pointer,
+                              &variable->is_syntax_variable, &variable->is_syntax_anonymous, &variable->is_used,
+                              &variable->is_out_of_scope);
+    ptcl_snapshot_visit_name(walker, &variable->name);
+    ptcl_snapshot_weak(walker, &variable->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    // Variables are given to transpiler with result, but it reads neither their types nor values of built-in ones.
+    // Parser reads them from prelude, values of variables out of scope are already released
+    if (walker->is_prelude)
+    {
+        ptcl_snapshot_visit_type(walker, &variable->type);
+        if (!walker->is_failed && !variable->is_out_of_scope)
+        {
+            ptcl_snapshot_visit_expression(walker, &variable->built_in);
+        }
+        else
+        {
+            ptcl_snapshot_clear(walker, &variable->built_in);
+        }
+    }
+    else
+    {
+        ptcl_snapshot_visit_unread_type(walker, &variable->type);
+        ptcl_snapshot_clear(walker, &variable->built_in);
+    }
+}
+
+static void ptcl_snapshot_visit_variables(ptcl_snapshot_walker *walker, ptcl_parser_variable *variables, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (!ptcl_snapshot_is_checking(walker))
+    {
+        ptcl_snapshot_add_object(walker, variables, count * sizeof(ptcl_parser_variable));
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ptcl_snapshot_visit_variable(walker, &variables[i]);
+    }
+}
+
+static void ptcl_snapshot_visit_tokens_state(ptcl_snapshot_walker *walker, ptcl_parser_tokens_state *state)
+{
+    // Position is set by parser, when it enters tokens
+    ptcl_snapshot_check_flags(walker, 1, &state->is_free);
+    ptcl_token *tokens = ptcl_snapshot_array(walker, &state->tokens, state->count, sizeof(ptcl_token), _Alignof(ptcl_token));
+    for (size_t i = 0; tokens != NULL && i < state->count && !walker->is_failed; i++)
+    {
+        walker->is_failed |= ptcl_snapshot_is_checking(walker) && (unsigned)tokens[i].type > ptcl_token_import_type;
+        ptcl_snapshot_check_flags(walker, 1, &tokens[i].is_free_value);
+        ptcl_snapshot_string(walker, &tokens[i].value);
+        ptcl_snapshot_visit_location(walker, &tokens[i].location);
+    }
+
+    if (walker->is_failed || ptcl_snapshot_read(&state->partners) == NULL)
+    {
+        return;
+    }
+
+    // Pair of bracket is found by adding partner to its position
+    size_t *partners = ptcl_snapshot_array(walker, &state->partners, state->count, sizeof(size_t), _Alignof(size_t));
+    for (size_t i = 0; partners != NULL && ptcl_snapshot_is_checking(walker) && i < state->count; i++)
+    {
+        walker->is_failed |= partners[i] >= state->count - i;
+    }
+}
+
+static void ptcl_snapshot_visit_syntax(ptcl_snapshot_walker *walker, ptcl_parser_syntax *syntax)
+{
+    ptcl_snapshot_check_flags(walker, 1, &syntax->is_out_of_scope);
+    ptcl_snapshot_check_lated(walker, syntax->index);
+    ptcl_snapshot_visit_name(walker, &syntax->name);
+    ptcl_snapshot_weak(walker, &syntax->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    ptcl_parser_syntax_node *nodes = ptcl_snapshot_array(walker, &syntax->nodes, syntax->count, sizeof(ptcl_parser_syntax_node), _Alignof(ptcl_parser_syntax_node));
+    for (size_t i = 0; nodes != NULL && i < syntax->count && !walker->is_failed; i++)
+    {
+        ptcl_parser_syntax_node *node = &nodes[i];
+        if (ptcl_snapshot_is_checking(walker) &&
+            ((unsigned)node->type > ptcl_parser_syntax_node_value_type ||
+             (node->type == ptcl_parser_syntax_node_word_type && (unsigned)node->word.type > ptcl_token_import_type)))
+        {
+            walker->is_failed = true;
+            return;
+        }
+
+        switch (node->type)
+        {
+        case ptcl_parser_syntax_node_word_type:
+            ptcl_snapshot_visit_name(walker, &node->word.name);
+            break;
+        case ptcl_parser_syntax_node_variable_type:
+            ptcl_snapshot_check_flags(walker, 1, &node->variable.is_variadic);
+            ptcl_snapshot_string(walker, &node->variable.name);
+            // Type of variadic variable can be left zeroed
+            ptcl_snapshot_visit_unread_type(walker, &node->variable.type);
+            break;
+        case ptcl_parser_syntax_node_object_type_type:
+            ptcl_snapshot_visit_type(walker, &node->object_type);
+            break;
+        case ptcl_parser_syntax_node_value_type:
+            ptcl_snapshot_visit_expression(walker, &node->value.value);
+            ptcl_snapshot_visit_tokens_state(walker, &node->value.state);
+            break;
+        }
+    }
+}
+
+static void ptcl_snapshot_visit_instance_function(ptcl_snapshot_walker *walker, ptcl_parser_function *function)
+{
+    ptcl_snapshot_check_flags(walker, 2, &function->is_built_in, &function->is_out_of_scope);
+    // Built-in functions are tables of parser, bound ones point to code of process, which has saved prelude
+    walker->is_failed |= ptcl_snapshot_read(&function->bind) != NULL;
+    ptcl_snapshot_visit_name(walker, &function->name);
+    ptcl_snapshot_weak(walker, &function->root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    ptcl_snapshot_visit_func_decl(walker, &function->func);
+}
+
+// Instances of prelude are read by parser of each file, their roots are kept, so scopes of them are found.
+// Top-level ones belong to root of prelude, which is saved with it
+static void ptcl_snapshot_visit_prelude(ptcl_snapshot_walker *walker, ptcl_parser_prelude *prelude)
+{
+    ptcl_parser_result *result = &prelude->result;
+    walker->is_prelude = true;
+    walker->lated_states_count = result->lated_states_count;
+    ptcl_snapshot_check_flags(walker, 1, &result->is_critical);
+    walker->is_failed = walker->is_failed || result->is_critical || result->errors_count > 0;
+    // Parser gives its own configuration, interner and arena to set prelude
+    ptcl_snapshot_clear(walker, &result->configuration);
+    ptcl_snapshot_clear(walker, &result->errors);
+    ptcl_snapshot_clear(walker, &result->arena);
+    ptcl_snapshot_clear(walker, &result->types);
+    ptcl_snapshot_clear(walker, &result->stats);
+    ptcl_snapshot_clear(walker, &result->prelude);
+    ptcl_snapshot_require(walker, &prelude->root);
+    ptcl_snapshot_visit_func_body_target(walker, &prelude->root);
+    ptcl_snapshot_visit_func_body(walker, &result->body);
+
+    ptcl_parser_syntax *syntaxes = ptcl_snapshot_array(walker, &result->syntaxes, result->syntaxes_count, sizeof(ptcl_parser_syntax), _Alignof(ptcl_parser_syntax));
+    for (size_t i = 0; syntaxes != NULL && i < result->syntaxes_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_visit_syntax(walker, &syntaxes[i]);
+    }
+
+    ptcl_parser_typedata *typedatas = ptcl_snapshot_array(walker, &result->typedatas, result->typedatas_count, sizeof(ptcl_parser_typedata), _Alignof(ptcl_parser_typedata));
+    for (size_t i = 0; typedatas != NULL && i < result->typedatas_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_check_flags(walker, 1, &typedatas[i].is_out_of_scope);
+        ptcl_snapshot_weak(walker, &typedatas[i].root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+        ptcl_snapshot_require(walker, &typedatas[i].typedata);
+        ptcl_snapshot_visit_typedata(walker, &typedatas[i].typedata);
+    }
+
+    ptcl_parser_comp_type *comp_types = ptcl_snapshot_array(walker, &result->comp_types, result->comp_types_count, sizeof(ptcl_parser_comp_type), _Alignof(ptcl_parser_comp_type));
+    for (size_t i = 0; comp_types != NULL && i < result->comp_types_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_check_flags(walker, 2, &comp_types[i].is_auto_static, &comp_types[i].is_out_of_scope);
+        ptcl_snapshot_visit_name(walker, &comp_types[i].identifier);
+        ptcl_snapshot_weak(walker, &comp_types[i].root, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+        ptcl_snapshot_require(walker, &comp_types[i].comp_type);
+        ptcl_snapshot_visit_comp_type(walker, &comp_types[i].comp_type);
+        ptcl_snapshot_visit_comp_type(walker, &comp_types[i].static_type);
+    }
+
+    ptcl_parser_function *functions = ptcl_snapshot_array(walker, &result->functions, result->functions_count, sizeof(ptcl_parser_function), _Alignof(ptcl_parser_function));
+    for (size_t i = 0; functions != NULL && i < result->functions_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_visit_instance_function(walker, &functions[i]);
+    }
+
+    ptcl_parser_variable *variables = ptcl_snapshot_array(walker, &result->variables, result->variables_count, sizeof(ptcl_parser_variable), _Alignof(ptcl_parser_variable));
+    for (size_t i = 0; variables != NULL && i < result->variables_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_visit_variable(walker, &variables[i]);
+    }
+
+    ptcl_parser_tokens_state *states = ptcl_snapshot_array(walker, &result->lated_states, result->lated_states_count, sizeof(ptcl_parser_tokens_state), _Alignof(ptcl_parser_tokens_state));
+    for (size_t i = 0; states != NULL && i < result->lated_states_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_visit_tokens_state(walker, &states[i]);
+    }
+
+    ptcl_parser_this_s_pair *pairs = ptcl_snapshot_array(walker, &result->this_pairs, result->this_pairs_count, sizeof(ptcl_parser_this_s_pair), _Alignof(ptcl_parser_this_s_pair));
+    for (size_t i = 0; pairs != NULL && i < result->this_pairs_count && !walker->is_failed; i++)
+    {
+        ptcl_snapshot_check_lated(walker, pairs[i].index);
+        ptcl_snapshot_weak(walker, &pairs[i].body, sizeof(ptcl_func_body), _Alignof(ptcl_func_body));
+    }
+}
+
+static int ptcl_snapshot_compare_objects(const void *left, const void *right)
+{
+    const uintptr_t first = ((const ptcl_snapshot_object *)left)->address;
+    const uintptr_t second = ((const ptcl_snapshot_object *)right)->address;
+    return first < second ? -1 : first > second;
+}
+
+static int ptcl_snapshot_compare_slots(const void *left, const void *right)
+{
+    const uintptr_t first = ((const ptcl_snapshot_slot *)left)->address;
+    const uintptr_t second = ((const ptcl_snapshot_slot *)right)->address;
+    return first < second ? -1 : first > second;
+}
+
+// Objects are sorted and don't overlap after merge. NULL if address isn't inside of any one
+static ptcl_snapshot_object *ptcl_snapshot_find_object(ptcl_snapshot_walker *walker, uintptr_t address)
+{
+    size_t low = 0;
+    size_t high = walker->objects_count;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (walker->objects[middle].address <= address)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low == 0 || address >= walker->objects[low - 1].end)
+    {
+        return NULL;
+    }
+
+    return &walker->objects[low - 1];
+}
+
+static uint64_t ptcl_snapshot_hash_string(ptcl_snapshot_slot *slot)
+{
+    const unsigned char *bytes = (const unsigned char *)slot->target;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < slot->size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+// Gives offsets to strings from start, equal strings get one offset. Returns end of strings
+static size_t ptcl_snapshot_intern_strings(ptcl_snapshot_walker *walker, size_t start)
+{
+    size_t capacity = PTCL_SNAPSHOT_DEFAULT_CAPACITY;
+    while (capacity < walker->slots_count * 2)
+    {
+        capacity *= 2;
+    }
+
+    // Indices of slots plus one, zero is empty place
+    size_t *table = calloc(capacity, sizeof(size_t));
+    if (table == NULL)
+    {
+        walker->is_failed = true;
+        return start;
+    }
+
+    size_t end = start;
+    for (size_t i = 0; i < walker->slots_count; i++)
+    {
+        ptcl_snapshot_slot *slot = &walker->slots[i];
+        if (slot->type != ptcl_snapshot_string_slot)
+        {
+            continue;
+        }
+
+        size_t index = (size_t)ptcl_snapshot_hash_string(slot) & (capacity - 1);
+        while (table[index] != 0)
+        {
+            const ptcl_snapshot_slot *other = &walker->slots[table[index] - 1];
+            if (other->size == slot->size && memcmp((void *)other->target, (void *)slot->target, slot->size) == 0)
+            {
+                break;
+            }
+
+            index = (index + 1) & (capacity - 1);
+        }
+
+        if (table[index] != 0)
+        {
+            slot->offset = walker->slots[table[index] - 1].offset;
+            continue;
+        }
+
+        table[index] = i + 1;
+        slot->offset = end;
+        end += slot->size;
+    }
+
+    free(table);
+    return end;
+}
+
+// Image of program, or of prelude, if it is given. Then result is result of prelude
+static char *ptcl_snapshot_build(ptcl_snapshot_walker *walker, ptcl_parser_result *result, ptcl_parser_prelude *prelude, uint64_t key, size_t *size)
+{
+    if (prelude != NULL)
+    {
+        ptcl_snapshot_add_object(walker, prelude, sizeof(ptcl_parser_prelude));
+        ptcl_snapshot_visit_prelude(walker, prelude);
+    }
+    else
+    {
+        ptcl_snapshot_add_object(walker, &result->body, sizeof(ptcl_func_body));
+        ptcl_snapshot_visit_func_body(walker, &result->body);
+        ptcl_snapshot_visit_variables(walker, result->variables, result->variables_count);
+    }
+
+    if (walker->is_failed)
+    {
+        return NULL;
+    }
+
+    qsort(walker->objects, walker->objects_count, sizeof(ptcl_snapshot_object), ptcl_snapshot_compare_objects);
+    size_t count = 0;
+    for (size_t i = 0; i < walker->objects_count; i++)
+    {
+        const ptcl_snapshot_object object = walker->objects[i];
+        if (count > 0 && object.address < walker->objects[count - 1].end)
+        {
+            ptcl_snapshot_object *last = &walker->objects[count - 1];
+            last->end = object.end > last->end ? object.end : last->end;
+            continue;
+        }
+
+        walker->objects[count++] = object;
+    }
+
+    walker->objects_count = count;
+    size_t offset = ptcl_snapshot_align(sizeof(ptcl_snapshot_header));
+    for (size_t i = 0; i < walker->objects_count; i++)
+    {
+        walker->objects[i].offset = offset;
+        offset = ptcl_snapshot_align(offset + (walker->objects[i].end - walker->objects[i].address));
+    }
+
+    // Released scopes and declarations point to it, so they stay set and distinct from saved ones
+    const size_t detached = offset;
+    const size_t detached_size = sizeof(ptcl_statement_func_decl) > sizeof(ptcl_func_body) ? sizeof(ptcl_statement_func_decl) : sizeof(ptcl_func_body);
+    offset = ptcl_snapshot_align(offset + detached_size);
+
+    // Slot can be reached from several owners
+    qsort(walker->slots, walker->slots_count, sizeof(ptcl_snapshot_slot), ptcl_snapshot_compare_slots);
+    count = 0;
+    for (size_t i = 0; i < walker->slots_count; i++)
+    {
+        if (count == 0 || walker->slots[i].address != walker->slots[count - 1].address)
+        {
+            walker->slots[count++] = walker->slots[i];
+        }
+    }
+
+    walker->slots_count = count;
+    const size_t relocations = ptcl_snapshot_align(ptcl_snapshot_intern_strings(walker, offset));
+    size_t relocations_count = 0;
+    for (size_t i = 0; i < walker->slots_count; i++)
+    {
+        relocations_count += walker->slots[i].type != ptcl_snapshot_clear_slot;
+    }
+
+    *size = relocations + relocations_count * sizeof(uint64_t);
+    char *image = walker->is_failed ? NULL : calloc(*size, 1);
+    if (image == NULL)
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < walker->objects_count; i++)
+    {
+        const ptcl_snapshot_object object = walker->objects[i];
+        memcpy(image + object.offset, (void *)object.address, object.end - object.address);
+    }
+
+    uint64_t *relocation = (uint64_t *)(image + relocations);
+    for (size_t i = 0; i < walker->slots_count; i++)
+    {
+        const ptcl_snapshot_slot slot = walker->slots[i];
+        const ptcl_snapshot_object *owner = ptcl_snapshot_find_object(walker, slot.address);
+        const ptcl_snapshot_object *target = slot.type == ptcl_snapshot_string_slot ? NULL : ptcl_snapshot_find_object(walker, slot.target);
+        if (owner == NULL || (slot.type == ptcl_snapshot_node_slot && target == NULL))
+        {
+            free(image);
+            return NULL;
+        }
+
+        uintptr_t value = 0;
+        switch (slot.type)
+        {
+        case ptcl_snapshot_node_slot:
+        case ptcl_snapshot_weak_slot:
+            value = target != NULL ? target->offset + (slot.target - target->address) : detached;
+            break;
+        case ptcl_snapshot_string_slot:
+            memcpy(image + slot.offset, (void *)slot.target, slot.size);
+            value = slot.offset;
+            break;
+        case ptcl_snapshot_clear_slot:
+            break;
+        }
+
+        const size_t position = owner->offset + (slot.address - owner->address);
+        memcpy(image + position, &value, sizeof(value));
+        if (slot.type != ptcl_snapshot_clear_slot)
+        {
+            *relocation++ = position;
+        }
+    }
+
+    const ptcl_snapshot_object *body = ptcl_snapshot_find_object(walker, (uintptr_t)&result->body);
+    const ptcl_snapshot_object *variables = ptcl_snapshot_find_object(walker, (uintptr_t)result->variables);
+    const ptcl_snapshot_object *owner = prelude != NULL ? ptcl_snapshot_find_object(walker, (uintptr_t)prelude) : NULL;
+    ptcl_snapshot_header header = {
+        .magic = PTCL_SNAPSHOT_MAGIC,
+        .version = PTCL_SNAPSHOT_VERSION,
+        .layout = ptcl_snapshot_layout(),
+        .size = *size,
+        .body = body->offset + ((uintptr_t)&result->body - body->address),
+        .variables = variables != NULL ? variables->offset + ((uintptr_t)result->variables - variables->address) : 0,
+        .variables_count = variables != NULL ? result->variables_count : 0,
+        .relocations = relocations,
+        .relocations_count = relocations_count,
+        .prelude = owner != NULL ? owner->offset + ((uintptr_t)prelude - owner->address) : 0,
+        .key = key};
+    memcpy(image, &header, sizeof(header));
+    header.checksum = ptcl_snapshot_checksum(image, *size);
+    memcpy(image, &header, sizeof(header));
+    return image;
+}
+
+static bool ptcl_snapshot_write(ptcl_parser_result *result, ptcl_parser_prelude *prelude, uint64_t key, char *path)
+{
+    ptcl_snapshot_walker walker = {0};
+    size_t size = 0;
+    char *image = ptcl_snapshot_build(&walker, result, prelude, key, &size);
+    free(walker.objects);
+    free(walker.slots);
+    free(walker.visits);
+    if (image == NULL)
+    {
+        return false;
+    }
+
+    const bool is_written = ptcl_file_write_atomic(path, image, size);
+    free(image);
+    return is_written;
+}
+
+bool ptcl_snapshot_save(ptcl_parser_result *result, char *path)
+{
+    if (result->is_critical || result->errors_count > 0)
+    {
+        return false;
+    }
+
+    return ptcl_snapshot_write(result, NULL, 0, path);
+}
+
+bool ptcl_snapshot_save_prelude(ptcl_parser_prelude *prelude, uint64_t key, char *path)
+{
+    return ptcl_snapshot_write(&prelude->result, prelude, key, path);
+}
+
+// Every offset is checked before it is used, so broken file is refused instead of being read out of image
+static bool ptcl_snapshot_relocate(ptcl_snapshot_walker *walker, char *image, size_t size, ptcl_snapshot_header header, bool is_prelude, uint64_t key)
+{
+    if (size < sizeof(header) || size % sizeof(uint64_t) != 0 || header.magic != PTCL_SNAPSHOT_MAGIC ||
+        header.version != PTCL_SNAPSHOT_VERSION || header.layout != ptcl_snapshot_layout() || header.size != size ||
+        (header.prelude != 0) != is_prelude || header.key != key)
+    {
+        return false;
+    }
+
+    const uint64_t checksum = header.checksum;
+    header.checksum = 0;
+    memcpy(image, &header, sizeof(header));
+    if (ptcl_snapshot_checksum(image, size) != checksum)
+    {
+        return false;
+    }
+
+    const uint64_t nodes_start = ptcl_snapshot_align(sizeof(header));
+    const uint64_t nodes_end = header.relocations;
+    if (nodes_end > size || nodes_end < nodes_start || nodes_end % sizeof(uint64_t) != 0 ||
+        header.relocations_count != (size - nodes_end) / sizeof(uint64_t) ||
+        header.body % _Alignof(ptcl_func_body) != 0 || header.body < nodes_start || header.body > nodes_end ||
+        nodes_end - header.body < sizeof(ptcl_func_body) ||
+        header.variables % _Alignof(ptcl_parser_variable) != 0 || header.variables > nodes_end ||
+        header.variables_count > (nodes_end - header.variables) / sizeof(ptcl_parser_variable) ||
+        (header.variables_count > 0 && header.variables < nodes_start) ||
+        (is_prelude && (header.prelude % _Alignof(ptcl_parser_prelude) != 0 || header.prelude < nodes_start ||
+                        header.prelude > nodes_end || nodes_end - header.prelude < sizeof(ptcl_parser_prelude))))
+    {
+        return false;
+    }
+
+    // One bit for each word of nodes and strings
+    const size_t words = (size_t)(nodes_end / sizeof(uint64_t) + 63) / 64;
+    walker->relocated = calloc(words, sizeof(uint64_t));
+    walker->reached = calloc(words, sizeof(uint64_t));
+    if (walker->relocated == NULL || walker->reached == NULL)
+    {
+        return false;
+    }
+
+    const uint64_t *relocations = (const uint64_t *)(image + nodes_end);
+    for (uint64_t i = 0; i < header.relocations_count; i++)
+    {
+        const uint64_t position = relocations[i];
+        if (position % sizeof(uintptr_t) != 0 || position < nodes_start || position > nodes_end - sizeof(uintptr_t))
+        {
+            return false;
+        }
+
+        const size_t index = (size_t)(position / sizeof(uint64_t));
+        const uint64_t bit = 1ULL << (index % 64);
+        if ((walker->relocated[index / 64] & bit) != 0)
+        {
+            return false;
+        }
+
+        walker->relocated[index / 64] |= bit;
+        uintptr_t value;
+        memcpy(&value, image + position, sizeof(value));
+        if (value < nodes_start || value >= nodes_end)
+        {
+            return false;
+        }
+
+        value += (uintptr_t)image;
+        memcpy(image + position, &value, sizeof(value));
+    }
+
+    // Same walk as by saving checks types of pointers, their targets and tags of nodes
+    walker->image = image;
+    walker->end = (size_t)nodes_end;
+    if (is_prelude)
+    {
+        ptcl_snapshot_visit_prelude(walker, (ptcl_parser_prelude *)(image + header.prelude));
+    }
+    else
+    {
+        ptcl_snapshot_visit_func_body(walker, (ptcl_func_body *)(image + header.body));
+        ptcl_snapshot_visit_variables(walker, (ptcl_parser_variable *)(image + header.variables), (size_t)header.variables_count);
+    }
+
+    return !walker->is_failed && walker->reached_count == header.relocations_count;
+}
+
+static ptcl_snapshot *ptcl_snapshot_map(char *path, bool is_prelude, uint64_t key)
+{
+    size_t size = 0;
+    char *image = ptcl_file_map(path, &size);
+    if (image == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_snapshot_header header = {0};
+    memcpy(&header, image, size < sizeof(header) ? size : sizeof(header));
+    ptcl_snapshot_walker walker = {0};
+    ptcl_snapshot *snapshot = malloc(sizeof(ptcl_snapshot));
+    const bool is_loaded = snapshot != NULL && ptcl_snapshot_relocate(&walker, image, size, header, is_prelude, key);
+    free(walker.visits);
+    free(walker.relocated);
+    free(walker.reached);
+    if (!is_loaded)
+    {
+        free(snapshot);
+        ptcl_file_unmap(image, size);
+        return NULL;
+    }
+
+    snapshot->image = image;
+    snapshot->size = size;
+    snapshot->header = header;
+    return snapshot;
+}
+
+ptcl_snapshot *ptcl_snapshot_load(char *path)
+{
+    return ptcl_snapshot_map(path, false, 0);
+}
+
+ptcl_snapshot *ptcl_snapshot_load_prelude(char *path, uint64_t key)
+{
+    return ptcl_snapshot_map(path, true, key);
+}
+
+ptcl_parser_result ptcl_snapshot_get_result(ptcl_snapshot *snapshot)
+{
+    ptcl_parser_result result = {0};
+    memcpy(&result.body, snapshot->image + snapshot->header.body, sizeof(ptcl_func_body));
+    result.variables_count = (size_t)snapshot->header.variables_count;
+    result.variables = result.variables_count > 0 ? (ptcl_parser_variable *)(snapshot->image + snapshot->header.variables) : NULL;
+    return result;
+}
+
+ptcl_parser_prelude ptcl_snapshot_get_prelude(ptcl_snapshot *snapshot)
+{
+    ptcl_parser_prelude prelude;
+    memcpy(&prelude, snapshot->image + snapshot->header.prelude, sizeof(prelude));
+    return prelude;
+}
+
+void ptcl_snapshot_destroy(ptcl_snapshot *snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return;
+    }
+
+    ptcl_file_unmap(snapshot->image, snapshot->size);
+    free(snapshot);
+}
@@ -6,10 +6,33 @@
 typedef struct ptcl_string_buffer
 {
     char *buffer;
+    size_t length;
     size_t capacity;
     size_t position;
 } ptcl_string_buffer;
 
+// Capacity grows geometrically and is never given back, so buffer reused for many outputs stops allocating
+static bool ptcl_string_buffer_reserve(ptcl_string_buffer *string_buffer, size_t count)
+{
+    const size_t required = string_buffer->length + count + 1;
+    if (required <= string_buffer->capacity)
+    {
+        return true;
+    }
+
+    size_t capacity = string_buffer->capacity * 2;
+    capacity = capacity < required ? required : capacity;
+    char *buffer = realloc(string_buffer->buffer, capacity * sizeof(char));
+    if (buffer == NULL)
+    {
+        return false;
+    }
+
+    string_buffer->buffer = buffer;
+    string_buffer->capacity = capacity;
+    return true;
+}
+
 ptcl_string_buffer *ptcl_string_buffer_create()
 {
     ptcl_string_buffer *string_buffer = malloc(sizeof(ptcl_string_buffer));
@@ -18,7 +41,7 @@ ptcl_string_buffer *ptcl_string_buffer_create()
         return NULL;
     }
 
-    char *buffer = malloc(sizeof(char));
+    char *buffer = malloc(PTCL_STRING_BUFFER_DEFAULT_CAPACITY * sizeof(char));
     if (buffer == NULL)
     {
         free(string_buffer);
@@ -26,7 +49,8 @@ ptcl_string_buffer *ptcl_string_buffer_create()
     }
 
     string_buffer->buffer = buffer;
-    string_buffer->capacity = 0;
+    string_buffer->length = 0;
+    string_buffer->capacity = PTCL_STRING_BUFFER_DEFAULT_CAPACITY;
     string_buffer->position = 0;
     string_buffer->buffer[0] = '\0';
     return string_buffer;
@@ -39,69 +63,61 @@ bool ptcl_string_buffer_append_str(ptcl_string_buffer *string_buffer, char *valu
         return true;
     }
 
-    char *buffer = realloc(string_buffer->buffer, (string_buffer->capacity + count + 1) * sizeof(char));
-    if (buffer == NULL)
+    if (!ptcl_string_buffer_reserve(string_buffer, count))
     {
         return false;
     }
 
-    string_buffer->buffer = buffer;
-    memcpy(string_buffer->buffer + string_buffer->capacity, value, count);
-    string_buffer->capacity += count;
-    string_buffer->buffer[string_buffer->capacity] = '\0';
+    memcpy(string_buffer->buffer + string_buffer->length, value, count);
+    string_buffer->length += count;
+    string_buffer->buffer[string_buffer->length] = '\0';
     return true;
 }
 
 bool ptcl_string_buffer_append(ptcl_string_buffer *string_buffer, char value)
 {
-    char *buffer = realloc(string_buffer->buffer, (string_buffer->capacity + 2) * sizeof(char));
-    if (buffer == NULL)
+    if (!ptcl_string_buffer_reserve(string_buffer, 1))
     {
         return false;
     }
 
-    string_buffer->buffer = buffer;
-    string_buffer->buffer[string_buffer->capacity++] = value;
-    string_buffer->buffer[string_buffer->capacity] = '\0';
+    string_buffer->buffer[string_buffer->length++] = value;
+    string_buffer->buffer[string_buffer->length] = '\0';
     return true;
 }
 
 bool ptcl_string_buffer_insert(ptcl_string_buffer *string_buffer, char value)
 {
-    if (string_buffer->position > string_buffer->capacity)
+    if (string_buffer->position > string_buffer->length)
     {
         return false;
     }
 
-    if (string_buffer->position == string_buffer->capacity)
+    if (string_buffer->position == string_buffer->length)
     {
         const bool result = ptcl_string_buffer_append(string_buffer, value);
         string_buffer->position++;
         return result;
     }
 
-    char *buffer = realloc(string_buffer->buffer, (string_buffer->capacity + 2) * sizeof(char));
-    if (buffer == NULL)
+    if (!ptcl_string_buffer_reserve(string_buffer, 1))
     {
         return false;
     }
 
-    string_buffer->buffer = buffer;
-    for (size_t i = string_buffer->capacity; i > string_buffer->position; i--)
-    {
-        string_buffer->buffer[i] = string_buffer->buffer[i - 1];
-    }
-
+    memmove(string_buffer->buffer + string_buffer->position + 1,
+            string_buffer->buffer + string_buffer->position,
+            string_buffer->length - string_buffer->position);
     string_buffer->buffer[string_buffer->position] = value;
-    string_buffer->capacity++;
-    string_buffer->buffer[string_buffer->capacity] = '\0';
+    string_buffer->length++;
+    string_buffer->buffer[string_buffer->length] = '\0';
     string_buffer->position++;
     return true;
 }
 
 bool ptcl_string_buffer_insert_str(ptcl_string_buffer *string_buffer, char *value, size_t count)
 {
-    if (string_buffer->position > string_buffer->capacity)
+    if (string_buffer->position > string_buffer->length)
     {
         return false;
     }
@@ -111,25 +127,22 @@ bool ptcl_string_buffer_insert_str(ptcl_string_buffer *string_buffer, char *valu
         return true;
     }
 
-    size_t new_capacity = string_buffer->capacity + count + 1;
-    char *buffer = realloc(string_buffer->buffer, new_capacity * sizeof(char));
-    if (buffer == NULL)
+    if (!ptcl_string_buffer_reserve(string_buffer, count))
     {
         return false;
     }
 
-    string_buffer->buffer = buffer;
-    if (string_buffer->position < string_buffer->capacity)
+    if (string_buffer->position < string_buffer->length)
     {
         memmove(string_buffer->buffer + string_buffer->position + count,
                 string_buffer->buffer + string_buffer->position,
-                string_buffer->capacity - string_buffer->position);
+                string_buffer->length - string_buffer->position);
     }
 
     memcpy(string_buffer->buffer + string_buffer->position, value, count);
-    string_buffer->capacity += count;
+    string_buffer->length += count;
     string_buffer->position += count;
-    string_buffer->buffer[string_buffer->capacity] = '\0';
+    string_buffer->buffer[string_buffer->length] = '\0';
     return true;
 }
 
@@ -147,17 +160,22 @@ char *ptcl_string_buffer_copy_and_clear(ptcl_string_buffer *string_buffer)
 
 size_t ptcl_string_buffer_length(ptcl_string_buffer *string_buffer)
 {
-    return string_buffer->capacity;
+    return string_buffer->length;
+}
+
+char *ptcl_string_buffer_get_data(ptcl_string_buffer *string_buffer)
+{
+    return string_buffer->buffer;
 }
 
 bool ptcl_string_buffer_is_empty(ptcl_string_buffer *string_buffer)
 {
-    if (string_buffer->capacity == 0)
+    if (string_buffer->length == 0)
     {
         return true;
     }
 
-    for (size_t i = 0; i < string_buffer->capacity; i++)
+    for (size_t i = 0; i < string_buffer->length; i++)
     {
         if (string_buffer->buffer[i] == ' ')
         {
@@ -172,7 +190,7 @@ bool ptcl_string_buffer_is_empty(ptcl_string_buffer *string_buffer)
 
 void ptcl_string_buffer_reset_position(ptcl_string_buffer *string_buffer)
 {
-    string_buffer->position = string_buffer->capacity;
+    string_buffer->position = string_buffer->length;
 }
 
 size_t ptcl_string_buffer_get_position(ptcl_string_buffer *string_buffer)
@@ -182,9 +200,9 @@ size_t ptcl_string_buffer_get_position(ptcl_string_buffer *string_buffer)
 
 void ptcl_string_buffer_set_position(ptcl_string_buffer *string_buffer, size_t position)
 {
-    if (position > string_buffer->capacity)
+    if (position > string_buffer->length)
     {
-        string_buffer->position = string_buffer->capacity;
+        string_buffer->position = string_buffer->length;
     }
     else
     {
@@ -194,9 +212,8 @@ void ptcl_string_buffer_set_position(ptcl_string_buffer *string_buffer, size_t p
 
 void ptcl_string_buffer_clear(ptcl_string_buffer *string_buffer)
 {
-    string_buffer->capacity = 0;
+    string_buffer->length = 0;
     string_buffer->position = 0;
-    string_buffer->buffer = realloc(string_buffer->buffer, sizeof(char));
     string_buffer->buffer[0] = '\0';
 }
 
@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <ptcl_thread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct ptcl_thread
+{
+    ptcl_thread_routine routine;
+    void *argument;
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+} ptcl_thread;
+
+typedef struct ptcl_mutex
+{
+#ifdef _WIN32
+    CRITICAL_SECTION section;
+#else
+    pthread_mutex_t handle;
+#endif
+} ptcl_mutex;
+
+#ifdef _WIN32
+static DWORD WINAPI ptcl_thread_start(LPVOID argument)
+{
+    ptcl_thread *thread = argument;
+    thread->routine(thread->argument);
+    return 0;
+}
+#else
+static void *ptcl_thread_start(void *argument)
+{
+    ptcl_thread *thread = argument;
+    thread->routine(thread->argument);
+    return NULL;
+}
+#endif
+
+ptcl_thread *ptcl_thread_create(ptcl_thread_routine routine, void *argument)
+{
+    ptcl_thread *thread = malloc(sizeof(ptcl_thread));
+    if (thread == NULL)
+    {
+        return NULL;
+    }
+
+    thread->routine = routine;
+    thread->argument = argument;
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, ptcl_thread_start, thread, 0, NULL);
+    if (thread->handle == NULL)
+    {
+        free(thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, ptcl_thread_start, thread) != 0)
+    {
+        free(thread);
+        return NULL;
+    }
+#endif
+
+    return thread;
+}
+
+void ptcl_thread_join(ptcl_thread *thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+size_t ptcl_thread_hardware_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#endif
+}
+
+ptcl_mutex *ptcl_mutex_create()
+{
+    ptcl_mutex *mutex = malloc(sizeof(ptcl_mutex));
+    if (mutex == NULL)
+    {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex->section);
+#else
+    if (pthread_mutex_init(&mutex->handle, NULL) != 0)
+    {
+        free(mutex);
+        return NULL;
+    }
+#endif
+
+    return mutex;
+}
+
+void ptcl_mutex_lock(ptcl_mutex *mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&mutex->section);
+#else
+    pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void ptcl_mutex_unlock(ptcl_mutex *mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex->section);
+#else
+    pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+void ptcl_mutex_destroy(ptcl_mutex *mutex)
+{
+    if (mutex == NULL)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    DeleteCriticalSection(&mutex->section);
+#else
+    pthread_mutex_destroy(&mutex->handle);
+#endif
+    free(mutex);
+}
@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_trace.h>
+#include <ptcl_arena.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+typedef struct ptcl_trace_event
+{
+    const char *category;
+    char *name;
+    uint64_t start;
+    uint64_t duration;
+} ptcl_trace_event;
+
+typedef struct ptcl_trace
+{
+    size_t thread_id;
+    ptcl_arena *names;
+    ptcl_trace_event *events;
+    size_t count;
+    size_t capacity;
+} ptcl_trace;
+
+ptcl_trace *ptcl_trace_create(size_t thread_id)
+{
+    ptcl_trace *trace = malloc(sizeof(ptcl_trace));
+    if (trace == NULL)
+    {
+        return NULL;
+    }
+
+    trace->names = ptcl_arena_create(PTCL_ARENA_DEFAULT_CHUNK_SIZE / 4);
+    trace->events = malloc(PTCL_TRACE_DEFAULT_CAPACITY * sizeof(ptcl_trace_event));
+    if (trace->names == NULL || trace->events == NULL)
+    {
+        ptcl_arena_destroy(trace->names);
+        free(trace->events);
+        free(trace);
+        return NULL;
+    }
+
+    trace->thread_id = thread_id;
+    trace->count = 0;
+    trace->capacity = PTCL_TRACE_DEFAULT_CAPACITY;
+    return trace;
+}
+
+uint64_t ptcl_trace_timestamp()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+#endif
+}
+
+bool ptcl_trace_add(ptcl_trace *trace, const char *category, const char *name, const char *suffix, uint64_t start)
+{
+    const uint64_t end = ptcl_trace_timestamp();
+    if (trace->count == trace->capacity)
+    {
+        size_t capacity = trace->capacity * 2;
+        ptcl_trace_event *events = realloc(trace->events, capacity * sizeof(ptcl_trace_event));
+        if (events == NULL)
+        {
+            return false;
+        }
+
+        trace->events = events;
+        trace->capacity = capacity;
+    }
+
+    const size_t name_length = strlen(name);
+    const size_t suffix_length = suffix != NULL ? strlen(suffix) : 0;
+    char *copy = ptcl_arena_allocate(trace->names, name_length + suffix_length + 2);
+    if (copy == NULL)
+    {
+        return false;
+    }
+
+    memcpy(copy, name, name_length);
+    if (suffix != NULL)
+    {
+        copy[name_length] = ' ';
+        memcpy(copy + name_length + 1, suffix, suffix_length);
+        copy[name_length + suffix_length + 1] = '\0';
+    }
+    else
+    {
+        copy[name_length] = '\0';
+    }
+
+    trace->events[trace->count++] = (ptcl_trace_event){
+        .category = category,
+        .name = copy,
+        .start = start,
+        .duration = end - start};
+    return true;
+}
+
+size_t ptcl_trace_count(ptcl_trace *trace)
+{
+    return trace->count;
+}
+
+static void ptcl_trace_write_string(FILE *output, const char *value)
+{
+    fputc('"', output);
+    for (; *value != '\0'; value++)
+    {
+        const unsigned char character = (unsigned char)*value;
+        if (character == '"' || character == '\\')
+        {
+            fputc('\\', output);
+            fputc(character, output);
+        }
+        else if (character < 0x20)
+        {
+            fprintf(output, "\\u%04x", character);
+        }
+        else
+        {
+            fputc(character, output);
+        }
+    }
+
+    fputc('"', output);
+}
+
+bool ptcl_trace_write(ptcl_trace **traces, size_t count, FILE *output)
+{
+    // Timestamps are relative to the earliest event, chrome://tracing expects microseconds
+    uint64_t origin = UINT64_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; j < traces[i]->count; j++)
+        {
+            if (traces[i]->events[j].start < origin)
+            {
+                origin = traces[i]->events[j].start;
+            }
+        }
+    }
+
+    fputs("{\"traceEvents\":[", output);
+    bool is_first = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        ptcl_trace *trace = traces[i];
+        for (size_t j = 0; j < trace->count; j++)
+        {
+            ptcl_trace_event event = trace->events[j];
+            fputs(is_first ? "\n" : ",\n", output);
+            is_first = false;
+
+            fputs("{\"name\":", output);
+            ptcl_trace_write_string(output, event.name);
+            fputs(",\"cat\":", output);
+            ptcl_trace_write_string(output, event.category);
+            fprintf(output, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%zu}",
+                    (double)(event.start - origin) / 1000.0,
+                    (double)event.duration / 1000.0,
+                    trace->thread_id);
+        }
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", output);
+    return ferror(output) == 0;
+}
+
+void ptcl_trace_destroy(ptcl_trace *trace)
+{
+    if (trace == NULL)
+    {
+        return;
+    }
+
+    free(trace->events);
+    ptcl_arena_destroy(trace->names);
+    free(trace);
+}
@@ -8,14 +8,18 @@ typedef struct ptcl_transpiler
     ptcl_string_buffer *string_buffer;
     ptcl_transpiler_variable *variables;
     size_t variables_count;
+    size_t variables_capacity;
     ptcl_transpiler_function *inner_functions;
     size_t inner_functions_count;
+    size_t inner_functions_capacity;
     ptcl_func_body *root;
     ptcl_func_body *main_root;
     ptcl_transpiler_anonymous *anonymouses;
     size_t anonymous_count;
+    size_t anonymous_capacity;
     ptcl_transpiler_replaced *replaced;
     size_t replaced_count;
+    size_t replaced_capacity;
     size_t temp_count;
     bool from_position;
     bool in_inner;
@@ -26,8 +30,33 @@ typedef struct ptcl_transpiler
     int inserted_bodies_depth;
     ptcl_transpiler_caller *callers;
     size_t callers_count;
+    size_t callers_capacity;
+    ptcl_transpiler_stats *stats;
+    ptcl_parser_profile *profile;
+    ptcl_trace *trace;
+    ptcl_incremental *incremental;
 } ptcl_transpiler;
 
+// Arrays grow geometrically and keep capacity after reset, so reused transpiler doesn't allocate them again
+static bool ptcl_transpiler_reserve(void **items, size_t *capacity, size_t count, size_t size)
+{
+    if (count < *capacity)
+    {
+        return true;
+    }
+
+    const size_t new_capacity = *capacity == 0 ? PTCL_TRANSPILER_DEFAULT_CAPACITY : *capacity * 2;
+    void *buffer = realloc(*items, new_capacity * size);
+    if (buffer == NULL)
+    {
+        return false;
+    }
+
+    *items = buffer;
+    *capacity = new_capacity;
+    return true;
+}
+
 static bool ptcl_transpiler_is_add_member(ptcl_type type)
 {
     return type.type != ptcl_value_any_type && !type.is_static;
@@ -188,14 +217,31 @@ ptcl_transpiler *ptcl_transpiler_create(ptcl_parser_result result)
         return NULL;
     }
 
+    transpiler->variables = NULL;
+    transpiler->variables_capacity = 0;
+    transpiler->inner_functions = NULL;
+    transpiler->inner_functions_capacity = 0;
+    transpiler->anonymouses = NULL;
+    transpiler->anonymous_capacity = 0;
+    transpiler->replaced = NULL;
+    transpiler->replaced_capacity = 0;
+    transpiler->callers = NULL;
+    transpiler->callers_capacity = 0;
+    transpiler->stats = NULL;
+    transpiler->profile = NULL;
+    transpiler->trace = NULL;
+    transpiler->incremental = NULL;
+    ptcl_transpiler_reset(transpiler, result);
+    return transpiler;
+}
+
+void ptcl_transpiler_reset(ptcl_transpiler *transpiler, ptcl_parser_result result)
+{
     transpiler->result = result;
     transpiler->in_inner = false;
-    transpiler->variables = NULL;
     transpiler->variables_count = 0;
-    transpiler->inner_functions = NULL;
     transpiler->inner_functions_count = 0;
     transpiler->root = NULL;
-    transpiler->anonymouses = NULL;
     transpiler->anonymous_count = 0;
     transpiler->temp_count = 0;
     transpiler->start = -1;
@@ -204,15 +250,38 @@ ptcl_transpiler *ptcl_transpiler_create(ptcl_parser_result result)
     transpiler->from_position = false;
     transpiler->last_stat_position = 0;
     transpiler->inserted_bodies_depth = 0;
-    transpiler->replaced = NULL;
     transpiler->replaced_count = 0;
-    transpiler->callers = NULL;
     transpiler->callers_count = 0;
-    return transpiler;
+    ptcl_string_buffer_clear(transpiler->string_buffer);
+}
+
+void ptcl_transpiler_set_stats(ptcl_transpiler *transpiler, ptcl_transpiler_stats *stats)
+{
+    transpiler->stats = stats;
+}
+
+void ptcl_transpiler_set_profile(ptcl_transpiler *transpiler, ptcl_parser_profile *profile)
+{
+    transpiler->profile = profile;
+}
+
+void ptcl_transpiler_set_trace(ptcl_transpiler *transpiler, ptcl_trace *trace)
+{
+    transpiler->trace = trace;
+}
+
+void ptcl_transpiler_set_incremental(ptcl_transpiler *transpiler, ptcl_incremental *incremental)
+{
+    transpiler->incremental = incremental;
 }
 
 char *ptcl_transpiler_transpile(ptcl_transpiler *transpiler)
 {
+    if (transpiler->stats != NULL)
+    {
+        *transpiler->stats = (ptcl_transpiler_stats){0};
+    }
+
     transpiler->main_root = &transpiler->result.body;
     ptcl_transpiler_add_func_body(transpiler, NULL, transpiler->result.body, false, false);
 
@@ -224,6 +293,13 @@ char *ptcl_transpiler_transpile(ptcl_transpiler *transpiler)
     }
 
     char *result = ptcl_string_buffer_copy_and_clear(transpiler->string_buffer);
+    if (transpiler->stats != NULL)
+    {
+        transpiler->stats->temp_variables_count = transpiler->temp_count;
+        transpiler->stats->anonymous_count = transpiler->anonymous_count;
+        transpiler->stats->output_bytes = result != NULL ? strlen(result) : 0;
+    }
+
     for (size_t i = 0; i < transpiler->anonymous_count; i++)
     {
         free(transpiler->anonymouses[i].alias);
@@ -345,78 +421,66 @@ bool ptcl_transpiler_is_caller(ptcl_transpiler *transpiler, ptcl_expression *exp
 
 bool ptcl_transpiler_add_variable(ptcl_transpiler *transpiler, ptcl_transpiler_variable variable)
 {
-    ptcl_transpiler_variable *buffer = realloc(transpiler->variables, (transpiler->variables_count + 1) * sizeof(ptcl_transpiler_variable));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->variables, &transpiler->variables_capacity, transpiler->variables_count, sizeof(ptcl_transpiler_variable)))
     {
         return false;
     }
 
-    transpiler->variables = buffer;
     transpiler->variables[transpiler->variables_count++] = variable;
     return true;
 }
 
 bool ptcl_transpiler_add_variable_f(ptcl_transpiler *transpiler, ptcl_name name, ptcl_type type, bool is_inner, ptcl_func_body *root)
 {
-    ptcl_transpiler_variable *buffer = realloc(transpiler->variables, (transpiler->variables_count + 1) * sizeof(ptcl_transpiler_variable));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->variables, &transpiler->variables_capacity, transpiler->variables_count, sizeof(ptcl_transpiler_variable)))
     {
         return false;
     }
 
-    transpiler->variables = buffer;
     transpiler->variables[transpiler->variables_count++] = ptcl_transpiler_variable_create(name, type, is_inner, root);
     return true;
 }
 
 bool ptcl_transpiler_add_inner_func(ptcl_transpiler *transpiler, ptcl_name name, ptcl_func_body *root)
 {
-    ptcl_transpiler_function *buffer = realloc(transpiler->inner_functions, (transpiler->inner_functions_count + 1) * sizeof(ptcl_transpiler_function));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->inner_functions, &transpiler->inner_functions_capacity, transpiler->inner_functions_count, sizeof(ptcl_transpiler_function)))
     {
         return false;
     }
 
-    transpiler->inner_functions = buffer;
     transpiler->inner_functions[transpiler->inner_functions_count++] = ptcl_transpiler_function_create(name, root);
     return true;
 }
 
 bool ptcl_transpiler_add_anonymous(ptcl_transpiler *transpiler, char *original_name, char *alias, ptcl_func_body *root)
 {
-    ptcl_transpiler_anonymous *buffer = realloc(transpiler->anonymouses, (transpiler->anonymous_count + 1) * sizeof(ptcl_transpiler_anonymous));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->anonymouses, &transpiler->anonymous_capacity, transpiler->anonymous_count, sizeof(ptcl_transpiler_anonymous)))
     {
         return false;
     }
 
-    transpiler->anonymouses = buffer;
     transpiler->anonymouses[transpiler->anonymous_count++] = ptcl_transpiler_anonymous_create(original_name, alias, root);
     return true;
 }
 
 bool ptcl_transpiler_add_replaced(ptcl_transpiler *transpiler, ptcl_name name, ptcl_name replaced_name, ptcl_func_body *root)
 {
-    ptcl_transpiler_replaced *buffer = realloc(transpiler->replaced, (transpiler->replaced_count + 1) * sizeof(ptcl_transpiler_replaced));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->replaced, &transpiler->replaced_capacity, transpiler->replaced_count, sizeof(ptcl_transpiler_replaced)))
     {
         return false;
     }
 
-    transpiler->replaced = buffer;
     transpiler->replaced[transpiler->replaced_count++] = ptcl_transpiler_replaced_name_create(name, replaced_name, root);
     return true;
 }
 
 bool ptcl_transpiler_add_caller(ptcl_transpiler *transpiler, ptcl_func_body *root, ptcl_expression *caller, size_t start, size_t count)
 {
-    ptcl_transpiler_caller *buffer = realloc(transpiler->callers, (transpiler->callers_count + 1) * sizeof(ptcl_transpiler_caller));
-    if (buffer == NULL)
+    if (!ptcl_transpiler_reserve((void **)&transpiler->callers, &transpiler->callers_capacity, transpiler->callers_count, sizeof(ptcl_transpiler_caller)))
     {
         return false;
     }
 
-    transpiler->callers = buffer;
     transpiler->callers[transpiler->callers_count++] = ptcl_transpiler_caller_create(root, caller, start, count);
     return true;
 }
@@ -503,6 +567,11 @@ void ptcl_transpiler_add_func_body(ptcl_transpiler *transpiler, ptcl_statement_f
 
 void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *statement, bool is_func_body)
 {
+    PTCL_STATS_ADD(transpiler->stats, statements_count, 1);
+    ptcl_parser_profile_entry *profile_entry = statement->origin != 0 && transpiler->profile != NULL
+                                                   ? ptcl_parser_profile_at(transpiler->profile, statement->origin - 1)
+                                                   : NULL;
+    const size_t profile_start = ptcl_string_buffer_length(transpiler->string_buffer);
     transpiler->from_position = transpiler->in_inner ? transpiler->from_position : false;
     transpiler->last_stat_position =
         transpiler->from_position
@@ -523,7 +592,7 @@ void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *
         break;
     case ptcl_statement_assign_type:
     {
-        const ptcl_parser_variable *variable_parser = NULL;
+        ptcl_parser_variable *variable_parser = NULL;
         if (ptcl_parser_try_get_variable_by_id(&transpiler->result, statement->assign.variable_id, &variable_parser) && variable_parser->type.is_static)
         {
             break;
@@ -553,10 +622,17 @@ void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *
             }
         }
 
+        // Variable of imported module is defined by compilation of module itself, importer declares it
+        const bool is_extern = statement->assign.is_define && ptcl_statement_modifiers_flags_prototype(statement->assign.modifiers);
+        if (is_extern)
+        {
+            ptcl_transpiler_append_word_s(transpiler, "extern");
+        }
+
         if (statement->assign.is_define)
         {
             bool added = false;
-            if (transpiler->inserted_bodies_depth > 0)
+            if (transpiler->inserted_bodies_depth > 0 && !is_extern)
             {
                 ptcl_transpiler_caller *caller = NULL;
                 if (!ptcl_transpiler_is_caller(transpiler, statement->assign.value, &caller))
@@ -607,8 +683,12 @@ void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *
             }
         }
 
-        ptcl_transpiler_append_character(transpiler, '=');
-        ptcl_transpiler_add_expression(transpiler, statement->assign.value, false);
+        if (!is_extern)
+        {
+            ptcl_transpiler_append_character(transpiler, '=');
+            ptcl_transpiler_add_expression(transpiler, statement->assign.value, false);
+        }
+
         ptcl_transpiler_append_character(transpiler, ';');
         break;
     }
@@ -680,7 +760,6 @@ void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *
         if (transpiler->from_position)
         {
             transpiler->from_position = last;
-            return;
         }
 
         break;
@@ -715,6 +794,11 @@ void ptcl_transpiler_add_statement(ptcl_transpiler *transpiler, ptcl_statement *
     case ptcl_statement_none_type:
         break;
     }
+
+    if (profile_entry != NULL)
+    {
+        profile_entry->output_bytes += ptcl_string_buffer_length(transpiler->string_buffer) - profile_start;
+    }
 }
 
 static void ptcl_transpiler_add_argument(ptcl_transpiler *transpiler, ptcl_argument argument)
@@ -757,6 +841,8 @@ static void ptcl_transpiler_add_func_signature(ptcl_transpiler *transpiler, ptcl
                 ptcl_transpiler_append_character(transpiler, ',');
             }
 
+            // Captured variable is passed by pointer, which target isn't static
+            variable.type.is_static = false;
             ptcl_type pointer = ptcl_type_create_pointer(&variable.type, false);
             ptcl_argument argument = ptcl_argument_create(pointer, variable.name);
             ptcl_transpiler_add_argument(transpiler, argument);
@@ -835,6 +921,44 @@ static void ptcl_transpiler_add_func_signature(ptcl_transpiler *transpiler, ptcl
     }
 }
 
+// Top-level body is appended to end of buffer, so its code is stored as is. Code, which has generated names
+// or is placed outside of body, depends on other bodies and isn't stored
+static void ptcl_transpiler_add_incremental_body(ptcl_transpiler *transpiler, ptcl_statement_func_decl func_decl)
+{
+    bool with_stdlib;
+    if (func_decl.is_cached)
+    {
+        char *code = ptcl_incremental_find(transpiler->incremental, func_decl.fingerprint, &with_stdlib);
+        if (code != NULL)
+        {
+            ptcl_string_buffer_append_str(transpiler->string_buffer, code, strlen(code));
+            transpiler->add_stdlib |= with_stdlib;
+        }
+
+        return;
+    }
+
+    const size_t start = ptcl_string_buffer_length(transpiler->string_buffer);
+    const size_t temp_count = transpiler->temp_count;
+    const size_t anonymous_count = transpiler->anonymous_count;
+    const size_t inner_functions_count = transpiler->inner_functions_count;
+    const size_t replaced_count = transpiler->replaced_count;
+    const size_t callers_count = transpiler->callers_count;
+    const bool add_stdlib = transpiler->add_stdlib;
+    transpiler->add_stdlib = false;
+    ptcl_transpiler_add_func_body(transpiler, NULL, *func_decl.func_body, true, false);
+    with_stdlib = transpiler->add_stdlib;
+    transpiler->add_stdlib |= add_stdlib;
+    if (transpiler->temp_count == temp_count && transpiler->anonymous_count == anonymous_count &&
+        transpiler->inner_functions_count == inner_functions_count && transpiler->replaced_count == replaced_count &&
+        transpiler->callers_count == callers_count && !transpiler->from_position)
+    {
+        char *data = ptcl_string_buffer_get_data(transpiler->string_buffer);
+        const size_t length = ptcl_string_buffer_length(transpiler->string_buffer);
+        ptcl_incremental_store(transpiler->incremental, func_decl.fingerprint, data + start, length - start, with_stdlib);
+    }
+}
+
 static void ptcl_transpiler_add_func_decl_body(ptcl_transpiler *transpiler, ptcl_statement_func_decl func_decl, size_t start, size_t position, size_t length, size_t previous_start)
 {
     bool is_root = false;
@@ -857,6 +981,10 @@ static void ptcl_transpiler_add_func_decl_body(ptcl_transpiler *transpiler, ptcl
     {
         ptcl_transpiler_append_character(transpiler, ';');
     }
+    else if (is_root && transpiler->incremental != NULL && func_decl.fingerprint != 0)
+    {
+        ptcl_transpiler_add_incremental_body(transpiler, func_decl);
+    }
     else
     {
         ptcl_transpiler_add_func_body(transpiler, NULL, *func_decl.func_body, true, !is_root);
@@ -891,6 +1019,7 @@ void ptcl_transpiler_add_func_decl(ptcl_transpiler *transpiler, ptcl_statement_f
         return;
     }
 
+    const uint64_t trace_start = PTCL_TRACE_START(transpiler->trace);
     const size_t original_buffer_pos = ptcl_string_buffer_get_position(transpiler->string_buffer);
     if (transpiler->in_inner)
     {
@@ -910,6 +1039,7 @@ void ptcl_transpiler_add_func_decl(ptcl_transpiler *transpiler, ptcl_statement_f
     const size_t length = ptcl_string_buffer_length(transpiler->string_buffer);
     ptcl_transpiler_add_func_signature(transpiler, func_decl, name, self);
     ptcl_transpiler_add_func_decl_body(transpiler, func_decl, start, position, length, previous_start);
+    PTCL_TRACE_ADD(transpiler->trace, "transpiler", "function", name.value, trace_start);
 }
 
 bool ptcl_transpiler_add_func_call(ptcl_transpiler *transpiler, ptcl_statement_func_call func_call)
@@ -962,7 +1092,7 @@ static void ptcl_transpiler_add_dot_expression(ptcl_transpiler *transpiler, ptcl
     bool is_special_func_call = expression->dot.left->return_type.type == ptcl_value_type_type;
     if (is_special_func_call)
     {
-        ptcl_statement_func_call func_call = expression->dot.right->func_call;
+        ptcl_statement_func_call func_call = *expression->dot.right->func_call;
         char *name = ptcl_transpiler_get_func_name_in_type(
             expression->dot.left->return_type.comp_type->identifier.value,
             func_call.identifier.name.value, expression->dot.left->return_type.is_static);
@@ -1020,16 +1150,34 @@ static void ptcl_transpiler_add_dot_expression(ptcl_transpiler *transpiler, ptcl
 
 void ptcl_transpiler_add_expression(ptcl_transpiler *transpiler, ptcl_expression *expression, bool specify_type)
 {
+    PTCL_STATS_ADD(transpiler->stats, expressions_count, 1);
     switch (expression->type)
     {
+    case ptcl_expression_string_type:
+        if (!expression->return_type.is_static)
+        {
+            ptcl_expression *characters = ptcl_expression_string_to_array(expression);
+            if (characters != NULL)
+            {
+                ptcl_transpiler_add_expression(transpiler, characters, specify_type);
+                ptcl_expression_destroy(characters);
+            }
+
+            break;
+        }
+
+        ptcl_transpiler_append_character(transpiler, '\"');
+        ptcl_transpiler_append_word(transpiler, expression->string.value);
+        ptcl_transpiler_append_character(transpiler, '\"');
+        break;
     case ptcl_expression_array_type:
         if (expression->return_type.is_static && ptcl_type_get_target(expression->return_type)->type == ptcl_value_character_type)
         {
             ptcl_transpiler_append_character(transpiler, '\"');
             // -1 because of end of line symbol
-            for (size_t i = 0; i < expression->array.count - 1; i++)
+            for (size_t i = 0; i < expression->array->count - 1; i++)
             {
-                ptcl_transpiler_append_character(transpiler, expression->array.expressions[i]->character);
+                ptcl_transpiler_append_character(transpiler, expression->array->expressions[i]->character);
             }
 
             ptcl_transpiler_append_character(transpiler, '\"');
@@ -1045,11 +1193,11 @@ void ptcl_transpiler_add_expression(ptcl_transpiler *transpiler, ptcl_expression
         }
 
         ptcl_transpiler_append_character(transpiler, '{');
-        for (size_t i = 0; i < expression->array.count; i++)
+        for (size_t i = 0; i < expression->array->count; i++)
         {
-            ptcl_transpiler_add_expression(transpiler, expression->array.expressions[i], false);
+            ptcl_transpiler_add_expression(transpiler, expression->array->expressions[i], false);
 
-            if (i != expression->array.count - 1)
+            if (i != expression->array->count - 1)
             {
                 ptcl_transpiler_append_character(transpiler, ',');
             }
@@ -1107,9 +1255,9 @@ void ptcl_transpiler_add_expression(ptcl_transpiler *transpiler, ptcl_expression
         break;
     case ptcl_expression_cast_type:
         ptcl_transpiler_append_character(transpiler, '(');
-        ptcl_transpiler_add_type_and_name(transpiler, expression->cast.type, ptcl_name_empty, NULL, false, false);
+        ptcl_transpiler_add_type_and_name(transpiler, expression->cast->type, ptcl_name_empty, NULL, false, false);
         ptcl_transpiler_append_character(transpiler, ')');
-        ptcl_transpiler_add_expression(transpiler, expression->cast.value, false);
+        ptcl_transpiler_add_expression(transpiler, expression->cast->value, false);
         break;
     case ptcl_expression_unary_type:
         ptcl_transpiler_add_binary_type(transpiler, expression->unary.type);
@@ -1158,17 +1306,17 @@ void ptcl_transpiler_add_expression(ptcl_transpiler *transpiler, ptcl_expression
         if (specify_type)
         {
             ptcl_transpiler_append_character(transpiler, '(');
-            ptcl_transpiler_add_name(transpiler, expression->ctor.name, false);
+            ptcl_transpiler_add_name(transpiler, expression->ctor->name, false);
             ptcl_transpiler_append_character(transpiler, ')');
         }
 
         ptcl_transpiler_append_character(transpiler, '{');
-        for (size_t i = 0; i < expression->ctor.count; i++)
+        for (size_t i = 0; i < expression->ctor->count; i++)
         {
-            if (ptcl_transpiler_is_add_member(expression->ctor.members[i].type))
+            if (ptcl_transpiler_is_add_member(expression->ctor->members[i].type))
             {
-                ptcl_transpiler_add_expression(transpiler, expression->ctor.values[i], true);
-                if (i != expression->ctor.count - 1)
+                ptcl_transpiler_add_expression(transpiler, expression->ctor->values[i], true);
+                if (i != expression->ctor->count - 1)
                 {
                     ptcl_transpiler_append_character(transpiler, ',');
                 }
@@ -1181,7 +1329,7 @@ void ptcl_transpiler_add_expression(ptcl_transpiler *transpiler, ptcl_expression
         ptcl_transpiler_add_dot_expression(transpiler, expression);
         break;
     case ptcl_expression_func_call_type:
-        ptcl_transpiler_add_func_call(transpiler, expression->func_call);
+        ptcl_transpiler_add_func_call(transpiler, *expression->func_call);
         break;
     case ptcl_expression_null_type:
         ptcl_transpiler_append_word_s(transpiler, "NULL");
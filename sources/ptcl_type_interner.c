@@ -0,0 +1,416 @@
+#include <stdint.h>
+#include <ptcl_type_interner.h>
+#include <ptcl_arena.h>
+
+typedef struct ptcl_type_interner
+{
+    struct ptcl_type_interner *shared;
+    ptcl_arena *arena;
+    ptcl_type **items;
+    size_t count;
+    size_t capacity;
+} ptcl_type_interner;
+
+static inline size_t ptcl_type_interner_mix(size_t hash, size_t value)
+{
+    return (hash ^ value) * (size_t)0x100000001b3ULL;
+}
+
+static size_t ptcl_type_interner_hash(ptcl_type *type)
+{
+    size_t hash = (size_t)0xcbf29ce484222325ULL;
+    hash = ptcl_type_interner_mix(hash, type->type);
+    hash = ptcl_type_interner_mix(hash, type->is_static | (type->is_const << 1));
+    switch (type->type)
+    {
+    case ptcl_value_pointer_type:
+        hash = ptcl_type_interner_mix(hash, (uintptr_t)type->pointer.target);
+        hash = ptcl_type_interner_mix(hash, type->pointer.is_any | (type->pointer.is_null << 1) | (type->pointer.is_const << 2));
+        break;
+    case ptcl_value_array_type:
+        hash = ptcl_type_interner_mix(hash, (uintptr_t)type->array.target);
+        hash = ptcl_type_interner_mix(hash, type->array.count);
+        break;
+    case ptcl_value_object_type_type:
+        hash = ptcl_type_interner_mix(hash, (uintptr_t)type->object_type.target);
+        break;
+    case ptcl_value_type_type:
+        hash = ptcl_type_interner_mix(hash, (uintptr_t)type->comp_type);
+        break;
+    case ptcl_value_typedata_type:
+        hash = ptcl_type_interner_mix(hash, (uintptr_t)type->typedata);
+        break;
+    case ptcl_value_function_pointer_type:
+        // Members aren't canonical, so only their shape is hashed
+        hash = ptcl_type_interner_mix(hash, type->function_pointer.return_type->type);
+        hash = ptcl_type_interner_mix(hash, type->function_pointer.count);
+        break;
+    default:
+        break;
+    }
+
+    return hash;
+}
+
+static bool ptcl_type_interner_equals(ptcl_type *left, ptcl_type *right);
+
+// Members of function pointers are owned by them, so they are compared by content. Names are compared too,
+// because transpiler writes them, and default values aren't compared, so types with them are never shared
+static bool ptcl_type_interner_member_equals(ptcl_type *left, ptcl_type *right)
+{
+    if (left == right)
+    {
+        return true;
+    }
+
+    if (left->type != right->type || left->is_static != right->is_static || left->is_const != right->is_const)
+    {
+        return false;
+    }
+
+    switch (left->type)
+    {
+    case ptcl_value_pointer_type:
+        if (left->pointer.is_any != right->pointer.is_any ||
+            left->pointer.is_null != right->pointer.is_null ||
+            left->pointer.is_const != right->pointer.is_const ||
+            (left->pointer.target == NULL) != (right->pointer.target == NULL))
+        {
+            return false;
+        }
+
+        return left->pointer.target == NULL || ptcl_type_interner_member_equals(left->pointer.target, right->pointer.target);
+    case ptcl_value_array_type:
+        return left->array.count == right->array.count && ptcl_type_interner_member_equals(left->array.target, right->array.target);
+    case ptcl_value_object_type_type:
+        return ptcl_type_interner_member_equals(left->object_type.target, right->object_type.target);
+    default:
+        return ptcl_type_interner_equals(left, right);
+    }
+}
+
+static bool ptcl_type_interner_function_equals(ptcl_type_functon_pointer_type left, ptcl_type_functon_pointer_type right)
+{
+    if (left.count != right.count ||
+        left.is_variadic != right.is_variadic ||
+        left.is_static_by_declaration != right.is_static_by_declaration ||
+        !ptcl_type_interner_member_equals(left.return_type, right.return_type))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < left.count; i++)
+    {
+        ptcl_argument argument = left.arguments[i];
+        ptcl_argument other = right.arguments[i];
+        if (argument.default_value != NULL || other.default_value != NULL ||
+            argument.is_variadic != other.is_variadic ||
+            !ptcl_name_compare(argument.name, other.name) ||
+            !ptcl_type_interner_member_equals(&argument.type, &other.type))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Targets are already canonical here, so nested types are compared by their addresses
+static bool ptcl_type_interner_equals(ptcl_type *left, ptcl_type *right)
+{
+    if (left->type != right->type || left->is_static != right->is_static || left->is_const != right->is_const)
+    {
+        return false;
+    }
+
+    switch (left->type)
+    {
+    case ptcl_value_pointer_type:
+        return left->pointer.target == right->pointer.target &&
+               left->pointer.is_any == right->pointer.is_any &&
+               left->pointer.is_null == right->pointer.is_null &&
+               left->pointer.is_const == right->pointer.is_const;
+    case ptcl_value_array_type:
+        return left->array.target == right->array.target && left->array.count == right->array.count;
+    case ptcl_value_object_type_type:
+        return left->object_type.target == right->object_type.target;
+    case ptcl_value_type_type:
+        return left->comp_type == right->comp_type;
+    case ptcl_value_typedata_type:
+        return left->typedata == right->typedata;
+    case ptcl_value_function_pointer_type:
+        return ptcl_type_interner_function_equals(left->function_pointer, right->function_pointer);
+    default:
+        return true;
+    }
+}
+
+static bool ptcl_type_interner_grow(ptcl_type_interner *interner)
+{
+    size_t capacity = interner->capacity * 2;
+    ptcl_type **items = calloc(capacity, sizeof(ptcl_type *));
+    if (items == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < interner->capacity; i++)
+    {
+        ptcl_type *item = interner->items[i];
+        if (item == NULL)
+        {
+            continue;
+        }
+
+        size_t index = ptcl_type_interner_hash(item) & (capacity - 1);
+        while (items[index] != NULL)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        items[index] = item;
+    }
+
+    free(interner->items);
+    interner->items = items;
+    interner->capacity = capacity;
+    return true;
+}
+
+static ptcl_type *ptcl_type_interner_find(ptcl_type_interner *interner, ptcl_type *type, size_t *index)
+{
+    *index = ptcl_type_interner_hash(type) & (interner->capacity - 1);
+    for (ptcl_type *item = interner->items[*index]; item != NULL; item = interner->items[*index])
+    {
+        if (ptcl_type_interner_equals(item, type))
+        {
+            return item;
+        }
+
+        *index = (*index + 1) & (interner->capacity - 1);
+    }
+
+    return NULL;
+}
+
+static bool ptcl_type_interner_intern_target(ptcl_type_interner *interner, ptcl_type **target)
+{
+    ptcl_type *owned = *target;
+    if (owned == NULL || (owned->is_primitive && owned->type == ptcl_value_function_pointer_type))
+    {
+        return true;
+    }
+
+    // Primitive targets are not owned by holder: global built-ins or already canonical nodes
+    *target = ptcl_type_interner_intern(interner, *owned);
+    if (!owned->is_primitive)
+    {
+        free(owned);
+    }
+
+    return *target != NULL;
+}
+
+ptcl_type_interner *ptcl_type_interner_create()
+{
+    ptcl_type_interner *interner = malloc(sizeof(ptcl_type_interner));
+    if (interner == NULL)
+    {
+        return NULL;
+    }
+
+    interner->arena = ptcl_arena_create(PTCL_ARENA_DEFAULT_CHUNK_SIZE / 4);
+    interner->items = calloc(PTCL_TYPE_INTERNER_DEFAULT_CAPACITY, sizeof(ptcl_type *));
+    if (interner->arena == NULL || interner->items == NULL)
+    {
+        ptcl_arena_destroy(interner->arena);
+        free(interner->items);
+        free(interner);
+        return NULL;
+    }
+
+    interner->shared = NULL;
+    interner->count = 0;
+    interner->capacity = PTCL_TYPE_INTERNER_DEFAULT_CAPACITY;
+    return interner;
+}
+
+ptcl_type_interner *ptcl_type_interner_create_local(ptcl_type_interner *shared)
+{
+    ptcl_type_interner *interner = ptcl_type_interner_create();
+    if (interner != NULL)
+    {
+        interner->shared = shared;
+    }
+
+    return interner;
+}
+
+ptcl_type *ptcl_type_interner_intern(ptcl_type_interner *interner, ptcl_type type)
+{
+    bool is_interned = true;
+    switch (type.type)
+    {
+    case ptcl_value_pointer_type:
+        is_interned = ptcl_type_interner_intern_target(interner, &type.pointer.target);
+        break;
+    case ptcl_value_array_type:
+        is_interned = ptcl_type_interner_intern_target(interner, &type.array.target);
+        break;
+    case ptcl_value_object_type_type:
+        is_interned = ptcl_type_interner_intern_target(interner, &type.object_type.target);
+        break;
+    default:
+        break;
+    }
+
+    if (!is_interned)
+    {
+        if (type.type == ptcl_value_function_pointer_type)
+        {
+            ptcl_type_destroy(type);
+        }
+
+        return NULL;
+    }
+
+    type.is_primitive = true;
+    size_t index;
+    ptcl_type *item = NULL;
+    for (ptcl_type_interner *shared = interner->shared; shared != NULL && item == NULL; shared = shared->shared)
+    {
+        item = ptcl_type_interner_find(shared, &type, &index);
+    }
+
+    if (item == NULL)
+    {
+        item = ptcl_type_interner_find(interner, &type, &index);
+    }
+
+    if (item != NULL)
+    {
+        // Members of equal function pointer are owned by canonical node
+        if (type.type == ptcl_value_function_pointer_type)
+        {
+            ptcl_type_destroy(type);
+        }
+
+        return item;
+    }
+
+    ptcl_type *result = ptcl_arena_allocate(interner->arena, sizeof(ptcl_type));
+    if (result == NULL)
+    {
+        if (type.type == ptcl_value_function_pointer_type)
+        {
+            ptcl_type_destroy(type);
+        }
+
+        return NULL;
+    }
+
+    *result = type;
+    if ((interner->count + 1) * 4 > interner->capacity * 3)
+    {
+        if (!ptcl_type_interner_grow(interner))
+        {
+            if (type.type == ptcl_value_function_pointer_type)
+            {
+                ptcl_type_destroy(type);
+            }
+
+            return NULL;
+        }
+
+        index = ptcl_type_interner_hash(result) & (interner->capacity - 1);
+        while (interner->items[index] != NULL)
+        {
+            index = (index + 1) & (interner->capacity - 1);
+        }
+    }
+
+    interner->items[index] = result;
+    interner->count++;
+    return result;
+}
+
+size_t ptcl_type_interner_count(ptcl_type_interner *interner)
+{
+    return interner->count;
+}
+
+bool ptcl_type_interner_adopt(ptcl_type_interner *interner, ptcl_type_interner *local)
+{
+    bool is_adopted = true;
+    for (size_t i = 0; i < local->capacity; i++)
+    {
+        ptcl_type *item = local->items[i];
+        if (item == NULL)
+        {
+            continue;
+        }
+
+        // Equal node is only kept alive, but function pointer is placed in table anyway, so clear releases its members
+        size_t index;
+        const bool is_found = ptcl_type_interner_find(interner, item, &index) != NULL;
+        if (is_found && item->type != ptcl_value_function_pointer_type)
+        {
+            continue;
+        }
+
+        if ((interner->count + 1) * 4 > interner->capacity * 3)
+        {
+            if (!ptcl_type_interner_grow(interner))
+            {
+                // Node is still released with arena, only its function pointer members are lost
+                is_adopted = false;
+                continue;
+            }
+
+            ptcl_type_interner_find(interner, item, &index);
+        }
+
+        while (interner->items[index] != NULL)
+        {
+            index = (index + 1) & (interner->capacity - 1);
+        }
+
+        interner->items[index] = item;
+        interner->count++;
+    }
+
+    ptcl_arena_adopt(interner->arena, local->arena);
+    free(local->items);
+    free(local);
+    return is_adopted;
+}
+
+void ptcl_type_interner_clear(ptcl_type_interner *interner)
+{
+    for (size_t i = 0; i < interner->capacity; i++)
+    {
+        ptcl_type *item = interner->items[i];
+        if (item != NULL && item->type == ptcl_value_function_pointer_type)
+        {
+            ptcl_type_destroy(*item);
+        }
+
+        interner->items[i] = NULL;
+    }
+
+    interner->count = 0;
+    ptcl_arena_clear(interner->arena);
+}
+
+void ptcl_type_interner_destroy(ptcl_type_interner *interner)
+{
+    if (interner == NULL)
+    {
+        return;
+    }
+
+    ptcl_type_interner_clear(interner);
+    free(interner->items);
+    ptcl_arena_destroy(interner->arena);
+    free(interner);
+}
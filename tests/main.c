@@ -1,123 +1,426 @@
 #include <stdio.h>
-#include <ptcl_transpiler.h>
+#include <string.h>
+#include <ptcl_batch.h>
+#include <ptcl_server.h>
 #include <ptcl_parser.h>
 #include <ptcl_lexer.h>
-#include <windows.h>
 
 // TODO: arrange structure members for greater speed
 
-int main()
+static void print_stats(FILE *output, ptcl_parser_stats *parser_stats, ptcl_transpiler_stats *transpiler_stats)
 {
-    char *source;
-    FILE *target = fopen("script.ptcl", "rb");
-    if (!target)
+    const double average_scan = parser_stats->lookups_count == 0
+                                    ? 0
+                                    : (double)parser_stats->lookups_scanned / parser_stats->lookups_count;
+
+    fprintf(output, "{\n  \"parser\": {\n");
+    fprintf(output, "    \"tokens\": %zu,\n", parser_stats->tokens_count);
+    fprintf(output, "    \"lookups\": %zu,\n", parser_stats->lookups_count);
+    fprintf(output, "    \"lookups_average_scan\": %.2f,\n", average_scan);
+    fprintf(output, "    \"syntax_match_attempts\": %zu,\n", parser_stats->syntax_match_attempts);
+    fprintf(output, "    \"syntax_backtracks\": %zu,\n", parser_stats->syntax_backtracks);
+    fprintf(output, "    \"syntax_expansions\": %zu,\n", parser_stats->syntax_expansions);
+    fprintf(output, "    \"lated_body_reparses\": %zu,\n", parser_stats->lated_body_reparses);
+    fprintf(output, "    \"cast_checks\": %zu,\n", parser_stats->cast_checks);
+    fprintf(output, "    \"interpreter_calls\": %zu,\n", parser_stats->interpreter_calls);
+    fprintf(output, "    \"interpreter_statements\": %zu,\n", parser_stats->interpreter_statements);
+    fprintf(output, "    \"statements\": %zu,\n", parser_stats->statements_count);
+    fprintf(output, "    \"expressions\": %zu,\n", parser_stats->expressions_count);
+    fprintf(output, "    \"nodes_bytes\": %zu,\n", parser_stats->nodes_bytes);
+    fprintf(output, "    \"interned_types\": %zu,\n", parser_stats->interned_types_count);
+    fprintf(output, "    \"arena_bytes\": %zu,\n", parser_stats->arena_bytes);
+    fprintf(output, "    \"incremental_bodies\": %zu,\n", parser_stats->incremental_bodies_count);
+    fprintf(output, "    \"cached_bodies\": %zu\n", parser_stats->cached_bodies_count);
+    fprintf(output, "  },\n  \"transpiler\": {\n");
+    fprintf(output, "    \"statements\": %zu,\n", transpiler_stats->statements_count);
+    fprintf(output, "    \"expressions\": %zu,\n", transpiler_stats->expressions_count);
+    fprintf(output, "    \"temp_variables\": %zu,\n", transpiler_stats->temp_variables_count);
+    fprintf(output, "    \"anonymous\": %zu,\n", transpiler_stats->anonymous_count);
+    fprintf(output, "    \"output_bytes\": %zu\n", transpiler_stats->output_bytes);
+    fprintf(output, "  }\n}\n");
+}
+
+static void add_stats(ptcl_parser_stats *parser_stats, ptcl_transpiler_stats *transpiler_stats, ptcl_batch_file *file)
+{
+    parser_stats->tokens_count += file->parser_stats->tokens_count;
+    parser_stats->lookups_count += file->parser_stats->lookups_count;
+    parser_stats->lookups_scanned += file->parser_stats->lookups_scanned;
+    parser_stats->syntax_match_attempts += file->parser_stats->syntax_match_attempts;
+    parser_stats->syntax_backtracks += file->parser_stats->syntax_backtracks;
+    parser_stats->syntax_expansions += file->parser_stats->syntax_expansions;
+    parser_stats->lated_body_reparses += file->parser_stats->lated_body_reparses;
+    parser_stats->cast_checks += file->parser_stats->cast_checks;
+    parser_stats->interpreter_calls += file->parser_stats->interpreter_calls;
+    parser_stats->interpreter_statements += file->parser_stats->interpreter_statements;
+    parser_stats->statements_count += file->parser_stats->statements_count;
+    parser_stats->expressions_count += file->parser_stats->expressions_count;
+    parser_stats->nodes_bytes += file->parser_stats->nodes_bytes;
+    parser_stats->interned_types_count += file->parser_stats->interned_types_count;
+    parser_stats->arena_bytes += file->parser_stats->arena_bytes;
+    parser_stats->incremental_bodies_count += file->parser_stats->incremental_bodies_count;
+    parser_stats->cached_bodies_count += file->parser_stats->cached_bodies_count;
+    transpiler_stats->statements_count += file->transpiler_stats->statements_count;
+    transpiler_stats->expressions_count += file->transpiler_stats->expressions_count;
+    transpiler_stats->temp_variables_count += file->transpiler_stats->temp_variables_count;
+    transpiler_stats->anonymous_count += file->transpiler_stats->anonymous_count;
+    transpiler_stats->output_bytes += file->transpiler_stats->output_bytes;
+}
+
+static int compare_profile_entries(const void *left, const void *right)
+{
+    const ptcl_parser_profile_entry *first = *(ptcl_parser_profile_entry *const *)left;
+    const ptcl_parser_profile_entry *second = *(ptcl_parser_profile_entry *const *)right;
+    if (first->output_bytes != second->output_bytes)
     {
-        perror("Failed to open file");
-        return 1;
+        return first->output_bytes < second->output_bytes ? 1 : -1;
     }
 
-    fseek(target, 0, SEEK_END);
-    long file_size = ftell(target);
-    if (file_size < 0)
+    if (first->nodes_count != second->nodes_count)
     {
-        perror("Failed to get file size");
-        fclose(target);
-        return 1;
+        return first->nodes_count < second->nodes_count ? 1 : -1;
     }
 
-    if (file_size == 0)
+    return strcmp(first->name, second->name);
+}
+
+static void print_profile(FILE *output, ptcl_parser_profile *profile)
+{
+    ptcl_parser_profile_entry **entries = malloc((profile->count + 1) * sizeof(ptcl_parser_profile_entry *));
+    if (entries == NULL)
     {
-        fclose(target);
-        source = strdup("");
+        perror("Memory allocation failed");
+        return;
     }
-    else
-    {
-        fseek(target, 0, SEEK_SET);
-        source = malloc(file_size + 1);
 
-        if (!source)
+    size_t count = 0;
+    for (size_t i = 0; i < profile->count; i++)
+    {
+        ptcl_parser_profile_entry *entry = ptcl_parser_profile_at(profile, i);
+        if (entry != NULL)
         {
-            fclose(target);
-            perror("Memory allocation failed");
-            return 1;
+            entries[count++] = entry;
         }
+    }
 
-        size_t bytes_read = fread(source, 1, file_size, target);
-        if (bytes_read != (size_t)file_size)
+    qsort(entries, count, sizeof(ptcl_parser_profile_entry *), compare_profile_entries);
+    fprintf(output, "%-8s %-32s %12s %12s %12s %12s\n", "kind", "name", "expansions", "tokens", "nodes", "c_bytes");
+    for (size_t i = 0; i < count; i++)
+    {
+        ptcl_parser_profile_entry *entry = entries[i];
+        fprintf(output, "%-8s %-32s %12zu %12zu %12zu %12zu\n",
+                entry->type == ptcl_parser_profile_syntax_type ? "syntax" : "inline",
+                entry->name,
+                entry->expansions_count,
+                entry->tokens_count,
+                entry->nodes_count,
+                entry->output_bytes);
+    }
+
+    free(entries);
+}
+
+// Replaces extension of input by ".c", result is owned by caller
+static char *default_output(char *input)
+{
+    const size_t length = strlen(input);
+    const char *extension = strrchr(input, '.');
+    const size_t stem = extension != NULL && strchr(extension, '/') == NULL && strchr(extension, '\\') == NULL
+                            ? (size_t)(extension - input)
+                            : length;
+    char *output = malloc(stem + 3);
+    if (output != NULL)
+    {
+        memcpy(output, input, stem);
+        memcpy(output + stem, ".c", 3);
+    }
+
+    return output;
+}
+
+static void print_usage(FILE *output)
+{
+    fprintf(output, "Usage: ptcl [options] [input [-o output]]...\n");
+    fprintf(output, "Without inputs script.ptcl is compiled into standard output\n");
+    fprintf(output, "       ptcl serve [--jobs <count>] [--prelude <file>] [socket]\n");
+}
+
+// ptcl serve [--jobs <count>] [--prelude <file>] [socket] compiles requests of clients until stop request,
+// then prints latencies of requests into stderr
+static int serve(int argc, char **argv)
+{
+    char *path = PTCL_SERVER_DEFAULT_PATH;
+    char *prelude = NULL;
+    size_t jobs = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+        {
+            jobs = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--prelude") == 0 && i + 1 < argc)
+        {
+            prelude = argv[++i];
+        }
+        else if (argv[i][0] == '-')
         {
-            source[bytes_read] = '\0';
+            fprintf(stderr, "Usage: ptcl serve [--jobs <count>] [--prelude <file>] [socket]\n");
+            return 1;
         }
         else
         {
-            source[file_size] = '\0';
+            path = argv[i];
         }
     }
 
-    fclose(target);
-
     ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
-    ptcl_lexer *lexer = ptcl_lexer_create("console", source, &configuration);
-    ptcl_tokens_list tokens_list = ptcl_lexer_tokenize(lexer);
+    ptcl_server *server = ptcl_server_create(&configuration, path, prelude, jobs);
+    if (server == NULL)
+    {
+        perror("Failed to start server");
+        return 1;
+    }
 
-    ptcl_parser *parser = ptcl_parser_create(&tokens_list, &configuration);
-    ptcl_parser_result result = ptcl_parser_parse(parser);
+    fprintf(stderr, "Listening on %s\n", path);
+    const bool is_served = ptcl_server_run(server);
+    const ptcl_server_latencies latencies = ptcl_server_get_latencies(server);
+    fprintf(stderr, "%zu requests, %zu failed, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            latencies.requests_count,
+            latencies.failures_count,
+            (double)latencies.p50 / 1000000.0,
+            (double)latencies.p90 / 1000000.0,
+            (double)latencies.p99 / 1000000.0,
+            (double)latencies.max / 1000000.0);
+    ptcl_server_destroy(server);
+    return is_served ? 0 : 1;
+}
 
-    if (result.errors_count == 0)
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "serve") == 0)
     {
-        ptcl_transpiler *transpiler = ptcl_transpiler_create(result);
-        char *transpiled = ptcl_transpiler_transpile(transpiler);
-        puts(transpiled);
+        return serve(argc - 1, argv + 1);
+    }
 
-        ptcl_transpiler_destroy(transpiler);
-        free(transpiled);
+    // --stats dumps performance counters as JSON into stderr, --trace <file> writes chrome://tracing events,
+    // --profile prints expansion costs of syntaxes and inlined static functions into stderr,
+    // --jobs <count> compiles files on threads, or function bodies of single file, 0 uses all processors,
+    // --summary prints time and throughput of every file into stderr, --prelude <file> is parsed once and placed before every input,
+    // --incremental keeps compiled function bodies next to inputs and compiles only changed ones next time,
+    // --cache <directory> reuses outputs and diagnostics of same inputs, --cache-limit <megabytes> bounds its size,
+    // --snapshot saves parsed programs next to inputs with ".ptcls" extension, such inputs are transpiled without parsing,
+    // prelude with ".ptclp" one, which next runs map instead of parsing prelude, and leading imports of inputs with ".ptclm" one.
+    // Single input without -o is printed into stdout, other ones are written near inputs with ".c" extension
+    bool with_stats = false;
+    bool with_profile = false;
+    bool with_summary = false;
+    char *trace_path = NULL;
+    char *prelude = NULL;
+    bool is_incremental = false;
+    bool with_snapshot = false;
+    char *cache = NULL;
+    size_t cache_limit = PTCL_OUTPUT_CACHE_DEFAULT_LIMIT;
+    size_t jobs = 1;
+    ptcl_batch_file *files = malloc(argc * sizeof(ptcl_batch_file));
+    char **outputs = calloc(argc, sizeof(char *));
+    size_t count = 0;
+    if (files == NULL || outputs == NULL)
+    {
+        perror("Memory allocation failed");
+        free(files);
+        free(outputs);
+        return 1;
     }
-    else
+
+    for (int i = 1; i < argc; i++)
     {
-        for (size_t i = 0; i < result.errors_count; i++)
+        if (strcmp(argv[i], "--stats") == 0)
         {
-            int error_pos = result.errors[i].location.position;
-            int line_start = 0;
-            int line_end = 0;
-            int line_number = 1;
-            for (int j = 0; j < error_pos; j++)
-            {
-                if (source[j] == '\n')
-                {
-                    line_number++;
-                    line_start = j + 1;
-                }
-            }
+            with_stats = true;
+        }
+        else if (strcmp(argv[i], "--profile") == 0)
+        {
+            with_profile = true;
+        }
+        else if (strcmp(argv[i], "--summary") == 0)
+        {
+            with_summary = true;
+        }
+        else if (strcmp(argv[i], "--incremental") == 0)
+        {
+            is_incremental = true;
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0)
+        {
+            with_snapshot = true;
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cache = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache-limit") == 0 && i + 1 < argc)
+        {
+            cache_limit = strtoul(argv[++i], NULL, 10) * 1024 * 1024;
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--prelude") == 0 && i + 1 < argc)
+        {
+            prelude = argv[++i];
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+        {
+            jobs = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc && count > 0)
+        {
+            files[count - 1].output = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            print_usage(stderr);
+            free(files);
+            free(outputs);
+            return 1;
+        }
+        else
+        {
+            files[count++] = ptcl_batch_file_create(argv[i], NULL);
+        }
+    }
+
+    if (count == 0)
+    {
+        files[count++] = ptcl_batch_file_create("script.ptcl", NULL);
+    }
 
-            line_end = error_pos;
-            while (source[line_end] != '\0' && source[line_end] != '\n')
+    int status = 0;
+    for (size_t i = 0; count > 1 && i < count; i++)
+    {
+        if (files[i].output == NULL)
+        {
+            outputs[i] = default_output(files[i].input);
+            files[i].output = outputs[i];
+            if (outputs[i] == NULL)
             {
-                line_end++;
+                perror("Memory allocation failed");
+                status = 1;
+                goto cleanup;
             }
+        }
+    }
+
+    ptcl_parser_stats *parser_stats = with_stats ? calloc(count, sizeof(ptcl_parser_stats)) : NULL;
+    ptcl_transpiler_stats *transpiler_stats = with_stats ? calloc(count, sizeof(ptcl_transpiler_stats)) : NULL;
+    ptcl_parser_profile *profiles = with_profile ? calloc(count, sizeof(ptcl_parser_profile)) : NULL;
+    if ((with_stats && (parser_stats == NULL || transpiler_stats == NULL)) || (with_profile && profiles == NULL))
+    {
+        perror("Memory allocation failed");
+        free(parser_stats);
+        free(transpiler_stats);
+        free(profiles);
+        status = 1;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        files[i].parser_stats = with_stats ? &parser_stats[i] : NULL;
+        files[i].transpiler_stats = with_stats ? &transpiler_stats[i] : NULL;
+        files[i].profile = with_profile ? &profiles[i] : NULL;
+    }
+
+    // Configuration and built-ins are shared by all workers
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_batch batch = ptcl_batch_create(&configuration, files, count, count == 1 ? 1 : jobs);
+    batch.parser_jobs = count == 1 ? jobs : 1;
+    batch.prelude = prelude;
+    batch.is_incremental = is_incremental;
+    batch.with_snapshot = with_snapshot;
+    batch.cache = cache;
+    batch.cache_limit = cache_limit;
+    batch.with_trace = trace_path != NULL;
+    if (!ptcl_batch_compile(&batch))
+    {
+        status = 1;
+    }
 
-            printf("Error at line %d, position %d:\n", line_number, error_pos - line_start);
-            printf("  ");
-            for (int j = line_start; j < line_end; j++)
+    for (size_t i = 0; i < count; i++)
+    {
+        ptcl_batch_file *file = &files[i];
+        if (file->transpiled != NULL)
+        {
+            puts(file->transpiled);
+        }
+
+        if (file->diagnostics != NULL)
+        {
+            if (count > 1)
             {
-                putchar(source[j]);
+                printf("%s:\n", file->input);
             }
 
-            printf("\n  ");
-            for (int j = line_start; j < error_pos; j++)
+            fputs(file->diagnostics, stdout);
+        }
+    }
+
+    if (with_stats)
+    {
+        ptcl_parser_stats parser_total = {0};
+        ptcl_transpiler_stats transpiler_total = {0};
+        for (size_t i = 0; i < count; i++)
+        {
+            add_stats(&parser_total, &transpiler_total, &files[i]);
+        }
+
+        print_stats(stderr, &parser_total, &transpiler_total);
+    }
+
+    if (with_profile)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (count > 1)
             {
-                putchar(' ');
+                fprintf(stderr, "%s:\n", files[i].input);
             }
-            printf("^\n");
 
-            printf("Message: %s\n\n", result.errors[i].message);
+            print_profile(stderr, &profiles[i]);
+            ptcl_parser_profile_destroy(&profiles[i]);
         }
     }
 
-    free(source);
+    if (with_summary)
+    {
+        ptcl_batch_write_summary(&batch, stderr);
+    }
+
+    if (trace_path != NULL)
+    {
+        FILE *trace_file = fopen(trace_path, "w");
+        if (trace_file == NULL || !ptcl_trace_write(batch.traces, batch.traces_count, trace_file))
+        {
+            perror("Failed to write trace");
+        }
+
+        if (trace_file != NULL)
+        {
+            fclose(trace_file);
+        }
+    }
 
-    ptcl_parser_result_destroy(result);
-    ptcl_parser_destroy(parser);
+    ptcl_batch_destroy(&batch);
+    free(parser_stats);
+    free(transpiler_stats);
+    free(profiles);
+cleanup:
+    for (size_t i = 0; i < count; i++)
+    {
+        free(outputs[i]);
+    }
 
-    ptcl_tokens_list_destroy(tokens_list);
-    ptcl_lexer_destroy(lexer);
-    return 0;
-}
\ No newline at end of file
+    free(outputs);
+    free(files);
+    return status;
+}
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_lexer.h>
+#include <ptcl_incremental.h>
+#include <ptcl_batch.h>
+#include <ptcl_file.h>
+
+// Edits one script step by step and compiles it with cache of bodies, which is kept between steps.
+// Every output must be the same as full compilation, and only bodies, which edit can't change, are taken from cache: make incremental
+#define INCREMENTAL_PATH "ptcl_incremental_test.ptcl"
+#define INCREMENTAL_CACHE_PATH "ptcl_incremental_test" PTCL_INCREMENTAL_EXTENSION
+
+typedef struct incremental_step
+{
+    char *name;
+    char *source;
+    size_t cached_count;
+} incremental_step;
+
+#define INCREMENTAL_PROTOTYPES                                      \
+    "unsyntax {\n"                                                  \
+    "\tprototype function printn(content: integer, ...): integer\n" \
+    "}\n\n"
+
+#define INCREMENTAL_CLAMP                         \
+    "function clamp(value: integer): integer {\n" \
+    "\tif (value > limit) {\n"                    \
+    "\t\treturn limit\n"                          \
+    "\t}\n\n"                                     \
+    "\treturn value\n"                            \
+    "}\n\n"
+
+#define INCREMENTAL_SYNTAX              \
+    "syntax twice [value: integer] {\n" \
+    "\tvalue * 2\n"                     \
+    "}\n\n"
+
+static incremental_step incremental_steps[] = {
+    {"first compilation",
+     INCREMENTAL_PROTOTYPES
+     "limit: integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right\n}\n\n" INCREMENTAL_CLAMP
+     "function show(value: integer): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(1, 2)))\n\n\treturn 0\n}\n",
+     0},
+    {"same script",
+     INCREMENTAL_PROTOTYPES
+     "limit: integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right\n}\n\n" INCREMENTAL_CLAMP
+     "function show(value: integer): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(1, 2)))\n\n\treturn 0\n}\n",
+     4},
+    // Only changed body
+    {"body",
+     INCREMENTAL_PROTOTYPES
+     "limit: integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right + 1\n}\n\n" INCREMENTAL_CLAMP
+     "function show(value: integer): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(1, 2)))\n\n\treturn 0\n}\n",
+     3},
+    // Function and its caller, tokens of which are the same
+    {"signature",
+     INCREMENTAL_PROTOTYPES
+     "limit: integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right + 1\n}\n\n" INCREMENTAL_CLAMP
+     "function show(value: integer, ...): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(1, 2)))\n\n\treturn 0\n}\n",
+     2},
+    // Syntax can change parsing of anything after it
+    {"new syntax",
+     INCREMENTAL_PROTOTYPES
+     "limit: integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right + 1\n}\n\n" INCREMENTAL_SYNTAX INCREMENTAL_CLAMP
+     "function show(value: integer, ...): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(#twice(1), 2)))\n\n\treturn 0\n}\n",
+     1},
+    // Static global is written by value, and other functions don't take it anymore
+    {"global type",
+     INCREMENTAL_PROTOTYPES
+     "limit: static integer = 5\n\n"
+     "function add(left: integer, right: integer): integer {\n\treturn left + right + 1\n}\n\n" INCREMENTAL_SYNTAX INCREMENTAL_CLAMP
+     "function show(value: integer, ...): void {\n\tprintn(value)\n}\n\n"
+     "function main(): integer {\n\tshow(clamp(add(#twice(1), 2)))\n\n\treturn 0\n}\n",
+     0}};
+
+// Returns transpiled code, cached bodies are counted by parser stats
+static char *incremental_compile(ptcl_lexer_configuration *configuration, bool is_incremental, size_t *cached_count)
+{
+    ptcl_parser_stats stats = {0};
+    ptcl_batch_file file = ptcl_batch_file_create(INCREMENTAL_PATH, NULL);
+    file.parser_stats = &stats;
+    ptcl_batch batch = ptcl_batch_create(configuration, &file, 1, 1);
+    batch.is_incremental = is_incremental;
+    char *transpiled = NULL;
+    if (ptcl_batch_compile(&batch))
+    {
+        transpiled = file.transpiled;
+        file.transpiled = NULL;
+    }
+    else if (file.diagnostics != NULL)
+    {
+        printf("%s", file.diagnostics);
+    }
+
+    *cached_count = stats.cached_bodies_count;
+    ptcl_batch_destroy(&batch);
+    return transpiled;
+}
+
+static bool incremental_test_step(ptcl_lexer_configuration *configuration, incremental_step *step)
+{
+    if (!ptcl_file_write_atomic(INCREMENTAL_PATH, step->source, strlen(step->source)))
+    {
+        printf("[FAIL] %s can't be written\n", step->name);
+        return false;
+    }
+
+    size_t cached_count;
+    char *expected = incremental_compile(configuration, false, &cached_count);
+    char *output = incremental_compile(configuration, true, &cached_count);
+    bool is_passed = expected != NULL && output != NULL && strcmp(expected, output) == 0;
+    if (!is_passed)
+    {
+        printf("[FAIL] %s: cached output differs from full compilation\n", step->name);
+    }
+    else if (cached_count != step->cached_count)
+    {
+        printf("[FAIL] %s: %zu bodies are taken from cache, expected %zu\n", step->name, cached_count, step->cached_count);
+        is_passed = false;
+    }
+    else
+    {
+        printf("[OK] %s, %zu bodies are taken from cache\n", step->name, cached_count);
+    }
+
+    free(output);
+    free(expected);
+    return is_passed;
+}
+
+// Fingerprint of body with declarations of given sources. Tokens live until fingerprint is counted, like tokens of parsed input
+static uint64_t incremental_fingerprint(ptcl_incremental *incremental, uint64_t seed, char *common, char *limit, char *body)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    char *sources[] = {common, limit, body};
+    ptcl_lexer *lexers[3];
+    ptcl_tokens_list tokens[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        lexers[i] = ptcl_lexer_create("fingerprint", sources[i] != NULL ? sources[i] : "", &configuration);
+        tokens[i] = ptcl_lexer_tokenize(lexers[i]);
+    }
+
+    ptcl_incremental_begin(incremental, seed);
+    if (common != NULL)
+    {
+        ptcl_incremental_declare(incremental, NULL, tokens[0].tokens, tokens[0].count);
+    }
+
+    ptcl_incremental_declare(incremental, "limit", tokens[1].tokens, tokens[1].count);
+    const uint64_t fingerprint = ptcl_incremental_fingerprint(incremental, tokens[2].tokens, tokens[2].count);
+    for (size_t i = 0; i < 3; i++)
+    {
+        ptcl_tokens_list_destroy(tokens[i]);
+        ptcl_lexer_destroy(lexers[i]);
+    }
+
+    return fingerprint;
+}
+
+// Body depends on declarations it names, on declarations without names and on seed
+static bool incremental_test_fingerprints(void)
+{
+    ptcl_incremental *incremental = ptcl_incremental_create("ptcl_incremental_fingerprint.ptcl");
+    if (incremental == NULL)
+    {
+        printf("[FAIL] fingerprints: cache can't be created\n");
+        return false;
+    }
+
+    char *limit = "limit: integer = 5";
+    char *user = "function clamp(value: integer): integer { return limit }";
+    char *other = "function add(left: integer, right: integer): integer { return left + right }";
+    const uint64_t base = incremental_fingerprint(incremental, 0, NULL, limit, user);
+    const bool is_passed =
+        base == incremental_fingerprint(incremental, 0, NULL, limit, user) &&
+        base != incremental_fingerprint(incremental, 0, NULL, "limit: static integer = 5", user) &&
+        incremental_fingerprint(incremental, 0, NULL, limit, other) ==
+            incremental_fingerprint(incremental, 0, NULL, "limit: static integer = 5", other) &&
+        base != incremental_fingerprint(incremental, 0, "syntax twice [value: integer] { value * 2 }", limit, user) &&
+        base != incremental_fingerprint(incremental, 1, NULL, limit, user);
+    ptcl_incremental_destroy(incremental);
+    printf(is_passed ? "[OK] fingerprints\n" : "[FAIL] fingerprints don't follow declarations\n");
+    return is_passed;
+}
+
+int main(void)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    remove(INCREMENTAL_CACHE_PATH);
+    size_t failures_count = incremental_test_fingerprints() ? 0 : 1;
+    const size_t count = sizeof(incremental_steps) / sizeof(incremental_steps[0]);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!incremental_test_step(&configuration, &incremental_steps[i]))
+        {
+            failures_count++;
+        }
+    }
+
+    remove(INCREMENTAL_PATH);
+    remove(INCREMENTAL_CACHE_PATH);
+    printf("Results: %zu steps, %zu failed\n", count + 1, failures_count);
+    return failures_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_lexer.h>
+#include <ptcl_parser.h>
+#include <ptcl_transpiler.h>
+#include <ptcl_context.h>
+#include <ptcl_snapshot.h>
+#include <ptcl_module.h>
+#include <ptcl_file.h>
+
+// Saves parsed scripts as snapshots, loads them and compares transpiled code with direct compilation.
+// Each script is also saved as prelude of empty program, which is parsed after mapped prelude,
+// and as module, which is imported by empty program, so prelude of its imports is saved next to importer.
+// Then loads broken copies of each image, checksum of which is counted again so checks after it are reached.
+// Broken image must be refused or transpiled without reading outside of it, so it is run under AddressSanitizer: make snapshot
+#define SNAPSHOT_PATH "ptcl_snapshot_test" PTCL_SNAPSHOT_EXTENSION
+#define SNAPSHOT_PRELUDE_PATH "ptcl_snapshot_test" PTCL_SNAPSHOT_PRELUDE_EXTENSION
+#define SNAPSHOT_PRELUDE_KEY 0x50544350ULL
+#define SNAPSHOT_MODULE_PATH "ptcl_snapshot_test_module" PTCL_MODULE_EXTENSION
+#define SNAPSHOT_IMPORTER_PATH "ptcl_snapshot_test_importer" PTCL_MODULE_EXTENSION
+#define SNAPSHOT_IMPORTS_PATH "ptcl_snapshot_test_importer" PTCL_SNAPSHOT_IMPORTS_EXTENSION
+#ifndef SNAPSHOT_MUTATIONS_COUNT
+#define SNAPSHOT_MUTATIONS_COUNT 2000
+#endif
+// Offset of checksum in header of image, after magic, version and layout
+#define SNAPSHOT_CHECKSUM_OFFSET 16
+
+typedef struct snapshot_counts
+{
+    size_t refused;
+    size_t loaded;
+    size_t failures;
+} snapshot_counts;
+
+static char *snapshot_transpile(ptcl_parser_result result)
+{
+    ptcl_transpiler *transpiler = ptcl_transpiler_create(result);
+    if (transpiler == NULL)
+    {
+        return NULL;
+    }
+
+    char *output = ptcl_transpiler_transpile(transpiler);
+    ptcl_transpiler_destroy(transpiler);
+    return output;
+}
+
+// Transpiled code of direct compilation, snapshot is saved before result is released
+static char *snapshot_compile(char *path, char *source, bool *is_saved)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_lexer *lexer = ptcl_lexer_create(path, source, &configuration);
+    ptcl_tokens_list tokens = ptcl_lexer_tokenize(lexer);
+    ptcl_parser *parser = ptcl_parser_create(&tokens, &configuration);
+    ptcl_parser_result result = ptcl_parser_parse(parser);
+    char *output = NULL;
+    *is_saved = false;
+    if (result.errors_count == 0 && !result.is_critical)
+    {
+        *is_saved = ptcl_snapshot_save(&result, SNAPSHOT_PATH);
+        output = snapshot_transpile(result);
+    }
+
+    ptcl_parser_result_destroy(result);
+    ptcl_parser_destroy(parser);
+    ptcl_tokens_list_destroy(tokens);
+    ptcl_lexer_destroy(lexer);
+    return output;
+}
+
+static char *snapshot_load(void)
+{
+    ptcl_snapshot *snapshot = ptcl_snapshot_load(SNAPSHOT_PATH);
+    if (snapshot == NULL)
+    {
+        return NULL;
+    }
+
+    char *output = snapshot_transpile(ptcl_snapshot_get_result(snapshot));
+    ptcl_snapshot_destroy(snapshot);
+    return output;
+}
+
+// Empty program after prelude, which is set in context
+static char *snapshot_compile_program(ptcl_context *context)
+{
+    ptcl_parser_result *result = ptcl_context_parse(context, "program.ptcl", "");
+    return result->errors_count == 0 && !result->is_critical ? ptcl_context_transpile(context) : NULL;
+}
+
+// Transpiled code of program after parsed prelude, prelude is saved before context is destroyed
+static char *snapshot_compile_prelude(char *path, char *source, bool *is_saved)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_context *context = ptcl_context_create(&configuration);
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_parser_result *result = ptcl_context_parse_prelude(context, path, source);
+    char *output = NULL;
+    *is_saved = false;
+    if (result->errors_count == 0 && !result->is_critical)
+    {
+        *is_saved = ptcl_context_save_prelude(context, SNAPSHOT_PRELUDE_PATH, SNAPSHOT_PRELUDE_KEY);
+        output = snapshot_compile_program(context);
+    }
+
+    ptcl_context_destroy(context);
+    return output;
+}
+
+static char *snapshot_load_prelude(void)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_context *context = ptcl_context_create(&configuration);
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    char *output = ptcl_context_load_prelude(context, SNAPSHOT_PRELUDE_PATH, SNAPSHOT_PRELUDE_KEY) ? snapshot_compile_program(context) : NULL;
+    ptcl_context_destroy(context);
+    return output;
+}
+
+// Program, which only imports module. Broken image of its imports is refused and module is parsed instead,
+// so each mapped image is counted as loaded
+static char *snapshot_compile_importer(bool is_saved)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_context *context = ptcl_context_create(&configuration);
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    ptcl_parser_set_imports_saved(ptcl_context_get_parser(context), is_saved);
+    ptcl_parser_result *result = ptcl_context_parse(context, SNAPSHOT_IMPORTER_PATH, "import \"" SNAPSHOT_MODULE_PATH "\"\n");
+    char *output = result->errors_count == 0 && !result->is_critical ? ptcl_context_transpile(context) : NULL;
+    ptcl_context_destroy(context);
+    return output;
+}
+
+static char *snapshot_compile_imports(char *path, char *source, bool *is_saved)
+{
+    (void)path;
+    remove(SNAPSHOT_IMPORTS_PATH);
+    char *output = ptcl_file_write_atomic(SNAPSHOT_MODULE_PATH, source, strlen(source)) ? snapshot_compile_importer(true) : NULL;
+    char *image = ptcl_file_read(SNAPSHOT_IMPORTS_PATH, NULL);
+    *is_saved = image != NULL;
+    free(image);
+    return output;
+}
+
+static char *snapshot_load_imports(void)
+{
+    return snapshot_compile_importer(false);
+}
+
+// Same words hash as loading uses, header is counted with zero checksum
+static void snapshot_seal(char *image, size_t size)
+{
+    uint64_t checksum = 0;
+    memcpy(image + SNAPSHOT_CHECKSUM_OFFSET, &checksum, sizeof(checksum));
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, image + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+
+    memcpy(image + SNAPSHOT_CHECKSUM_OFFSET, &hash, sizeof(hash));
+}
+
+static uint64_t snapshot_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Flips bits, replaces words by small numbers or by offsets inside of image, which look like relocated pointers,
+// and cuts image. Only cut image keeps old checksum, so it is refused by size
+static size_t snapshot_mutate(char *image, size_t size, uint64_t *state)
+{
+    const size_t words = size / sizeof(uint64_t);
+    const size_t word = (size_t)(snapshot_random(state) % words);
+    uint64_t value;
+    memcpy(&value, image + word * sizeof(uint64_t), sizeof(value));
+    switch (snapshot_random(state) % 4)
+    {
+    case 0:
+        value ^= 1ULL << (snapshot_random(state) % 64);
+        break;
+    case 1:
+        value = snapshot_random(state) % 64;
+        break;
+    case 2:
+        value = snapshot_random(state) % size & ~(uint64_t)(sizeof(uint64_t) - 1);
+        break;
+    default:
+        return (size_t)(snapshot_random(state) % size);
+    }
+
+    memcpy(image + word * sizeof(uint64_t), &value, sizeof(value));
+    if (word != SNAPSHOT_CHECKSUM_OFFSET / sizeof(uint64_t))
+    {
+        snapshot_seal(image, size);
+    }
+
+    return size;
+}
+
+static void snapshot_fuzz(char *path, char *image_path, char *(*load)(void), char *image, size_t size, snapshot_counts *counts)
+{
+    char *copy = malloc(size);
+    if (copy == NULL)
+    {
+        counts->failures++;
+        return;
+    }
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL ^ size;
+    for (size_t i = 0; i < SNAPSHOT_MUTATIONS_COUNT; i++)
+    {
+        memcpy(copy, image, size);
+        const size_t mutated = snapshot_mutate(copy, size, &state);
+        if (!ptcl_file_write_atomic(image_path, copy, mutated))
+        {
+            printf("[FAIL] %s can't write mutation %zu\n", path, i);
+            counts->failures++;
+            break;
+        }
+
+        char *output = load();
+        if (output == NULL)
+        {
+            counts->refused++;
+            continue;
+        }
+
+        counts->loaded++;
+        free(output);
+    }
+
+    free(copy);
+}
+
+// Compiles source directly, then from saved image, and fuzzes image if outputs are the same
+static void snapshot_test(char *path, char *source, char *kind, char *image_path, char *(*compile)(char *, char *, bool *),
+                          char *(*load)(void), snapshot_counts *counts)
+{
+    bool is_saved;
+    char *expected = compile(path, source, &is_saved);
+    if (expected == NULL || !is_saved)
+    {
+        printf("[SKIP] %s %s (compile error)\n", kind, path);
+        free(expected);
+        return;
+    }
+
+    size_t size = 0;
+    char *image = ptcl_file_read(image_path, &size);
+    char *output = load();
+    if (image == NULL || output == NULL || strcmp(output, expected) != 0)
+    {
+        printf("[FAIL] %s %s differs after loading snapshot\n", kind, path);
+        counts->failures++;
+    }
+    else
+    {
+        printf("[OK] %s %s, image is %zu bytes\n", kind, path, size);
+        snapshot_fuzz(path, image_path, load, image, size, counts);
+    }
+
+    free(output);
+    free(image);
+    free(expected);
+}
+
+// Image of prelude is refused by loader of programs and by other key
+static void snapshot_test_keys(snapshot_counts *counts)
+{
+    ptcl_snapshot *program = ptcl_snapshot_load(SNAPSHOT_PRELUDE_PATH);
+    ptcl_snapshot *other = ptcl_snapshot_load_prelude(SNAPSHOT_PRELUDE_PATH, SNAPSHOT_PRELUDE_KEY + 1);
+    if (program != NULL || other != NULL)
+    {
+        printf("[FAIL] image of prelude is loaded as program or with other key\n");
+        counts->failures++;
+    }
+
+    ptcl_snapshot_destroy(program);
+    ptcl_snapshot_destroy(other);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: ptcl_snapshot <file>...\n");
+        return 1;
+    }
+
+    snapshot_counts counts = {0};
+    for (int i = 1; i < argc; i++)
+    {
+        char *source = ptcl_file_read(argv[i], NULL);
+        if (source == NULL)
+        {
+            printf("[SKIP] %s (read error)\n", argv[i]);
+            continue;
+        }
+
+        snapshot_test(argv[i], source, "program", SNAPSHOT_PATH, snapshot_compile, snapshot_load, &counts);
+        snapshot_test(argv[i], source, "prelude", SNAPSHOT_PRELUDE_PATH, snapshot_compile_prelude, snapshot_load_prelude, &counts);
+        snapshot_test(argv[i], source, "imports", SNAPSHOT_IMPORTS_PATH, snapshot_compile_imports, snapshot_load_imports, &counts);
+        free(source);
+    }
+
+    snapshot_test_keys(&counts);
+    remove(SNAPSHOT_PATH);
+    remove(SNAPSHOT_PRELUDE_PATH);
+    remove(SNAPSHOT_IMPORTS_PATH);
+    remove(SNAPSHOT_MODULE_PATH);
+    remove(SNAPSHOT_IMPORTER_PATH);
+    remove("ptcl_snapshot_test_module" PTCL_MODULE_INTERFACE_EXTENSION);
+    printf("Results: %zu broken images refused, %zu loaded, %zu failed\n", counts.refused, counts.loaded, counts.failures);
+    return counts.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ptcl_lexer.h>
+#include <ptcl_parser.h>
+#include <ptcl_transpiler.h>
+#include <ptcl_thread.h>
+#include <ptcl_file.h>
+
+// Compiles same scripts on several threads at once and compares outputs with serial run.
+// Parsers share only read-only built-ins, so it is run under ThreadSanitizer: make stress
+#define STRESS_THREADS_COUNT 8
+#define STRESS_ROUNDS_COUNT 6
+#define STRESS_MAX_FILES 16
+
+typedef struct stress_file
+{
+    char *path;
+    char *source;
+    char *expected;
+} stress_file;
+
+typedef struct stress_state
+{
+    stress_file files[STRESS_MAX_FILES];
+    size_t files_count;
+    ptcl_mutex *mutex;
+    size_t failures_count;
+} stress_state;
+
+typedef struct stress_worker
+{
+    stress_state *state;
+    size_t index;
+} stress_worker;
+
+static char *stress_compile(char *path, char *source, size_t jobs)
+{
+    ptcl_lexer_configuration configuration = ptcl_lexer_configuration_default();
+    ptcl_lexer *lexer = ptcl_lexer_create(path, source, &configuration);
+    ptcl_tokens_list tokens = ptcl_lexer_tokenize(lexer);
+    ptcl_parser *parser = ptcl_parser_create(&tokens, &configuration);
+    ptcl_parser_set_jobs(parser, jobs);
+    ptcl_parser_result result = ptcl_parser_parse(parser);
+    char *output = NULL;
+    if (result.errors_count == 0 && !result.is_critical)
+    {
+        ptcl_transpiler *transpiler = ptcl_transpiler_create(result);
+        output = ptcl_transpiler_transpile(transpiler);
+        ptcl_transpiler_destroy(transpiler);
+    }
+    else
+    {
+        char errors[64];
+        snprintf(errors, sizeof(errors), "errors %zu", result.errors_count);
+        output = strdup(errors);
+    }
+
+    ptcl_parser_result_destroy(result);
+    ptcl_parser_destroy(parser);
+    ptcl_tokens_list_destroy(tokens);
+    ptcl_lexer_destroy(lexer);
+    return output;
+}
+
+static void stress_run(void *argument)
+{
+    stress_worker *worker = argument;
+    stress_state *state = worker->state;
+    for (size_t round = 0; round < STRESS_ROUNDS_COUNT; round++)
+    {
+        stress_file *file = &state->files[(worker->index + round) % state->files_count];
+        char *output = stress_compile(file->path, file->source, 1 + round % 2);
+        if (output == NULL || strcmp(output, file->expected) != 0)
+        {
+            ptcl_mutex_lock(state->mutex);
+            state->failures_count++;
+            ptcl_mutex_unlock(state->mutex);
+            printf("[FAIL] %s differs on thread %zu\n", file->path, worker->index);
+        }
+
+        free(output);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    stress_state state = {0};
+    state.mutex = ptcl_mutex_create();
+    for (int i = 1; i < argc && state.files_count < STRESS_MAX_FILES; i++)
+    {
+        stress_file *file = &state.files[state.files_count];
+        file->path = argv[i];
+        file->source = ptcl_file_read(argv[i], NULL);
+        if (file->source == NULL)
+        {
+            printf("[SKIP] %s (read error)\n", argv[i]);
+            continue;
+        }
+
+        file->expected = stress_compile(file->path, file->source, 1);
+        if (file->expected == NULL)
+        {
+            printf("[SKIP] %s (compile error)\n", argv[i]);
+            free(file->source);
+            continue;
+        }
+
+        state.files_count++;
+    }
+
+    if (state.mutex == NULL || state.files_count == 0)
+    {
+        printf("Usage: ptcl_stress <file>...\n");
+        ptcl_mutex_destroy(state.mutex);
+        return 1;
+    }
+
+    stress_worker workers[STRESS_THREADS_COUNT];
+    ptcl_thread *threads[STRESS_THREADS_COUNT];
+    for (size_t i = 0; i < STRESS_THREADS_COUNT; i++)
+    {
+        workers[i] = (stress_worker){.state = &state, .index = i};
+        threads[i] = ptcl_thread_create(stress_run, &workers[i]);
+        if (threads[i] == NULL)
+        {
+            stress_run(&workers[i]);
+        }
+    }
+
+    for (size_t i = 0; i < STRESS_THREADS_COUNT; i++)
+    {
+        if (threads[i] != NULL)
+        {
+            ptcl_thread_join(threads[i]);
+        }
+    }
+
+    printf("Results: %zu compilations on %d threads, %zu failed\n",
+           (size_t)STRESS_THREADS_COUNT * STRESS_ROUNDS_COUNT, STRESS_THREADS_COUNT, state.failures_count);
+    for (size_t i = 0; i < state.files_count; i++)
+    {
+        free(state.files[i].source);
+        free(state.files[i].expected);
+    }
+
+    ptcl_mutex_destroy(state.mutex);
+    return state.failures_count == 0 ? 0 : 1;
+}